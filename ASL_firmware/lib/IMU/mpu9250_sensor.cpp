@@ -25,6 +25,12 @@
 #define REG_I2C_SLV4_CTRL   0x34
 #define REG_I2C_SLV4_DI     0x35
 #define REG_EXT_SENS_DATA_00 0x49
+#define REG_I2C_MST_DELAY_CTRL 0x67
+
+// Burst layout from ACCEL_XOUT_H: 14 bytes accel/temp/gyro, then the AK8963
+// block SLV0 copies into EXT_SENS_DATA_00 (ST1, HXL..HZH, ST2).
+#define MOTION_BYTES   14
+#define AK_BLOCK_BYTES 8
 
 // MPU addresses
 #define MPU_ADDR_LOW   0x68
@@ -54,39 +60,33 @@
 #define AK_SCALE       (4912.0f / 32760.0f)  // μT
 #define QMC_SCALE      (12000.0f / 32768.0f)  // Gauss to μT
 
+// A full rotation sweeps each magnetometer axis through about twice the
+// local field (25-65 uT); less than this means the glove was not turned
+// enough for the min/max centre to be the hard-iron offset.
+#define MAG_MIN_CAL_SPAN 30.0f  // μT
+
 // Constructor
-MPU9250_Sensor::MPU9250_Sensor(TwoWire &bus, uint8_t addr)
-    : wire(&bus), mpuAddr(addr), initialized(false), magMode(MAG_NONE),
+MPU9250_Sensor::MPU9250_Sensor(I2CBus &bus, uint8_t addr)
+    : bus(&bus), mpuAddr(addr), initialized(false), magMode(MAG_NONE),
       magOK(false), ax(0), ay(0), az(0), gx(0), gy(0), gz(0),
       mx(0), my(0), mz(0), temp(0), q0(1), q1(0), q2(0), q3(0),
       beta(0.1f), lastUpdate(0) {
     akAdj[0] = akAdj[1] = akAdj[2] = 1.0f;
+    resetCalibration();
 }
 
 // I2C Helpers
-void MPU9250_Sensor::writeReg(uint8_t addr, uint8_t reg, uint8_t val) {
-    wire->beginTransmission(addr);
-    wire->write(reg);
-    wire->write(val);
-    wire->endTransmission();
+bool MPU9250_Sensor::writeReg(uint8_t addr, uint8_t reg, uint8_t val) {
+    return bus->writeReg(addr, reg, val) == I2C_OK;
 }
 
 uint8_t MPU9250_Sensor::readReg(uint8_t addr, uint8_t reg) {
-    wire->beginTransmission(addr);
-    wire->write(reg);
-    wire->endTransmission(false);
-    wire->requestFrom((int)addr, 1);
-    return wire->available() ? wire->read() : 0xFF;
+    uint8_t value;
+    return bus->readReg(addr, reg, value) == I2C_OK ? value : 0xFF;
 }
 
-void MPU9250_Sensor::readRegs(uint8_t addr, uint8_t reg, uint8_t count, uint8_t* data) {
-    wire->beginTransmission(addr);
-    wire->write(reg);
-    wire->endTransmission(false);
-    wire->requestFrom((int)addr, (int)count);
-    for (uint8_t i = 0; i < count && wire->available(); i++) {
-        data[i] = wire->read();
-    }
+bool MPU9250_Sensor::readRegs(uint8_t addr, uint8_t reg, uint8_t count, uint8_t* data) {
+    return bus->readRegs(addr, reg, data, count) == I2C_OK;
 }
 
 // MPU Detection & Init
@@ -107,10 +107,27 @@ void MPU9250_Sensor::initMPU() {
     writeReg(mpuAddr, REG_ACCEL_CONFIG2, 0x03); // DLPF 44Hz
 }
 
-void MPU9250_Sensor::readAccelGyro() {
-    uint8_t data[14];
-    readRegs(mpuAddr, REG_ACCEL_XOUT_H, 14, data);
+bool MPU9250_Sensor::readAccelGyro() {
+    uint8_t data[MOTION_BYTES];
+    // Keep the previous reading if the bus dropped this one.
+    if (!readRegs(mpuAddr, REG_ACCEL_XOUT_H, MOTION_BYTES, data)) return false;
+    parseAccelGyro(data);
+    return true;
+}
+
+// One 22-byte transaction returns accel, temp, gyro and the magnetometer
+// block the MPU's I2C master sampled on its own. magFresh is set only when
+// that block holds a new, non-overflowed AK8963 sample.
+bool MPU9250_Sensor::readMotionAndMag(bool& magFresh) {
+    uint8_t data[MOTION_BYTES + AK_BLOCK_BYTES];
+    magFresh = false;
+    if (!readRegs(mpuAddr, REG_ACCEL_XOUT_H, sizeof(data), data)) return false;
+    parseAccelGyro(data);
+    magFresh = parseAK8963Block(data + MOTION_BYTES);
+    return true;
+}
 
+void MPU9250_Sensor::parseAccelGyro(const uint8_t* data) {
     int16_t axRaw = (int16_t)(data[0]  << 8 | data[1]);
     int16_t ayRaw = (int16_t)(data[2]  << 8 | data[3]);
     int16_t azRaw = (int16_t)(data[4]  << 8 | data[5]);
@@ -132,6 +149,24 @@ void MPU9250_Sensor::readAccelGyro() {
     temp = tempRaw * TEMP_SCALE + TEMP_OFFSET;
 }
 
+// data: ST1, HXL, HXH, HYL, HYH, HZL, HZH, ST2
+bool MPU9250_Sensor::parseAK8963Block(const uint8_t* data) {
+    if (!(data[0] & 0x01) || (data[7] & 0x08)) return false;  // not ready / overflow
+
+    int16_t mxRaw = (int16_t)(data[2] << 8 | data[1]);
+    int16_t myRaw = (int16_t)(data[4] << 8 | data[3]);
+    int16_t mzRaw = (int16_t)(data[6] << 8 | data[5]);
+
+    // AK8963 axes are sensor X=Y_mpu, Y=X_mpu, Z=-Z_mpu; combined with the
+    // PCB X/Y swap applied to accel/gyro this leaves X and Y and flips Z.
+    // The hard-iron offset is zero until runCalibrationRoutine() measures it.
+    mx = mxRaw * AK_SCALE * akAdj[0] - magOffset[0];
+    my = myRaw * AK_SCALE * akAdj[1] - magOffset[1];
+    mz = -mzRaw * AK_SCALE * akAdj[2] - magOffset[2];
+    magOK = true;
+    return true;
+}
+
 // AK8963 Bypass Mode
 bool MPU9250_Sensor::initAK8963Bypass() {
     writeReg(mpuAddr, REG_USER_CTRL, 0x00);
@@ -147,7 +182,7 @@ bool MPU9250_Sensor::initAK8963Bypass() {
     delay(100);
 
     uint8_t asa[3];
-    readRegs(AK8963_ADDR, AK_ASAX, 3, asa);
+    if (!readRegs(AK8963_ADDR, AK_ASAX, 3, asa)) return false;
     for (int i = 0; i < 3; i++) {
         akAdj[i] = ((float)asa[i] - 128.0f) / 256.0f + 1.0f;
     }
@@ -161,29 +196,19 @@ bool MPU9250_Sensor::initAK8963Bypass() {
 }
 
 bool MPU9250_Sensor::readAK8963Bypass() {
-    if (!(readReg(AK8963_ADDR, AK_ST1) & 0x01)) return false;
-
-    uint8_t data[7];
-    readRegs(AK8963_ADDR, AK_HXL, 7, data);
-    if (data[6] & 0x08) return false;  // Overflow
-
-    int16_t mxRaw = (int16_t)(data[1] << 8 | data[0]);
-    int16_t myRaw = (int16_t)(data[3] << 8 | data[2]);
-    int16_t mzRaw = (int16_t)(data[5] << 8 | data[4]);
-
-    mx = mxRaw * AK_SCALE * akAdj[0];
-    my = myRaw * AK_SCALE * akAdj[1];
-    mz = mzRaw * AK_SCALE * akAdj[2];
-
-    return true;
+    uint8_t data[AK_BLOCK_BYTES];
+    if (!readRegs(AK8963_ADDR, AK_ST1, AK_BLOCK_BYTES, data)) return false;
+    return parseAK8963Block(data);
 }
 
 // AK8963 Master Mode
 bool MPU9250_Sensor::masterWrite(uint8_t reg, uint8_t val) {
-    writeReg(mpuAddr, REG_I2C_SLV4_ADDR, AK8963_ADDR);
-    writeReg(mpuAddr, REG_I2C_SLV4_REG, reg);
-    writeReg(mpuAddr, REG_I2C_SLV4_DO, val);
-    writeReg(mpuAddr, REG_I2C_SLV4_CTRL, 0x80);
+    if (!writeReg(mpuAddr, REG_I2C_SLV4_ADDR, AK8963_ADDR) ||
+        !writeReg(mpuAddr, REG_I2C_SLV4_REG, reg) ||
+        !writeReg(mpuAddr, REG_I2C_SLV4_DO, val) ||
+        !writeReg(mpuAddr, REG_I2C_SLV4_CTRL, 0x80)) {
+        return false;
+    }
 
     for (int i = 0; i < 50; i++) {
         if (readReg(mpuAddr, REG_I2C_MST_STATUS) & 0x40) return true;
@@ -225,7 +250,7 @@ bool MPU9250_Sensor::initAK8963Master() {
     delay(10);
 
     uint8_t asa[3];
-    readRegs(mpuAddr, REG_EXT_SENS_DATA_00, 3, asa);
+    if (!readRegs(mpuAddr, REG_EXT_SENS_DATA_00, 3, asa)) return false;
     for (int i = 0; i < 3; i++) {
         akAdj[i] = ((float)asa[i] - 128.0f) / 256.0f + 1.0f;
     }
@@ -235,26 +260,20 @@ bool MPU9250_Sensor::initAK8963Master() {
     if (!masterWrite(AK_CNTL1, 0x16)) return false;
     delay(100);
 
-    masterReadSetup(AK_ST1, 8);
+    // SLV0 copies ST1..ST2 into EXT_SENS_DATA every other sample (100 Hz,
+    // the AK8963 rate), so the accel/gyro burst can pick it up for free.
+    masterReadSetup(AK_ST1, AK_BLOCK_BYTES);
+    writeReg(mpuAddr, REG_I2C_SLV4_CTRL, 0x01);       // I2C_MST_DLY = 1
+    writeReg(mpuAddr, REG_I2C_MST_DELAY_CTRL, 0x01);  // apply it to SLV0
     delay(10);
 
     return true;
 }
 
 bool MPU9250_Sensor::readAK8963Master() {
-    uint8_t data[8];
-    readRegs(mpuAddr, REG_EXT_SENS_DATA_00, 8, data);
-    if (!(data[0] & 0x01) || (data[7] & 0x08)) return false;
-
-    int16_t mxRaw = (int16_t)(data[2] << 8 | data[1]);
-    int16_t myRaw = (int16_t)(data[4] << 8 | data[3]);
-    int16_t mzRaw = (int16_t)(data[6] << 8 | data[5]);
-
-    mx = mxRaw * AK_SCALE * akAdj[0];
-    my = myRaw * AK_SCALE * akAdj[1];
-    mz = mzRaw * AK_SCALE * akAdj[2];
-
-    return true;
+    uint8_t data[AK_BLOCK_BYTES];
+    if (!readRegs(mpuAddr, REG_EXT_SENS_DATA_00, AK_BLOCK_BYTES, data)) return false;
+    return parseAK8963Block(data);
 }
 
 // QMC5883L
@@ -264,15 +283,14 @@ bool MPU9250_Sensor::initQMC5883L() {
     writeReg(QMC_ADDR, QMC_CTRL1, 0x1D);  // 200Hz, 8x oversample, continuous
     delay(10);
 
-    wire->beginTransmission(QMC_ADDR);
-    return (wire->endTransmission() == 0);
+    return bus->probe(QMC_ADDR) == I2C_OK;
 }
 
 bool MPU9250_Sensor::readQMC5883L() {
     if (!(readReg(QMC_ADDR, QMC_STATUS) & 0x01)) return false;
 
     uint8_t data[6];
-    readRegs(QMC_ADDR, QMC_X_L, 6, data);
+    if (!readRegs(QMC_ADDR, QMC_X_L, 6, data)) return false;
 
     int16_t mxRaw = (int16_t)(data[1] << 8 | data[0]);
     int16_t myRaw = (int16_t)(data[3] << 8 | data[2]);
@@ -450,9 +468,21 @@ bool MPU9250_Sensor::begin() {
     Serial.printf("MPU6050/MPU9250 found at 0x%02X\n", mpuAddr);
     initMPU();
 
-    // 6-DOF mode only (no magnetometer)
+#if MPU_ENABLE_MAG
+    // The AK8963 sits behind the MPU's auxiliary I2C master, which samples it
+    // autonomously; falls back to 6-DOF on an MPU6050 or a missing AK8963.
+    if (initAK8963Master()) {
+        magMode = MAG_AK_MASTER;
+        Serial.println("9-axis IMU mode (AK8963 via MPU I2C master)");
+    } else {
+        writeReg(mpuAddr, REG_USER_CTRL, 0x00);  // I2C master off
+        magMode = MAG_NONE;
+        Serial.println("AK8963 not found, 6-axis IMU mode (accel + gyro only)");
+    }
+#else
     magMode = MAG_NONE;
     Serial.println("6-axis IMU mode (accel + gyro only)");
+#endif
     Serial.println("PCB coordinate mapping: X->Yaw, Y->Pitch");
     Serial.println("IMU ready!\n");
     initialized = true;
@@ -467,15 +497,23 @@ bool MPU9250_Sensor::isReady() {
 void MPU9250_Sensor::update() {
     if (!initialized) return;
 
+    // Read accel/gyro (+ mag in the same burst); on a dropped read the next
+    // dt spans both periods
+    bool magFresh = false;
+    const bool ok = (magMode == MAG_AK_MASTER) ? readMotionAndMag(magFresh) : readAccelGyro();
+    if (!ok) return;
+
     unsigned long now = millis();
     float dt = (now - lastUpdate) / 1000.0f;
     lastUpdate = now;
 
-    // Read accel/gyro
-    readAccelGyro();
-
-    // Update Madgwick filter (6-DOF only, no magnetometer)
-    madgwickUpdateIMU(ax, ay, az, gx, gy, gz, dt);
+    // 9-DOF only on a new, hard-iron corrected magnetometer sample;
+    // otherwise gyro + accel.
+    if (magFresh && magCalibrated) {
+        madgwickUpdate(ax, ay, az, gx, gy, gz, mx, my, mz, dt);
+    } else {
+        madgwickUpdateIMU(ax, ay, az, gx, gy, gz, dt);
+    }
 }
 
 // Sensor Data Accessors
@@ -498,11 +536,13 @@ float MPU9250_Sensor::getFusedQuatZ() { return q3; }
 
 void MPU9250_Sensor::resetCalibration() {
     calibrationReady = false;
+    magCalibrated = false;
     for (int i = 0; i < 3; ++i) {
         accelMin[i] = -9.81f;
         accelMax[i] = 9.81f;
         gyroMin[i] = -2.0f;
         gyroMax[i] = 2.0f;
+        magOffset[i] = 0.0f;
     }
 }
 
@@ -568,6 +608,8 @@ bool MPU9250_Sensor::runCalibrationRoutine(uint32_t durationMs) {
     float accMax[3] = {-FLT_MAX, -FLT_MAX, -FLT_MAX};
     float gyroMinVals[3] = {FLT_MAX, FLT_MAX, FLT_MAX};
     float gyroMaxVals[3] = {-FLT_MAX, -FLT_MAX, -FLT_MAX};
+    float magMin[3] = {FLT_MAX, FLT_MAX, FLT_MAX};
+    float magMax[3] = {-FLT_MAX, -FLT_MAX, -FLT_MAX};
 
     const unsigned long start = millis();
     unsigned long samples = 0;
@@ -576,12 +618,18 @@ bool MPU9250_Sensor::runCalibrationRoutine(uint32_t durationMs) {
 
         float accVals[3] = {ax, ay, az};
         float gyroVals[3] = {gx, gy, gz};
+        // Uncorrected field, so a repeated calibration starts from scratch
+        float magVals[3] = {mx + magOffset[0], my + magOffset[1], mz + magOffset[2]};
 
         for (int i = 0; i < 3; ++i) {
             if (accVals[i] < accMin[i]) accMin[i] = accVals[i];
             if (accVals[i] > accMax[i]) accMax[i] = accVals[i];
             if (gyroVals[i] < gyroMinVals[i]) gyroMinVals[i] = gyroVals[i];
             if (gyroVals[i] > gyroMaxVals[i]) gyroMaxVals[i] = gyroVals[i];
+            if (magOK) {
+                if (magVals[i] < magMin[i]) magMin[i] = magVals[i];
+                if (magVals[i] > magMax[i]) magMax[i] = magVals[i];
+            }
         }
 
         samples++;
@@ -611,6 +659,17 @@ bool MPU9250_Sensor::runCalibrationRoutine(uint32_t durationMs) {
         gyroMax[i] = gyroMaxVals[i];
     }
 
+    // Hard-iron offset: the centre of the field sphere the rotation traced.
+    // Without enough rotation keep fusing accel + gyro only.
+    bool magSwept = magMode == MAG_AK_MASTER;
+    for (int i = 0; i < 3; ++i) {
+        magSwept = magSwept && magMax[i] - magMin[i] >= MAG_MIN_CAL_SPAN;
+    }
+    magCalibrated = magSwept;
+    for (int i = 0; i < 3; ++i) {
+        magOffset[i] = magSwept ? (magMin[i] + magMax[i]) * 0.5f : 0.0f;
+    }
+
     calibrationReady = true;
     printCalibrationInfo();
     Serial.println("IMU normalization now maps calibrated ranges to 0-1.\n");
@@ -633,5 +692,11 @@ void MPU9250_Sensor::printCalibrationInfo() const {
     for (int i = 0; i < 3; ++i) {
         Serial.printf("  %s: %.2f to %.2f\n", axis[i], gyroMin[i], gyroMax[i]);
     }
+    if (magCalibrated) {
+        Serial.printf("Magnetometer hard-iron offset (uT): %.1f, %.1f, %.1f\n",
+                      magOffset[0], magOffset[1], magOffset[2]);
+    } else if (magMode == MAG_AK_MASTER) {
+        Serial.println("Magnetometer not calibrated (rotate further); fusing accel + gyro only");
+    }
     Serial.println();
 }
@@ -2,11 +2,18 @@
 #define MPU9250_SENSOR_H
 
 #include <Arduino.h>
-#include <Wire.h>
+#include "i2c_bus.h"
+
+// Read the AK8963 through the MPU's I2C master and run 9-DOF fusion. Fusion
+// uses it only once runCalibrationRoutine() has measured its hard-iron
+// offsets; until then orientation comes from accel + gyro alone.
+#ifndef MPU_ENABLE_MAG
+#define MPU_ENABLE_MAG 1
+#endif
 
 class MPU9250_Sensor {
 public:
-    MPU9250_Sensor(TwoWire &bus = Wire, uint8_t addr = 0x68);
+    MPU9250_Sensor(I2CBus &bus = i2cBus, uint8_t addr = 0x68);
 
     bool begin();
     bool isReady();
@@ -15,6 +22,7 @@ public:
     bool runCalibrationRoutine(uint32_t durationMs = 6000);
     void printCalibrationInfo() const;
     bool isCalibrated() const { return calibrationReady; }
+    bool isMagCalibrated() const { return magCalibrated; }
     void getNormalizedReadings(float* accelOut, float* gyroOut) const;
 
     // Raw sensor data
@@ -39,8 +47,8 @@ private:
     // Magnetometer mode
     enum MagMode { MAG_NONE, MAG_AK_BYPASS, MAG_AK_MASTER, MAG_QMC };
 
-    // I2C
-    TwoWire* wire;
+    // I2C (shared, serialized by I2CBus)
+    I2CBus* bus;
     uint8_t mpuAddr;
 
     // State
@@ -63,14 +71,17 @@ private:
     float akAdj[3];
 
     // I2C helpers
-    void writeReg(uint8_t addr, uint8_t reg, uint8_t val);
+    bool writeReg(uint8_t addr, uint8_t reg, uint8_t val);
     uint8_t readReg(uint8_t addr, uint8_t reg);
-    void readRegs(uint8_t addr, uint8_t reg, uint8_t count, uint8_t* data);
+    bool readRegs(uint8_t addr, uint8_t reg, uint8_t count, uint8_t* data);
 
     // MPU functions
     bool detectMPU();
     void initMPU();
-    void readAccelGyro();
+    bool readAccelGyro();
+    bool readMotionAndMag(bool& magFresh);
+    void parseAccelGyro(const uint8_t* data);
+    bool parseAK8963Block(const uint8_t* data);
 
     // AK8963 bypass mode
     bool initAK8963Bypass();
@@ -102,7 +113,9 @@ private:
     float accelMax[3];
     float gyroMin[3];
     float gyroMax[3];
+    float magOffset[3];  // hard-iron offset (uT), subtracted before fusion
     bool calibrationReady;
+    bool magCalibrated;
 };
 
 #endif // MPU9250_SENSOR_H
@@ -0,0 +1,326 @@
+#include "audio_cache.h"
+
+#include <LittleFS.h>
+#include "SD.h"
+
+AudioCache audioCache;
+
+namespace {
+
+const uint32_t kIndexMagic = 0x31494341;  // "ACI1"
+
+}  // namespace
+
+AudioCache::AudioCache()
+    : entryCount(0), mutex(nullptr), initialized(false), dirty(false), playsSinceSave(0),
+      flashHits(0), sdHits(0), misses(0), promotions(0), demotions(0) {
+    memset(entries, 0, sizeof(entries));
+}
+
+bool AudioCache::begin() {
+    if (!mutex) {
+        mutex = mutexStorage.create();
+        if (!mutex) return false;
+    }
+    if (!LittleFS.begin(true)) {
+        Serial.println("[Cache] LittleFS mount failed, flash tier disabled");
+        return false;
+    }
+    if (!lock()) return false;
+    load();
+    initialized = true;
+    unlock();
+
+    Serial.printf("[Cache] %u clips indexed, LittleFS %u/%u KB used\n",
+                  (unsigned)entryCount, (unsigned)(LittleFS.usedBytes() / 1024),
+                  (unsigned)(LittleFS.totalBytes() / 1024));
+    return true;
+}
+
+bool AudioCache::lock() {
+    return mutex && xSemaphoreTake(mutex, portMAX_DELAY) == pdTRUE;
+}
+
+void AudioCache::unlock() {
+    xSemaphoreGive(mutex);
+}
+
+bool AudioCache::load() {
+    entryCount = 0;
+    File file = LittleFS.open(AUDIO_CACHE_INDEX_PATH, FILE_READ);
+    if (!file) return false;
+
+    uint32_t magic = 0;
+    uint32_t count = 0;
+    bool ok = file.read((uint8_t*)&magic, sizeof(magic)) == sizeof(magic) &&
+              file.read((uint8_t*)&count, sizeof(count)) == sizeof(count) &&
+              magic == kIndexMagic;
+    if (ok) {
+        count = min(count, (uint32_t)AUDIO_CACHE_MAX_ENTRIES);
+        for (uint32_t i = 0; i < count; i++) {
+            AudioCacheEntry& e = entries[entryCount];
+            if (file.read((uint8_t*)&e, sizeof(e)) != sizeof(e)) break;
+            e.name[AUDIO_CACHE_NAME_LEN - 1] = '\0';
+            // A flash copy lost to a reflash or an interrupted write is
+            // simply served from SD again.
+            if ((e.flags & FLAG_FLASH) && !LittleFS.exists(e.name)) {
+                e.flags &= ~FLAG_FLASH;
+                dirty = true;
+            }
+            if (e.flags) entryCount++;
+        }
+    }
+    file.close();
+    return ok;
+}
+
+bool AudioCache::save() {
+    if (!lock()) return false;
+    const bool ok = saveLocked();
+    unlock();
+    return ok;
+}
+
+bool AudioCache::saveLocked() {
+    if (!initialized) return false;
+    File file = LittleFS.open(AUDIO_CACHE_INDEX_PATH, FILE_WRITE);
+    if (!file) return false;
+    const uint32_t count = entryCount;
+    file.write((const uint8_t*)&kIndexMagic, sizeof(kIndexMagic));
+    file.write((const uint8_t*)&count, sizeof(count));
+    file.write((const uint8_t*)entries, entryCount * sizeof(AudioCacheEntry));
+    file.close();
+    dirty = false;
+    playsSinceSave = 0;
+    return true;
+}
+
+AudioCacheEntry* AudioCache::find(const char* filename) {
+    for (size_t i = 0; i < entryCount; i++) {
+        if (strncmp(entries[i].name, filename, AUDIO_CACHE_NAME_LEN) == 0) return &entries[i];
+    }
+    return nullptr;
+}
+
+// Adds an entry, evicting the least-played SD-only clip from the index when
+// full (its file stays on the card and is re-indexed on its next lookup).
+AudioCacheEntry* AudioCache::add(const char* filename) {
+    if (strlen(filename) >= AUDIO_CACHE_NAME_LEN) return nullptr;
+    if (entryCount >= AUDIO_CACHE_MAX_ENTRIES) {
+        AudioCacheEntry* coldest = nullptr;
+        for (size_t i = 0; i < entryCount; i++) {
+            if (entries[i].flags & FLAG_FLASH) continue;
+            if (!coldest || entries[i].uses < coldest->uses) coldest = &entries[i];
+        }
+        if (!coldest) return nullptr;
+        remove(coldest);
+    }
+    AudioCacheEntry* e = &entries[entryCount++];
+    memset(e, 0, sizeof(*e));
+    strncpy(e->name, filename, AUDIO_CACHE_NAME_LEN - 1);
+    dirty = true;
+    return e;
+}
+
+void AudioCache::remove(AudioCacheEntry* entry) {
+    const size_t index = entry - entries;
+    entries[index] = entries[--entryCount];
+    dirty = true;
+}
+
+AudioTier AudioCache::lookup(const char* filename) {
+    if (!filename) return AUDIO_TIER_NONE;
+    if (!lock()) {
+        // Cache never started: behave like the plain SD store
+        return SD.exists(filename) ? AUDIO_TIER_SD : AUDIO_TIER_NONE;
+    }
+
+    AudioTier tier = AUDIO_TIER_NONE;
+    AudioCacheEntry* e = find(filename);
+    if (!e && SD.exists(filename)) {
+        // Clip predates the index (or was evicted from it)
+        e = add(filename);
+        if (e) {
+            e->flags = FLAG_SD;
+        } else {
+            tier = AUDIO_TIER_SD;
+        }
+    }
+    if (e) {
+        tier = (e->flags & FLAG_FLASH) ? AUDIO_TIER_FLASH : AUDIO_TIER_SD;
+    }
+
+    if (tier == AUDIO_TIER_FLASH) flashHits++;
+    else if (tier == AUDIO_TIER_SD) sdHits++;
+    else misses++;
+
+    unlock();
+    return tier;
+}
+
+fs::FS& AudioCache::fsFor(AudioTier tier) {
+    if (tier == AUDIO_TIER_FLASH) return LittleFS;
+    return SD;
+}
+
+void AudioCache::recordDownload(const char* filename) {
+    if (!filename || !lock()) return;
+    AudioCacheEntry* e = find(filename);
+    if (!e) e = add(filename);
+    if (e) {
+        if (e->flags & FLAG_FLASH) demote(*e);  // fresh download replaces the hot copy
+        e->flags = FLAG_SD;
+        e->uses = 0;
+        e->bytes = 0;
+        dirty = true;
+    }
+    unlock();
+}
+
+void AudioCache::recordPlay(const char* filename) {
+    if (!filename || !lock()) return;
+    AudioCacheEntry* e = find(filename);
+    if (e) {
+        e->uses++;
+        dirty = true;
+        if (initialized) maybePromote(*e);
+    }
+    if (initialized && dirty && ++playsSinceSave >= AUDIO_CACHE_SAVE_EVERY) {
+        saveLocked();
+    }
+    unlock();
+}
+
+void AudioCache::invalidate(const char* filename) {
+    if (!filename || !lock()) return;
+    AudioCacheEntry* e = find(filename);
+    if (e) {
+        if (e->flags & FLAG_FLASH) demote(*e);
+        remove(e);
+        if (initialized) saveLocked();
+    }
+    unlock();
+}
+
+void AudioCache::maybePromote(AudioCacheEntry& entry) {
+    if ((entry.flags & FLAG_FLASH) || !(entry.flags & FLAG_SD)) return;
+    if (entry.uses < AUDIO_CACHE_PROMOTE_MIN_USES) return;
+
+    size_t hot = 0;
+    AudioCacheEntry* coldestHot = nullptr;
+    for (size_t i = 0; i < entryCount; i++) {
+        if (!(entries[i].flags & FLAG_FLASH)) continue;
+        hot++;
+        if (!coldestHot || entries[i].uses < coldestHot->uses) coldestHot = &entries[i];
+    }
+
+    if (hot >= AUDIO_CACHE_HOT_SLOTS) {
+        if (!coldestHot || coldestHot->uses >= entry.uses) return;
+        demote(*coldestHot);
+    }
+    if (promote(entry)) {
+        saveLocked();
+    }
+}
+
+bool AudioCache::promote(AudioCacheEntry& entry) {
+    if (entry.bytes == 0) {
+        File src = SD.open(entry.name, FILE_READ);
+        if (!src) return false;
+        entry.bytes = src.size();
+        src.close();
+    }
+    if (entry.bytes == 0 || entry.bytes > AUDIO_CACHE_MAX_CLIP_BYTES) return false;
+
+    const size_t freeBytes = LittleFS.totalBytes() - LittleFS.usedBytes();
+    if (freeBytes < entry.bytes + AUDIO_CACHE_FLASH_RESERVE) return false;
+
+    const uint32_t start = millis();
+    if (!copyToFlash(entry.name, entry.bytes)) return false;
+
+    entry.flags |= FLAG_FLASH;
+    promotions++;
+    Serial.printf("[Cache] Promoted %s (%u B, %u plays) in %u ms\n", entry.name,
+                  (unsigned)entry.bytes, (unsigned)entry.uses, (unsigned)(millis() - start));
+    return true;
+}
+
+void AudioCache::demote(AudioCacheEntry& entry) {
+    LittleFS.remove(entry.name);
+    entry.flags &= ~FLAG_FLASH;
+    demotions++;
+    dirty = true;
+}
+
+// Copies through a temporary file so a reset mid-copy never leaves a
+// truncated clip under the real name.
+bool AudioCache::copyToFlash(const char* filename, uint32_t bytes) {
+    File src = SD.open(filename, FILE_READ);
+    if (!src) return false;
+
+    char tmpPath[AUDIO_CACHE_NAME_LEN + 4];
+    snprintf(tmpPath, sizeof(tmpPath), "%s.tmp", filename);
+    File dst = LittleFS.open(tmpPath, FILE_WRITE);
+    if (!dst) {
+        src.close();
+        return false;
+    }
+
+    uint8_t buffer[512];
+    uint32_t copied = 0;
+    while (copied < bytes) {
+        const size_t n = src.read(buffer, sizeof(buffer));
+        if (n == 0 || dst.write(buffer, n) != n) break;
+        copied += n;
+    }
+    src.close();
+    dst.close();
+
+    if (copied != bytes || !LittleFS.rename(tmpPath, filename)) {
+        LittleFS.remove(tmpPath);
+        return false;
+    }
+    return true;
+}
+
+void AudioCache::clear() {
+    if (!lock()) return;
+    for (size_t i = 0; i < entryCount; i++) {
+        if (entries[i].flags & FLAG_FLASH) LittleFS.remove(entries[i].name);
+    }
+    entryCount = 0;
+    dirty = true;
+    saveLocked();
+    unlock();
+    Serial.println("[Cache] Flash tier and index cleared");
+}
+
+void AudioCache::printStats() {
+    if (!lock()) return;
+    size_t hot = 0;
+    uint32_t hotBytes = 0;
+    for (size_t i = 0; i < entryCount; i++) {
+        if (entries[i].flags & FLAG_FLASH) {
+            hot++;
+            hotBytes += entries[i].bytes;
+        }
+    }
+
+    Serial.println("\n=== Audio Cache ===");
+    Serial.printf("Indexed: %u clips, %u in flash (%u KB)\n", (unsigned)entryCount,
+                  (unsigned)hot, (unsigned)(hotBytes / 1024));
+    if (initialized) {
+        Serial.printf("LittleFS: %u/%u KB used\n", (unsigned)(LittleFS.usedBytes() / 1024),
+                      (unsigned)(LittleFS.totalBytes() / 1024));
+    }
+    Serial.printf("Lookups: %u flash, %u SD, %u miss | %u promoted, %u demoted\n",
+                  (unsigned)flashHits, (unsigned)sdHits, (unsigned)misses,
+                  (unsigned)promotions, (unsigned)demotions);
+    for (size_t i = 0; i < entryCount; i++) {
+        const AudioCacheEntry& e = entries[i];
+        Serial.printf("  %-24s %5u plays  %s\n", e.name, (unsigned)e.uses,
+                      (e.flags & FLAG_FLASH) ? "flash" : "sd");
+    }
+    Serial.println();
+    unlock();
+}
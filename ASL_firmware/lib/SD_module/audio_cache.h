@@ -0,0 +1,96 @@
+#ifndef AUDIO_CACHE_H
+#define AUDIO_CACHE_H
+
+#include <Arduino.h>
+#include "FS.h"
+#include <freertos/FreeRTOS.h>
+#include <freertos/semphr.h>
+
+#include "static_alloc.h"
+
+// Configuration
+#define AUDIO_CACHE_MAX_ENTRIES 64
+#define AUDIO_CACHE_NAME_LEN 32
+#define AUDIO_CACHE_HOT_SLOTS 16            // clips kept in internal flash
+#define AUDIO_CACHE_PROMOTE_MIN_USES 3      // plays before a clip is worth copying
+#define AUDIO_CACHE_MAX_CLIP_BYTES 65536    // short words only
+#define AUDIO_CACHE_FLASH_RESERVE 32768     // headroom left free on LittleFS
+#define AUDIO_CACHE_SAVE_EVERY 8            // plays between index writes (flash wear)
+#define AUDIO_CACHE_INDEX_PATH "/audio_index.bin"
+
+enum AudioTier {
+    AUDIO_TIER_NONE = 0,
+    AUDIO_TIER_SD,       // cold: SPI SD card
+    AUDIO_TIER_FLASH     // hot: LittleFS in internal flash
+};
+
+struct AudioCacheEntry {
+    char name[AUDIO_CACHE_NAME_LEN];
+    uint32_t uses;
+    uint32_t bytes;
+    uint8_t flags;
+};
+
+// Two-tier store for spoken clips. Every clip lives on the SD card; the
+// AUDIO_CACHE_HOT_SLOTS most-played ones also get a copy in LittleFS so that
+// short words start without touching the card. One index, persisted to
+// LittleFS with its usage counters, answers every lookup, so the SD card is
+// only opened for cold clips, downloads and promotions.
+class AudioCache {
+public:
+    AudioCache();
+
+    bool begin();
+    bool isReady() const { return initialized; }
+
+    // Where to play a clip from; AUDIO_TIER_NONE means it must be downloaded.
+    AudioTier lookup(const char* filename);
+    fs::FS& fsFor(AudioTier tier);
+
+    // A new clip was written to the SD card.
+    void recordDownload(const char* filename);
+    // Counts a play and promotes the clip if it ranks among the hottest. Runs
+    // after playback so the copy never delays a word.
+    void recordPlay(const char* filename);
+    // A clip the index listed could not be opened; forget it.
+    void invalidate(const char* filename);
+
+    // Drops every flash copy and the index (after the SD cache was cleared).
+    void clear();
+    bool save();
+    void printStats();
+
+private:
+    static const uint8_t FLAG_SD = 0x01;
+    static const uint8_t FLAG_FLASH = 0x02;
+
+    AudioCacheEntry entries[AUDIO_CACHE_MAX_ENTRIES];
+    size_t entryCount;
+    StaticMutex mutexStorage;
+    SemaphoreHandle_t mutex;
+    bool initialized;
+    bool dirty;
+    uint32_t playsSinceSave;
+
+    uint32_t flashHits;
+    uint32_t sdHits;
+    uint32_t misses;
+    uint32_t promotions;
+    uint32_t demotions;
+
+    bool lock();
+    void unlock();
+    bool load();
+    bool saveLocked();
+    AudioCacheEntry* find(const char* filename);
+    AudioCacheEntry* add(const char* filename);
+    void remove(AudioCacheEntry* entry);
+    void maybePromote(AudioCacheEntry& entry);
+    bool promote(AudioCacheEntry& entry);
+    void demote(AudioCacheEntry& entry);
+    bool copyToFlash(const char* filename, uint32_t bytes);
+};
+
+extern AudioCache audioCache;
+
+#endif // AUDIO_CACHE_H
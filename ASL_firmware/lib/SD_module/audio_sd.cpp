@@ -1,38 +1,13 @@
 #include "audio_sd.h"
 
 SD_module::SD_module(uint8_t chipSelectPin) : csPin(chipSelectPin), initialized(false),
-                    rgb(NUM_PIXELS, RGB_LED_PIN, NEO_GRB + NEO_KHZ800) {
-}
-
-void SD_module::setLED(uint8_t r, uint8_t g, uint8_t b) { 
-  rgb.setPixelColor(0, rgb.Color(r, g, b));
-  rgb.show(); 
-}
-
-void SD_module::ledOff() {
-  setLED(0, 0, 0);
-}
-
-void SD_module::ledRed() {
-  setLED(255, 0, 0);
-}
-
-void SD_module::ledBlink(uint8_t r, uint8_t g, uint8_t b, int times, int delayMs) {
-  for (int i = 0; i < times; i++) {
-    setLED(r, g, b);
-    delay(delayMs);
-    ledOff();
-    delay(delayMs);
-  }
+                    led(RGB_LED_PIN, NUM_PIXELS) {
 }
 
 bool SD_module::begin() {
   // Initialize NeoPixel HERE, not in constructor
-  rgb.begin();
-  rgb.setBrightness(50);
-  ledOff();
-  
-  ledBlink(0, 0, 255, 2, 150);
+  led.begin(50);
+  led.blink(0, 0, 255, 2, 150);
   
   // Initialize SPI with your custom pins
   SPI.begin(13, 12, 10, 9);  // SCK, MISO, MOSI, CS
@@ -40,14 +15,14 @@ bool SD_module::begin() {
   
   if (!SD.begin(csPin, SPI)) {
     Serial.println("SD Card Mount Failed!");
-    ledBlink(255, 0, 0, 2, 100);
+    led.blink(255, 0, 0, 2, 100, LED_PRIORITY_ERROR);
     return false;
   }
   
   uint8_t cardType = SD.cardType();
   if (cardType == CARD_NONE) {
     Serial.println("No SD card attached");
-    ledBlink(255, 0, 0, 3, 200);
+    led.blink(255, 0, 0, 3, 200, LED_PRIORITY_ERROR);
     return false;
   }
   
@@ -60,15 +35,12 @@ bool SD_module::begin() {
   File root = SD.open("/");
   if (!root) {
     Serial.println("Failed to open root directory");
-    ledBlink(255, 0, 0, 3, 200);
+    led.blink(255, 0, 0, 3, 200, LED_PRIORITY_ERROR);
     return false;
   }
   root.close();
   
-  ledBlink(0, 255, 0, 3, 150);
-  setLED(0, 255, 0);
-  delay(1000);
-  ledOff();
+  led.blink(0, 255, 0, 3, 150, LED_PRIORITY_SUCCESS);
   
   initialized = true;
   return true;
@@ -80,11 +52,11 @@ bool SD_module::isReady() {
 
 bool SD_module::saveAudioChunk(const char* filename, const uint8_t* audioData, size_t dataSize, bool append) {
   if (!initialized) {
-    ledBlink(255, 0, 0, 1, 150);
+    led.blink(255, 0, 0, 1, 150, LED_PRIORITY_ERROR);
     return false;
   }
   
-  setLED(0, 0, 100);
+  led.setColor(0, 0, 100);
 
   const char* openMode;
   if (append) {
@@ -96,7 +68,8 @@ bool SD_module::saveAudioChunk(const char* filename, const uint8_t* audioData, s
 
   File file = SD.open(filename, openMode);
   if (!file) {
-    ledBlink(255, 0, 0, 2, 150);
+    led.off();
+    led.blink(255, 0, 0, 2, 150, LED_PRIORITY_ERROR);
     return false;
   }
   
@@ -104,11 +77,12 @@ bool SD_module::saveAudioChunk(const char* filename, const uint8_t* audioData, s
   file.close();
   
   if (written == dataSize) {
-    ledBlink(0, 255, 0, 1, 100);
-    ledOff();
+    led.off();
+    led.blink(0, 255, 0, 1, 100, LED_PRIORITY_SUCCESS);
     return true;
   } else {
-    ledBlink(255, 0, 0, 4, 200);
+    led.off();
+    led.blink(255, 0, 0, 4, 200, LED_PRIORITY_ERROR);
     return false;
   }
 }
@@ -138,37 +112,33 @@ size_t SD_module::getFileSize(const char* filename) {
 
 bool SD_module::streamAudioFile(const char* filename, void (*callback)(uint8_t*, size_t), size_t chunkSize) {
   if (!initialized) {
-    ledBlink(255, 0, 0, 1, 150);
+    led.blink(255, 0, 0, 1, 150, LED_PRIORITY_ERROR);
     return false;
   }
   
   File file = SD.open(filename, FILE_READ);
   if (!file) {
-    ledBlink(255, 0, 0, 2, 150);
+    led.blink(255, 0, 0, 2, 150, LED_PRIORITY_ERROR);
     return false;
   }
   
-  setLED(128, 0, 128);
+  led.setColor(128, 0, 128);
   
-  uint8_t* buffer = new uint8_t[chunkSize];
-  if (!buffer) {
-    file.close();
-    ledBlink(255, 0, 0, 5, 250);
-    return false;
+  if (chunkSize == 0 || chunkSize > SD_STREAM_CHUNK_MAX) {
+    chunkSize = SD_STREAM_CHUNK_MAX;
   }
 
   while (file.available()) {
-    size_t bytesRead = file.read(buffer, chunkSize);
+    size_t bytesRead = file.read(streamBuffer, chunkSize);
     if (bytesRead > 0) {
-      callback(buffer, bytesRead);
+      callback(streamBuffer, bytesRead);
     }
   }
   
-  delete[] buffer;
   file.close();
   
-  ledBlink(0, 255, 0, 1, 100);
-  ledOff();
+  led.off();
+  led.blink(0, 255, 0, 1, 100, LED_PRIORITY_SUCCESS);
   
   return true;
 }
@@ -186,7 +156,7 @@ bool SD_module::fileExists(const char* filename) {
 void SD_module::printStorageInfo() {
   if (!initialized) {
     Serial.println("SD Card not initialized");
-    ledBlink(255, 0, 0, 1, 150);
+    led.blink(255, 0, 0, 1, 150, LED_PRIORITY_ERROR);
     return;
   }
   
@@ -200,7 +170,7 @@ void SD_module::printStorageInfo() {
   Serial.printf("  Used Space: %llu MB\n", usedBytes);
   Serial.printf("  Free Space: %llu MB\n", totalBytes - usedBytes);
   
-  ledBlink(0, 255, 255, 2, 100);
+  led.blink(0, 255, 255, 2, 100, LED_PRIORITY_INFO);
 }
 
 bool SD_module::createAudioDir(const char* dirname) {
@@ -209,31 +179,32 @@ bool SD_module::createAudioDir(const char* dirname) {
 }
 
 void SD_module::setStatusLED(uint8_t r, uint8_t g, uint8_t b) {
-  setLED(r, g, b);
+  led.setColor(r, g, b);
 }
 
 void SD_module::clearStatusLED() {
-  ledOff();
+  led.off();
 }
 
 void SD_module::blinkStatusLED(uint8_t r, uint8_t g, uint8_t b, int times, int delayMs) {
-  ledBlink(r, g, b, times, delayMs);
+  led.blink(r, g, b, times, delayMs);
 }
 
 bool SD_module::clearTTSCache() {
   if (!initialized) {
     Serial.println("[SD] SD card not initialized");
-    ledBlink(255, 0, 0, 1, 150);
+    led.blink(255, 0, 0, 1, 150, LED_PRIORITY_ERROR);
     return false;
   }
 
   Serial.println("[SD] Clearing TTS cache...");
-  setLED(255, 128, 0);
+  led.setColor(255, 128, 0);
 
   File root = SD.open("/");
   if (!root) {
     Serial.println("[SD] Failed to open root directory");
-    ledBlink(255, 0, 0, 3, 200);
+    led.off();
+    led.blink(255, 0, 0, 3, 200, LED_PRIORITY_ERROR);
     return false;
   }
 
@@ -264,14 +235,14 @@ bool SD_module::clearTTSCache() {
   Serial.printf("[SD] TTS cache cleared: %d files deleted, %d failed\n", deletedCount, failedCount);
 
   if (failedCount > 0) {
-    ledBlink(255, 128, 0, 2, 150);
+    led.blink(255, 128, 0, 2, 150, LED_PRIORITY_WARNING);
   } else if (deletedCount > 0) {
-    ledBlink(0, 255, 0, 3, 150);
+    led.blink(0, 255, 0, 3, 150, LED_PRIORITY_SUCCESS);
   } else {
     Serial.println("[SD] No .mp3 files found in cache");
-    ledBlink(0, 255, 255, 2, 100);
+    led.blink(0, 255, 255, 2, 100, LED_PRIORITY_INFO);
   }
 
-  ledOff();
+  led.off();
   return (failedCount == 0);
 }
\ No newline at end of file
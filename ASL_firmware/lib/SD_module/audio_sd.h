@@ -4,22 +4,18 @@
 #include "FS.h"
 #include "SD.h"
 #include "SPI.h"
-#include "Adafruit_NeoPixel.h"
+#include "status_led.h"
 
 #define RGB_LED_PIN 48 //Onboard RGB LED Pin
 #define NUM_PIXELS 1 //one LED
+#define SD_STREAM_CHUNK_MAX 1024 //largest chunk streamAudioFile hands out
 
 class SD_module{
     private:
         bool initialized;
         uint8_t csPin;
-        Adafruit_NeoPixel rgb;
-
-        // LED color definitions
-        void setLED(uint8_t r, uint8_t g, uint8_t b);
-        void ledOff();
-        void ledRed();
-        void ledBlink(uint8_t r, uint8_t g, uint8_t b, int times = 3, int delayMs = 50);
+        StatusLed led;
+        uint8_t streamBuffer[SD_STREAM_CHUNK_MAX];
 
     
     public:
@@ -41,7 +37,8 @@ class SD_module{
         // Get audio file size
         size_t getFileSize(const char* filename);
         
-        // Stream audio file in chunks (for playback)
+        // Stream audio file in chunks (for playback); chunkSize is capped at
+        // SD_STREAM_CHUNK_MAX. Not reentrant: the chunk buffer is shared.
         bool streamAudioFile(const char* filename, void (*callback)(uint8_t*, size_t), size_t chunkSize = 512);
         
         // Delete audio file
@@ -56,10 +53,13 @@ class SD_module{
         // Create directory for audio files
         bool createAudioDir(const char* dirname);
         
-        // Public LED control methods
+        // Public LED control methods. All of them return immediately; the
+        // pattern is played by the StatusLed task.
         void setStatusLED(uint8_t r, uint8_t g, uint8_t b);
         void clearStatusLED();
         void blinkStatusLED(uint8_t r, uint8_t g, uint8_t b, int times = 3, int delayMs = 50);
+        void flashStatusLED(uint8_t r, uint8_t g, uint8_t b, int durationMs);
+        StatusLed& statusLed() { return led; }
 
         // Clear TTS cache (delete all .mp3 files)
         bool clearTTSCache();
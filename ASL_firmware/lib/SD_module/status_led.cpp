@@ -0,0 +1,162 @@
+#include "status_led.h"
+
+StatusLed::StatusLed(uint8_t pin, uint16_t numPixels)
+    : pixels(numPixels, pin, NEO_GRB + NEO_KHZ800), queue(nullptr), task(nullptr), dropped(0),
+      base{}, overlay{}, overlayActive(false), overlayStart(0), baseStart(0), lastColor(0) {
+}
+
+bool StatusLed::begin(uint8_t brightness) {
+    if (task) return true;
+
+    pixels.begin();
+    pixels.setBrightness(brightness);
+    pixels.clear();
+    pixels.show();
+
+    queue = queueStorage.create();
+    if (!queue) return false;
+
+    task = taskStorage.start(taskEntry, "StatusLed", this, STATUS_LED_TASK_PRIORITY, STATUS_LED_TASK_CORE);
+    return task != nullptr;
+}
+
+void StatusLed::setColor(uint8_t r, uint8_t g, uint8_t b) {
+    LedCommand cmd{};
+    cmd.mode = LED_MODE_SOLID;
+    cmd.r = r;
+    cmd.g = g;
+    cmd.b = b;
+    post(cmd);
+}
+
+void StatusLed::pulse(uint8_t r, uint8_t g, uint8_t b, uint16_t periodMs) {
+    LedCommand cmd{};
+    cmd.mode = LED_MODE_PULSE;
+    cmd.r = r;
+    cmd.g = g;
+    cmd.b = b;
+    cmd.onMs = periodMs > 0 ? periodMs : 1;
+    post(cmd);
+}
+
+void StatusLed::off() {
+    LedCommand cmd{};
+    cmd.mode = LED_MODE_OFF;
+    post(cmd);
+}
+
+void StatusLed::blink(uint8_t r, uint8_t g, uint8_t b, uint8_t times, uint16_t intervalMs,
+                      LedPriority priority) {
+    if (times == 0) return;
+    LedCommand cmd{};
+    cmd.mode = LED_MODE_BLINK;
+    cmd.overlay = true;
+    cmd.priority = priority;
+    cmd.r = r;
+    cmd.g = g;
+    cmd.b = b;
+    cmd.times = times;
+    cmd.onMs = intervalMs;
+    cmd.offMs = intervalMs;
+    post(cmd);
+}
+
+void StatusLed::flash(uint8_t r, uint8_t g, uint8_t b, uint16_t durationMs, LedPriority priority) {
+    LedCommand cmd{};
+    cmd.mode = LED_MODE_BLINK;
+    cmd.overlay = true;
+    cmd.priority = priority;
+    cmd.r = r;
+    cmd.g = g;
+    cmd.b = b;
+    cmd.times = 1;
+    cmd.onMs = durationMs;
+    cmd.offMs = 0;
+    post(cmd);
+}
+
+// Never blocks: a full queue drops the pattern rather than stall the caller.
+void StatusLed::post(const LedCommand& cmd) {
+    if (!queue || xQueueSend(queue, &cmd, 0) != pdTRUE) {
+        dropped++;
+    }
+}
+
+void StatusLed::show(uint8_t r, uint8_t g, uint8_t b) {
+    const uint32_t color = pixels.Color(r, g, b);
+    if (color == lastColor) return;
+    lastColor = color;
+    pixels.setPixelColor(0, color);
+    pixels.show();
+}
+
+void StatusLed::apply(const LedCommand& cmd, uint32_t now) {
+    if (cmd.overlay) {
+        if (!overlayActive || cmd.priority >= overlay.priority) {
+            overlay = cmd;
+            overlayActive = true;
+            overlayStart = now;
+        }
+    } else {
+        base = cmd;
+        baseStart = now;
+    }
+}
+
+// Draws the current frame and returns how long the task may sleep before the
+// next change is due.
+TickType_t StatusLed::render(uint32_t now) {
+    if (overlayActive) {
+        const uint32_t period = (uint32_t)overlay.onMs + overlay.offMs;
+        const uint32_t elapsed = now - overlayStart;
+        if (period > 0 && elapsed < period * overlay.times) {
+            const uint32_t phase = elapsed % period;
+            if (phase < overlay.onMs) {
+                show(overlay.r, overlay.g, overlay.b);
+                return pdMS_TO_TICKS(overlay.onMs - phase) + 1;
+            }
+            show(0, 0, 0);
+            return pdMS_TO_TICKS(period - phase) + 1;
+        }
+        overlayActive = false;
+    }
+
+    switch (base.mode) {
+        case LED_MODE_SOLID:
+            show(base.r, base.g, base.b);
+            return portMAX_DELAY;
+        case LED_MODE_PULSE: {
+            // Triangle wave, dark -> full -> dark over one period
+            const uint32_t period = base.onMs;
+            const uint32_t phase = (now - baseStart) % period;
+            const uint32_t half = period / 2 > 0 ? period / 2 : 1;
+            // The falling edge covers period - half, one tick longer than the
+            // rising edge for an odd period, so it peaks at exactly 255 too
+            const uint32_t level = phase < half ? phase * 255 / half
+                                                : (period - phase) * 255 / (period - half);
+            show(base.r * level / 255, base.g * level / 255, base.b * level / 255);
+            return pdMS_TO_TICKS(STATUS_LED_FRAME_MS);
+        }
+        default:
+            show(0, 0, 0);
+            return portMAX_DELAY;
+    }
+}
+
+void StatusLed::taskEntry(void* param) {
+    static_cast<StatusLed*>(param)->run();
+}
+
+void StatusLed::run() {
+    LedCommand cmd;
+    while (true) {
+        const TickType_t wait = render(millis());
+        if (xQueueReceive(queue, &cmd, wait) == pdTRUE) {
+            const uint32_t now = millis();
+            apply(cmd, now);
+            while (xQueueReceive(queue, &cmd, 0) == pdTRUE) {
+                apply(cmd, now);
+            }
+        }
+    }
+}
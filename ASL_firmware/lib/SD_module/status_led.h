@@ -0,0 +1,87 @@
+#ifndef STATUS_LED_H
+#define STATUS_LED_H
+
+#include <Arduino.h>
+#include <freertos/FreeRTOS.h>
+#include <freertos/queue.h>
+#include <freertos/task.h>
+#include "Adafruit_NeoPixel.h"
+#include "static_alloc.h"
+
+// Configuration
+#define STATUS_LED_QUEUE_LEN 8
+#define STATUS_LED_TASK_STACK 2048
+#define STATUS_LED_TASK_PRIORITY 1     // below every pipeline task
+#define STATUS_LED_TASK_CORE 1
+#define STATUS_LED_FRAME_MS 20         // pulse animation step
+
+// Overlay priorities: a running overlay is only replaced by one of equal or
+// higher priority, so an error blink is not cut short by a success blink.
+enum LedPriority {
+    LED_PRIORITY_INFO = 0,
+    LED_PRIORITY_SUCCESS,
+    LED_PRIORITY_WARNING,
+    LED_PRIORITY_ERROR
+};
+
+// Drives the NeoPixel from its own low-priority task. Callers post patterns
+// to a queue and return at once; nothing on the caller's path waits for the
+// animation. Two layers: a persistent base (off, solid or pulsing) and a
+// transient overlay (blink / flash) that returns to the base when done.
+class StatusLed {
+public:
+    StatusLed(uint8_t pin, uint16_t numPixels);
+
+    bool begin(uint8_t brightness = 50);
+
+    // Base layer
+    void setColor(uint8_t r, uint8_t g, uint8_t b);
+    void pulse(uint8_t r, uint8_t g, uint8_t b, uint16_t periodMs = 1000);
+    void off();
+
+    // Overlay layer
+    void blink(uint8_t r, uint8_t g, uint8_t b, uint8_t times = 3, uint16_t intervalMs = 50,
+               LedPriority priority = LED_PRIORITY_INFO);
+    void flash(uint8_t r, uint8_t g, uint8_t b, uint16_t durationMs,
+               LedPriority priority = LED_PRIORITY_INFO);
+
+    uint32_t getDroppedCount() const { return dropped; }
+
+private:
+    enum LedMode : uint8_t { LED_MODE_OFF, LED_MODE_SOLID, LED_MODE_PULSE, LED_MODE_BLINK };
+
+    struct LedCommand {
+        LedMode mode;
+        bool overlay;
+        uint8_t priority;
+        uint8_t r, g, b;
+        uint8_t times;
+        uint16_t onMs;
+        uint16_t offMs;
+    };
+
+    Adafruit_NeoPixel pixels;
+    StaticQueue<LedCommand, STATUS_LED_QUEUE_LEN> queueStorage;
+    StaticTask<STATUS_LED_TASK_STACK> taskStorage;
+    QueueHandle_t queue;
+    TaskHandle_t task;
+    volatile uint32_t dropped;
+
+    // Owned by the LED task
+    LedCommand base;
+    LedCommand overlay;
+    bool overlayActive;
+    uint32_t overlayStart;
+    uint32_t baseStart;
+    uint32_t lastColor;
+
+    void post(const LedCommand& cmd);
+    void show(uint8_t r, uint8_t g, uint8_t b);
+    TickType_t render(uint32_t now);
+    void apply(const LedCommand& cmd, uint32_t now);
+
+    static void taskEntry(void* param);
+    void run();
+};
+
+#endif // STATUS_LED_H
@@ -4,8 +4,8 @@
 // WiFi for TTS streaming
 #include <WiFi.h>
 #include <HTTPClient.h>
-#include <ArduinoJson.h>
 #include <ctype.h>
+#include <new>
 
 extern const char* API_KEY;
 
@@ -20,6 +20,25 @@ int8_t base64CharToValue(char c) {
     return -1;
 }
 
+// Copies text into out as the body of a JSON string; returns false if it
+// does not fit.
+bool jsonEscape(char* out, size_t space, const char* text) {
+    size_t n = 0;
+    for (const char* p = text; *p; ++p) {
+        const unsigned char c = static_cast<unsigned char>(*p);
+        if (c == '"' || c == '\\') {
+            if (n + 2 >= space) return false;
+            out[n++] = '\\';
+            out[n++] = static_cast<char>(c);
+        } else if (c >= 0x20) {
+            if (n + 1 >= space) return false;
+            out[n++] = static_cast<char>(c);
+        }
+    }
+    out[n] = '\0';
+    return true;
+}
+
 bool decodeBase64ToFile(const char* input, size_t length, File& file, size_t& bytesWritten) {
     uint32_t bit_stream = 0;
     int bits = 0;
@@ -102,14 +121,14 @@ size_t base64_decode(const char* input, uint8_t* output, size_t outputLen) {
 
 I2S_Amplifier::I2S_Amplifier(int8_t bclk, int8_t lrc, int8_t dout)
     : initialized(false), volume(24), bclk_pin(bclk), lrc_pin(lrc), dout_pin(dout) {
-    audio = new Audio(false, 3, I2S_NUM_0);
+    audio = new (audioStorage) Audio(false, 3, I2S_NUM_0);
     audio->setConnectionTimeout(500, 2700);
     audio->setBufsize(8192, 16384);  // 8KB input, 16KB output
 }
 
 I2S_Amplifier::~I2S_Amplifier() {
     if (audio) {
-        delete audio;
+        audio->~Audio();
         audio = nullptr;
     }
 }
@@ -130,11 +149,14 @@ bool I2S_Amplifier::isReady() {
 bool I2S_Amplifier::playFileFromSD(const char* filename) {
     if (!initialized) return false;
     if (!SD.exists(filename)) return false;
-    if (audio) {
-        audio->connecttoFS((fs::FS&)SD, filename);
-        return true;
-    }
-    return false;
+    return playFile(SD, filename);
+}
+
+// No exists() check here: callers that resolved the file through the audio
+// cache index already know where it is, and connecttoFS fails on a missing file.
+bool I2S_Amplifier::playFile(fs::FS& fs, const char* filename) {
+    if (!initialized || !audio) return false;
+    return audio->connecttoFS(fs, filename);
 }
 
 bool I2S_Amplifier::playCloudTTS(const char* text, const char* language) {
@@ -148,28 +170,34 @@ bool I2S_Amplifier::downloadCloudTTS(const char* text, const char* language, con
 
     Serial.printf("[TTS] Downloading '%s' to %s\n", text, filename);
 
-    HTTPClient http;
-    const char* url = "https://texttospeech.googleapis.com/v1/text:synthesize";
-    String fullUrl = String(url) + "?key=" + API_KEY;
-
-    http.begin(fullUrl);
-    http.addHeader("Content-Type", "application/json");
+    char escaped[TTS_REQUEST_MAX / 2];
+    if (!jsonEscape(escaped, sizeof(escaped), text)) {
+        Serial.println("[TTS] Text too long for request buffer");
+        return false;
+    }
 
-    JsonDocument doc;
-    doc["input"]["text"] = text;
-    doc["voice"]["languageCode"] = language;
-    doc["voice"]["name"] = String(language) + "-Neural2-C";
-    doc["audioConfig"]["audioEncoding"] = "MP3";
-    doc["audioConfig"]["speakingRate"] = 1.0;
-    doc["audioConfig"]["pitch"] = 0.0;
+    char url[TTS_URL_MAX];
+    snprintf(url, sizeof(url), "https://texttospeech.googleapis.com/v1/text:synthesize?key=%s", API_KEY);
+
+    char requestBody[TTS_REQUEST_MAX];
+    const int requestLen = snprintf(
+        requestBody, sizeof(requestBody),
+        "{\"input\":{\"text\":\"%s\"},"
+        "\"voice\":{\"languageCode\":\"%s\",\"name\":\"%s-Neural2-C\"},"
+        "\"audioConfig\":{\"audioEncoding\":\"MP3\",\"speakingRate\":1.0,\"pitch\":0.0}}",
+        escaped, language, language);
+    if (requestLen < 0 || requestLen >= (int)sizeof(requestBody)) {
+        Serial.println("[TTS] Request does not fit the request buffer");
+        return false;
+    }
 
-    String requestBody;
-    serializeJson(doc, requestBody);
-    doc.clear();
+    HTTPClient http;
+    http.begin(url);
+    http.addHeader("Content-Type", "application/json");
 
-    Serial.printf("[TTS] Request size: %d bytes, Free heap: %d\n", requestBody.length(), ESP.getFreeHeap());
+    Serial.printf("[TTS] Request size: %d bytes, Free heap: %d\n", requestLen, ESP.getFreeHeap());
 
-    int httpCode = http.POST(requestBody);
+    int httpCode = http.POST(reinterpret_cast<uint8_t*>(requestBody), requestLen);
 
     if (httpCode != 200) {
         Serial.printf("[TTS] HTTP error: %d\n", httpCode);
@@ -180,20 +208,23 @@ bool I2S_Amplifier::downloadCloudTTS(const char* text, const char* language, con
     WiFiClient* stream = http.getStreamPtr();
 
     bool found = false;
-    String searchPattern = "\"audioContent\"";
-    String buffer;
+    static const char kSearchPattern[] = "\"audioContent\"";
+    const size_t patternLen = sizeof(kSearchPattern) - 1;
+    size_t matched = 0;
 
     Serial.printf("[TTS] Searching for audioContent field, Free heap: %d\n", ESP.getFreeHeap());
 
     while (stream->connected() && stream->available()) {
         char c = stream->read();
-        buffer += c;
-        if (buffer.endsWith(searchPattern)) {
-            found = true;
-            break;
-        }
-        if (buffer.length() > 50) {
-            buffer.remove(0, buffer.length() - searchPattern.length());
+        // The quote only occurs at the ends of the pattern, so on a mismatch
+        // the match restarts at 0, or at 1 if this byte is itself a quote
+        if (c == kSearchPattern[matched]) {
+            if (++matched == patternLen) {
+                found = true;
+                break;
+            }
+        } else {
+            matched = (c == kSearchPattern[0]) ? 1 : 0;
         }
     }
 
@@ -221,9 +252,8 @@ bool I2S_Amplifier::downloadCloudTTS(const char* text, const char* language, con
         return false;
     }
 
-    String b64Buffer;
+    size_t b64Len = 0;
     size_t totalBytesWritten = 0;
-    const size_t CHUNK_SIZE = 1024;
 
     while (stream->connected() || stream->available()) {
         if (!stream->available()) {
@@ -236,11 +266,11 @@ bool I2S_Amplifier::downloadCloudTTS(const char* text, const char* language, con
 
         if ((c >= 'A' && c <= 'Z') || (c >= 'a' && c <= 'z') ||
             (c >= '0' && c <= '9') || c == '+' || c == '/' || c == '=') {
-            b64Buffer += c;
+            b64Chunk[b64Len++] = c;
 
-            if (b64Buffer.length() >= CHUNK_SIZE) {
+            if (b64Len >= TTS_B64_CHUNK) {
                 size_t bytesWritten = 0;
-                if (!decodeBase64ToFile(b64Buffer.c_str(), b64Buffer.length(), file, bytesWritten)) {
+                if (!decodeBase64ToFile(b64Chunk, b64Len, file, bytesWritten)) {
                     Serial.println("[TTS] Base64 decode failed during streaming");
                     file.close();
                     http.end();
@@ -248,14 +278,14 @@ bool I2S_Amplifier::downloadCloudTTS(const char* text, const char* language, con
                     return false;
                 }
                 totalBytesWritten += bytesWritten;
-                b64Buffer = "";
+                b64Len = 0;
             }
         }
     }
 
-    if (b64Buffer.length() > 0) {
+    if (b64Len > 0) {
         size_t bytesWritten = 0;
-        decodeBase64ToFile(b64Buffer.c_str(), b64Buffer.length(), file, bytesWritten);
+        decodeBase64ToFile(b64Chunk, b64Len, file, bytesWritten);
         totalBytesWritten += bytesWritten;
     }
 
@@ -8,9 +8,19 @@
 #define I2S_LRC_PIN  16
 #define I2S_DOUT_PIN 17
 
+// Fixed buffers for the TTS download path (no String growth per byte)
+#define TTS_URL_MAX 160
+#define TTS_REQUEST_MAX 384
+#define TTS_B64_CHUNK 1024                 // multiple of 4: decodes without carry
+
 class I2S_Amplifier {
 private:
+    // The Audio object lives in this static storage rather than on the heap;
+    // the decoder buffers it sizes with setBufsize() are still allocated by
+    // the library, once, in the constructor.
+    alignas(Audio) uint8_t audioStorage[sizeof(Audio)];
     Audio* audio;
+    char b64Chunk[TTS_B64_CHUNK];
     bool initialized;
     int8_t volume;
     int8_t bclk_pin;
@@ -26,6 +36,7 @@ public:
     bool begin();
     bool isReady();
     bool playFileFromSD(const char* filename);
+    bool playFile(fs::FS& fs, const char* filename);
     bool playCloudTTS(const char* text, const char* language = "en-US");
     bool downloadCloudTTS(const char* text, const char* language, const char* filename);
     void stop();
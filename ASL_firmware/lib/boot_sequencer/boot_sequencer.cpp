@@ -0,0 +1,128 @@
+#include "boot_sequencer.h"
+
+BootSequencer bootSequencer;
+
+BootSequencer::BootSequencer()
+    : phaseCount(0), milestoneCount(0), events(nullptr), started(false), startMs(0) {
+    markLock = portMUX_INITIALIZER_UNLOCKED;
+}
+
+int BootSequencer::addPhase(const char* name, BootPhaseFn fn, uint32_t deps, BaseType_t core,
+                            uint32_t stackSize) {
+    if (started || phaseCount >= BOOT_MAX_PHASES || !fn) return -1;
+    // Only earlier phases can be waited on, which also rules out cycles
+    if (deps & ~allBits()) return -1;
+
+    BootPhase& phase = phases[phaseCount];
+    phase.name = name;
+    phase.fn = fn;
+    phase.deps = deps;
+    phase.core = core;
+    phase.stackSize = stackSize;
+    phase.startMs = 0;
+    phase.endMs = 0;
+    phase.ok = false;
+    phase.owner = this;
+    phase.id = (uint8_t)phaseCount;
+    return phaseCount++;
+}
+
+bool BootSequencer::start() {
+    if (started) return true;
+    events = xEventGroupCreateStatic(&eventStorage);
+    if (!events) return false;
+
+    startMs = millis();
+    started = true;
+    for (int i = 0; i < phaseCount; i++) {
+        char taskName[configMAX_TASK_NAME_LEN];
+        snprintf(taskName, sizeof(taskName), "boot:%s", phases[i].name);
+        if (xTaskCreatePinnedToCore(phaseTask, taskName, phases[i].stackSize, &phases[i],
+                                    BOOT_PHASE_PRIORITY, nullptr, phases[i].core) != pdPASS) {
+            // Still release dependents so the rest of the boot can proceed
+            Serial.printf("[BOOT] Failed to start phase '%s'\n", phases[i].name);
+            xEventGroupSetBits(events, BOOT_PHASE_BIT(i));
+        }
+    }
+    return true;
+}
+
+bool BootSequencer::waitFor(uint32_t mask, uint32_t timeoutMs) {
+    if (!started || !events) return false;
+    const EventBits_t bits = xEventGroupWaitBits(events, mask, pdFALSE, pdTRUE, pdMS_TO_TICKS(timeoutMs));
+    return (bits & mask) == mask;
+}
+
+bool BootSequencer::isFinishedMask(uint32_t mask) const {
+    return events && (xEventGroupGetBits(events) & mask) == mask;
+}
+
+bool BootSequencer::isFinished(int id) const {
+    return id >= 0 && id < phaseCount && isFinishedMask(BOOT_PHASE_BIT(id));
+}
+
+bool BootSequencer::succeeded(int id) const {
+    return isFinished(id) && phases[id].ok;
+}
+
+void BootSequencer::mark(const char* name) {
+    portENTER_CRITICAL(&markLock);
+    bool seen = false;
+    for (int i = 0; i < milestoneCount; i++) {
+        if (strcmp(milestones[i].name, name) == 0) {
+            seen = true;
+            break;
+        }
+    }
+    if (!seen && milestoneCount < BOOT_MAX_MILESTONES) {
+        milestones[milestoneCount].name = name;
+        milestones[milestoneCount].atMs = millis();
+        milestoneCount = milestoneCount + 1;
+    }
+    portEXIT_CRITICAL(&markLock);
+}
+
+void BootSequencer::printReport() const {
+    Serial.println("\nBoot Timing (ms since power-on)");
+    Serial.println("Phase        Core  Start    End  Took  Result");
+    uint32_t lastEnd = startMs;
+    for (int i = 0; i < phaseCount; i++) {
+        const BootPhase& phase = phases[i];
+        if (!isFinished(i)) {
+            Serial.printf("%-12s %4d  %5s  %5s  %4s  pending\n", phase.name, (int)phase.core, "-", "-", "-");
+            continue;
+        }
+        Serial.printf("%-12s %4d  %5u  %5u  %4u  %s\n", phase.name, (int)phase.core,
+                      (unsigned)phase.startMs, (unsigned)phase.endMs,
+                      (unsigned)(phase.endMs - phase.startMs), phase.ok ? "OK" : "FAILED");
+        if (phase.endMs > lastEnd) lastEnd = phase.endMs;
+    }
+
+    uint32_t serialMs = 0;
+    for (int i = 0; i < phaseCount; i++) {
+        if (isFinished(i)) serialMs += phases[i].endMs - phases[i].startMs;
+    }
+    if (isComplete()) {
+        Serial.printf("All phases done at %u ms (%u ms of phase work, %u ms wall)\n",
+                      (unsigned)lastEnd, (unsigned)serialMs, (unsigned)(lastEnd - startMs));
+    }
+
+    for (int i = 0; i < milestoneCount; i++) {
+        Serial.printf("%s at %u ms\n", milestones[i].name, (unsigned)milestones[i].atMs);
+    }
+    Serial.println();
+}
+
+void BootSequencer::phaseTask(void* param) {
+    BootPhase* phase = static_cast<BootPhase*>(param);
+    BootSequencer* owner = phase->owner;
+
+    if (phase->deps) {
+        xEventGroupWaitBits(owner->events, phase->deps, pdFALSE, pdTRUE, portMAX_DELAY);
+    }
+    phase->startMs = millis();
+    phase->ok = phase->fn();
+    phase->endMs = millis();
+    xEventGroupSetBits(owner->events, BOOT_PHASE_BIT(phase->id));
+    vTaskDelete(nullptr);
+}
@@ -0,0 +1,91 @@
+#ifndef BOOT_SEQUENCER_H
+#define BOOT_SEQUENCER_H
+
+#include <Arduino.h>
+#include <freertos/FreeRTOS.h>
+#include <freertos/event_groups.h>
+#include <freertos/task.h>
+
+// Configuration
+#define BOOT_MAX_PHASES 12               // one event group bit each (24 available)
+#define BOOT_MAX_MILESTONES 4
+#define BOOT_PHASE_STACK 4096
+#define BOOT_PHASE_PRIORITY 5            // above the pipeline tasks while booting
+
+typedef bool (*BootPhaseFn)();
+
+#define BOOT_PHASE_BIT(id) (1UL << (id))
+
+class BootSequencer;
+
+struct BootPhase {
+    const char* name;
+    BootPhaseFn fn;
+    uint32_t deps;                       // BOOT_PHASE_BIT mask of prerequisite phases
+    BaseType_t core;
+    uint32_t stackSize;
+    uint32_t startMs;
+    uint32_t endMs;
+    volatile bool ok;
+    BootSequencer* owner;
+    uint8_t id;
+};
+
+struct BootMilestone {
+    const char* name;
+    uint32_t atMs;
+};
+
+// Dependency-aware boot. Each phase runs in its own short-lived task pinned
+// to the requested core, waits on an event group until every phase in its
+// deps mask has finished, then runs and sets its own bit. Phases with no
+// shared dependencies therefore initialize concurrently on both cores. A
+// phase is marked finished whether or not it succeeded; dependents that care
+// check succeeded(). Times are millis() since power-on.
+//
+// Phase tasks are deliberately not static: their stacks go back to the heap
+// when the phase ends instead of pinning BOOT_PHASE_STACK each in .bss for
+// the whole uptime.
+class BootSequencer {
+public:
+    BootSequencer();
+
+    // Returns the phase ID (use BOOT_PHASE_BIT(id) in deps), or -1 when full.
+    // Phases may only depend on phases added before them.
+    int addPhase(const char* name, BootPhaseFn fn, uint32_t deps, BaseType_t core,
+                 uint32_t stackSize = BOOT_PHASE_STACK);
+
+    bool start();
+    bool waitFor(uint32_t mask, uint32_t timeoutMs);
+    bool waitAll(uint32_t timeoutMs) { return waitFor(allBits(), timeoutMs); }
+
+    bool isFinished(int id) const;
+    bool succeeded(int id) const;
+    bool isComplete() const { return started && isFinishedMask(allBits()); }
+
+    // Records the first time a named event happens after boot (e.g. the first
+    // committed letter); later calls with the same name are ignored.
+    void mark(const char* name);
+
+    void printReport() const;
+
+private:
+    BootPhase phases[BOOT_MAX_PHASES];
+    int phaseCount;
+    BootMilestone milestones[BOOT_MAX_MILESTONES];
+    volatile int milestoneCount;
+    StaticEventGroup_t eventStorage;
+    EventGroupHandle_t events;
+    portMUX_TYPE markLock;
+    bool started;
+    uint32_t startMs;
+
+    uint32_t allBits() const { return phaseCount ? BOOT_PHASE_BIT(phaseCount) - 1 : 0; }
+    bool isFinishedMask(uint32_t mask) const;
+
+    static void phaseTask(void* param);
+};
+
+extern BootSequencer bootSequencer;
+
+#endif // BOOT_SEQUENCER_H
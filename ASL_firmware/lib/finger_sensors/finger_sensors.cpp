@@ -1,66 +1,18 @@
 #include "finger_sensors.h"
 
-// Moving Average Filter Implementation
-
-MovingAverageFilter::MovingAverageFilter(int windowSize, float deadbandThreshold) {
-    size = min(windowSize, MAX_FILTER_SIZE);
-    index = 0;
-    sum = 0;
-    count = 0;
-    lastOutput = 0;
-    deadband = deadbandThreshold;
-
-    for (int i = 0; i < MAX_FILTER_SIZE; i++) {
-        buffer[i] = 0;
-    }
-}
-
-float MovingAverageFilter::add(float value) {
-    // Remove oldest value from sum
-    if (count >= size) {
-        sum -= buffer[index];
-    }
-
-    // Add new value
-    buffer[index] = value;
-    sum += value;
-    index = (index + 1) % size;
-
-    if (count < size) count++;
-
-    // Calculate average
-    float filtered = sum / count;
-
-    // Apply deadband to reduce jitter
-    if (count >= size && abs(filtered - lastOutput) < deadband) {
-        return lastOutput;
-    }
-
-    lastOutput = filtered;
-    return filtered;
-}
-
-void MovingAverageFilter::reset() {
-    sum = 0;
-    count = 0;
-    index = 0;
-    lastOutput = 0;
-}
-
 // Finger Sensor Implementation
 
 FingerSensor::FingerSensor()
-    : pin(0), name(""), filter(5, 0.02f), numCalibPoints(0),
+    : pin(0), name(""), numCalibPoints(0),
       baselineVoltage(0), baselineEstablished(false),
       baselineCount(0), baselineSum(0),
       flex_min(0), flex_max(V_REF), calibrationComplete(false),
       lastRawVoltage(0), lastFilteredVoltage(0), lastAngle(0), lastNormalized(0) {
 }
 
-void FingerSensor::begin(uint8_t analogPin, const String& fingerName, int filterSize) {
+void FingerSensor::begin(uint8_t analogPin, const String& fingerName) {
     pin = analogPin;
     name = fingerName;
-    filter = MovingAverageFilter(filterSize, 0.02f);
 
     // Set default calibration if none provided
     if (numCalibPoints == 0) {
@@ -151,10 +103,9 @@ void FingerSensor::resetBaseline() {
     baselineEstablished = false;
     baselineCount = 0;
     baselineSum = 0;
-    filter.reset();
 }
 
-void FingerSensor::update() {
+float FingerSensor::sample() {
     // Read raw voltage
     lastRawVoltage = readVoltage();
 
@@ -165,13 +116,8 @@ void FingerSensor::update() {
         compensatedVoltage = constrain(compensatedVoltage, 0.0f, V_REF);
     }
 
-    // Apply smoothing filter
-    lastFilteredVoltage = filter.add(compensatedVoltage);
-
-    // Convert to angle
-    lastAngle = voltageToAngle(lastFilteredVoltage);
-
-    // Calculate normalized value (0-1 range) if calibrated
+    // Calculate normalized value (0-1 range) if calibrated. This stays on the
+    // raw voltage: the model was trained on unfiltered values.
     if (calibrationComplete) {
         float span = flex_max - flex_min;
         if (fabsf(span) > 0.01f) {
@@ -188,6 +134,15 @@ void FingerSensor::update() {
     } else {
         lastNormalized = 0.0f;
     }
+
+    return compensatedVoltage;
+}
+
+void FingerSensor::applyFiltered(float voltage) {
+    lastFilteredVoltage = voltage;
+
+    // Convert to angle
+    lastAngle = voltageToAngle(lastFilteredVoltage);
 }
 
 String FingerSensor::getPositionStatus() const {
@@ -211,14 +166,14 @@ void FingerSensorManager::begin() {
     analogSetAttenuation(ADC_11db);
 }
 
-int FingerSensorManager::addFinger(uint8_t pin, const String& name, int filterSize) {
+int FingerSensorManager::addFinger(uint8_t pin, const String& name) {
     if (numFingers >= MAX_FINGERS) {
         Serial.println("ERROR: Maximum number of fingers reached!");
         return -1;
     }
 
     int index = numFingers;
-    fingers[index].begin(pin, name, filterSize);
+    fingers[index].begin(pin, name);
     numFingers++;
 
     return index;
@@ -260,12 +215,20 @@ void FingerSensorManager::resetAllBaselines() {
     for (int i = 0; i < numFingers; i++) {
         fingers[i].resetBaseline();
     }
+    filterBank.reset();
     baselineComplete = false;
 }
 
 void FingerSensorManager::updateAll() {
+    float voltages[MAX_FINGERS];
+    for (int i = 0; i < numFingers; i++) {
+        voltages[i] = fingers[i].sample();
+    }
+
+    filterBank.process(voltages, voltages, numFingers);
+
     for (int i = 0; i < numFingers; i++) {
-        fingers[i].update();
+        fingers[i].applyFiltered(voltages[i]);
     }
 }
 
@@ -349,8 +312,8 @@ bool FingerSensorManager::calibrateOpen(int durationMs) {
     unsigned long startTime = millis();
     while (millis() - startTime < durationMs) {
         // Update all sensors
+        updateAll();
         for (int i = 0; i < numFingers; i++) {
-            fingers[i].update();
             sums[i] += fingers[i].getRawVoltage();
         }
         sampleCount++;
@@ -400,8 +363,8 @@ bool FingerSensorManager::calibrateClosed(int durationMs) {
     unsigned long startTime = millis();
     while (millis() - startTime < durationMs) {
         // Update all sensors
+        updateAll();
         for (int i = 0; i < numFingers; i++) {
-            fingers[i].update();
             sums[i] += fingers[i].getRawVoltage();
         }
         sampleCount++;
@@ -2,10 +2,13 @@
 #define FINGER_SENSORS_H
 
 #include <Arduino.h>
+#include "flex_filter.h"
 
 // Configuration Constants
 #define MAX_FINGERS 5
-#define MAX_FILTER_SIZE 10
+#if MAX_FINGERS > FLEX_FILTER_MAX_CHANNELS
+#error "FLEX_FILTER_MAX_CHANNELS must cover MAX_FINGERS"
+#endif
 #define MAX_CALIB_POINTS 6
 #define BASELINE_SAMPLES 20
 
@@ -20,26 +23,6 @@ struct CalibrationPoint {
     float angle;      // Corresponding angle in degrees
 };
 
-// Moving Average Filter Class
-class MovingAverageFilter {
-private:
-    float buffer[MAX_FILTER_SIZE];
-    int size;
-    int index;
-    float sum;
-    int count;
-    float lastOutput;
-    float deadband;
-
-public:
-    MovingAverageFilter(int windowSize = 5, float deadbandThreshold = 0.02f);
-
-    float add(float value);
-    void reset();
-    float getLastOutput() const { return lastOutput; }
-    void setDeadband(float db) { deadband = db; }
-};
-
 // Finger Sensor Class
 class FingerSensor {
 private:
@@ -47,9 +30,6 @@ private:
     uint8_t pin;
     String name;
 
-    // Filtering
-    MovingAverageFilter filter;
-
     // Calibration
     CalibrationPoint calibration[MAX_CALIB_POINTS];
     int numCalibPoints;
@@ -79,7 +59,7 @@ public:
     FingerSensor();
 
     // Initialization
-    void begin(uint8_t analogPin, const String& fingerName, int filterSize = 5);
+    void begin(uint8_t analogPin, const String& fingerName);
 
     // Calibration setup
     void setCalibration(const CalibrationPoint* points, int count);
@@ -91,8 +71,11 @@ public:
     bool isBaselineReady() const { return baselineEstablished; }
     float getBaselineVoltage() const { return baselineVoltage; }
 
-    // Main update function
-    void update();
+    // Main update, split so the manager can filter all channels in one pass:
+    // sample() reads the ADC and returns the drift-compensated voltage,
+    // applyFiltered() takes that voltage back after filtering.
+    float sample();
+    void applyFiltered(float voltage);
 
     // Data access
     float getRawVoltage() const { return lastRawVoltage; }
@@ -122,13 +105,14 @@ private:
     FingerSensor fingers[MAX_FINGERS];
     int numFingers;
     bool baselineComplete;
+    FlexFilterBank filterBank;
 
 public:
     FingerSensorManager();
 
     // Setup
     void begin();
-    int addFinger(uint8_t pin, const String& name, int filterSize = 5);
+    int addFinger(uint8_t pin, const String& name);
     void setFingerCalibration(int fingerIndex, const CalibrationPoint* points, int count);
 
     // Baseline calibration
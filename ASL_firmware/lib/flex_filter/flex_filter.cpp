@@ -0,0 +1,125 @@
+#include "flex_filter.h"
+
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+
+// Plain C++ only, so the filters also build and are tested on the host.
+
+namespace {
+
+const float kPi = 3.14159265358979f;
+const float kSamplePeriod = 1.0f / FLEX_FILTER_RATE_HZ;
+
+// Smoothing factor of a first-order low-pass with the given cutoff
+inline float emaAlpha(float cutoffHz) {
+    const float tau = 1.0f / (2.0f * kPi * cutoffHz);
+    return 1.0f / (1.0f + tau / kSamplePeriod);
+}
+
+inline float median3(float a, float b, float c) {
+    return std::max(std::min(a, b), std::min(std::max(a, b), c));
+}
+
+}  // namespace
+
+// One-Euro
+
+OneEuroFilterBank::OneEuroFilterBank() : alphaDeriv(emaAlpha(ONE_EURO_DERIV_CUTOFF_HZ)) {
+    reset();
+}
+
+void OneEuroFilterBank::reset() {
+    std::memset(x, 0, sizeof(x));
+    std::memset(dx, 0, sizeof(dx));
+    primed = false;
+}
+
+void OneEuroFilterBank::process(const float* in, float* out, int channels) {
+    if (!primed) {
+        for (int i = 0; i < channels; i++) {
+            x[i] = out[i] = in[i];
+            dx[i] = 0.0f;
+        }
+        primed = true;
+        return;
+    }
+
+    for (int i = 0; i < channels; i++) {
+        const float rate = (in[i] - x[i]) * FLEX_FILTER_RATE_HZ;
+        dx[i] += alphaDeriv * (rate - dx[i]);
+        const float cutoff = ONE_EURO_MIN_CUTOFF_HZ + ONE_EURO_BETA * std::fabs(dx[i]);
+        x[i] += emaAlpha(cutoff) * (in[i] - x[i]);
+        out[i] = x[i];
+    }
+}
+
+// Biquad
+
+BiquadFilterBank::BiquadFilterBank() {
+    // RBJ low-pass, Q = 1/sqrt(2)
+    const float w0 = 2.0f * kPi * BIQUAD_CUTOFF_HZ / FLEX_FILTER_RATE_HZ;
+    const float cosw = std::cos(w0);
+    const float alpha = std::sin(w0) / (2.0f * 0.70710678f);
+    const float a0 = 1.0f + alpha;
+    b0 = (1.0f - cosw) / 2.0f / a0;
+    b1 = (1.0f - cosw) / a0;
+    b2 = b0;
+    a1 = -2.0f * cosw / a0;
+    a2 = (1.0f - alpha) / a0;
+    reset();
+}
+
+void BiquadFilterBank::reset() {
+    std::memset(z1, 0, sizeof(z1));
+    std::memset(z2, 0, sizeof(z2));
+    primed = false;
+}
+
+void BiquadFilterBank::process(const float* in, float* out, int channels) {
+    if (!primed) {
+        // Start in steady state at the first sample instead of ramping from 0 V
+        for (int i = 0; i < channels; i++) {
+            z1[i] = (1.0f - b0) * in[i];
+            z2[i] = (b2 - a2) * in[i];
+        }
+        primed = true;
+    }
+
+    for (int i = 0; i < channels; i++) {
+        const float y = b0 * in[i] + z1[i];
+        z1[i] = b1 * in[i] - a1 * y + z2[i];
+        z2[i] = b2 * in[i] - a2 * y;
+        out[i] = y;
+    }
+}
+
+// Median-of-3 + EMA
+
+MedianEmaFilterBank::MedianEmaFilterBank() {
+    reset();
+}
+
+void MedianEmaFilterBank::reset() {
+    std::memset(hist, 0, sizeof(hist));
+    std::memset(y, 0, sizeof(y));
+    pos = 0;
+    primed = false;
+}
+
+void MedianEmaFilterBank::process(const float* in, float* out, int channels) {
+    if (!primed) {
+        for (int i = 0; i < channels; i++) {
+            hist[i][0] = hist[i][1] = hist[i][2] = y[i] = in[i];
+        }
+        primed = true;
+    }
+
+    for (int i = 0; i < channels; i++) {
+        hist[i][pos] = in[i];
+        const float m = median3(hist[i][0], hist[i][1], hist[i][2]);
+        y[i] += MEDIAN_EMA_ALPHA * (m - y[i]);
+        out[i] = y[i];
+    }
+    pos = (pos + 1) % 3;
+}
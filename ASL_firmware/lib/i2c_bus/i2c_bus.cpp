@@ -0,0 +1,211 @@
+#include "i2c_bus.h"
+
+I2CBus i2cBus;
+
+I2CBus::I2CBus(TwoWire& wire)
+    : wire(&wire), mutex(nullptr), initialized(false), sda(-1), scl(-1),
+      frequency(100000), busRecoveries(0), deviceCount(0) {
+    memset(devices, 0, sizeof(devices));
+}
+
+bool I2CBus::begin(int sdaPin, int sclPin, uint32_t freq) {
+    if (!mutex) {
+        mutex = mutexStorage.create();
+        if (!mutex) return false;
+    }
+    sda = sdaPin;
+    scl = sclPin;
+    frequency = freq;
+
+    // A slave left mid-transfer by a reset can hold SDA low; clear it first.
+    clearBus();
+    busRecoveries = 0;
+    initialized = true;
+    return true;
+}
+
+bool I2CBus::lock() {
+    return mutex && xSemaphoreTake(mutex, pdMS_TO_TICKS(I2C_BUS_LOCK_TIMEOUT_MS)) == pdTRUE;
+}
+
+void I2CBus::unlock() {
+    xSemaphoreGive(mutex);
+}
+
+I2CDeviceStats* I2CBus::statsFor(uint8_t addr) {
+    for (size_t i = 0; i < deviceCount; i++) {
+        if (devices[i].address == addr) return &devices[i];
+    }
+    if (deviceCount >= I2C_BUS_MAX_DEVICES) return nullptr;
+    I2CDeviceStats* stats = &devices[deviceCount++];
+    memset(stats, 0, sizeof(*stats));
+    stats->address = addr;
+    return stats;
+}
+
+const I2CDeviceStats* I2CBus::getStats(uint8_t addr) const {
+    for (size_t i = 0; i < deviceCount; i++) {
+        if (devices[i].address == addr) return &devices[i];
+    }
+    return nullptr;
+}
+
+I2CStatus I2CBus::endTransmissionStatus(uint8_t result) const {
+    switch (result) {
+        case 0: return I2C_OK;
+        case 2:
+        case 3: return I2C_NACK;
+        case 5: return I2C_TIMEOUT;
+        default: return I2C_ERROR;
+    }
+}
+
+// Called with the lock held. Records the transaction and clears the bus once
+// a device has failed I2C_BUS_RECOVER_AFTER times in a row.
+I2CStatus I2CBus::finish(I2CDeviceStats* stats, uint32_t startUs, I2CStatus status) {
+    if (!stats) return status;
+
+    const uint32_t elapsed = micros() - startUs;
+    stats->transactions++;
+    stats->lastUs = elapsed;
+    stats->totalUs += elapsed;
+    if (elapsed > stats->maxUs) stats->maxUs = elapsed;
+
+    if (status == I2C_OK) {
+        stats->consecutiveErrors = 0;
+        return status;
+    }
+
+    stats->errors++;
+    if (status == I2C_TIMEOUT) stats->timeouts++;
+    if (++stats->consecutiveErrors >= I2C_BUS_RECOVER_AFTER) {
+        Serial.printf("[I2C] 0x%02X failed %u times (%s), clearing bus\n",
+                      stats->address, (unsigned)stats->consecutiveErrors, statusName(status));
+        clearBus();
+        stats->recoveries++;
+        stats->consecutiveErrors = 0;
+    }
+    return status;
+}
+
+I2CStatus I2CBus::writeReg(uint8_t addr, uint8_t reg, uint8_t value) {
+    if (!lock()) return I2C_BUSY;
+    const uint32_t start = micros();
+    wire->beginTransmission(addr);
+    wire->write(reg);
+    wire->write(value);
+    I2CStatus status = endTransmissionStatus(wire->endTransmission());
+    status = finish(statsFor(addr), start, status);
+    unlock();
+    return status;
+}
+
+I2CStatus I2CBus::readReg(uint8_t addr, uint8_t reg, uint8_t& value) {
+    return readRegs(addr, reg, &value, 1);
+}
+
+I2CStatus I2CBus::readRegs(uint8_t addr, uint8_t reg, uint8_t* data, size_t count) {
+    if (!lock()) return I2C_BUSY;
+    const uint32_t start = micros();
+    wire->beginTransmission(addr);
+    wire->write(reg);
+    I2CStatus status = endTransmissionStatus(wire->endTransmission(false));
+    if (status == I2C_OK) {
+        const int received = wire->requestFrom((int)addr, (int)count);
+        size_t i = 0;
+        for (; i < count && wire->available(); i++) {
+            data[i] = wire->read();
+        }
+        if (i < count) {
+            // requestFrom() returns 0 on timeout as well as on NACK
+            status = received == 0 ? I2C_TIMEOUT : I2C_SHORT_READ;
+        }
+    }
+    status = finish(statsFor(addr), start, status);
+    unlock();
+    return status;
+}
+
+I2CStatus I2CBus::probe(uint8_t addr) {
+    if (!lock()) return I2C_BUSY;
+    wire->beginTransmission(addr);
+    // Probes are expected to NACK for absent devices; keep them out of the stats.
+    const I2CStatus status = endTransmissionStatus(wire->endTransmission());
+    unlock();
+    return status;
+}
+
+bool I2CBus::recover() {
+    if (!lock()) return false;
+    const bool ok = clearBus();
+    unlock();
+    return ok;
+}
+
+// Standard bus clear: with the controller detached, clock SCL until the slave
+// releases SDA (at most 9 bits), then issue a STOP and re-attach Wire.
+bool I2CBus::clearBus() {
+    wire->end();
+
+    pinMode(sda, INPUT_PULLUP);
+    pinMode(scl, OUTPUT_OPEN_DRAIN);
+    digitalWrite(scl, HIGH);
+    delayMicroseconds(5);
+
+    for (int i = 0; i < I2C_BUS_CLEAR_PULSES && digitalRead(sda) == LOW; i++) {
+        digitalWrite(scl, LOW);
+        delayMicroseconds(5);
+        digitalWrite(scl, HIGH);
+        delayMicroseconds(5);
+    }
+
+    // STOP: SDA low -> high while SCL is high
+    pinMode(sda, OUTPUT_OPEN_DRAIN);
+    digitalWrite(sda, LOW);
+    delayMicroseconds(5);
+    digitalWrite(sda, HIGH);
+    delayMicroseconds(5);
+
+    pinMode(sda, INPUT_PULLUP);
+    const bool released = digitalRead(sda) == HIGH;
+
+    wire->begin(sda, scl, frequency);
+    wire->setTimeout(I2C_BUS_TIMEOUT_MS);
+    busRecoveries++;
+    return released;
+}
+
+void I2CBus::resetStats() {
+    if (!lock()) return;
+    for (size_t i = 0; i < deviceCount; i++) {
+        const uint8_t addr = devices[i].address;
+        memset(&devices[i], 0, sizeof(devices[i]));
+        devices[i].address = addr;
+    }
+    busRecoveries = 0;
+    unlock();
+}
+
+void I2CBus::printStats() const {
+    Serial.println("\n=== I2C Bus ===");
+    Serial.printf("Bus clears: %u\n", (unsigned)busRecoveries);
+    for (size_t i = 0; i < deviceCount; i++) {
+        const I2CDeviceStats& s = devices[i];
+        const uint32_t avg = s.transactions ? (uint32_t)(s.totalUs / s.transactions) : 0;
+        Serial.printf("0x%02X: %u txns, %u errors (%u timeouts), %u recoveries, avg=%uus max=%uus\n",
+                      s.address, (unsigned)s.transactions, (unsigned)s.errors,
+                      (unsigned)s.timeouts, (unsigned)s.recoveries, (unsigned)avg, (unsigned)s.maxUs);
+    }
+    Serial.println();
+}
+
+const char* I2CBus::statusName(I2CStatus status) {
+    switch (status) {
+        case I2C_OK: return "ok";
+        case I2C_BUSY: return "busy";
+        case I2C_NACK: return "nack";
+        case I2C_TIMEOUT: return "timeout";
+        case I2C_SHORT_READ: return "short read";
+        default: return "error";
+    }
+}
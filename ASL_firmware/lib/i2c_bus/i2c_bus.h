@@ -0,0 +1,88 @@
+#ifndef I2C_BUS_H
+#define I2C_BUS_H
+
+#include <Arduino.h>
+#include <Wire.h>
+#include <freertos/FreeRTOS.h>
+#include <freertos/semphr.h>
+
+#include "static_alloc.h"
+
+// Configuration
+#define I2C_BUS_MAX_DEVICES 8
+#define I2C_BUS_TIMEOUT_MS 10          // per transaction, passed to Wire
+#define I2C_BUS_LOCK_TIMEOUT_MS 50     // wait for another client's transaction
+#define I2C_BUS_RECOVER_AFTER 3        // consecutive failures before a bus clear
+#define I2C_BUS_CLEAR_PULSES 9
+
+enum I2CStatus {
+    I2C_OK = 0,
+    I2C_BUSY,      // lock not acquired in time
+    I2C_NACK,      // address or data not acknowledged
+    I2C_TIMEOUT,   // transaction exceeded I2C_BUS_TIMEOUT_MS
+    I2C_SHORT_READ,
+    I2C_ERROR
+};
+
+// Per-device transaction statistics
+struct I2CDeviceStats {
+    uint8_t address;
+    uint32_t transactions;
+    uint32_t errors;
+    uint32_t timeouts;
+    uint32_t recoveries;
+    uint32_t consecutiveErrors;
+    uint32_t lastUs;
+    uint32_t maxUs;
+    uint64_t totalUs;
+};
+
+// Owns the I2C peripheral. Every transaction from any task or core is
+// serialized through one mutex and timed; a device that keeps failing gets a
+// bus clear (SCL pulses + STOP) instead of a full Wire teardown.
+class I2CBus {
+public:
+    I2CBus(TwoWire& wire = Wire);
+
+    bool begin(int sdaPin, int sclPin, uint32_t frequency);
+    bool isReady() const { return initialized; }
+
+    I2CStatus writeReg(uint8_t addr, uint8_t reg, uint8_t value);
+    I2CStatus readReg(uint8_t addr, uint8_t reg, uint8_t& value);
+    I2CStatus readRegs(uint8_t addr, uint8_t reg, uint8_t* data, size_t count);
+    I2CStatus probe(uint8_t addr);
+
+    // Releases a slave holding SDA low and re-arms the controller.
+    bool recover();
+
+    const I2CDeviceStats* getStats(uint8_t addr) const;
+    uint32_t getBusRecoveries() const { return busRecoveries; }
+    void resetStats();
+    void printStats() const;
+
+    static const char* statusName(I2CStatus status);
+
+private:
+    TwoWire* wire;
+    StaticMutex mutexStorage;
+    SemaphoreHandle_t mutex;
+    bool initialized;
+    int sda;
+    int scl;
+    uint32_t frequency;
+    uint32_t busRecoveries;
+    I2CDeviceStats devices[I2C_BUS_MAX_DEVICES];
+    size_t deviceCount;
+
+    bool lock();
+    void unlock();
+    I2CDeviceStats* statsFor(uint8_t addr);
+    I2CStatus finish(I2CDeviceStats* stats, uint32_t startUs, I2CStatus status);
+    I2CStatus endTransmissionStatus(uint8_t result) const;
+    bool clearBus();
+};
+
+// Global bus on the glove's IMU pins
+extern I2CBus i2cBus;
+
+#endif // I2C_BUS_H
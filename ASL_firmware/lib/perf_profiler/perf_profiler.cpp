@@ -23,9 +23,9 @@ void PerformanceProfiler::initializeMarkerNames() {
     markerNames[MARKER_IMU_UPDATE] = "IMU_Update";
     markerNames[MARKER_FINGER_UPDATE] = "FingerUpdate";
     markerNames[MARKER_WINDOW_BUILD] = "WindowBuild";
-    markerNames[MARKER_CUSTOM_1] = "Custom1";
-    markerNames[MARKER_CUSTOM_2] = "Custom2";
-    markerNames[MARKER_CUSTOM_3] = "Custom3";
+    markerNames[MARKER_DEADLINE_MISS] = "DeadlineMiss";
+    markerNames[MARKER_QUEUE_OVERFLOW] = "QueueOverflow";
+    markerNames[MARKER_TEMPLATE_MATCH] = "TemplateMatch";
     markerNames[MARKER_CUSTOM_4] = "Custom4";
     markerNames[MARKER_CUSTOM_5] = "Custom5";
     markerNames[MARKER_CUSTOM_6] = "Custom6";
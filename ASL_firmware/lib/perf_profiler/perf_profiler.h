@@ -19,9 +19,9 @@ enum ProfilingMarker {
     MARKER_IMU_UPDATE,
     MARKER_FINGER_UPDATE,
     MARKER_WINDOW_BUILD,
-    MARKER_CUSTOM_1,
-    MARKER_CUSTOM_2,
-    MARKER_CUSTOM_3,
+    MARKER_DEADLINE_MISS,    // zero-length events from the task supervisor
+    MARKER_QUEUE_OVERFLOW,
+    MARKER_TEMPLATE_MATCH,
     MARKER_CUSTOM_4,
     MARKER_CUSTOM_5,
     MARKER_CUSTOM_6
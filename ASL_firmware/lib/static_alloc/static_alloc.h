@@ -0,0 +1,67 @@
+#ifndef STATIC_ALLOC_H
+#define STATIC_ALLOC_H
+
+#include <Arduino.h>
+#include <freertos/FreeRTOS.h>
+#include <freertos/queue.h>
+#include <freertos/semphr.h>
+#include <freertos/task.h>
+
+// Storage for FreeRTOS objects that live for the whole uptime. Declared as
+// globals or members of global objects, they land in internal .bss, so the
+// linker accounts for them (see scripts/memory_report.py) and the heap only
+// serves the few remaining runtime allocations. Nothing here is ever freed.
+//
+// ESP-IDF counts stack depth in bytes (StackType_t is uint8_t), so StackBytes
+// is both the array length and the depth passed to the kernel.
+
+template <uint32_t StackBytes>
+class StaticTask {
+public:
+    TaskHandle_t start(TaskFunction_t fn, const char* name, void* arg, UBaseType_t priority, BaseType_t core) {
+        if (!handle) {
+            handle = xTaskCreateStaticPinnedToCore(fn, name, StackBytes, arg, priority, stack, &tcb, core);
+        }
+        return handle;
+    }
+    TaskHandle_t get() const { return handle; }
+
+private:
+    StackType_t stack[StackBytes / sizeof(StackType_t)];
+    StaticTask_t tcb;
+    TaskHandle_t handle = nullptr;
+};
+
+template <typename T, size_t Length>
+class StaticQueue {
+public:
+    QueueHandle_t create() {
+        if (!handle) {
+            handle = xQueueCreateStatic(Length, sizeof(T), storage, &control);
+        }
+        return handle;
+    }
+    QueueHandle_t get() const { return handle; }
+
+private:
+    uint8_t storage[Length * sizeof(T)];
+    StaticQueue_t control;
+    QueueHandle_t handle = nullptr;
+};
+
+class StaticMutex {
+public:
+    SemaphoreHandle_t create() {
+        if (!handle) {
+            handle = xSemaphoreCreateMutexStatic(&control);
+        }
+        return handle;
+    }
+    SemaphoreHandle_t get() const { return handle; }
+
+private:
+    StaticSemaphore_t control;
+    SemaphoreHandle_t handle = nullptr;
+};
+
+#endif // STATIC_ALLOC_H
@@ -0,0 +1,232 @@
+#include "task_supervisor.h"
+
+#include "perf_profiler.h"
+
+TaskSupervisor taskSupervisor;
+
+namespace {
+
+// Upper edges of the jitter histogram bins (us); the last bin is open-ended
+const uint32_t kJitterEdgesUs[SUPERVISOR_JITTER_BINS - 1] = {100, 250, 500, 1000, 2000, 5000};
+
+int jitterBin(uint32_t jitterUs) {
+    for (int i = 0; i < SUPERVISOR_JITTER_BINS - 1; i++) {
+        if (jitterUs < kJitterEdgesUs[i]) return i;
+    }
+    return SUPERVISOR_JITTER_BINS - 1;
+}
+
+}  // namespace
+
+TaskSupervisor::TaskSupervisor()
+    : taskCount(0), queueCount(0), currentLevel(DEGRADE_NONE), actionMask(SUPERVISOR_DEFAULT_ACTIONS),
+      lastMissTotal(0), windowMisses(0), cleanWindows(0), levelChanges(0), task(nullptr) {
+    memset(tasks, 0, sizeof(tasks));
+    memset(queues, 0, sizeof(queues));
+}
+
+bool TaskSupervisor::begin() {
+    if (task) return true;
+    task = taskStorage.start(taskEntry, "Supervisor", this, SUPERVISOR_TASK_PRIORITY, SUPERVISOR_TASK_CORE);
+    return task != nullptr;
+}
+
+int TaskSupervisor::addTask(const char* name, uint32_t periodMs, uint32_t deadlineMs) {
+    if (taskCount >= SUPERVISOR_MAX_TASKS) return -1;
+    TaskHealth& health = tasks[taskCount];
+    memset(&health, 0, sizeof(health));
+    health.name = name;
+    health.periodUs = periodMs * 1000;
+    health.deadlineUs = deadlineMs * 1000;
+    return taskCount++;
+}
+
+int TaskSupervisor::addQueue(const char* name, QueueHandle_t queue) {
+    if (queueCount >= SUPERVISOR_MAX_QUEUES || !queue) return -1;
+    QueueHealth& health = queues[queueCount];
+    memset(&health, 0, sizeof(health));
+    health.name = name;
+    health.handle = queue;
+    health.capacity = uxQueueMessagesWaiting(queue) + uxQueueSpacesAvailable(queue);
+    return queueCount++;
+}
+
+void TaskSupervisor::cycleStart(int id) {
+    if (id < 0 || id >= taskCount) return;
+    TaskHealth& health = tasks[id];
+    const uint32_t now = micros();
+    health.cycleStartUs = now;
+
+    if (health.periodUs && health.cycles > 0) {
+        const uint32_t interval = now - health.lastStartUs;
+        const uint32_t jitter = interval > health.periodUs ? interval - health.periodUs : health.periodUs - interval;
+        health.jitterBins[jitterBin(jitter)]++;
+        if (jitter > health.maxJitterUs) health.maxJitterUs = jitter;
+        if (interval > health.periodUs + health.periodUs * SUPERVISOR_PERIOD_SLACK_PCT / 100) {
+            health.periodMisses++;
+            perfProfiler.markEvent(MARKER_DEADLINE_MISS);
+        }
+    }
+    health.lastStartUs = now;
+    health.cycles++;
+}
+
+void TaskSupervisor::cycleEnd(int id) {
+    if (id < 0 || id >= taskCount) return;
+    TaskHealth& health = tasks[id];
+    const uint32_t exec = micros() - health.cycleStartUs;
+    if (exec > health.maxExecUs) health.maxExecUs = exec;
+    if (health.deadlineUs && exec > health.deadlineUs) {
+        health.deadlineMisses++;
+        perfProfiler.markEvent(MARKER_DEADLINE_MISS);
+    }
+}
+
+void TaskSupervisor::noteSkipped(int id, uint32_t count) {
+    if (id < 0 || id >= taskCount || count == 0) return;
+    tasks[id].skipped += count;
+}
+
+bool TaskSupervisor::send(int id, const void* item, TickType_t wait) {
+    if (id < 0 || id >= queueCount) return false;
+    QueueHealth& health = queues[id];
+    if (xQueueSend(health.handle, item, wait) != pdPASS) {
+        health.overflows++;
+        perfProfiler.markEvent(MARKER_QUEUE_OVERFLOW);
+        return false;
+    }
+    health.sent++;
+    const uint32_t depth = uxQueueMessagesWaiting(health.handle);
+    if (depth > health.highWater) health.highWater = depth;
+    return true;
+}
+
+uint32_t TaskSupervisor::missTotal() const {
+    uint32_t total = 0;
+    for (int i = 0; i < taskCount; i++) {
+        total += tasks[i].periodMisses + tasks[i].deadlineMisses + tasks[i].skipped;
+    }
+    for (int i = 0; i < queueCount; i++) {
+        total += queues[i].overflows;
+    }
+    return total;
+}
+
+// Next level in the given direction whose action is enabled (NONE is always
+// reachable going down); returns from when there is none.
+DegradeLevel TaskSupervisor::stepFrom(DegradeLevel from, int direction) const {
+    int level = (int)from + direction;
+    while (level > DEGRADE_NONE && level < DEGRADE_LEVEL_COUNT) {
+        if (actionMask & DEGRADE_ACTION_BIT(level)) return (DegradeLevel)level;
+        level += direction;
+    }
+    return level <= DEGRADE_NONE ? DEGRADE_NONE : from;
+}
+
+void TaskSupervisor::evaluate() {
+    const uint32_t total = missTotal();
+    // reset() can run between windows; count from zero then
+    windowMisses = total >= lastMissTotal ? total - lastMissTotal : total;
+    lastMissTotal = total;
+
+    DegradeLevel next = currentLevel;
+    if (windowMisses >= SUPERVISOR_ESCALATE_MISSES) {
+        cleanWindows = 0;
+        next = stepFrom(currentLevel, +1);
+    } else if (windowMisses == 0 && currentLevel != DEGRADE_NONE) {
+        if (++cleanWindows >= SUPERVISOR_RECOVER_WINDOWS) {
+            cleanWindows = 0;
+            next = stepFrom(currentLevel, -1);
+        }
+    } else {
+        cleanWindows = 0;
+    }
+
+    if (next != currentLevel) {
+        Serial.printf("[SUPERVISOR] %s -> %s (%u misses in %u ms)\n", levelName(currentLevel), levelName(next),
+                      (unsigned)windowMisses, (unsigned)SUPERVISOR_WINDOW_MS);
+        currentLevel = next;
+        levelChanges++;
+    }
+}
+
+void TaskSupervisor::reset() {
+    for (int i = 0; i < taskCount; i++) {
+        TaskHealth& health = tasks[i];
+        health.cycles = 0;
+        health.periodMisses = 0;
+        health.deadlineMisses = 0;
+        health.skipped = 0;
+        health.maxExecUs = 0;
+        health.maxJitterUs = 0;
+        memset(health.jitterBins, 0, sizeof(health.jitterBins));
+    }
+    for (int i = 0; i < queueCount; i++) {
+        queues[i].sent = 0;
+        queues[i].overflows = 0;
+        queues[i].highWater = 0;
+    }
+    lastMissTotal = 0;
+    windowMisses = 0;
+    cleanWindows = 0;
+}
+
+const char* TaskSupervisor::levelName(DegradeLevel level) {
+    switch (level) {
+        case DEGRADE_NONE: return "NORMAL";
+        case DEGRADE_SHED_DEBUG: return "SHED_DEBUG";
+        case DEGRADE_DECIMATE_INFERENCE: return "DECIMATE_INFERENCE";
+        case DEGRADE_DROP_LOGGING: return "DROP_LOGGING";
+        default: return "?";
+    }
+}
+
+void TaskSupervisor::printReport() const {
+    Serial.println("\n[SUPERVISOR] Task Health");
+    Serial.println("=================================================");
+    Serial.printf("Level: %s (%u changes), last window: %u misses\n", levelName(currentLevel),
+                  (unsigned)levelChanges, (unsigned)windowMisses);
+    Serial.print("Enabled actions:");
+    for (int level = DEGRADE_SHED_DEBUG; level < DEGRADE_LEVEL_COUNT; level++) {
+        if (actionMask & DEGRADE_ACTION_BIT(level)) {
+            Serial.printf(" %s", levelName((DegradeLevel)level));
+        }
+    }
+    Serial.println();
+    Serial.println("Task           | Cycles | PeriodMiss | DeadlineMiss | Skipped | MaxExec(us) | MaxJitter(us)");
+    Serial.println("---------------|--------|------------|--------------|---------|-------------|--------------");
+    for (int i = 0; i < taskCount; i++) {
+        const TaskHealth& health = tasks[i];
+        Serial.printf("%-14s | %6u | %10u | %12u | %7u | %11u | %13u\n", health.name, (unsigned)health.cycles,
+                      (unsigned)health.periodMisses, (unsigned)health.deadlineMisses, (unsigned)health.skipped,
+                      (unsigned)health.maxExecUs, (unsigned)health.maxJitterUs);
+    }
+
+    Serial.println("\nJitter (us)    |  <100 |  <250 |  <500 | <1000 | <2000 | <5000 | >=5000");
+    for (int i = 0; i < taskCount; i++) {
+        const TaskHealth& health = tasks[i];
+        if (!health.periodUs) continue;
+        Serial.printf("%-14s", health.name);
+        for (int bin = 0; bin < SUPERVISOR_JITTER_BINS; bin++) {
+            Serial.printf(" | %5u", (unsigned)health.jitterBins[bin]);
+        }
+        Serial.println();
+    }
+
+    Serial.println("\nQueue          |   Sent | Overflows | HighWater");
+    for (int i = 0; i < queueCount; i++) {
+        const QueueHealth& health = queues[i];
+        Serial.printf("%-14s | %6u | %9u | %4u/%-4u\n", health.name, (unsigned)health.sent,
+                      (unsigned)health.overflows, (unsigned)health.highWater, (unsigned)health.capacity);
+    }
+    Serial.println("=================================================\n");
+}
+
+void TaskSupervisor::taskEntry(void* param) {
+    TaskSupervisor* supervisor = static_cast<TaskSupervisor*>(param);
+    TickType_t lastWake = xTaskGetTickCount();
+    while (true) {
+        vTaskDelayUntil(&lastWake, pdMS_TO_TICKS(SUPERVISOR_WINDOW_MS));
+        supervisor->evaluate();
+    }
+}
@@ -0,0 +1,136 @@
+#ifndef TASK_SUPERVISOR_H
+#define TASK_SUPERVISOR_H
+
+#include <Arduino.h>
+#include <freertos/FreeRTOS.h>
+#include <freertos/queue.h>
+#include <freertos/task.h>
+
+#include "static_alloc.h"
+
+// Configuration
+#define SUPERVISOR_MAX_TASKS 4
+#define SUPERVISOR_MAX_QUEUES 4
+#define SUPERVISOR_JITTER_BINS 7
+#define SUPERVISOR_WINDOW_MS 1000
+#define SUPERVISOR_ESCALATE_MISSES 3     // misses in one window to degrade a step
+#define SUPERVISOR_RECOVER_WINDOWS 5     // clean windows in a row to recover a step
+#define SUPERVISOR_PERIOD_SLACK_PCT 50   // a period over 150% of nominal is a miss
+#define SUPERVISOR_DECIMATION 2          // run inference on every Nth sample when decimating
+#define SUPERVISOR_TASK_STACK 3072
+#define SUPERVISOR_TASK_PRIORITY 1
+#define SUPERVISOR_TASK_CORE 1
+
+// Degradation steps, mildest first. Each level keeps the actions of the
+// levels below it.
+enum DegradeLevel {
+    DEGRADE_NONE = 0,
+    DEGRADE_SHED_DEBUG,          // drop debug output
+    DEGRADE_DECIMATE_INFERENCE,  // classify every SUPERVISOR_DECIMATION samples
+    DEGRADE_DROP_LOGGING,        // skip CSV rows (timestamps show the gap)
+    DEGRADE_LEVEL_COUNT
+};
+
+#define DEGRADE_ACTION_BIT(level) (1UL << (level))
+#define SUPERVISOR_DEFAULT_ACTIONS                                         \
+    (DEGRADE_ACTION_BIT(DEGRADE_SHED_DEBUG) |                              \
+     DEGRADE_ACTION_BIT(DEGRADE_DECIMATE_INFERENCE) |                      \
+     DEGRADE_ACTION_BIT(DEGRADE_DROP_LOGGING))
+
+struct TaskHealth {
+    const char* name;
+    uint32_t periodUs;                   // 0 for event-driven tasks
+    uint32_t deadlineUs;                 // allowed execution time per cycle
+    uint32_t cycleStartUs;
+    uint32_t lastStartUs;
+    uint32_t cycles;
+    uint32_t periodMisses;
+    uint32_t deadlineMisses;
+    uint32_t skipped;                    // work items coalesced or dropped
+    uint32_t maxExecUs;
+    uint32_t maxJitterUs;
+    uint32_t jitterBins[SUPERVISOR_JITTER_BINS];
+};
+
+struct QueueHealth {
+    const char* name;
+    QueueHandle_t handle;
+    uint32_t capacity;
+    uint32_t sent;
+    uint32_t overflows;
+    uint32_t highWater;
+};
+
+// Watches the real-time tasks for overruns. A monitored task brackets each
+// cycle with cycleStart()/cycleEnd(). That gives the period jitter
+// histogram, period misses (the cycle started late enough to lose a sample
+// slot) and deadline misses (the work took longer than its budget).
+// Producers send through send() so queue overflows are counted too.
+//
+// Every SUPERVISOR_WINDOW_MS a low-priority task totals the new misses. Too
+// many misses move one step down the degradation ladder; a run of clean
+// windows moves back up. Steps whose action is disabled are skipped. Misses
+// also show up as profiler events (MARKER_DEADLINE_MISS,
+// MARKER_QUEUE_OVERFLOW).
+//
+// Each counter has a single writer (the monitored task or the producer), so
+// the hot path takes no locks.
+class TaskSupervisor {
+public:
+    TaskSupervisor();
+
+    bool begin();
+
+    // Returns an ID for cycleStart()/cycleEnd(), or -1 when full.
+    int addTask(const char* name, uint32_t periodMs, uint32_t deadlineMs);
+    // Returns an ID for send(), or -1 when full.
+    int addQueue(const char* name, QueueHandle_t queue);
+
+    void cycleStart(int id);
+    void cycleEnd(int id);
+    void noteSkipped(int id, uint32_t count);
+    bool send(int id, const void* item, TickType_t wait);
+
+    DegradeLevel level() const { return currentLevel; }
+    bool isActive(DegradeLevel action) const {
+        return currentLevel >= action && (actionMask & DEGRADE_ACTION_BIT(action));
+    }
+    bool shedDebug() const { return isActive(DEGRADE_SHED_DEBUG); }
+    uint32_t inferenceDecimation() const {
+        return isActive(DEGRADE_DECIMATE_INFERENCE) ? SUPERVISOR_DECIMATION : 1;
+    }
+    bool dropLogging() const { return isActive(DEGRADE_DROP_LOGGING); }
+
+    void setActions(uint32_t mask) { actionMask = mask; }
+    uint32_t getActions() const { return actionMask; }
+
+    // Closes one window and adjusts the level; called by the supervisor task.
+    void evaluate();
+    void printReport() const;
+    void reset();
+
+    static const char* levelName(DegradeLevel level);
+
+private:
+    TaskHealth tasks[SUPERVISOR_MAX_TASKS];
+    QueueHealth queues[SUPERVISOR_MAX_QUEUES];
+    int taskCount;
+    int queueCount;
+    volatile DegradeLevel currentLevel;
+    volatile uint32_t actionMask;
+    uint32_t lastMissTotal;
+    uint32_t windowMisses;
+    uint32_t cleanWindows;
+    uint32_t levelChanges;
+    StaticTask<SUPERVISOR_TASK_STACK> taskStorage;
+    TaskHandle_t task;
+
+    uint32_t missTotal() const;
+    DegradeLevel stepFrom(DegradeLevel from, int direction) const;
+
+    static void taskEntry(void* param);
+};
+
+extern TaskSupervisor taskSupervisor;
+
+#endif // TASK_SUPERVISOR_H
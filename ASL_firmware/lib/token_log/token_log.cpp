@@ -0,0 +1,190 @@
+#include "token_log.h"
+
+#include <algorithm>
+
+TokenLog tokenLog;
+
+namespace {
+
+const uint32_t kRingMask = TOKEN_LOG_RING_SLOTS - 1;
+static_assert((TOKEN_LOG_RING_SLOTS & kRingMask) == 0, "ring size must be a power of two");
+
+// Appends one printf conversion to out, reading its argument from the words.
+size_t formatArg(char* out, size_t space, const char* spec, char conv, const uint32_t* words, size_t& w,
+                 size_t count) {
+    if (conv == 's') {
+        char str[TOKEN_LOG_STRING_WORDS * 4];
+        const size_t avail = w < count ? std::min((size_t)TOKEN_LOG_STRING_WORDS, count - w) : 0;
+        memcpy(str, &words[w], avail * 4);
+        str[avail > 0 ? avail * 4 - 1 : 0] = '\0';
+        w += TOKEN_LOG_STRING_WORDS;
+        return snprintf(out, space, spec, str);
+    }
+    const uint32_t word = w < count ? words[w] : 0;
+    w++;
+    switch (conv) {
+        case 'f': case 'F': case 'e': case 'E': case 'g': case 'G': {
+            float f;
+            memcpy(&f, &word, sizeof(f));
+            return snprintf(out, space, spec, (double)f);
+        }
+        case 'd': case 'i': case 'c':
+            return snprintf(out, space, spec, (int)word);
+        default:
+            return snprintf(out, space, spec, (unsigned)word);
+    }
+}
+
+}  // namespace
+
+TokenLog::TokenLog()
+    : formats(nullptr), formatCount(0), binaryOutput(false), task(nullptr), reportedDrops(0) {
+    for (int c = 0; c < TOKEN_LOG_CORES; c++) {
+        rings[c].head.store(0);
+        rings[c].tail.store(0);
+        rings[c].dropped.store(0);
+        for (size_t i = 0; i < TOKEN_LOG_RING_SLOTS; i++) {
+            rings[c].slots[i].seq.store(0);
+        }
+    }
+}
+
+bool TokenLog::begin(const char* const* formatTable, size_t count) {
+    formats = formatTable;
+    formatCount = count;
+    if (task) return true;
+    task = taskStorage.start(taskEntry, "TokenLog", this, TOKEN_LOG_TASK_PRIORITY, TOKEN_LOG_TASK_CORE);
+    return task != nullptr;
+}
+
+uint32_t TokenLog::getDropped() const {
+    uint32_t total = 0;
+    for (int c = 0; c < TOKEN_LOG_CORES; c++) {
+        total += rings[c].dropped.load(std::memory_order_relaxed);
+    }
+    return total;
+}
+
+void TokenLog::pack(uint32_t* words, size_t& n, const char* str) {
+    char buf[TOKEN_LOG_STRING_WORDS * 4] = {0};
+    if (str) strncpy(buf, str, sizeof(buf) - 1);
+    for (int i = 0; i < TOKEN_LOG_STRING_WORDS && n < TOKEN_LOG_MAX_WORDS; i++) {
+        memcpy(&words[n++], &buf[i * 4], 4);
+    }
+}
+
+// Hot path: one CAS to reserve, a copy, one release store to publish.
+void TokenLog::commit(uint16_t id, const uint32_t* words, size_t count) {
+    const uint32_t now = micros();
+    Ring& ring = rings[xPortGetCoreID() % TOKEN_LOG_CORES];
+
+    uint32_t head = ring.head.load(std::memory_order_relaxed);
+    do {
+        if (head - ring.tail.load(std::memory_order_acquire) >= TOKEN_LOG_RING_SLOTS) {
+            ring.dropped.fetch_add(1, std::memory_order_relaxed);
+            return;
+        }
+    } while (!ring.head.compare_exchange_weak(head, head + 1, std::memory_order_acq_rel,
+                                              std::memory_order_relaxed));
+
+    TokenLogRecord& rec = ring.slots[head & kRingMask];
+    rec.entry.id = id;
+    rec.entry.core = (uint8_t)(&ring - rings);
+    rec.entry.words = (uint8_t)count;
+    rec.entry.timestampUs = now;
+    memcpy(rec.entry.args, words, count * sizeof(uint32_t));
+    rec.seq.store(head + 1, std::memory_order_release);
+}
+
+void TokenLog::drain() {
+    for (int c = 0; c < TOKEN_LOG_CORES; c++) {
+        Ring& ring = rings[c];
+        uint32_t tail = ring.tail.load(std::memory_order_relaxed);
+        while (tail != ring.head.load(std::memory_order_acquire)) {
+            const TokenLogRecord& rec = ring.slots[tail & kRingMask];
+            // Reserved but not yet published: pick it up on the next pass
+            if (rec.seq.load(std::memory_order_acquire) != tail + 1) break;
+            const TokenLogEntry entry = rec.entry;
+            ring.tail.store(++tail, std::memory_order_release);
+
+            if (binaryOutput) {
+                emitBinary(entry);
+            } else {
+                emitText(entry);
+            }
+        }
+    }
+
+    const uint32_t dropped = getDropped();
+    if (dropped != reportedDrops) {
+        Serial.printf("[LOG] %u records dropped (ring full)\n", (unsigned)(dropped - reportedDrops));
+        reportedDrops = dropped;
+    }
+}
+
+void TokenLog::emitText(const TokenLogEntry& entry) {
+    if (!formats || entry.id >= formatCount) {
+        Serial.printf("[LOG] unknown id %u\n", (unsigned)entry.id);
+        return;
+    }
+
+    char line[192];
+    size_t len = 0;
+    size_t w = 0;
+    const char* p = formats[entry.id];
+    while (*p && len < sizeof(line) - 1) {
+        if (*p != '%') {
+            line[len++] = *p++;
+            continue;
+        }
+        if (p[1] == '%') {
+            line[len++] = '%';
+            p += 2;
+            continue;
+        }
+        // Copy the conversion spec without length modifiers (all words are 32-bit)
+        char spec[16];
+        size_t s = 0;
+        spec[s++] = *p++;
+        while (*p && !strchr("diouxXcfFeEgGs", *p) && s < sizeof(spec) - 2) {
+            if (!strchr("lhzjt", *p)) spec[s++] = *p;
+            p++;
+        }
+        if (!*p) break;
+        const char conv = *p++;
+        spec[s++] = conv;
+        spec[s] = '\0';
+        const size_t n = formatArg(line + len, sizeof(line) - len, spec, conv, entry.args, w, entry.words);
+        len = std::min(len + n, sizeof(line) - 1);
+    }
+    line[len] = '\0';
+    Serial.print(line);
+}
+
+void TokenLog::emitBinary(const TokenLogEntry& entry) {
+    uint8_t frame[2 + 8 + TOKEN_LOG_MAX_WORDS * 4 + 1];
+    size_t n = 0;
+    frame[n++] = TOKEN_LOG_SYNC0;
+    frame[n++] = TOKEN_LOG_SYNC1;
+    const size_t body = n;
+    frame[n++] = entry.id & 0xFF;
+    frame[n++] = entry.id >> 8;
+    frame[n++] = entry.core;
+    frame[n++] = entry.words;
+    memcpy(&frame[n], &entry.timestampUs, 4);
+    n += 4;
+    memcpy(&frame[n], entry.args, entry.words * 4);
+    n += entry.words * 4;
+    uint8_t check = 0;
+    for (size_t i = body; i < n; i++) check ^= frame[i];
+    frame[n++] = check;
+    Serial.write(frame, n);
+}
+
+void TokenLog::taskEntry(void* param) {
+    TokenLog* log = static_cast<TokenLog*>(param);
+    while (true) {
+        log->drain();
+        vTaskDelay(pdMS_TO_TICKS(TOKEN_LOG_DRAIN_PERIOD_MS));
+    }
+}
@@ -0,0 +1,112 @@
+#ifndef TOKEN_LOG_H
+#define TOKEN_LOG_H
+
+#include <Arduino.h>
+#include <atomic>
+#include <type_traits>
+
+#include "static_alloc.h"
+
+// Configuration
+#define TOKEN_LOG_CORES 2
+#define TOKEN_LOG_RING_SLOTS 32          // per core, power of two
+#define TOKEN_LOG_MAX_WORDS 12           // argument words per record
+#define TOKEN_LOG_STRING_WORDS 3         // a %s argument: up to 11 chars inline
+#define TOKEN_LOG_DRAIN_PERIOD_MS 20
+#define TOKEN_LOG_TASK_STACK 3072
+#define TOKEN_LOG_TASK_PRIORITY 1
+#define TOKEN_LOG_TASK_CORE 1
+
+// Binary frame: sync bytes, then id u16, core u8, word count u8, timestamp
+// u32 (us), the argument words and an XOR checksum, all little-endian.
+#define TOKEN_LOG_SYNC0 0xA5
+#define TOKEN_LOG_SYNC1 0x5A
+
+struct TokenLogEntry {
+    uint16_t id;
+    uint8_t core;
+    uint8_t words;
+    uint32_t timestampUs;
+    uint32_t args[TOKEN_LOG_MAX_WORDS];
+};
+
+struct TokenLogRecord {
+    std::atomic<uint32_t> seq;           // ring position + 1 once committed
+    TokenLogEntry entry;
+};
+
+// Deferred-format logging. A call site stores a format ID and its raw
+// arguments (floats as IEEE bits, integers as 32-bit words, short strings
+// inline) in its core's ring and returns; formatting happens later in a
+// low-priority drain task. Output is either the rendered text, or compact
+// binary frames decoded on the host against the same format table
+// (python/src/decode_log.py), so debug output can stay on in production.
+//
+// Producers reserve a slot with one compare-and-swap and never block; a full
+// ring drops the record and counts it.
+class TokenLog {
+public:
+    TokenLog();
+
+    bool begin(const char* const* formats, size_t formatCount);
+    bool isReady() const { return task != nullptr; }
+
+    void setBinary(bool enabled) { binaryOutput = enabled; }
+    bool isBinary() const { return binaryOutput; }
+    uint32_t getDropped() const;
+
+    template <typename... Args>
+    void write(uint16_t id, Args... args) {
+        static_assert(sizeof...(Args) <= TOKEN_LOG_MAX_WORDS, "too many log arguments");
+        uint32_t words[TOKEN_LOG_MAX_WORDS];
+        size_t n = 0;
+        // Expands to one pack() per argument, in order
+        int expand[] = {0, (pack(words, n, args), 0)...};
+        (void)expand;
+        commit(id, words, n);
+    }
+
+    // Drains both rings once; called by the drain task.
+    void drain();
+
+private:
+    struct Ring {
+        TokenLogRecord slots[TOKEN_LOG_RING_SLOTS];
+        std::atomic<uint32_t> head;
+        std::atomic<uint32_t> tail;
+        std::atomic<uint32_t> dropped;
+    };
+
+    Ring rings[TOKEN_LOG_CORES];
+    const char* const* formats;
+    size_t formatCount;
+    volatile bool binaryOutput;
+    StaticTask<TOKEN_LOG_TASK_STACK> taskStorage;
+    TaskHandle_t task;
+    uint32_t reportedDrops;
+
+    void commit(uint16_t id, const uint32_t* words, size_t count);
+    void emitText(const TokenLogEntry& entry);
+    void emitBinary(const TokenLogEntry& entry);
+
+    template <typename T>
+    static void pack(uint32_t* words, size_t& n, T value) {
+        if (n >= TOKEN_LOG_MAX_WORDS) return;
+        if (std::is_floating_point<T>::value) {
+            const float f = static_cast<float>(value);
+            memcpy(&words[n++], &f, sizeof(f));
+        } else {
+            words[n++] = static_cast<uint32_t>(value);
+        }
+    }
+    static void pack(uint32_t* words, size_t& n, const char* str);
+    static void pack(uint32_t* words, size_t& n, char* str) { pack(words, n, (const char*)str); }
+
+    static void taskEntry(void* param);
+};
+
+extern TokenLog tokenLog;
+
+#define TLOG(id, ...) tokenLog.write(static_cast<uint16_t>(id), ##__VA_ARGS__)
+
+#endif // TOKEN_LOG_H
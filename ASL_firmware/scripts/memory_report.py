@@ -0,0 +1,246 @@
+"""Static memory report for the firmware image.
+
+Parses the linker map and prints how many bytes each subsystem places in each
+memory region (internal DRAM/IRAM, PSRAM, flash, RTC), the largest RAM
+objects, and the used/free size of every region, so a new feature can be
+checked against what is left.
+
+Runs after every `pio run` as a PlatformIO post script (see platformio.ini),
+or by hand on an existing map:
+
+    python scripts/memory_report.py .pio/build/esp32-s3-devkitc-1/firmware.map
+"""
+
+import argparse
+import json
+import re
+import shutil
+import subprocess
+import sys
+from collections import defaultdict
+from pathlib import Path
+from typing import Dict, List, Optional, Tuple
+
+# Output-section prefix -> region shown in the report
+REGIONS = [
+    (".dram0.", "DRAM"),
+    (".noinit", "DRAM"),
+    (".iram0.", "IRAM"),
+    (".ext_ram", "PSRAM"),
+    (".flash.", "Flash"),
+    (".rtc", "RTC"),
+]
+REGION_ORDER = ["DRAM", "IRAM", "PSRAM", "Flash", "RTC"]
+RAM_REGIONS = {"DRAM", "IRAM", "PSRAM"}
+
+# Memory Configuration segment -> region, for the capacity column
+SEGMENTS = {
+    "dram0_0_seg": "DRAM",
+    "iram0_0_seg": "IRAM",
+    "extern_ram_seg": "PSRAM",
+    "drom_seg": "Flash",
+    "irom_seg": "Flash",
+    "rtc_slow_seg": "RTC",
+}
+
+_OUTPUT_RE = re.compile(r"^(\.\S+)(?:\s+0x([0-9a-fA-F]+)\s+0x([0-9a-fA-F]+))?")
+_INPUT_RE = re.compile(r"^ (\S+)(?:\s+0x([0-9a-fA-F]+)\s+0x([0-9a-fA-F]+)\s*(.*))?$")
+_WRAPPED_RE = re.compile(r"^\s+0x([0-9a-fA-F]+)\s+0x([0-9a-fA-F]+)\s+(.+)$")
+_SEGMENT_RE = re.compile(r"^(\S+)\s+0x([0-9a-fA-F]+)\s+0x([0-9a-fA-F]+)")
+_PIO_LIB_RE = re.compile(r"[/\\]lib[0-9a-fA-F]{3}[/\\](?:lib)?([^/\\(]+?)(?:\.a\(|[/\\])")
+
+
+def region_for(section: str) -> Optional[str]:
+    for prefix, region in REGIONS:
+        if section.startswith(prefix):
+            return region
+    return None
+
+
+def subsystem_for(path: str) -> str:
+    """Names the owner of an object file: a lib/ folder, app code, or the SDK."""
+    norm = path.replace("\\", "/")
+    match = _PIO_LIB_RE.search(norm)
+    if match:
+        return match.group(1)
+    if "libFrameworkArduino" in norm:
+        return "arduino-core"
+    if "/toolchain-" in norm or re.search(r"lib(gcc|stdc\+\+|c|m)\.a\(", norm):
+        return "toolchain"
+    if ".a(" in norm:
+        return "esp-idf"
+    if "/src/ml/" in norm or norm.startswith("src/ml/"):
+        return "src/ml"
+    if "/src/" in norm or norm.startswith("src/"):
+        return "src"
+    return "(linker)"
+
+
+def parse_map(text: str) -> Tuple[List[Tuple[str, str, str, int]], Dict[str, int]]:
+    """Returns (region, subsystem, input section, size) rows and segment sizes."""
+    capacity: Dict[str, int] = defaultdict(int)
+    rows = []
+
+    lines = text.splitlines()
+    start = 0
+    if "Memory Configuration" in text:
+        in_config = False
+        for index, line in enumerate(lines):
+            if line.startswith("Memory Configuration"):
+                in_config = True
+                continue
+            if line.startswith("Linker script and memory map"):
+                start = index
+                break
+            if in_config:
+                match = _SEGMENT_RE.match(line)
+                if match and match.group(1) in SEGMENTS:
+                    capacity[SEGMENTS[match.group(1)]] += int(match.group(3), 16)
+
+    region = None
+    pending = None
+    for line in lines[start:]:
+        if not line.strip():
+            continue
+        if pending is not None:
+            wrapped = _WRAPPED_RE.match(line)
+            if wrapped:
+                size = int(wrapped.group(2), 16)
+                if region and size:
+                    rows.append((region, subsystem_for(wrapped.group(3)), pending, size))
+                pending = None
+                continue
+            pending = None
+
+        if not line.startswith(" "):
+            match = _OUTPUT_RE.match(line)
+            region = region_for(match.group(1)) if match else None
+            continue
+        if region is None:
+            continue
+
+        match = _INPUT_RE.match(line)
+        if not match:
+            continue
+        name = match.group(1)
+        if name.startswith("0x"):
+            continue  # symbol line inside an input section
+        if match.group(2) is None:
+            pending = name  # name too long; address, size and file are on the next line
+            continue
+        size = int(match.group(3), 16)
+        if not size:
+            continue
+        owner = "(padding)" if name == "*fill*" else subsystem_for(match.group(4))
+        rows.append((region, owner, name, size))
+    return rows, dict(capacity)
+
+
+def demangle(names: List[str]) -> List[str]:
+    tool = shutil.which("xtensa-esp32s3-elf-c++filt") or shutil.which("c++filt")
+    if not tool or not names:
+        return names
+    try:
+        out = subprocess.run([tool], input="\n".join(names), capture_output=True, text=True, check=True)
+        result = out.stdout.splitlines()
+        return result if len(result) == len(names) else names
+    except (OSError, subprocess.CalledProcessError):
+        return names
+
+
+def symbol_name(section: str) -> str:
+    for prefix in (".bss.", ".data.", ".sbss.", ".sdata.", ".rodata.", ".text.", ".iram1.", ".dram1."):
+        if section.startswith(prefix):
+            return section[len(prefix):]
+    return section
+
+
+def build_report(rows, capacity, top: int) -> dict:
+    totals: Dict[str, Dict[str, int]] = defaultdict(lambda: defaultdict(int))
+    used: Dict[str, int] = defaultdict(int)
+    for region, owner, _, size in rows:
+        totals[owner][region] += size
+        used[region] += size
+
+    largest = sorted((r for r in rows if r[0] in RAM_REGIONS and r[1] != "(padding)"),
+                     key=lambda r: r[3], reverse=True)[:top]
+    names = demangle([symbol_name(r[2]) for r in largest])
+
+    return {
+        "subsystems": {owner: dict(regions) for owner, regions in totals.items()},
+        "regions": {region: {"used": used.get(region, 0), "size": capacity.get(region, 0)}
+                    for region in REGION_ORDER if used.get(region) or capacity.get(region)},
+        "largest_ram_objects": [
+            {"region": r[0], "subsystem": r[1], "symbol": name, "bytes": r[3]}
+            for r, name in zip(largest, names)
+        ],
+    }
+
+
+def print_report(report: dict, out=sys.stdout) -> None:
+    regions = [r for r in REGION_ORDER if r in report["regions"]]
+
+    def write(line: str = "") -> None:
+        print(line, file=out)
+
+    write("\n[MEMORY] Static memory by subsystem (bytes)")
+    header = f"{'Subsystem':<22}" + "".join(f"{r:>10}" for r in regions)
+    write(header)
+    write("-" * len(header))
+    subsystems = report["subsystems"]
+    ram = lambda owner: sum(v for k, v in subsystems[owner].items() if k in RAM_REGIONS)
+    for owner in sorted(subsystems, key=lambda o: (-ram(o), o)):
+        write(f"{owner:<22}" + "".join(f"{subsystems[owner].get(r, 0):>10}" for r in regions))
+
+    write("\n[MEMORY] Regions")
+    for region in regions:
+        info = report["regions"][region]
+        if info["size"]:
+            free = info["size"] - info["used"]
+            write(f"{region:<6} {info['used']:>9} / {info['size']:>9} used, {free:>9} free "
+                  f"({100.0 * info['used'] / info['size']:.1f}%)")
+        else:
+            write(f"{region:<6} {info['used']:>9} used")
+    if "DRAM" in report["regions"] and "IRAM" in report["regions"]:
+        write("DRAM and IRAM share the internal SRAM; whatever neither uses is the runtime heap.")
+
+    write("\n[MEMORY] Largest RAM objects")
+    for item in report["largest_ram_objects"]:
+        write(f"{item['bytes']:>9}  {item['region']:<6} {item['subsystem']:<20} {item['symbol']}")
+    write()
+
+
+def run(map_path: Path, top: int = 15, json_path: Optional[Path] = None) -> dict:
+    rows, capacity = parse_map(map_path.read_text(encoding="utf-8", errors="replace"))
+    report = build_report(rows, capacity, top)
+    print_report(report)
+    if json_path:
+        json_path.write_text(json.dumps(report, indent=2), encoding="utf-8")
+    return report
+
+
+def main() -> int:
+    parser = argparse.ArgumentParser(description="Per-subsystem static memory report from a linker map")
+    parser.add_argument("map", type=Path, help="Linker map file (firmware.map)")
+    parser.add_argument("--top", type=int, default=15, help="How many of the largest RAM objects to list")
+    parser.add_argument("--json", type=Path, help="Also write the report as JSON")
+    args = parser.parse_args()
+    run(args.map, args.top, args.json)
+    return 0
+
+
+try:
+    Import("env")  # noqa: F821 - provided by PlatformIO's SCons environment
+except NameError:
+    env = None
+
+if env is not None:
+    _map = env.subst("$BUILD_DIR/${PROGNAME}.map")
+    env.Append(LINKFLAGS=[f"-Wl,-Map,{_map}"])
+
+    def _after_link(source, target, env):
+        run(Path(_map), json_path=Path(env.subst("$BUILD_DIR/memory_report.json")))
+
+    env.AddPostAction("$BUILD_DIR/${PROGNAME}.elf", _after_link)
+elif __name__ == "__main__":
+    sys.exit(main())
@@ -6,9 +6,18 @@
 
 #include "mpu9250_sensor.h"
 #include "freertos_tasks.h"
-#include "ml/asl_inference.h"
+#include "i2c_bus.h"
+#include "ml/dtw_matcher.h"
+#include "ml/model_router.h"
+#include "ml/prototype_classifier.h"
+#include "audio_cache.h"
 #include "audio_sd.h"
+#include "boot_sequencer.h"
 #include "perf_profiler.h"
+#include "profile_store.h"
+#include "task_supervisor.h"
+#include "text_composer.h"
+#include "token_log.h"
 
 DataLogger dataLogger;
 
@@ -69,7 +78,7 @@ void DataLogger::begin(FingerSensorManager* manager, MPU9250_Sensor* imu, SD_mod
     fingerManager = manager;
     imuSensor = imu;
     sdCard = sd;
-    configMutex = xSemaphoreCreateMutex();
+    configMutex = configMutexStorage.create();
     printHelp();
     Serial.println("[DATA] Press 'p' to set person ID, 'l' to set label, 'g' to start logging.");
 }
@@ -82,13 +91,16 @@ void DataLogger::printHelp() const {
     Serial.println("s - Toggle Shake detection debug output");
     Serial.println("m - Toggle inference debug output");
     Serial.println("x - Toggle TTS/shake-triggered speech");
-    Serial.println("e - Start ML inference");
-    Serial.println("a - Show sensor + logger status");
+    Serial.println("e - Start ML inference (retry if the boot phase failed)");
+    Serial.println("a - Show sensor + logger status and boot timing");
+    Serial.println("b - Show I2C bus statistics");
     Serial.println("u - Run IMU calibration routine");
     Serial.println("c - Show flex calibration info");
     Serial.println("r - Run flex calibration routine");
     Serial.println("n - Show normalized flex values");
     Serial.println("d - Delete TTS cache (clear all .mp3 files)");
+    Serial.println("y - Show audio cache tiers and play counts");
+    Serial.println("z - Toggle binary (tokenized) debug log output");
     Serial.println("p - Set person ID (e.g. P1, P2)");
     Serial.println("l - Set label (A, B, NEUTRAL, SPACE, etc)");
     Serial.println("g - Start/arm data logging (auto starts after label entry)");
@@ -96,6 +108,14 @@ void DataLogger::printHelp() const {
     Serial.println("o - Start performance profiling");
     Serial.println("O - Stop profiling and show statistics");
     Serial.println("j - Export profiling data to VCD file on SD card");
+    Serial.println("k - Show task deadline/jitter/queue health (then reset counters)");
+    Serial.println("< / > - Undo / redo the last edit to the spoken text");
+    Serial.println("* - Toggle the lexicon beam decoder (letters) vs hold-to-commit");
+    Serial.println("+ - Record a word template (type the word, ENTER, then sign it)");
+    Serial.println("- - Delete the templates of a word");
+    Serial.println("= - List recorded word templates");
+    Serial.println("# - Toggle personalized prototypes (taught while logging a label)");
+    Serial.println("! - Forget this person's prototypes");
     Serial.println("q - Quiet mode (disable all debug prints)");
     Serial.println("v - Verbose mode (enable all debug prints)");
     Serial.println("h/? - Show this help menu\n");
@@ -147,9 +167,10 @@ void DataLogger::processSerial(bool imuReady, bool fingersReady, bool wifiReady)
                 break;
             case 'e':
             case 'E':
-                if (aslInference.isReady()) {
+                if (aslRouter.isReady()) {
                     Serial.println("[CMD] Inference already initialized.");
-                } else if (aslInference.begin()) {
+                } else if (aslRouter.begin()) {
+                    aslRouter.setPrototypes(&aslPrototypes);
                     Serial.println("[CMD] Inference initialized.");
                 } else {
                     Serial.println("[CMD] Failed to initialize inference.");
@@ -159,6 +180,10 @@ void DataLogger::processSerial(bool imuReady, bool fingersReady, bool wifiReady)
             case 'A':
                 printStatus(imuReady, fingersReady, wifiReady);
                 break;
+            case 'b':
+            case 'B':
+                i2cBus.printStats();
+                break;
             case 'c':
             case 'C':
                 if (fingerManager) {
@@ -169,10 +194,21 @@ void DataLogger::processSerial(bool imuReady, bool fingersReady, bool wifiReady)
             case 'D':
                 if (sdCard) {
                     sdCard->clearTTSCache();
+                    audioCache.clear();
                 } else {
                     Serial.println("[CMD] SD card not available.");
                 }
                 break;
+            case 'y':
+            case 'Y':
+                audioCache.printStats();
+                break;
+            case 'z':
+            case 'Z':
+                tokenLog.setBinary(!tokenLog.isBinary());
+                Serial.printf("[CMD] Debug log output: %s\n",
+                              tokenLog.isBinary() ? "binary (decode with python/src/decode_log.py)" : "text");
+                break;
             case 'r':
             case 'R':
                 if (fingerManager) {
@@ -245,6 +281,45 @@ void DataLogger::processSerial(bool imuReady, bool fingersReady, bool wifiReady)
                     Serial.println("[CMD] SD card not available for VCD export.");
                 }
                 break;
+            case 'k':
+            case 'K':
+                taskSupervisor.printReport();
+                taskSupervisor.reset();
+                break;
+            case '*':
+                gBeamDecoderEnabled = !gBeamDecoderEnabled;
+                Serial.printf("[CMD] Beam decoder %s\n", gBeamDecoderEnabled ? "ENABLED" : "DISABLED");
+                break;
+            case '+':
+                startInput(InputMode::Template);
+                break;
+            case '-':
+                startInput(InputMode::RemoveTemplate);
+                break;
+            case '=':
+                listTemplates();
+                break;
+            case '#':
+                aslPrototypes.setEnabled(!aslPrototypes.enabled());
+                Serial.printf("[CMD] Personalized prototypes %s\n", aslPrototypes.enabled() ? "ENABLED" : "DISABLED");
+                break;
+            case '!':
+                if (profileStore.clear()) {
+                    Serial.printf("[PROTO] Prototypes of %s cleared\n",
+                                  profileStore.person()[0] ? profileStore.person() : "(nobody)");
+                }
+                break;
+            case '<':
+            case '>': {
+                // Runs on LogicTask, which owns the composer
+                const bool changed = (incoming == '<') ? textComposer.undo() : textComposer.redo();
+                if (changed) {
+                    Serial.printf("[CMD] Text: \"%s\"\n", textComposer.text());
+                } else {
+                    Serial.println(incoming == '<' ? "[CMD] Nothing to undo." : "[CMD] Nothing to redo.");
+                }
+                break;
+            }
             case 'h':
             case 'H':
             case '?':
@@ -285,25 +360,30 @@ void DataLogger::recordSample(const SensorSample& sample) {
     }
 
     if (needHeader) {
-        Serial.println("person_id,label,timestamp,flex1,flex2,flex3,flex4,flex5,ax_norm,ay_norm,az_norm,gx_norm,gy_norm,gz_norm");
+        // Every run starts at rest; repetitions count from 1 again
+        segmenter.reset();
+        Serial.println("person_id,label,timestamp,flex1,flex2,flex3,flex4,flex5,ax,ay,az,gx,gy,gz,rep_id,active");
     }
+    const GestureSegmenter::Tag tag = segmenter.update(sample);
 
     Serial.printf(
-        "%s,%s,%lu,%.4f,%.4f,%.4f,%.4f,%.4f,%.4f,%.4f,%.4f,%.4f,%.4f,%.4f\n",
+        "%s,%s,%lu,%.4f,%.4f,%.4f,%.4f,%.4f,%.4f,%.4f,%.4f,%.4f,%.4f,%.4f,%u,%d\n",
         personCopy,
         labelCopy,
         static_cast<unsigned long>(sample.timestampMs),
-        sample.flex[0],
-        sample.flex[1],
-        sample.flex[2],
-        sample.flex[3],
-        sample.flex[4],
-        sample.accelNorm[0],
-        sample.accelNorm[1],
-        sample.accelNorm[2],
-        sample.gyroNorm[0],
-        sample.gyroNorm[1],
-        sample.gyroNorm[2]);
+        sample.flexValue(0),
+        sample.flexValue(1),
+        sample.flexValue(2),
+        sample.flexValue(3),
+        sample.flexValue(4),
+        sample.accelValue(0),
+        sample.accelValue(1),
+        sample.accelValue(2),
+        sample.gyroValue(0),
+        sample.gyroValue(1),
+        sample.gyroValue(2),
+        static_cast<unsigned>(tag.repetition),
+        tag.active ? 1 : 0);
 }
 
 void DataLogger::startInput(InputMode mode) {
@@ -315,6 +395,10 @@ void DataLogger::startInput(InputMode mode) {
         Serial.println("\n[DATA] Enter person ID (e.g. P1, P2) and press ENTER:");
     } else if (mode == InputMode::Label) {
         Serial.println("\n[DATA] Enter label (A-Z, NEUTRAL, SPACE, etc) and press ENTER:");
+    } else if (mode == InputMode::Template) {
+        Serial.println("\n[DTW] Enter the word to record and press ENTER, then sign it once:");
+    } else if (mode == InputMode::RemoveTemplate) {
+        Serial.println("\n[DTW] Enter the word whose templates to delete and press ENTER:");
     }
 }
 
@@ -330,6 +414,12 @@ void DataLogger::finalizeInput() {
     } else if (pendingInput == InputMode::Label) {
         uppercaseInPlace(pendingBuffer);
         storeLabel(pendingBuffer);
+    } else if (pendingInput == InputMode::Template) {
+        uppercaseInPlace(pendingBuffer);
+        recordTemplate(pendingBuffer);
+    } else if (pendingInput == InputMode::RemoveTemplate) {
+        uppercaseInPlace(pendingBuffer);
+        removeTemplate(pendingBuffer);
     }
 
     pendingInput = InputMode::None;
@@ -343,6 +433,11 @@ void DataLogger::storePersonId(const char* value) {
     copySafe(personId, sizeof(personId), value);
     xSemaphoreGive(configMutex);
     Serial.printf("[DATA] Person ID set to %s\n", personId);
+    // Only this person's word templates match from now on
+    if (!dtwMatcher.requestPerson(personId)) {
+        Serial.println("[DTW] Matcher busy, templates of every person stay active.");
+    }
+    profileStore.select(personId);
 }
 
 void DataLogger::storeLabel(const char* value) {
@@ -372,6 +467,51 @@ void DataLogger::storeLabel(const char* value) {
             Serial.println("[DATA] Debug output muted while logging for clean CSV.");
         }
     }
+    if (loggingEnabled) {
+        startLearning();
+    } else {
+        aslPrototypes.stopLearning();
+    }
+}
+
+void DataLogger::recordTemplate(const char* word) {
+    char person[sizeof(personId)] = "";
+    if (configMutex && xSemaphoreTake(configMutex, portMAX_DELAY) == pdTRUE) {
+        copySafe(person, sizeof(person), personId);
+        xSemaphoreGive(configMutex);
+    }
+    if (!dtwMatcher.requestCapture(word, person)) {
+        Serial.println("[DTW] Matcher busy, try again.");
+        return;
+    }
+    Serial.printf("[DTW] Recording \"%s\" for %s: get ready...\n", word, person[0] ? person : "everyone");
+}
+
+void DataLogger::removeTemplate(const char* word) {
+    if (!dtwMatcher.requestRemove(word)) {
+        Serial.println("[DTW] Matcher busy, try again.");
+        return;
+    }
+    Serial.printf("[DTW] Deleting templates for \"%s\"\n", word);
+}
+
+void DataLogger::listTemplates() const {
+    // Runs on LogicTask; static to keep a template off its stack
+    static DtwMatcher::Template tmpl;
+    const size_t count = dtwMatcher.count();
+    Serial.printf("\n[DTW] %u/%u word templates\n", (unsigned)count, (unsigned)DtwMatcher::kMaxTemplates);
+    for (size_t i = 0; i < count; ++i) {
+        if (dtwMatcher.copyTemplate(i, tmpl)) {
+            Serial.printf("  %u: %-16s %-8s %u frames (%.2f s)\n", (unsigned)i, tmpl.word,
+                          tmpl.person[0] ? tmpl.person : "-", (unsigned)tmpl.length,
+                          tmpl.length * DtwMatcher::kFrameStride / (float)asl_model::kSensorRateHz);
+        }
+    }
+    const DtwMatcher::Stats& stats = dtwMatcher.stats();
+    Serial.printf("  match threshold %.2f, DTW cells last/max %lu/%lu, pruned %lu + abandoned %lu of %lu\n",
+                  dtwMatcher.params().acceptDistance, (unsigned long)stats.lastCells,
+                  (unsigned long)stats.maxCells, (unsigned long)stats.lbPruned,
+                  (unsigned long)stats.abandoned, (unsigned long)stats.candidates);
 }
 
 void DataLogger::startLogging() {
@@ -403,7 +543,9 @@ void DataLogger::startLogging() {
     Serial.printf("[DATA] Logging enabled for %s label %s (50 Hz). Use 't' to stop.\n",
                   personId,
                   currentLabel);
+    Serial.println("[DATA] Start with the hand relaxed; rest between repetitions to separate them.");
     Serial.println("[DATA] Debug output muted while logging for clean CSV.");
+    startLearning();
 }
 
 void DataLogger::stopLogging() {
@@ -411,7 +553,20 @@ void DataLogger::stopLogging() {
     if (xSemaphoreTake(configMutex, portMAX_DELAY) != pdTRUE) return;
     loggingEnabled = false;
     xSemaphoreGive(configMutex);
-    Serial.println("[DATA] Logging stopped.");
+    // profileStore.poll() saves the prototypes now that the run is over
+    aslPrototypes.stopLearning();
+    Serial.printf("[DATA] Logging stopped after %u repetitions.\n", static_cast<unsigned>(segmenter.repetitions()));
+}
+
+void DataLogger::startLearning() {
+    // A logged label doubles as a personalization run for the model class
+    // of the same name; other labels are only recorded.
+    if (!aslPrototypes.available()) return;
+    if (aslPrototypes.startLearning(currentLabel)) {
+        Serial.printf("[PROTO] Learning %s for %s while logging\n", currentLabel, personId);
+    } else {
+        aslPrototypes.stopLearning();
+    }
 }
 
 void DataLogger::printStatus(bool imuReady, bool fingersReady, bool wifiReady) {
@@ -426,6 +581,13 @@ void DataLogger::printStatus(bool imuReady, bool fingersReady, bool wifiReady) {
         Serial.printf("Logging: %s\n", loggingEnabled ? "ENABLED" : "DISABLED");
         xSemaphoreGive(configMutex);
     }
+    if (aslPrototypes.available()) {
+        Serial.printf("Prototypes: %s, %u classes personalized, %lu windows re-weighted\n",
+                      aslPrototypes.enabled() ? "ENABLED" : "DISABLED",
+                      (unsigned)aslPrototypes.trainedClasses(), (unsigned long)aslPrototypes.fusedWindows());
+    } else {
+        Serial.println("Prototypes: unavailable (model has no embedding output)");
+    }
 
     if (fingerManager) {
         fingerManager->printStatus();
@@ -433,7 +595,7 @@ void DataLogger::printStatus(bool imuReady, bool fingersReady, bool wifiReady) {
     if (imuSensor) {
         imuSensor->printCalibrationInfo();
     }
-    Serial.println();
+    bootSequencer.printReport();
 }
 
 void DataLogger::toggleFlag(const char* name, bool& flag) {
@@ -5,7 +5,9 @@
 #include <freertos/semphr.h>
 
 #include "finger_sensors.h"
+#include "ml/gesture_segmenter.h"
 #include "sensor_types.h"
+#include "static_alloc.h"
 
 class MPU9250_Sensor;
 class SD_module;
@@ -15,13 +17,17 @@ public:
     enum class InputMode {
         None,
         Person,
-        Label
+        Label,
+        Template,        // word to record a DTW template for
+        RemoveTemplate   // word whose templates to delete
     };
 
     DataLogger();
 
     void begin(FingerSensorManager* manager, MPU9250_Sensor* imuSensor = nullptr, SD_module* sdCard = nullptr);
     void processSerial(bool imuReady, bool fingersReady, bool wifiReady);
+    // Logs the sample as the CSV row the training and replay tools read:
+    // flex in [0, 1], IMU raw in m/s² and rad/s.
     void recordSample(const SensorSample& sample);
     void printHelp() const;
 
@@ -36,6 +42,7 @@ private:
     FingerSensorManager* fingerManager;
     MPU9250_Sensor* imuSensor;
     SD_module* sdCard;
+    StaticMutex configMutexStorage;
     SemaphoreHandle_t configMutex;
 
     bool loggingEnabled;
@@ -52,11 +59,17 @@ private:
 
     char personId[8];
     char currentLabel[16];
+    // Tags logged samples with repetition and rest/active; SensorTask only
+    GestureSegmenter segmenter;
 
     void startInput(InputMode mode);
     void finalizeInput();
     void storePersonId(const char* value);
     void storeLabel(const char* value);
+    void recordTemplate(const char* word);
+    void removeTemplate(const char* word);
+    void listTemplates() const;
+    void startLearning();
     void startLogging();
     void stopLogging();
     void printStatus(bool imuReady, bool fingersReady, bool wifiReady);
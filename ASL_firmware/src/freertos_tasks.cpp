@@ -2,7 +2,6 @@
 
 #include <Arduino.h>
 #include <WiFi.h>
-#include <Wire.h>
 #include <math.h>
 #include <string.h>
 #include <esp_wpa2.h>
@@ -10,54 +9,85 @@
 #include <algorithm>
 #include <freertos/queue.h>
 
+#include "audio_cache.h"
 #include "audio_sd.h"
+#include "boot_sequencer.h"
 #include "data_logger.h"
 #include "finger_sensors.h"
 #include "i2s_amp.h"
+#include "log_formats.h"
 #include "mpu9250_sensor.h"
 #include "ml/asl_inference.h"
-#include "ml/imu_normalization.h"
+#include "ml/beam_decoder.h"
+#include "ml/dtw_matcher.h"
+#include "ml/model_router.h"
+#include "ml/sample_history.h"
 #include "sensor_types.h"
 #include "perf_profiler.h"
+#include "static_alloc.h"
+#include "task_supervisor.h"
+#include "template_store.h"
+#include "profile_store.h"
+#include "text_composer.h"
+#include "token_log.h"
 
 /*
  FreeRTOS Task Overview
  -------------------------------------------------------------------------------
- [Core 0 | Prio 4] SensorTask    - 50 Hz sampling for IMU + flex, fills windows,
-                                  pushes samples to logger/logic queues.
- [Core 0 | Prio 3] InferenceTask - Builds window features, runs classify_letter,
-                                  forwards letter decisions.
+ [Core 0 | Prio 4] SensorTask    - 50 Hz sampling for IMU + flex, appends to the
+                                  shared sample history, pushes samples to
+                                  logger/logic queues.
+ [Core 0 | Prio 3] InferenceTask - Runs the model router over the sample history,
+                                  forwards letter decisions; matches and records
+                                  DTW word templates.
  [Core 1 | Prio 2] LogicTask     - Serial console, letter state machine, shake
                                   detection, queues TTS requests.
  [Core 1 | Prio 2] TTSTask       - Wi-Fi + Google TTS downloads, feeds AudioTask.
  [Core 1 | Prio 3] AudioTask     - High-priority I2S playback loop from SD files.
+ [Core 1 | Prio 1] Supervisor    - Once a second, checks Sensor/Inference deadline
+                                  misses and queue overflows and sets the
+                                  degradation level (lib/task_supervisor).
 */
 
 namespace {
-constexpr size_t SENSOR_WINDOW_SIZE = 25;
-constexpr TickType_t SENSOR_PERIOD = pdMS_TO_TICKS(20);
+constexpr uint32_t SENSOR_PERIOD_MS = 20;
+constexpr TickType_t SENSOR_PERIOD = pdMS_TO_TICKS(SENSOR_PERIOD_MS);
+constexpr uint32_t SENSOR_DEADLINE_MS = 10;      // leaves half the period as headroom
+constexpr uint32_t INFERENCE_DEADLINE_MS = 20;   // must finish before the next sample
 constexpr float GYRO_SHAKE_THRESH = 3.5f;
 constexpr size_t SHAKE_BUFFER_SIZE = 25;
 constexpr size_t SHAKE_COUNT_THRESHOLD = 18;
 constexpr uint32_t SHAKE_COOLDOWN_MS = 1500;
 constexpr uint32_t LETTER_HOLD_MS = 200;
-constexpr size_t MAX_TEXT_BUFFER = 64;
 constexpr float MIN_CONFIDENCE_THRESHOLD = 0.85f;
 
-struct SensorWindow {
-    SensorSample samples[SENSOR_WINDOW_SIZE];
-};
-
 struct LetterDecision {
     char letter;
     float confidence;
     uint32_t timestamp;
+    const char* label;  // model package label, nullptr for tokens
+    int stage;          // router stage and class, resolved by textComposer
     int classIndex;
+    BeamDecoder::Observation candidates;  // top classes for aslDecoder
+};
+
+// Word template matches and capture progress from InferenceTask
+struct TemplateEvent {
+    DtwMatcher::Event event;
+    float distance;
+    char word[DtwMatcher::kWordLength];
 };
 
 struct TTSRequest {
     char text[128];
 };
+static_assert(TEXT_COMPOSER_CAPACITY < sizeof(TTSRequest::text), "composed text must fit a TTS request");
+static_assert(ModelRouter::kNumStages <= TEXT_COMPOSER_MAX_STAGES &&
+                  ModelRouter::kMaxClasses <= TEXT_COMPOSER_MAX_CLASSES,
+              "text composer kind table is too small for the router");
+static_assert(ModelRouter::kNumStages <= BeamDecoder::kMaxStages &&
+                  ModelRouter::kMaxClasses <= BeamDecoder::kMaxClasses,
+              "beam decoder symbol table is too small for the router");
 
 struct AudioJob {
     char filepath[32];
@@ -104,32 +134,47 @@ private:
     uint32_t lastTriggerMs{0};
 };
 
+// Task stacks, TCBs and queue storage are static so the pipeline never touches
+// the heap; scripts/memory_report.py lists them at build time.
+StaticTask<3072> sensorTaskStorage;
+StaticTask<4096> inferenceTaskStorage;
+StaticTask<4096> logicTaskStorage;
+StaticTask<12288> ttsTaskStorage;
+StaticTask<4096> audioTaskStorage;
+StaticQueue<SensorSample, 20> sensorSampleQueueStorage;
+StaticQueue<LetterDecision, 10> letterDecisionQueueStorage;
+StaticQueue<TemplateEvent, 4> templateEventQueueStorage;
+StaticQueue<TTSRequest, 3> ttsRequestQueueStorage;
+StaticQueue<AudioJob, 3> audioJobQueueStorage;
+
 // Global Resources
 TaskResources gResources;
 QueueHandle_t sensorSampleQueue = nullptr;
-QueueHandle_t sensorWindowQueue = nullptr;
 QueueHandle_t letterDecisionQueue = nullptr;
+QueueHandle_t templateEventQueue = nullptr;
 QueueHandle_t ttsRequestQueue = nullptr;
 QueueHandle_t audioJobQueue = nullptr;
 
-char classifyLetter(const SensorWindow& window, float& confidence, int& classIndex) {
-    char letter = ASLInferenceEngine::kNeutralToken;
-    confidence = 0.0f;
-    classIndex = -1;
+// Task supervisor IDs, assigned in startSystemTasks()
+int gSensorHealth = -1;
+int gInferenceHealth = -1;
+int gSampleQueueHealth = -1;
+int gDecisionQueueHealth = -1;
+int gTemplateQueueHealth = -1;
+int gTTSQueueHealth = -1;
 
-    if (!aslInference.isReady()) {
-        return letter;
-    }
+#define ASL_LOG_STRING(id, fmt) fmt,
+const char* const kAslLogFormats[LOG_FORMAT_COUNT] = {ASL_LOG_FORMATS(ASL_LOG_STRING)};
+#undef ASL_LOG_STRING
 
-    aslInference.classify(window.samples, SENSOR_WINDOW_SIZE, letter, confidence, classIndex);
-    return letter;
-}
+// Written only by SensorTask; every router stage reads its own window from it.
+SampleHistory gSampleHistory;
 
 bool enqueueTTSRequest(const char* text) {
     if (!ttsRequestQueue || !text) return false;
     TTSRequest req{};
     snprintf(req.text, sizeof(req.text), "%s ", text);
-    return xQueueSend(ttsRequestQueue, &req, pdMS_TO_TICKS(100)) == pdPASS;
+    return taskSupervisor.send(gTTSQueueHealth, &req, pdMS_TO_TICKS(100));
 }
 
 bool connectWiFi(const TaskResources& resources) {
@@ -196,9 +241,7 @@ bool connectWiFi(const TaskResources& resources) {
                           WiFi.localIP().toString().c_str());
         }
         if (resources.sd) {
-            resources.sd->setStatusLED(0, 0, 255);
-            vTaskDelay(pdMS_TO_TICKS(200));
-            resources.sd->clearStatusLED();
+            resources.sd->flashStatusLED(0, 0, 255, 200);
         }
     } else {
         Serial.println("[TTSTask] WiFi connection failed.");
@@ -213,14 +256,6 @@ void disconnectWiFi() {
     gWifiConnected = false;
 }
 
-void reinitI2C() {
-    Wire.end();
-    vTaskDelay(pdMS_TO_TICKS(100));
-    Wire.begin(18, 46, 100000);
-    Wire.setTimeout(1000);
-    vTaskDelay(pdMS_TO_TICKS(50));
-}
-
 }  // namespace
 
 TaskHandle_t SensorTaskHandle = nullptr;
@@ -229,117 +264,100 @@ TaskHandle_t LogicTaskHandle = nullptr;
 TaskHandle_t TTSTaskHandle = nullptr;
 TaskHandle_t AudioTaskHandle = nullptr;
 
-bool gImuAvailable = false;
-bool gFingersAvailable = false;
-bool gWifiConnected = false;
+// Set by the boot phases while the pipeline tasks are already running
+volatile bool gImuAvailable = false;
+volatile bool gFingersAvailable = false;
+volatile bool gWifiConnected = false;
 volatile bool gTTSInProgress = false;
 volatile uint32_t gLastTTSCompleteTime = 0;
 volatile char gLastPlayedWord[32] = "";
 constexpr uint32_t TTS_COOLDOWN_MS = 1500;
 bool gTTSEnabled = false;
+bool gBeamDecoderEnabled = false;
 
 void SensorTask(void* parameter) {
     Serial.println("[SensorTask] Starting on Core 0");
     TickType_t lastWake = xTaskGetTickCount();
-
-    static SensorWindow rollingWindow;
-    static SensorWindow snapshot;
-    size_t windowIndex = 0;
-    bool windowPrimed = false;
+    uint16_t sampleSeq = 0;
 
     while (true) {
+        taskSupervisor.cycleStart(gSensorHealth);
         perfProfiler.markStart(MARKER_SENSOR_READ);
         
         SensorSample sample{};
         sample.timestampMs = millis();
+        sample.seq = sampleSeq++;
 
         if (gFingersAvailable && gResources.fingers) {
             perfProfiler.markStart(MARKER_FINGER_UPDATE);
             gResources.fingers->updateAll();
-            gResources.fingers->getNormalizedValues(sample.flex);
-            sample.fingersValid = true;
+            float flex[5];
+            gResources.fingers->getNormalizedValues(flex);
+            sample.setFlex(flex);
             perfProfiler.markEnd(MARKER_FINGER_UPDATE);
         }
 
-        if (gImuAvailable && gResources.imu && gResources.imu->isReady() && !gTTSInProgress) {
+        if (gImuAvailable && gResources.imu && gResources.imu->isReady()) {
             perfProfiler.markStart(MARKER_IMU_UPDATE);
             gResources.imu->update();
-            sample.accel[0] = gResources.imu->getAccelX_mss();
-            sample.accel[1] = gResources.imu->getAccelY_mss();
-            sample.accel[2] = gResources.imu->getAccelZ_mss();
-            sample.gyro[0] = gResources.imu->getGyroX_rads();
-            sample.gyro[1] = gResources.imu->getGyroY_rads();
-            sample.gyro[2] = gResources.imu->getGyroZ_rads();
-            if (gResources.imu->isCalibrated()) {
-                gResources.imu->getNormalizedReadings(sample.accelNorm, sample.gyroNorm);
-            } else {
-                sample.accelNorm[0] = normalizeSensor(sample.accel[0], kAxParams);
-                sample.accelNorm[1] = normalizeSensor(sample.accel[1], kAyParams);
-                sample.accelNorm[2] = normalizeSensor(sample.accel[2], kAzParams);
-                sample.gyroNorm[0] = normalizeSensor(sample.gyro[0], kGxParams);
-                sample.gyroNorm[1] = normalizeSensor(sample.gyro[1], kGyParams);
-                sample.gyroNorm[2] = normalizeSensor(sample.gyro[2], kGzParams);
-            }
-            sample.imuValid = true;
+            const float accel[3] = {gResources.imu->getAccelX_mss(),
+                                    gResources.imu->getAccelY_mss(),
+                                    gResources.imu->getAccelZ_mss()};
+            const float gyro[3] = {gResources.imu->getGyroX_rads(),
+                                   gResources.imu->getGyroY_rads(),
+                                   gResources.imu->getGyroZ_rads()};
+            sample.setImu(accel, gyro);
             perfProfiler.markEnd(MARKER_IMU_UPDATE);
         }
         
         perfProfiler.markEnd(MARKER_SENSOR_READ);
 
-        dataLogger.recordSample(sample);
+        if (dataLogger.loggingActive() && !taskSupervisor.dropLogging()) {
+            dataLogger.recordSample(sample);
+        }
 
         if (sensorSampleQueue) {
-            xQueueSend(sensorSampleQueue, &sample, 0);
+            taskSupervisor.send(gSampleQueueHealth, &sample, 0);
         }
 
-        rollingWindow.samples[windowIndex] = sample;
-        windowIndex = (windowIndex + 1) % SENSOR_WINDOW_SIZE;
-        if (!windowPrimed && windowIndex == 0) {
-            windowPrimed = true;
+        perfProfiler.markStart(MARKER_WINDOW_BUILD);
+        gSampleHistory.push(sample);
+        perfProfiler.markEnd(MARKER_WINDOW_BUILD);
+        if (InferenceTaskHandle && sample.seq % taskSupervisor.inferenceDecimation() == 0) {
+            xTaskNotifyGive(InferenceTaskHandle);
         }
 
-        if (windowPrimed && sensorWindowQueue) {
-            perfProfiler.markStart(MARKER_WINDOW_BUILD);
-            for (size_t i = 0; i < SENSOR_WINDOW_SIZE; ++i) {
-                size_t idx = (windowIndex + i) % SENSOR_WINDOW_SIZE;
-                snapshot.samples[i] = rollingWindow.samples[idx];
-            }
-            xQueueOverwrite(sensorWindowQueue, &snapshot);
-            perfProfiler.markEnd(MARKER_WINDOW_BUILD);
-            if (InferenceTaskHandle) {
-                xTaskNotifyGive(InferenceTaskHandle);
-            }
-        }
-
-        if (dataLogger.imuDebugEnabled() && sample.imuValid) {
+        const bool debugAllowed = !taskSupervisor.shedDebug();
+        if (debugAllowed && dataLogger.imuDebugEnabled() && sample.imuValid()) {
             static uint32_t lastPrint = 0;
             if (millis() - lastPrint >= 500) {
                 lastPrint = millis();
-                Serial.printf("[IMU] A: %.2f %.2f %.2f | G: %.2f %.2f %.2f\n",
-                              sample.accel[0],
-                              sample.accel[1],
-                              sample.accel[2],
-                              sample.gyro[0],
-                              sample.gyro[1],
-                              sample.gyro[2]);
+                TLOG(LOG_IMU_READING,
+                     sample.accelValue(0),
+                     sample.accelValue(1),
+                     sample.accelValue(2),
+                     sample.gyroValue(0),
+                     sample.gyroValue(1),
+                     sample.gyroValue(2));
             }
         }
 
-        if (dataLogger.fingerDebugEnabled() && gFingersAvailable && gResources.fingers) {
+        if (debugAllowed && dataLogger.fingerDebugEnabled() && gFingersAvailable && gResources.fingers) {
             static uint32_t lastFingerPrint = 0;
             if (millis() - lastFingerPrint >= 1000) {
                 lastFingerPrint = millis();
                 float angles[5];
                 gResources.fingers->getAngles(angles);
-                Serial.printf("[FINGERS] T:%.0f I:%.0f M:%.0f R:%.0f P:%.0f\n",
-                              angles[4],
-                              angles[3],
-                              angles[2],
-                              angles[1],
-                              angles[0]);
+                TLOG(LOG_FINGER_ANGLES,
+                     angles[4],
+                     angles[3],
+                     angles[2],
+                     angles[1],
+                     angles[0]);
             }
         }
 
+        taskSupervisor.cycleEnd(gSensorHealth);
         vTaskDelayUntil(&lastWake, SENSOR_PERIOD);
     }
 }
@@ -347,33 +365,54 @@ void SensorTask(void* parameter) {
 void InferenceTask(void* parameter) {
     Serial.println("[InferenceTask] Starting on Core 0");
     while (true) {
-        ulTaskNotifyTake(pdTRUE, portMAX_DELAY);
-        SensorWindow window;
-        if (!sensorWindowQueue ||
-            xQueueReceive(sensorWindowQueue, &window, 0) != pdPASS) {
+        const uint32_t pending = ulTaskNotifyTake(pdTRUE, portMAX_DELAY);
+        // More than one pending notification means samples arrived while the
+        // last classification was still running
+        taskSupervisor.noteSkipped(gInferenceHealth, pending - 1);
+        taskSupervisor.cycleStart(gInferenceHealth);
+
+        // Word templates need no model, so they match (and record) even
+        // before the model has loaded
+        perfProfiler.markStart(MARKER_TEMPLATE_MATCH);
+        DtwMatcher::Match match;
+        const DtwMatcher::Event templateEvent = dtwMatcher.update(gSampleHistory, match);
+        perfProfiler.markEnd(MARKER_TEMPLATE_MATCH);
+        if (templateEvent != DtwMatcher::Event::None && templateEventQueue) {
+            TemplateEvent event{templateEvent, match.distance, {}};
+            memcpy(event.word, match.word, sizeof(event.word));
+            taskSupervisor.send(gTemplateQueueHealth, &event, 0);
+        }
+
+        if (!aslRouter.isReady()) {
+            taskSupervisor.cycleEnd(gInferenceHealth);
             continue;
         }
 
         perfProfiler.markStart(MARKER_INFERENCE);
-        float confidence = 0.0f;
-        int classIndex = -1;
-        char letter = classifyLetter(window, confidence, classIndex);
+        InferenceResult result;
+        float scores[ModelRouter::kMaxClasses];
+        const bool classified = aslRouter.classify(gSampleHistory, result, scores);
         perfProfiler.markEnd(MARKER_INFERENCE);
+        if (!classified) {
+            taskSupervisor.cycleEnd(gInferenceHealth);
+            continue;
+        }
+        bootSequencer.mark("First inference");
+        const char letter = result.letter;
+        const float confidence = result.confidence;
 
-        if (!dataLogger.loggingActive() && dataLogger.inferenceDebugEnabled()) {
+        if (!dataLogger.loggingActive() && dataLogger.inferenceDebugEnabled() && !taskSupervisor.shedDebug()) {
             static uint32_t lastPrintMs = 0;
-            static int lastPrintClass = -2;
+            static const char* lastPrintLabel = nullptr;
             static char lastPrintLetter = '\0';
             const uint32_t now = millis();
-            const bool changed = (classIndex != lastPrintClass) || (letter != lastPrintLetter);
+            const bool changed = (result.label != lastPrintLabel) || (letter != lastPrintLetter);
             if (changed || (now - lastPrintMs) >= 100) {
                 lastPrintMs = now;
-                lastPrintClass = classIndex;
+                lastPrintLabel = result.label;
                 lastPrintLetter = letter;
 
-                const char* label = (classIndex >= 0)
-                                        ? aslInference.labelForIndex(static_cast<size_t>(classIndex))
-                                        : nullptr;
+                const char* label = result.label;
                 if (!label || !label[0]) {
                     if (letter == ASLInferenceEngine::kBackspaceToken) {
                         label = "BACKSPACE";
@@ -386,13 +425,14 @@ void InferenceTask(void* parameter) {
                     }
                 }
                 const char* confMarker = (confidence < MIN_CONFIDENCE_THRESHOLD) ? " [LOW]" : "";
-                Serial.printf("[Inference] Label: %s | Letter: %c | Confidence: %.2f%s\n",
-                              label,
-                              (letter == ASLInferenceEngine::kSpaceToken)
-                                  ? ' '
-                                  : (letter == ASLInferenceEngine::kNeutralToken ? '-' : letter),
-                              confidence,
-                              confMarker);
+                TLOG(LOG_INFERENCE,
+                     label,
+                     (letter == ASLInferenceEngine::kSpaceToken)
+                         ? ' '
+                         : (letter == ASLInferenceEngine::kNeutralToken ? '-' : letter),
+                     confidence,
+                     confMarker,
+                     static_cast<unsigned>(result.stage));
             }
         }
 
@@ -401,9 +441,14 @@ void InferenceTask(void* parameter) {
                 .letter = letter,
                 .confidence = confidence,
                 .timestamp = millis(),
-                .classIndex = classIndex};
-            xQueueSend(letterDecisionQueue, &decision, 0);
+                .label = result.label,
+                .stage = result.stage,
+                .classIndex = result.classIndex,
+                .candidates = BeamDecoder::Observation::fromScores(
+                    result.stage, scores, aslRouter.stage(static_cast<size_t>(result.stage)).numClasses())};
+            taskSupervisor.send(gDecisionQueueHealth, &decision, 0);
         }
+        taskSupervisor.cycleEnd(gInferenceHealth);
 
         taskYIELD();
         vTaskDelay(1);
@@ -419,91 +464,163 @@ void LogicTask(void* parameter) {
     char heldLetter = '\0';
     uint32_t holdStart = 0;
     uint32_t lastCommitMs = 0;
-    String textBuffer;
     char lastCommittedLetter = ASLInferenceEngine::kNeutralToken;
     constexpr uint32_t LETTER_COOLDOWN_MS = 200;
-    auto commitToBuffer = [&](char value, int classIndex) {
-        if (value == ASLInferenceEngine::kNeutralToken) {
+
+    for (size_t i = 0; i < aslRouter.numStages(); ++i) {
+        textComposer.setVocabulary(i, aslRouter.stage(i).model());
+        aslDecoder.setVocabulary(i, aslRouter.stage(i).model());
+    }
+    // Whole-word models keep the hold rule; spelling goes through the decoder
+    gBeamDecoderEnabled = aslDecoder.spellsLetters();
+
+    auto drainDecoder = [&]() {
+        uint16_t word;
+        while (aslDecoder.popWord(word)) {
+            const char* text = aslDecoder.wordText(word);
+            const TextComposer::Result result = textComposer.commitWord(text);
+            if (result == TextComposer::Result::Ok) {
+                bootSequencer.mark("First letter");
+            }
+            if (!dataLogger.loggingActive()) {
+                if (result == TextComposer::Result::Full) {
+                    Serial.printf("[LogicTask] Text buffer full, dropped: %s\n", text);
+                } else {
+                    Serial.printf("[LogicTask] Word decoded: %s | Buffer: %s\n", text, textComposer.text());
+                }
+            }
+        }
+    };
+
+    auto commitToBuffer = [&](const LetterDecision& decision) {
+        const size_t stage = static_cast<size_t>(decision.stage);
+        const size_t classIndex = static_cast<size_t>(decision.classIndex);
+        const TextComposer::TokenKind kind = textComposer.kindOf(stage, classIndex);
+        if (kind == TextComposer::TokenKind::Ignore) {
+            return;
+        }
+        if (kind == TextComposer::TokenKind::Word && dtwMatcher.hasWord(textComposer.labelOf(stage, classIndex))) {
+            return;  // the user recorded this word; the template matcher commits it
+        }
+        if (gBeamDecoderEnabled && aslDecoder.handles(stage, classIndex)) {
+            return;  // committed by the decoder
+        }
+        if (gBeamDecoderEnabled && kind == TextComposer::TokenKind::Backspace && aslDecoder.hasPending()) {
+            // Abandon the word being spelled before touching committed text
+            aslDecoder.reset();
+            lastCommitMs = millis();
+            if (!dataLogger.loggingActive()) {
+                Serial.println("[LogicTask] Discarded the word in progress.");
+            }
             return;
         }
 
         const uint32_t now = millis();
-        const char* fullLabel = (classIndex >= 0) ? aslInference.labelForIndex(static_cast<size_t>(classIndex)) : nullptr;
+        const char* label = textComposer.labelOf(stage, classIndex);
 
         // Block same word during TTS cooldown
         if (gLastTTSCompleteTime > 0 && (now - gLastTTSCompleteTime) < TTS_COOLDOWN_MS) {
-            if (fullLabel && strcmp(fullLabel, (const char*)gLastPlayedWord) == 0) {
+            if (strcmp(label, (const char*)gLastPlayedWord) == 0) {
                 return;
             }
         }
-        if (value != ASLInferenceEngine::kBackspaceToken) {
-            if (value == lastCommittedLetter &&
-                (now - lastCommitMs) < LETTER_COOLDOWN_MS) {
-                return;
-            }
-            lastCommitMs = now;
-        } else {
-            lastCommitMs = now;
+        if (kind != TextComposer::TokenKind::Backspace &&
+            decision.letter == lastCommittedLetter &&
+            (now - lastCommitMs) < LETTER_COOLDOWN_MS) {
+            return;
         }
+        lastCommitMs = now;
 
-        if (value == ASLInferenceEngine::kBackspaceToken) {
-            if (textBuffer.length() > 0) {
-                textBuffer.remove(textBuffer.length() - 1);
-            }
+        const TextComposer::Result result = textComposer.commit(stage, classIndex);
+        if (kind == TextComposer::TokenKind::Backspace) {
             lastCommittedLetter = ASLInferenceEngine::kNeutralToken;
-        } else {
-            const char* fullLabel = (classIndex >= 0) ? aslInference.labelForIndex(static_cast<size_t>(classIndex)) : nullptr;
-
-            if (fullLabel && fullLabel[0] != '\0' &&
-                strcmp(fullLabel, "NEUTRAL") != 0 &&
-                strcmp(fullLabel, "BACKSPACE") != 0 &&
-                strcmp(fullLabel, "SPACE") != 0) {
-                textBuffer = String(fullLabel) + " ";
-            } else if (value == ASLInferenceEngine::kSpaceToken) {
-                textBuffer += ' ';
+        } else if (result == TextComposer::Result::Ok) {
+            lastCommittedLetter = decision.letter;
+            bootSequencer.mark("First letter");
+        }
+
+        if (!dataLogger.loggingActive()) {
+            if (result == TextComposer::Result::Full) {
+                Serial.printf("[LogicTask] Text buffer full, dropped: %s\n", label);
             } else {
-                textBuffer += value;
+                Serial.printf("[LogicTask] Letter committed: %s | Buffer: %s\n",
+                              label,
+                              textComposer.text());
             }
-            lastCommittedLetter = value;
         }
+    };
 
-        if (!dataLogger.loggingActive()) {
-            const char* label = (classIndex >= 0)
-                                    ? aslInference.labelForIndex(static_cast<size_t>(classIndex))
-                                    : nullptr;
-            if (!label || !label[0]) {
-                if (value == ASLInferenceEngine::kBackspaceToken) {
-                    label = "BACKSPACE";
-                } else if (value == ASLInferenceEngine::kSpaceToken) {
-                    label = "SPACE";
-                } else if (value == ASLInferenceEngine::kNeutralToken) {
-                    label = "NEUTRAL";
-                } else {
-                    label = "?";
+    auto handleTemplateEvent = [&](const TemplateEvent& event) {
+        switch (event.event) {
+            case DtwMatcher::Event::Match: {
+                const uint32_t now = millis();
+                if (gLastTTSCompleteTime > 0 && (now - gLastTTSCompleteTime) < TTS_COOLDOWN_MS &&
+                    strcmp(event.word, (const char*)gLastPlayedWord) == 0) {
+                    return;
+                }
+                // Finish the word being spelled so the text stays in order
+                if (gBeamDecoderEnabled) {
+                    aslDecoder.flush();
+                    drainDecoder();
                 }
+                perfProfiler.markStart(MARKER_LETTER_COMMIT);
+                const TextComposer::Result result = textComposer.commitWord(event.word);
+                perfProfiler.markEnd(MARKER_LETTER_COMMIT);
+                lastCommitMs = now;
+                lastCommittedLetter = ASLInferenceEngine::kNeutralToken;
+                // The classifier saw the same motion; let it settle first
+                state = LetterState::WaitNeutral;
+                if (result == TextComposer::Result::Ok) {
+                    bootSequencer.mark("First letter");
+                }
+                if (!dataLogger.loggingActive()) {
+                    if (result == TextComposer::Result::Full) {
+                        Serial.printf("[LogicTask] Text buffer full, dropped: %s\n", event.word);
+                    } else {
+                        Serial.printf("[LogicTask] Template matched: %s (%.2f) | Buffer: %s\n",
+                                      event.word, event.distance, textComposer.text());
+                    }
+                }
+                break;
             }
-            Serial.printf("[LogicTask] Letter committed: %s | Buffer: %s\n",
-                          label,
-                          textBuffer.c_str());
+            case DtwMatcher::Event::CaptureStarted:
+                Serial.println("[DTW] Sign the word now...");
+                break;
+            case DtwMatcher::Event::CaptureSaved:
+                Serial.printf("[DTW] Template saved (%u/%u)\n", (unsigned)dtwMatcher.count(),
+                              (unsigned)DtwMatcher::kMaxTemplates);
+                break;
+            case DtwMatcher::Event::CaptureFailed:
+                Serial.printf("[DTW] Capture failed: no clear motion, or the table is full (%u/%u)\n",
+                              (unsigned)dtwMatcher.count(), (unsigned)DtwMatcher::kMaxTemplates);
+                break;
+            case DtwMatcher::Event::Removed:
+                Serial.printf("[DTW] %u templates left\n", (unsigned)dtwMatcher.count());
+                break;
+            case DtwMatcher::Event::None:
+                break;
         }
     };
 
+    auto shakeDebug = []() { return dataLogger.shakeDebugEnabled() && !taskSupervisor.shedDebug(); };
+
     while (true) {
         if (sensorSampleQueue) {
             SensorSample sample;
             if (xQueueReceive(sensorSampleQueue, &sample, pdMS_TO_TICKS(5)) == pdPASS) {
-                if (sample.imuValid) {
+                if (sample.imuValid()) {
                     perfProfiler.markStart(MARKER_SHAKE_DETECT);
-                    float mag = sqrtf(sample.gyro[0] * sample.gyro[0] +
-                                      sample.gyro[1] * sample.gyro[1] +
-                                      sample.gyro[2] * sample.gyro[2]);
+                    const float gx = sample.gyroValue(0);
+                    const float gy = sample.gyroValue(1);
+                    const float gz = sample.gyroValue(2);
+                    float mag = sqrtf(gx * gx + gy * gy + gz * gz);
                     shakeDetector.addSample(mag);
                     perfProfiler.markEnd(MARKER_SHAKE_DETECT);
-                    if (dataLogger.shakeDebugEnabled()) {
+                    if (shakeDebug()) {
                         static uint32_t lastShakePrint = 0;
                         if (millis() - lastShakePrint >= 1000) {
                             lastShakePrint = millis();
-                            Serial.printf("[SHAKE] Mag: %.2f\n", mag);
+                            TLOG(LOG_SHAKE_MAG, mag);
                         }
                     }
                 }
@@ -511,18 +628,22 @@ void LogicTask(void* parameter) {
                 const bool shakeFired = shakeDetector.triggered();
 
                 if (gTTSEnabled && shakeFired) {
-                    if (dataLogger.shakeDebugEnabled()) {
-                        Serial.println("[LogicTask] Shake detected.");
+                    if (shakeDebug()) {
+                        TLOG(LOG_SHAKE_DETECTED);
                     }
 
-                    if (textBuffer.length() > 0) {
+                    if (gBeamDecoderEnabled && !gTTSInProgress) {
+                        aslDecoder.flush();
+                        drainDecoder();
+                    }
+                    if (!textComposer.empty()) {
                         if (!gTTSInProgress) {
-                            if (enqueueTTSRequest(textBuffer.c_str())) {
+                            if (enqueueTTSRequest(textComposer.text())) {
                                 if (!dataLogger.loggingActive()) {
                                     Serial.printf("[LogicTask] Queued TTS for \"%s\"\n",
-                                                  textBuffer.c_str());
+                                                  textComposer.text());
                                 }
-                                textBuffer = "";
+                                textComposer.clear();
                             } else if (!dataLogger.loggingActive()) {
                                 Serial.println("[LogicTask] TTS queue full.");
                             }
@@ -531,10 +652,10 @@ void LogicTask(void* parameter) {
                                 Serial.println("[LogicTask] TTS in progress, skipping queue.");
                             }
                         }
-                    } else if (dataLogger.shakeDebugEnabled()) {
+                    } else if (shakeDebug()) {
                         Serial.println("[LogicTask] Shake ignored (buffer empty).");
                     }
-                } else if (!gTTSEnabled && shakeFired && dataLogger.shakeDebugEnabled()) {
+                } else if (!gTTSEnabled && shakeFired && shakeDebug()) {
                     Serial.println("[LogicTask] Shake detected but TTS disabled.");
                 }
             }
@@ -543,6 +664,11 @@ void LogicTask(void* parameter) {
         if (letterDecisionQueue) {
             LetterDecision decision;
             if (xQueueReceive(letterDecisionQueue, &decision, 0) == pdPASS) {
+                if (gBeamDecoderEnabled) {
+                    aslDecoder.update(decision.candidates);
+                    drainDecoder();
+                }
+
                 // Treat low-confidence predictions as neutral
                 const bool isNeutralDecision =
                     (decision.letter == ASLInferenceEngine::kNeutralToken) ||
@@ -560,7 +686,7 @@ void LogicTask(void* parameter) {
                         if (decision.letter == heldLetter) {
                             if (millis() - holdStart >= LETTER_HOLD_MS) {
                                 perfProfiler.markStart(MARKER_LETTER_COMMIT);
-                                commitToBuffer(heldLetter, decision.classIndex);
+                                commitToBuffer(decision);
                                 perfProfiler.markEnd(MARKER_LETTER_COMMIT);
                                 state = LetterState::WaitNeutral;
                             }
@@ -577,6 +703,15 @@ void LogicTask(void* parameter) {
             }
         }
 
+        if (templateEventQueue) {
+            TemplateEvent event;
+            if (xQueueReceive(templateEventQueue, &event, 0) == pdPASS) {
+                handleTemplateEvent(event);
+            }
+        }
+        templateStore.poll();
+        profileStore.poll();
+
         dataLogger.processSerial(gImuAvailable, gFingersAvailable, gWifiConnected);
         vTaskDelay(pdMS_TO_TICKS(5));
     }
@@ -610,11 +745,11 @@ void TTSTask(void* parameter) {
         char filename[32];
         snprintf(filename, sizeof(filename), "/%s.mp3", textTrimmed.c_str());
 
-        Serial.printf("[TTSTask] Free heap: %d bytes\n", ESP.getFreeHeap());
+        TLOG(LOG_TTS_FREE_HEAP, ESP.getFreeHeap());
 
-        bool fileExists = gResources.sd && gResources.sd->fileExists(filename);
+        AudioTier tier = audioCache.lookup(filename);
 
-        if (!fileExists) {
+        if (tier == AUDIO_TIER_NONE) {
             if (!gResources.amplifier || !gResources.amplifier->isReady()) {
                 Serial.println("[TTSTask] Amplifier not ready.");
                 gTTSInProgress = false;
@@ -647,17 +782,20 @@ void TTSTask(void* parameter) {
             }
 
             Serial.printf("[TTSTask] Download complete, saved to %s\n", filename);
+            audioCache.recordDownload(filename);
+            tier = AUDIO_TIER_SD;
 
             // Disconnect WiFi before playback
             disconnectWiFi();
             vTaskDelay(pdMS_TO_TICKS(500));
         }
 
-        // Play from SD card
-        Serial.printf("[TTSTask] Playing %s from SD card...\n", filename);
+        Serial.printf("[TTSTask] Playing %s from %s...\n", filename,
+                      tier == AUDIO_TIER_FLASH ? "flash" : "SD card");
 
-        if (!gResources.amplifier->playFileFromSD(filename)) {
-            Serial.println("[TTSTask] Failed to start playback from SD.");
+        if (!gResources.amplifier->playFile(audioCache.fsFor(tier), filename)) {
+            Serial.println("[TTSTask] Failed to start playback.");
+            audioCache.invalidate(filename);
             if (gResources.sd) gResources.sd->clearStatusLED();
             gTTSInProgress = false;
             continue;
@@ -675,13 +813,13 @@ void TTSTask(void* parameter) {
 
         // Cleanup
         gResources.amplifier->stop();
+        audioCache.recordPlay(filename);
         vTaskDelay(pdMS_TO_TICKS(100));
 
         if (gResources.sd) {
             gResources.sd->clearStatusLED();
         }
 
-        reinitI2C();
         gTTSInProgress = false;
         // Set cooldown timestamp
         gLastTTSCompleteTime = millis();
@@ -707,8 +845,10 @@ void AudioTask(void* parameter) {
             continue;
         }
 
+        const AudioTier tier = audioCache.lookup(job.filepath);
         Serial.printf("[AudioTask] Playing %s\n", job.filepath);
-        if (!gResources.amplifier->playFileFromSD(job.filepath)) {
+        if (tier == AUDIO_TIER_NONE ||
+            !gResources.amplifier->playFile(audioCache.fsFor(tier), job.filepath)) {
             Serial.println("[AudioTask] Failed to start playback.");
             gTTSInProgress = false;
             continue;
@@ -721,6 +861,7 @@ void AudioTask(void* parameter) {
 
         // Explicitly stop and cleanup audio resources
         gResources.amplifier->stop();
+        audioCache.recordPlay(job.filepath);
         // Allow time for cleanup
         vTaskDelay(pdMS_TO_TICKS(100));
 
@@ -728,72 +869,46 @@ void AudioTask(void* parameter) {
             gResources.sd->clearStatusLED();
         }
 
-        reinitI2C();
         gTTSInProgress = false;
         // Set cooldown timestamp
         gLastTTSCompleteTime = millis();
         Serial.println("[AudioTask] Playback complete.");
-        Serial.printf("[AudioTask] Free heap after cleanup: %d bytes\n", ESP.getFreeHeap());
+        TLOG(LOG_AUDIO_FREE_HEAP, ESP.getFreeHeap());
     }
 }
 
 void startSystemTasks(const TaskResources& resources) {
     gResources = resources;
 
-    sensorSampleQueue = xQueueCreate(20, sizeof(SensorSample));
-    sensorWindowQueue = xQueueCreate(1, sizeof(SensorWindow));
-    letterDecisionQueue = xQueueCreate(10, sizeof(LetterDecision));
-    ttsRequestQueue = xQueueCreate(3, sizeof(TTSRequest));
-    audioJobQueue = xQueueCreate(3, sizeof(AudioJob));
+    sensorSampleQueue = sensorSampleQueueStorage.create();
+    letterDecisionQueue = letterDecisionQueueStorage.create();
+    templateEventQueue = templateEventQueueStorage.create();
+    ttsRequestQueue = ttsRequestQueueStorage.create();
+    audioJobQueue = audioJobQueueStorage.create();
 
-    if (!sensorSampleQueue || !sensorWindowQueue || !letterDecisionQueue ||
+    if (!sensorSampleQueue || !letterDecisionQueue || !templateEventQueue ||
         !ttsRequestQueue || !audioJobQueue) {
         Serial.println("[RTOS] Failed to allocate queues!");
         return;
     }
 
-    xTaskCreatePinnedToCore(
-        SensorTask,
-        "SensorTask",
-        3072,
-        nullptr,
-        4,
-        &SensorTaskHandle,
-        0);
-
-    xTaskCreatePinnedToCore(
-        InferenceTask,
-        "InferenceTask",
-        4096,
-        nullptr,
-        3,
-        &InferenceTaskHandle,
-        0);
-
-    xTaskCreatePinnedToCore(
-        LogicTask,
-        "LogicTask",
-        4096,
-        nullptr,
-        2,
-        &LogicTaskHandle,
-        1);
-
-    xTaskCreatePinnedToCore(
-        TTSTask,
-        "TTSTask",
-        12288,
-        nullptr,
-        2,
-        &TTSTaskHandle,
-        1);
-
-    xTaskCreatePinnedToCore(
-        AudioTask,
-        "AudioTask",
-        4096,
-        nullptr,
-        3,
-        &AudioTaskHandle,
-        1);
+    if (!tokenLog.begin(kAslLogFormats, LOG_FORMAT_COUNT)) {
+        Serial.println("[RTOS] Failed to start log drain task.");
+    }
+
+    gSensorHealth = taskSupervisor.addTask("SensorTask", SENSOR_PERIOD_MS, SENSOR_DEADLINE_MS);
+    gInferenceHealth = taskSupervisor.addTask("InferenceTask", 0, INFERENCE_DEADLINE_MS);
+    gSampleQueueHealth = taskSupervisor.addQueue("sensorSample", sensorSampleQueue);
+    gDecisionQueueHealth = taskSupervisor.addQueue("letterDecision", letterDecisionQueue);
+    gTTSQueueHealth = taskSupervisor.addQueue("ttsRequest", ttsRequestQueue);
+    gTemplateQueueHealth = taskSupervisor.addQueue("templateEvent", templateEventQueue);
+    if (!taskSupervisor.begin()) {
+        Serial.println("[RTOS] Failed to start task supervisor.");
+    }
+
+    SensorTaskHandle = sensorTaskStorage.start(SensorTask, "SensorTask", nullptr, 4, 0);
+    InferenceTaskHandle = inferenceTaskStorage.start(InferenceTask, "InferenceTask", nullptr, 3, 0);
+    LogicTaskHandle = logicTaskStorage.start(LogicTask, "LogicTask", nullptr, 2, 1);
+    TTSTaskHandle = ttsTaskStorage.start(TTSTask, "TTSTask", nullptr, 2, 1);
+    AudioTaskHandle = audioTaskStorage.start(AudioTask, "AudioTask", nullptr, 3, 1);
 }
@@ -24,10 +24,11 @@ extern TaskHandle_t LogicTaskHandle;
 extern TaskHandle_t TTSTaskHandle;
 extern TaskHandle_t AudioTaskHandle;
 
-extern bool gImuAvailable;
-extern bool gFingersAvailable;
-extern bool gWifiConnected;
+extern volatile bool gImuAvailable;
+extern volatile bool gFingersAvailable;
+extern volatile bool gWifiConnected;
 extern volatile bool gTTSInProgress;
 extern bool gTTSEnabled;
+extern bool gBeamDecoderEnabled;
 
 void startSystemTasks(const TaskResources& resources);
@@ -0,0 +1,943 @@
+// Host-side replay of recorded glove sessions through the firmware inference
+// path (ASLInferenceEngine + TFLite Micro). Built by the `native_runner`
+// PlatformIO environment; never compiled into the ESP32 image.
+//
+// Usage:
+//   asl_host_runner [--jobs N] [--out results.json] [--no-windows] session.csv...
+//   asl_host_runner --bench model.tflite [--bench model2.tflite ...] [--runs N] [--out cost.json]
+//   asl_host_runner --decode phrases.txt [--lm-weight W] [--out decode.json] session.csv...
+//
+// Each CSV is a DataLogger/csv_collector capture (person_id,label,timestamp,
+// flex1..flex5,ax,ay,az,gx,gy,gz). Samples are pushed into a SampleHistory the
+// way SensorTask does and the ModelRouter runs once per sample, so cascaded
+// short/long stages are scored exactly as on the glove. Classes and the
+// confusion matrix follow the primary (asl_model) package. Every sample also
+// goes through the DataLogger's GestureSegmenter, so each window carries the
+// repetition and rest/active tag it would have been logged with.
+//
+// --bench skips the sessions and instead measures standalone .tflite files
+// (tensor arena bytes and host Invoke() time) for the architecture search in
+// ML_model/model_search.py.
+//
+// --decode splices the recorded sessions into continuous signing of each
+// phrase (one per line): every letter is a slice of that letter's recording
+// followed by a slice of NEUTRAL, words with their own recording are used
+// whole, and words are separated by SPACE (or a pause if SPACE was never
+// recorded). The stream is decoded twice, by LogicTask's greedy hold-to-commit
+// rule and by the BeamDecoder, and both are scored for word/character error
+// rate and words per minute.
+
+// The unit tests (`pio test -e native_runner`) build src/ as well and bring
+// their own main().
+#ifndef PIO_UNIT_TESTING
+
+#include <algorithm>
+#include <atomic>
+#include <cctype>
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <fstream>
+#include <iterator>
+#include <map>
+#include <memory>
+#include <numeric>
+#include <sstream>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "ml/asl_lexicon.h"
+#include "ml/asl_model_config.h"
+#include "ml/beam_decoder.h"
+#include "ml/gesture_segmenter.h"
+#include "ml/model_router.h"
+#include "ml/sample_history.h"
+#include "sensor_types.h"
+#include "text_composer.h"
+
+namespace {
+constexpr size_t kNumClasses = asl_model::kNumClasses;
+constexpr size_t kNumStages = ModelRouter::kNumStages;
+// Raw captures carry gravity, so their mean accel magnitude sits near 9.81
+// m/s²; min-max or z-scored IMU columns stay below ~1.7. imu_is_raw() in
+// data_preprocessing.py applies the same bound.
+constexpr float kMinRawGravity = 0.5f * 9.81f;
+
+struct RunnerOptions {
+    std::vector<std::string> sessions;
+    std::vector<std::string> benchModels;
+    std::string decodePhrases;
+    float lmWeight = BeamDecoder::Params{}.lmWeight;
+    uint32_t benchRuns = 200;
+    std::string outPath = "host_results.json";
+    unsigned jobs = 0;
+    bool perWindow = true;
+};
+
+struct Session {
+    std::string path;
+    std::string label;
+    std::vector<SensorSample> samples;
+};
+
+struct WindowResult {
+    uint32_t timestampMs;
+    int classIndex;  // index into the primary package labels, -1 if unknown
+    int stage;
+    bool gated;
+    const char* label;
+    float confidence;
+    uint32_t latencyUs;
+    uint16_t repetition;
+    bool active;  // segmenter state at the window's newest sample
+    float scores[ModelRouter::kMaxClasses];
+};
+
+struct SessionResult {
+    std::string path;
+    std::string label;
+    int trueIndex{-1};
+    size_t sampleCount{0};
+    size_t activeSamples{0};
+    uint16_t repetitions{0};
+    std::vector<WindowResult> windows;
+    uint32_t stageRuns[kNumStages]{};
+    uint32_t stageInvokes[kNumStages]{};
+    std::string error;
+};
+
+void printUsage(const char* argv0) {
+    std::fprintf(stderr,
+                 "Usage: %s [--jobs N] [--out results.json] [--no-windows] session.csv...\n"
+                 "       %s --bench model.tflite [--bench ...] [--runs N] [--out cost.json]\n"
+                 "       %s --decode phrases.txt [--lm-weight W] [--out decode.json] session.csv...\n",
+                 argv0, argv0, argv0);
+}
+
+bool parseArgs(int argc, char** argv, RunnerOptions& options) {
+    for (int i = 1; i < argc; ++i) {
+        const char* arg = argv[i];
+        if (std::strcmp(arg, "--jobs") == 0 && i + 1 < argc) {
+            options.jobs = static_cast<unsigned>(std::atoi(argv[++i]));
+        } else if (std::strcmp(arg, "--out") == 0 && i + 1 < argc) {
+            options.outPath = argv[++i];
+        } else if (std::strcmp(arg, "--no-windows") == 0) {
+            options.perWindow = false;
+        } else if (std::strcmp(arg, "--bench") == 0 && i + 1 < argc) {
+            options.benchModels.emplace_back(argv[++i]);
+        } else if (std::strcmp(arg, "--runs") == 0 && i + 1 < argc) {
+            options.benchRuns = static_cast<uint32_t>(std::max(1, std::atoi(argv[++i])));
+        } else if (std::strcmp(arg, "--decode") == 0 && i + 1 < argc) {
+            options.decodePhrases = argv[++i];
+        } else if (std::strcmp(arg, "--lm-weight") == 0 && i + 1 < argc) {
+            options.lmWeight = std::strtof(argv[++i], nullptr);
+        } else if (arg[0] == '-') {
+            return false;
+        } else {
+            options.sessions.emplace_back(arg);
+        }
+    }
+    return !options.sessions.empty() || !options.benchModels.empty();
+}
+
+std::vector<std::string> splitCsvLine(const std::string& line) {
+    std::vector<std::string> fields;
+    std::stringstream stream(line);
+    std::string field;
+    while (std::getline(stream, field, ',')) {
+        if (!field.empty() && field.back() == '\r') {
+            field.pop_back();
+        }
+        fields.push_back(field);
+    }
+    return fields;
+}
+
+int columnIndex(const std::vector<std::string>& header, const char* name) {
+    for (size_t i = 0; i < header.size(); ++i) {
+        if (header[i] == name) {
+            return static_cast<int>(i);
+        }
+    }
+    return -1;
+}
+
+bool loadSession(const std::string& path, Session& session, std::string& error) {
+    std::ifstream file(path);
+    if (!file) {
+        error = "cannot open file";
+        return false;
+    }
+
+    std::string line;
+    if (!std::getline(file, line)) {
+        error = "empty file";
+        return false;
+    }
+    const std::vector<std::string> header = splitCsvLine(line);
+
+    static const char* kFlexColumns[5] = {"flex1", "flex2", "flex3", "flex4", "flex5"};
+    static const char* kImuColumns[6] = {"ax", "ay", "az", "gx", "gy", "gz"};
+    int flexIdx[5];
+    int imuIdx[6];
+    for (size_t i = 0; i < 5; ++i) {
+        flexIdx[i] = columnIndex(header, kFlexColumns[i]);
+        if (flexIdx[i] < 0) {
+            error = std::string("missing column ") + kFlexColumns[i];
+            return false;
+        }
+    }
+    for (size_t i = 0; i < 6; ++i) {
+        imuIdx[i] = columnIndex(header, kImuColumns[i]);
+        if (imuIdx[i] < 0) {
+            error = std::string("missing column ") + kImuColumns[i];
+            return false;
+        }
+    }
+    const int labelIdx = columnIndex(header, "label");
+    const int timestampIdx = columnIndex(header, "timestamp");
+
+    session.path = path;
+    double gravitySum = 0.0;
+    while (std::getline(file, line)) {
+        const std::vector<std::string> fields = splitCsvLine(line);
+        if (fields.size() < header.size()) {
+            continue;
+        }
+
+        SensorSample sample{};
+        sample.timestampMs = timestampIdx >= 0
+                                 ? static_cast<uint32_t>(std::strtoul(fields[timestampIdx].c_str(), nullptr, 10))
+                                 : static_cast<uint32_t>(session.samples.size() * 20);
+        sample.seq = static_cast<uint16_t>(session.samples.size());
+        float flex[5];
+        float accel[3];
+        float gyro[3];
+        for (size_t i = 0; i < 5; ++i) {
+            flex[i] = std::strtof(fields[flexIdx[i]].c_str(), nullptr);
+        }
+        // DataLogger writes the raw m/s² and rad/s readings; packing them
+        // back into sensor counts reproduces what SensorTask stored.
+        for (size_t i = 0; i < 3; ++i) {
+            accel[i] = std::strtof(fields[imuIdx[i]].c_str(), nullptr);
+            gyro[i] = std::strtof(fields[imuIdx[i + 3]].c_str(), nullptr);
+        }
+        gravitySum += std::sqrt(accel[0] * accel[0] + accel[1] * accel[1] + accel[2] * accel[2]);
+        sample.setFlex(flex);
+        sample.setImu(accel, gyro);
+
+        if (labelIdx >= 0 && session.label.empty()) {
+            session.label = fields[labelIdx];
+        }
+        session.samples.push_back(sample);
+    }
+    // Older firmware logged normalized IMU columns (min-max or z-scored).
+    // The engine would normalize those a second time, so they are not replayed.
+    if (!session.samples.empty() && gravitySum / session.samples.size() < kMinRawGravity) {
+        error = "IMU columns are normalized, not raw m/s² and rad/s";
+        return false;
+    }
+    return true;
+}
+
+int labelToIndex(const char* label) {
+    if (!label) {
+        return -1;
+    }
+    for (size_t i = 0; i < kNumClasses; ++i) {
+        if (std::strcmp(label, asl_model::kLabelNames[i]) == 0) {
+            return static_cast<int>(i);
+        }
+    }
+    return -1;
+}
+
+// Mirrors SensorTask + InferenceTask: push each sample into the history and
+// run the router once per sample.
+void runSession(ModelRouter& router, const Session& session, SessionResult& result) {
+    auto history = std::make_unique<SampleHistory>();
+    GestureSegmenter segmenter;
+
+    result.sampleCount = session.samples.size();
+    result.trueIndex = labelToIndex(session.label.c_str());
+
+    uint32_t runsBefore[kNumStages];
+    uint32_t invokesBefore[kNumStages];
+    for (size_t i = 0; i < kNumStages; ++i) {
+        runsBefore[i] = router.runs(i);
+        invokesBefore[i] = router.invokes(i);
+    }
+
+    for (const SensorSample& sample : session.samples) {
+        history->push(sample);
+        const GestureSegmenter::Tag tag = segmenter.update(sample);
+        if (tag.active) {
+            result.activeSamples++;
+        }
+
+        WindowResult window{};
+        window.timestampMs = sample.timestampMs;
+        window.repetition = tag.repetition;
+        window.active = tag.active;
+        InferenceResult inference;
+
+        const auto start = std::chrono::steady_clock::now();
+        const bool classified = router.classify(*history, inference, window.scores);
+        const auto end = std::chrono::steady_clock::now();
+        if (!classified) {
+            continue;
+        }
+        window.latencyUs = static_cast<uint32_t>(
+            std::chrono::duration_cast<std::chrono::microseconds>(end - start).count());
+        window.stage = inference.stage;
+        window.gated = inference.gated;
+        window.label = inference.label;
+        window.confidence = inference.confidence;
+        window.classIndex = labelToIndex(inference.label);
+
+        result.windows.push_back(window);
+    }
+
+    result.repetitions = segmenter.repetitions();
+    for (size_t i = 0; i < kNumStages; ++i) {
+        result.stageRuns[i] = router.runs(i) - runsBefore[i];
+        result.stageInvokes[i] = router.invokes(i) - invokesBefore[i];
+    }
+}
+
+uint32_t percentile(std::vector<uint32_t> values, double fraction) {
+    if (values.empty()) return 0;
+    std::sort(values.begin(), values.end());
+    const size_t idx = static_cast<size_t>(fraction * (values.size() - 1) + 0.5);
+    return values[std::min(idx, values.size() - 1)];
+}
+
+std::string jsonEscape(const std::string& value) {
+    std::string out;
+    for (char c : value) {
+        if (c == '"' || c == '\\') {
+            out += '\\';
+        }
+        out += c;
+    }
+    return out;
+}
+
+void writeLatency(std::ostream& out, const std::vector<uint32_t>& latencies) {
+    uint64_t total = 0;
+    uint32_t maxUs = 0;
+    for (uint32_t value : latencies) {
+        total += value;
+        maxUs = std::max(maxUs, value);
+    }
+    const double mean = latencies.empty() ? 0.0 : static_cast<double>(total) / latencies.size();
+    out << "{\"count\": " << latencies.size()
+        << ", \"mean_us\": " << mean
+        << ", \"p50_us\": " << percentile(latencies, 0.50)
+        << ", \"p95_us\": " << percentile(latencies, 0.95)
+        << ", \"max_us\": " << maxUs << "}";
+}
+
+bool writeResults(const RunnerOptions& options,
+                  const ModelRouter& router,
+                  const std::vector<SessionResult>& results) {
+    std::ofstream out(options.outPath);
+    if (!out) {
+        std::fprintf(stderr, "[Runner] Cannot write %s\n", options.outPath.c_str());
+        return false;
+    }
+
+    const size_t numClasses = kNumClasses;
+    std::vector<std::vector<uint32_t>> confusion(numClasses, std::vector<uint32_t>(numClasses, 0));
+    std::vector<uint32_t> allLatencies;
+    uint64_t stageRuns[kNumStages]{};
+    uint64_t stageAnswers[kNumStages]{};
+    uint64_t stageInvokes[kNumStages]{};
+    size_t scored = 0;
+    size_t correct = 0;
+    size_t activeScored = 0;
+    size_t activeCorrect = 0;
+
+    out << "{\n  \"classes\": [";
+    for (size_t i = 0; i < numClasses; ++i) {
+        out << (i ? ", " : "") << "\"" << jsonEscape(asl_model::kLabelNames[i]) << "\"";
+    }
+    out << "],\n  \"window_size\": " << asl_model::kWindowSize << ",\n  \"stages\": [";
+    for (size_t i = 0; i < kNumStages; ++i) {
+        const asl_model::ModelDescriptor& model = router.stage(i).model();
+        out << (i ? ", " : "") << "{\"name\": \"" << model.name << "\""
+            << ", \"window_size\": " << model.windowSize
+            << ", \"sample_stride\": " << model.sampleStride
+            << ", \"gate\": " << (router.stage(i).hasGate() ? "true" : "false") << "}";
+    }
+    out << "],\n  \"sessions\": [\n";
+
+    for (size_t s = 0; s < results.size(); ++s) {
+        const SessionResult& result = results[s];
+        std::vector<uint32_t> latencies;
+        size_t sessionCorrect = 0;
+        for (size_t i = 0; i < kNumStages; ++i) {
+            stageRuns[i] += result.stageRuns[i];
+            stageInvokes[i] += result.stageInvokes[i];
+        }
+        for (const WindowResult& window : result.windows) {
+            latencies.push_back(window.latencyUs);
+            stageAnswers[window.stage]++;
+            if (result.trueIndex >= 0) {
+                // A label the primary model does not know (e.g. a short-stage
+                // letter) counts against the session.
+                scored++;
+                if (window.classIndex >= 0) {
+                    confusion[result.trueIndex][window.classIndex]++;
+                }
+                if (window.classIndex == result.trueIndex) {
+                    correct++;
+                    sessionCorrect++;
+                }
+                if (window.active) {
+                    activeScored++;
+                    activeCorrect += window.classIndex == result.trueIndex;
+                }
+            }
+        }
+        allLatencies.insert(allLatencies.end(), latencies.begin(), latencies.end());
+
+        out << "    {\"file\": \"" << jsonEscape(result.path) << "\""
+            << ", \"label\": \"" << jsonEscape(result.label) << "\""
+            << ", \"samples\": " << result.sampleCount
+            << ", \"repetitions\": " << result.repetitions
+            << ", \"active_samples\": " << result.activeSamples
+            << ", \"window_count\": " << result.windows.size();
+        if (!result.error.empty()) {
+            out << ", \"error\": \"" << jsonEscape(result.error) << "\"";
+        }
+        if (result.trueIndex >= 0 && !result.windows.empty()) {
+            out << ", \"accuracy\": " << static_cast<double>(sessionCorrect) / result.windows.size();
+        }
+        out << ", \"latency\": ";
+        writeLatency(out, latencies);
+
+        if (options.perWindow) {
+            out << ",\n     \"windows\": [";
+            for (size_t w = 0; w < result.windows.size(); ++w) {
+                const WindowResult& window = result.windows[w];
+                out << (w ? ",\n       " : "\n       ")
+                    << "{\"t\": " << window.timestampMs
+                    << ", \"class\": " << window.classIndex
+                    << ", \"label\": \"" << jsonEscape(window.label ? window.label : "")
+                    << "\", \"stage\": " << window.stage
+                    << ", \"gated\": " << (window.gated ? "true" : "false")
+                    << ", \"confidence\": " << window.confidence
+                    << ", \"latency_us\": " << window.latencyUs
+                    << ", \"rep\": " << window.repetition
+                    << ", \"active\": " << (window.active ? "true" : "false")
+                    << ", \"scores\": [";
+                const size_t stageClasses = router.stage(window.stage).numClasses();
+                for (size_t c = 0; c < stageClasses; ++c) {
+                    out << (c ? ", " : "") << window.scores[c];
+                }
+                out << "]}";
+            }
+            out << "]";
+        }
+        out << "}" << (s + 1 < results.size() ? "," : "") << "\n";
+    }
+
+    out << "  ],\n  \"confusion_matrix\": [\n";
+    for (size_t t = 0; t < numClasses; ++t) {
+        out << "    [";
+        for (size_t p = 0; p < numClasses; ++p) {
+            out << (p ? ", " : "") << confusion[t][p];
+        }
+        out << "]" << (t + 1 < numClasses ? "," : "") << "\n";
+    }
+    out << "  ],\n  \"summary\": {\"scored_windows\": " << scored
+        << ", \"accuracy\": " << (scored ? static_cast<double>(correct) / scored : 0.0)
+        << ", \"active_scored_windows\": " << activeScored
+        << ", \"active_accuracy\": " << (activeScored ? static_cast<double>(activeCorrect) / activeScored : 0.0)
+        << ", \"stage_runs\": [";
+    for (size_t i = 0; i < kNumStages; ++i) {
+        out << (i ? ", " : "") << stageRuns[i];
+    }
+    out << "], \"stage_answers\": [";
+    for (size_t i = 0; i < kNumStages; ++i) {
+        out << (i ? ", " : "") << stageAnswers[i];
+    }
+    out << "], \"stage_invokes\": [";
+    uint64_t totalRuns = 0;
+    uint64_t totalInvokes = 0;
+    for (size_t i = 0; i < kNumStages; ++i) {
+        out << (i ? ", " : "") << stageInvokes[i];
+        totalRuns += stageRuns[i];
+        totalInvokes += stageInvokes[i];
+    }
+    // Fraction of stage classifications the gates answered without the model.
+    out << "], \"gate_skip_rate\": "
+        << (totalRuns ? 1.0 - static_cast<double>(totalInvokes) / totalRuns : 0.0)
+        << ", \"escalation_rate\": "
+        << (kNumStages > 1 && stageRuns[0] ? static_cast<double>(stageRuns[kNumStages - 1]) / stageRuns[0] : 0.0)
+        << ", \"latency\": ";
+    writeLatency(out, allLatencies);
+    out << "}\n}\n";
+
+    std::printf("[Runner] %zu sessions, %zu scored windows, accuracy %.4f\n",
+                results.size(),
+                scored,
+                scored ? static_cast<double>(correct) / scored : 0.0);
+    std::printf("[Runner] Model invoked on %llu of %llu stage runs, mean %.1f us per window\n",
+                static_cast<unsigned long long>(totalInvokes),
+                static_cast<unsigned long long>(totalRuns),
+                allLatencies.empty() ? 0.0
+                                     : static_cast<double>(std::accumulate(allLatencies.begin(),
+                                                                           allLatencies.end(), uint64_t{0})) /
+                                           allLatencies.size());
+    std::printf("[Runner] Results written to %s\n", options.outPath.c_str());
+    return true;
+}
+// Measures each --bench model in turn (single thread, so timings do not
+// contend) and writes one JSON record per model.
+int runBench(const RunnerOptions& options) {
+    std::ofstream out(options.outPath);
+    if (!out) {
+        std::fprintf(stderr, "[Runner] Cannot write %s\n", options.outPath.c_str());
+        return 1;
+    }
+
+    bool allOk = true;
+    out << "{\n  \"arena_budget_bytes\": " << ASLInferenceEngine::kTensorArenaSize
+        << ",\n  \"models\": [\n";
+    for (size_t m = 0; m < options.benchModels.size(); ++m) {
+        const std::string& path = options.benchModels[m];
+        std::ifstream file(path, std::ios::binary);
+        std::vector<unsigned char> data((std::istreambuf_iterator<char>(file)),
+                                        std::istreambuf_iterator<char>());
+
+        ModelCost cost;
+        const bool ok = !data.empty() && measureModelCost(data.data(), options.benchRuns, cost);
+        allOk = allOk && ok;
+
+        out << "    {\"file\": \"" << jsonEscape(path) << "\""
+            << ", \"model_bytes\": " << data.size();
+        if (ok) {
+            out << ", \"arena_bytes\": " << cost.arenaBytes
+                << ", \"fits_arena\": " << (cost.arenaBytes <= ASLInferenceEngine::kTensorArenaSize ? "true" : "false")
+                << ", \"input_bytes\": " << cost.inputBytes
+                << ", \"output_bytes\": " << cost.outputBytes
+                << ", \"runs\": " << cost.runs
+                << ", \"mean_invoke_us\": " << cost.meanInvokeUs
+                << ", \"min_invoke_us\": " << cost.minInvokeUs;
+            std::printf("[Runner] %s: %zu B model, %zu B arena, %.1f us/invoke\n", path.c_str(),
+                        data.size(), cost.arenaBytes, cost.meanInvokeUs);
+        } else {
+            out << ", \"error\": \"" << (data.empty() ? "cannot read model" : "cannot run model") << "\"";
+            std::fprintf(stderr, "[Runner] %s: failed to benchmark\n", path.c_str());
+        }
+        out << "}" << (m + 1 < options.benchModels.size() ? "," : "") << "\n";
+    }
+    out << "  ]\n}\n";
+    std::printf("[Runner] Results written to %s\n", options.outPath.c_str());
+    return allOk ? 0 : 1;
+}
+
+// Continuous-signing benchmark (--decode). Slice lengths are in 50 Hz samples.
+constexpr size_t kLetterSamples = 40;   // 0.8 s per letter
+constexpr size_t kGapSamples = 12;      // neutral between letters
+constexpr size_t kPauseSamples = 80;    // between words without SPACE, and at the end
+constexpr size_t kHoldSamples = 10;     // LogicTask LETTER_HOLD_MS at 50 Hz
+constexpr float kMinConfidence = 0.85f; // LogicTask MIN_CONFIDENCE_THRESHOLD
+
+std::string upperCase(std::string text) {
+    for (char& c : text) {
+        c = static_cast<char>(std::toupper(static_cast<unsigned char>(c)));
+    }
+    return text;
+}
+
+std::vector<std::string> splitWords(const std::string& text) {
+    std::vector<std::string> words;
+    std::stringstream stream(text);
+    std::string word;
+    while (stream >> word) {
+        words.push_back(word);
+    }
+    return words;
+}
+
+template <typename T>
+size_t editDistance(const std::vector<T>& a, const std::vector<T>& b) {
+    std::vector<size_t> row(b.size() + 1);
+    std::iota(row.begin(), row.end(), size_t{0});
+    for (size_t i = 1; i <= a.size(); ++i) {
+        size_t diagonal = row[0];
+        row[0] = i;
+        for (size_t j = 1; j <= b.size(); ++j) {
+            const size_t above = row[j];
+            row[j] = std::min({row[j] + 1, row[j - 1] + 1, diagonal + (a[i - 1] == b[j - 1] ? 0 : 1)});
+            diagonal = above;
+        }
+    }
+    return row[b.size()];
+}
+
+// Recorded sessions by upper-case label; NEUTR and BACK are the short
+// spellings csv_collector writes.
+class SpliceSource {
+public:
+    void add(Session session) {
+        std::string label = upperCase(session.label);
+        if (label == "NEUTR") label = "NEUTRAL";
+        if (label == "BACK") label = "BACKSPACE";
+        if (!session.samples.empty()) {
+            byLabel_[label].push_back(std::move(session));
+        }
+    }
+
+    bool has(const std::string& label) const { return byLabel_.count(label) > 0; }
+
+    // Appends `count` samples of `label` (all of it if count is 0), walking
+    // through its recordings so repeated letters do not reuse one slice.
+    bool append(const std::string& label, size_t count, std::vector<SensorSample>& out) {
+        auto it = byLabel_.find(label);
+        if (it == byLabel_.end()) {
+            return false;
+        }
+        size_t& use = uses_[label];
+        const Session& session = it->second[use % it->second.size()];
+        const size_t total = session.samples.size();
+        const size_t length = (count == 0 || count > total) ? total : count;
+        // Skip the start of the recording, where the hand is still moving in.
+        const size_t slots = total - length + 1;
+        const size_t start = (total / 4 + use * 37) % slots;
+        use++;
+        for (size_t i = 0; i < length; ++i) {
+            SensorSample sample = session.samples[start + i];
+            sample.timestampMs = static_cast<uint32_t>(out.size() * 20);
+            sample.seq = static_cast<uint16_t>(out.size());
+            out.push_back(sample);
+        }
+        return true;
+    }
+
+private:
+    std::map<std::string, std::vector<Session>> byLabel_;
+    std::map<std::string, size_t> uses_;
+};
+
+bool splicePhrase(SpliceSource& source, const std::vector<std::string>& words,
+                  std::vector<SensorSample>& out, std::string& missing) {
+    const bool hasSpace = source.has("SPACE");
+    for (size_t w = 0; w < words.size(); ++w) {
+        const std::string& word = words[w];
+        if (w > 0) {
+            if (hasSpace) {
+                source.append("SPACE", kLetterSamples, out);
+                source.append("NEUTRAL", kGapSamples, out);
+            } else {
+                source.append("NEUTRAL", kPauseSamples, out);
+            }
+        }
+        if (word.size() > 1 && source.has(word)) {
+            source.append(word, 0, out);
+            source.append("NEUTRAL", kGapSamples, out);
+            continue;
+        }
+        for (char letter : word) {
+            if (!source.append(std::string(1, letter), kLetterSamples, out)) {
+                missing = std::string(1, letter);
+                return false;
+            }
+            source.append("NEUTRAL", kGapSamples, out);
+        }
+    }
+    source.append("NEUTRAL", kPauseSamples, out);
+    return true;
+}
+
+// LogicTask's letter state machine: a non-neutral, confident class held for
+// kHoldSamples commits once, then waits for neutral.
+class HoldCommitter {
+public:
+    // Returns true when the decision commits.
+    bool step(const InferenceResult& result) {
+        const bool neutral = result.letter == asl_model::kNeutralToken || result.confidence < kMinConfidence;
+        switch (state_) {
+            case State::Neutral:
+                if (!neutral) {
+                    held_ = result.letter;
+                    holdStart_ = tick_;
+                    state_ = State::Held;
+                }
+                break;
+            case State::Held:
+                if (result.letter == held_) {
+                    if (tick_ - holdStart_ >= kHoldSamples) {
+                        state_ = State::WaitNeutral;
+                        tick_++;
+                        return true;
+                    }
+                } else if (neutral) {
+                    state_ = State::Neutral;
+                }
+                break;
+            case State::WaitNeutral:
+                if (neutral) {
+                    state_ = State::Neutral;
+                }
+                break;
+        }
+        tick_++;
+        return false;
+    }
+
+private:
+    enum class State { Neutral, Held, WaitNeutral };
+    State state_{State::Neutral};
+    char held_{0};
+    size_t holdStart_{0};
+    size_t tick_{0};
+};
+
+struct DecodeScore {
+    size_t wordErrors{0};
+    size_t words{0};
+    size_t charErrors{0};
+    size_t chars{0};
+    size_t outputChars{0};
+    double seconds{0.0};
+
+    void add(const std::string& target, const std::string& output, double duration) {
+        const std::vector<std::string> targetWords = splitWords(target);
+        const std::vector<std::string> outputWords = splitWords(output);
+        const std::vector<char> targetChars(target.begin(), target.end());
+        const std::vector<char> outputChars(output.begin(), output.end());
+        wordErrors += editDistance(targetWords, outputWords);
+        words += targetWords.size();
+        charErrors += editDistance(targetChars, outputChars);
+        chars += target.size();
+        this->outputChars += output.size();
+        seconds += duration;
+    }
+
+    double wer() const { return words ? static_cast<double>(wordErrors) / words : 0.0; }
+    double cer() const { return chars ? std::min(1.0, static_cast<double>(charErrors) / chars) : 0.0; }
+    // Text-entry convention: five characters (including spaces) per word.
+    double wpm() const { return seconds > 0.0 ? (outputChars / 5.0) / (seconds / 60.0) : 0.0; }
+    double effectiveWpm() const { return wpm() * (1.0 - cer()); }
+
+    void write(std::ostream& out) const {
+        out << "{\"wer\": " << wer() << ", \"cer\": " << cer() << ", \"wpm\": " << wpm()
+            << ", \"effective_wpm\": " << effectiveWpm() << "}";
+    }
+};
+
+std::string trimmed(const char* text) {
+    std::string value(text);
+    while (!value.empty() && value.back() == ' ') {
+        value.pop_back();
+    }
+    return value;
+}
+
+int runDecode(const RunnerOptions& options) {
+    std::ifstream phraseFile(options.decodePhrases);
+    if (!phraseFile) {
+        std::fprintf(stderr, "[Runner] Cannot read %s\n", options.decodePhrases.c_str());
+        return 1;
+    }
+    std::vector<std::string> phrases;
+    std::string line;
+    while (std::getline(phraseFile, line)) {
+        const std::string phrase = upperCase(line.substr(0, line.find('#')));
+        if (!splitWords(phrase).empty()) {
+            phrases.push_back(phrase);
+        }
+    }
+
+    SpliceSource source;
+    for (const std::string& path : options.sessions) {
+        Session session;
+        std::string error;
+        if (!loadSession(path, session, error)) {
+            std::fprintf(stderr, "[Runner] %s: %s\n", path.c_str(), error.c_str());
+            continue;
+        }
+        source.add(std::move(session));
+    }
+
+    auto router = std::make_unique<ModelRouter>();
+    if (!router->begin()) {
+        std::fprintf(stderr, "[Runner] Failed to initialize inference engine.\n");
+        return 1;
+    }
+    auto decoder = std::make_unique<BeamDecoder>(asl_lexicon::kLexicon);
+    BeamDecoder::Params params;
+    params.lmWeight = options.lmWeight;
+    decoder->setParams(params);
+    auto greedyText = std::make_unique<TextComposer>();
+    auto beamText = std::make_unique<TextComposer>();
+    for (size_t i = 0; i < kNumStages; ++i) {
+        decoder->setVocabulary(i, router->stage(i).model());
+        greedyText->setVocabulary(i, router->stage(i).model());
+        beamText->setVocabulary(i, router->stage(i).model());
+    }
+
+    std::ofstream out(options.outPath);
+    if (!out) {
+        std::fprintf(stderr, "[Runner] Cannot write %s\n", options.outPath.c_str());
+        return 1;
+    }
+
+    DecodeScore greedyScore;
+    DecodeScore beamScore;
+    std::vector<uint32_t> decodeLatencies;
+    size_t maxExpansions = 0;
+    size_t skipped = 0;
+    float scores[ModelRouter::kMaxClasses];
+
+    out << "{\n  \"lexicon_words\": " << decoder->lexiconWords()
+        << ",\n  \"lm_weight\": " << params.lmWeight << ",\n  \"phrases\": [\n";
+    bool first = true;
+    for (const std::string& phrase : phrases) {
+        std::vector<SensorSample> stream;
+        std::string missing;
+        if (!splicePhrase(source, splitWords(phrase), stream, missing)) {
+            std::fprintf(stderr, "[Runner] Skipping \"%s\": no recording of %s\n", phrase.c_str(), missing.c_str());
+            skipped++;
+            continue;
+        }
+
+        auto history = std::make_unique<SampleHistory>();
+        HoldCommitter greedyHold;
+        HoldCommitter beamHold;
+        greedyText->clear();
+        beamText->clear();
+        decoder->reset();
+
+        for (const SensorSample& sample : stream) {
+            history->push(sample);
+            InferenceResult result;
+            if (!router->classify(*history, result, scores)) {
+                continue;
+            }
+            const size_t stage = static_cast<size_t>(result.stage);
+            const size_t classIndex = static_cast<size_t>(result.classIndex);
+
+            if (greedyHold.step(result)) {
+                greedyText->commit(stage, classIndex);
+            }
+            // With the decoder, the hold rule only handles what it leaves out
+            if (beamHold.step(result) && !decoder->handles(stage, classIndex)) {
+                beamText->commit(stage, classIndex);
+            }
+
+            const BeamDecoder::Observation observation = BeamDecoder::Observation::fromScores(
+                result.stage, scores, router->stage(stage).numClasses());
+            const auto start = std::chrono::steady_clock::now();
+            decoder->update(observation);
+            const auto end = std::chrono::steady_clock::now();
+            decodeLatencies.push_back(static_cast<uint32_t>(
+                std::chrono::duration_cast<std::chrono::nanoseconds>(end - start).count() / 1000));
+            maxExpansions = std::max(maxExpansions, decoder->lastExpansions());
+
+            uint16_t word;
+            while (decoder->popWord(word)) {
+                beamText->commitWord(decoder->wordText(word));
+            }
+        }
+        decoder->flush();
+        uint16_t word;
+        while (decoder->popWord(word)) {
+            beamText->commitWord(decoder->wordText(word));
+        }
+
+        const double seconds = stream.size() / static_cast<double>(asl_model::kSensorRateHz);
+        const std::string greedyOut = trimmed(greedyText->text());
+        const std::string beamOut = trimmed(beamText->text());
+        greedyScore.add(phrase, greedyOut, seconds);
+        beamScore.add(phrase, beamOut, seconds);
+
+        out << (first ? "" : ",\n") << "    {\"target\": \"" << jsonEscape(phrase) << "\""
+            << ", \"seconds\": " << seconds
+            << ", \"greedy\": \"" << jsonEscape(greedyOut) << "\""
+            << ", \"beam\": \"" << jsonEscape(beamOut) << "\"}";
+        first = false;
+    }
+
+    out << "\n  ],\n  \"skipped\": " << skipped << ",\n  \"greedy\": ";
+    greedyScore.write(out);
+    out << ",\n  \"beam\": ";
+    beamScore.write(out);
+    out << ",\n  \"decoder_latency\": ";
+    writeLatency(out, decodeLatencies);
+    out << ",\n  \"max_expansions\": " << maxExpansions
+        << ", \"expansion_budget\": " << BeamDecoder::kMaxCandidates << "\n}\n";
+
+    std::printf("[Runner] %zu phrases decoded, %zu skipped\n", phrases.size() - skipped, skipped);
+    std::printf("[Runner] greedy: WER %.3f CER %.3f, %.1f WPM (%.1f effective)\n", greedyScore.wer(),
+                greedyScore.cer(), greedyScore.wpm(), greedyScore.effectiveWpm());
+    std::printf("[Runner] beam:   WER %.3f CER %.3f, %.1f WPM (%.1f effective), p95 %u us/window\n",
+                beamScore.wer(), beamScore.cer(), beamScore.wpm(), beamScore.effectiveWpm(),
+                percentile(decodeLatencies, 0.95));
+    std::printf("[Runner] Results written to %s\n", options.outPath.c_str());
+    return 0;
+}
+}  // namespace
+
+int main(int argc, char** argv) {
+    RunnerOptions options;
+    if (!parseArgs(argc, argv, options)) {
+        printUsage(argv[0]);
+        return 2;
+    }
+    if (!options.benchModels.empty()) {
+        return runBench(options);
+    }
+    if (!options.decodePhrases.empty()) {
+        return runDecode(options);
+    }
+
+    unsigned jobs = options.jobs ? options.jobs : std::thread::hardware_concurrency();
+    jobs = std::max(1u, std::min<unsigned>(jobs, options.sessions.size()));
+
+    // One router (engines and tensor arenas) per worker; the interpreter is
+    // not re-entrant.
+    std::vector<std::unique_ptr<ModelRouter>> routers;
+    for (unsigned i = 0; i < jobs; ++i) {
+        routers.emplace_back(new ModelRouter());
+        if (!routers.back()->begin()) {
+            std::fprintf(stderr, "[Runner] Failed to initialize inference engine.\n");
+            return 1;
+        }
+    }
+
+    std::vector<SessionResult> results(options.sessions.size());
+    std::atomic<size_t> next{0};
+    auto worker = [&](ModelRouter* router) {
+        for (size_t i = next++; i < options.sessions.size(); i = next++) {
+            Session session;
+            SessionResult& result = results[i];
+            result.path = options.sessions[i];
+            if (!loadSession(options.sessions[i], session, result.error)) {
+                std::fprintf(stderr, "[Runner] %s: %s\n", result.path.c_str(), result.error.c_str());
+                continue;
+            }
+            result.label = session.label;
+            runSession(*router, session, result);
+        }
+    };
+
+    std::vector<std::thread> threads;
+    for (unsigned i = 0; i < jobs; ++i) {
+        threads.emplace_back(worker, routers[i].get());
+    }
+    for (std::thread& thread : threads) {
+        thread.join();
+    }
+
+    return writeResults(options, *routers.front(), results) ? 0 : 1;
+}
+
+#endif  // PIO_UNIT_TESTING
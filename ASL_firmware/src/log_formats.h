@@ -0,0 +1,22 @@
+#pragma once
+
+// Format table for tokenized logging (lib/token_log). Entries are only ever
+// appended: the ID is the position in this list, and python/src/decode_log.py
+// parses this file to decode binary captures. Arguments are 32-bit words, so
+// use %d/%u/%x/%c for integers, %f/%e/%g for floats, and %s only for short
+// strings (copied inline, truncated to 11 chars).
+#define ASL_LOG_FORMATS(X)                                                              \
+    X(LOG_IMU_READING, "[IMU] A: %.2f %.2f %.2f | G: %.2f %.2f %.2f\n")                  \
+    X(LOG_FINGER_ANGLES, "[FINGERS] T:%.0f I:%.0f M:%.0f R:%.0f P:%.0f\n")               \
+    X(LOG_INFERENCE, "[Inference] Label: %s | Letter: %c | Confidence: %.2f%s | Stage: %u\n") \
+    X(LOG_SHAKE_MAG, "[SHAKE] Mag: %.2f\n")                                              \
+    X(LOG_SHAKE_DETECTED, "[LogicTask] Shake detected.\n")                               \
+    X(LOG_TTS_FREE_HEAP, "[TTSTask] Free heap: %u bytes\n")                              \
+    X(LOG_AUDIO_FREE_HEAP, "[AudioTask] Free heap after cleanup: %u bytes\n")
+
+#define ASL_LOG_ENUM(id, fmt) id,
+enum AslLogId : uint16_t { ASL_LOG_FORMATS(ASL_LOG_ENUM) LOG_FORMAT_COUNT };
+#undef ASL_LOG_ENUM
+
+// Defined in freertos_tasks.cpp
+extern const char* const kAslLogFormats[LOG_FORMAT_COUNT];
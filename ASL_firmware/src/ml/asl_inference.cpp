@@ -1,14 +1,13 @@
 #include "ml/asl_inference.h"
 
-#include <Arduino.h>
-
 #include <algorithm>
-#include <array>
 #include <cmath>
 #include <cstdint>
+#include <cstring>
+#include <new>
 
-#include "ml/asl_model_data.h"
 #include "ml/imu_normalization.h"
+#include "ml/prototype_classifier.h"
 
 #include "tensorflow/lite/c/common.h"
 #include "tensorflow/lite/micro/micro_error_reporter.h"
@@ -20,27 +19,29 @@
 #define TFLITE_SCHEMA_VERSION (3)
 #endif
 
+// The engine is also built for the host runner (src/host), so logging must not
+// depend on the Arduino core.
+#ifdef ARDUINO
+#include <Arduino.h>
+#define ML_LOG(...) Serial.printf(__VA_ARGS__)
+#else
+#include <cstdio>
+#define ML_LOG(...) std::fprintf(stderr, __VA_ARGS__)
+#endif
+
 namespace {
-constexpr size_t kWindowSize = 25;
-constexpr size_t kNumFlex = 5;
-constexpr size_t kNumIMU = 6;
-constexpr size_t kNumFeatures = kNumFlex + kNumIMU;
-constexpr size_t kNumClasses = 2;
-constexpr int kTensorArenaSize = 90 * 1024;
-
-alignas(16) uint8_t tensor_arena[kTensorArenaSize];
-tflite::MicroErrorReporter micro_error_reporter;
-tflite::ErrorReporter* error_reporter = &micro_error_reporter;
-tflite::MicroInterpreter* interpreter = nullptr;
-TfLiteTensor* input_tensor = nullptr;
-TfLiteTensor* output_tensor = nullptr;
+using asl_model::kNumFeatures;
+using asl_model::kNumFlex;
+using asl_model::kNumImu;
 
-constexpr std::array<const char*, kNumClasses> kLabelNames = {
-    "EAT", "HELLO"};
+static_assert(sizeof(SensorSample::flex) / sizeof(SensorSample::flex[0]) == kNumFlex,
+              "SensorSample flex channels do not match the model");
+static_assert(sizeof(SensorSample::accel) / sizeof(SensorSample::accel[0]) +
+                      sizeof(SensorSample::gyro) / sizeof(SensorSample::gyro[0]) == kNumImu,
+              "SensorSample IMU channels do not match the model");
 
-constexpr std::array<char, kNumClasses> kLabelToChar = {
-    'E',
-    'H'};
+tflite::MicroErrorReporter micro_error_reporter;
+tflite::ErrorReporter* error_reporter = &micro_error_reporter;
 
 inline int8_t quantize(float value, float scale, int zero_point) {
     int32_t quantized = static_cast<int32_t>(std::round(value / scale) + zero_point);
@@ -51,117 +52,231 @@ inline int8_t quantize(float value, float scale, int zero_point) {
 float dequantize(int8_t value, float scale, int zero_point) {
     return (static_cast<int>(value) - zero_point) * scale;
 }
+
+// Shared by every engine instance; registration runs once even when the host
+// runner brings up engines from several threads.
+tflite::MicroMutableOpResolver<11>& opResolver() {
+    static tflite::MicroMutableOpResolver<11> resolver;
+    static const bool registered = [] {
+        resolver.AddConv2D();
+        resolver.AddAdd();
+        resolver.AddMul();
+        resolver.AddMean();
+        resolver.AddReshape();
+        resolver.AddFullyConnected();
+        resolver.AddMaxPool2D();
+        resolver.AddSoftmax();
+        resolver.AddExpandDims();
+        resolver.AddQuantize();
+        resolver.AddDequantize();
+        return true;
+    }();
+    (void)registered;
+    return resolver;
+}
 }  // namespace
 
-ASLInferenceEngine aslInference;
+static_assert(sizeof(tflite::MicroInterpreter) <= ASLInferenceEngine::kInterpreterStorageSize,
+              "raise kInterpreterStorageSize");
+static_assert(alignof(tflite::MicroInterpreter) <= 16, "interpreter storage is 16-byte aligned");
 
 bool ASLInferenceEngine::begin() {
-    const tflite::Model* model = tflite::GetModel(g_asl_model_data);
+    const tflite::Model* model = tflite::GetModel(model_.data);
     if (model->version() != TFLITE_SCHEMA_VERSION) {
-        Serial.println("[ML] Model schema mismatch.");
+        ML_LOG("[ML] %s: model schema mismatch.\n", model_.name);
         ready_ = false;
         return false;
     }
 
-    static tflite::MicroMutableOpResolver<10> resolver;
-    resolver.AddConv2D();
-    resolver.AddAdd();
-    resolver.AddMul();
-    resolver.AddMean();
-    resolver.AddReshape();
-    resolver.AddFullyConnected();
-    resolver.AddMaxPool2D();
-    resolver.AddSoftmax();
-    resolver.AddExpandDims();
-    resolver.AddQuantize();
-    resolver.AddDequantize();
-
-    static tflite::MicroInterpreter static_interpreter(
-        model, resolver, tensor_arena, kTensorArenaSize, error_reporter);
-    interpreter = &static_interpreter;
-
-    if (interpreter->AllocateTensors() != kTfLiteOk) {
-        Serial.println("[ML] Failed to allocate tensors.");
+    if (!interpreter_) {
+        interpreter_ = new (interpreter_storage_) tflite::MicroInterpreter(
+            model, opResolver(), tensor_arena_, kTensorArenaSize, error_reporter);
+    }
+
+    if (interpreter_->AllocateTensors() != kTfLiteOk) {
+        ML_LOG("[ML] %s: failed to allocate tensors.\n", model_.name);
         ready_ = false;
         return false;
     }
 
-    input_tensor = interpreter->input(0);
-    output_tensor = interpreter->output(0);
+    input_tensor_ = interpreter_->input(0);
+    output_tensor_ = interpreter_->output(model_.classOutput);
+    embedding_tensor_ = nullptr;
+
+    if (!input_tensor_ || !output_tensor_ ||
+        input_tensor_->type != kTfLiteInt8 || output_tensor_->type != kTfLiteInt8) {
+        ML_LOG("[ML] %s: unexpected tensor types.\n", model_.name);
+        ready_ = false;
+        return false;
+    }
 
-    if (!input_tensor || !output_tensor ||
-        input_tensor->type != kTfLiteInt8 || output_tensor->type != kTfLiteInt8) {
-        Serial.println("[ML] Unexpected tensor types.");
+    // Shapes and quantization are baked into the generated package header;
+    // refuse a model blob that disagrees rather than reading dims at inference time.
+    if (input_tensor_->bytes != model_.inputBytes() ||
+        output_tensor_->bytes != model_.numClasses ||
+        input_tensor_->params.scale != model_.inputScale ||
+        input_tensor_->params.zero_point != model_.inputZeroPoint ||
+        output_tensor_->params.scale != model_.outputScale ||
+        output_tensor_->params.zero_point != model_.outputZeroPoint) {
+        ML_LOG("[ML] %s: model does not match %s_config.h.\n", model_.name, model_.name);
+        ready_ = false;
+        return false;
+    }
+
+    if (model_.embeddingSize > 0) {
+        TfLiteTensor* embedding = interpreter_->outputs_size() == 2 ? interpreter_->output(1 - model_.classOutput)
+                                                                    : nullptr;
+        if (!embedding || embedding->type != kTfLiteInt8 || embedding->bytes != model_.embeddingSize ||
+            embedding->params.scale != model_.embeddingScale ||
+            embedding->params.zero_point != model_.embeddingZeroPoint) {
+            ML_LOG("[ML] %s: embedding output does not match %s_config.h.\n", model_.name, model_.name);
+            ready_ = false;
+            return false;
+        }
+        embedding_tensor_ = embedding;
+    } else if (interpreter_->outputs_size() != 1) {
+        ML_LOG("[ML] %s: model does not match %s_config.h.\n", model_.name, model_.name);
+        ready_ = false;
+        return false;
+    }
+
+    if (model_.span() >= SampleHistory::kCapacity) {
+        ML_LOG("[ML] %s: window spans %u samples, history reads at most %u.\n", model_.name,
+               static_cast<unsigned>(model_.span()), static_cast<unsigned>(SampleHistory::kCapacity - 1));
         ready_ = false;
         return false;
     }
 
     ready_ = true;
-    Serial.printf("[ML] Inference ready. Input dims: %d x %d\n",
-                  input_tensor->dims->data[1], input_tensor->dims->data[2]);
+    ML_LOG("[ML] %s ready. Input dims: %u x %u @ %u Hz\n", model_.name,
+           static_cast<unsigned>(model_.windowSize),
+           static_cast<unsigned>(asl_model::kNumFeatures),
+           static_cast<unsigned>(asl_model::kSensorRateHz / model_.sampleStride));
     return true;
 }
 
-bool ASLInferenceEngine::classify(const SensorSample* samples,
-                                  size_t sample_count,
-                                  char& letter,
-                                  float& confidence,
-                                  int& class_index) {
-    letter = kNeutralToken;
-    confidence = 0.0f;
-    class_index = -1;
+void ASLInferenceEngine::sampleFeatures(const SensorSample& sample, const asl_model::NormParams* imuNorm,
+                                        float* frame) {
+    for (size_t f = 0; f < kNumFlex; ++f) {
+        const float value = sample.fingersValid() ? sample.flexValue(static_cast<int>(f)) : 0.0f;
+        frame[f] = std::min(1.0f, std::max(0.0f, value));
+    }
+    for (int axis = 0; axis < 3; ++axis) {
+        frame[kNumFlex + axis] =
+            sample.imuValid() ? normalizeSensor(sample.accelValue(axis), imuNorm[axis]) : 0.0f;
+        frame[kNumFlex + 3 + axis] =
+            sample.imuValid() ? normalizeSensor(sample.gyroValue(axis), imuNorm[3 + axis]) : 0.0f;
+    }
+}
 
-    if (!ready_ || !samples || sample_count == 0 || !input_tensor || !output_tensor) {
+int8_t ASLInferenceEngine::quantizeInput(float value) const {
+    return quantize(value, model_.inputScale, model_.inputZeroPoint);
+}
+
+bool ASLInferenceEngine::classify(const SampleHistory& history, InferenceResult& result, float* scores) {
+    result.letter = kNeutralToken;
+    result.confidence = 0.0f;
+    result.classIndex = -1;
+    result.label = nullptr;
+    result.gated = false;
+
+    if (!ready_) {
         return false;
     }
+    if (prototypes_) {
+        prototypes_->poll();
+    }
 
-    const size_t window = std::min(sample_count, static_cast<size_t>(input_tensor->dims->data[1]));
-    const float input_scale = input_tensor->params.scale;
-    const int input_zero_point = input_tensor->params.zero_point;
+    const uint32_t newest = history.written();
+    const size_t span = model_.span();
+    if (newest < span) {
+        return false;
+    }
 
-    size_t offset = 0;
-    for (size_t i = 0; i < window; ++i) {
-        const SensorSample& sample = samples[i];
+    int8_t* input = input_tensor_->data.int8;
 
-        for (size_t f = 0; f < kNumFlex; ++f) {
-            float value = sample.fingersValid ? sample.flex[f] : 0.0f;
-            value = std::min(1.0f, std::max(0.0f, value));
-            input_tensor->data.int8[offset++] = quantize(value, input_scale, input_zero_point);
-        }
+    // Per-channel sums for the gate, gathered while the input is filled.
+    float sum[kNumFeatures] = {};
+    float sum_sq[kNumFeatures] = {};
+    float frame[kNumFeatures];
 
-        const float ax = sample.imuValid ? normalizeSensor(sample.accel[0], kAxParams) : 0.0f;
-        const float ay = sample.imuValid ? normalizeSensor(sample.accel[1], kAyParams) : 0.0f;
-        const float az = sample.imuValid ? normalizeSensor(sample.accel[2], kAzParams) : 0.0f;
-        const float gx = sample.imuValid ? normalizeSensor(sample.gyro[0], kGxParams) : 0.0f;
-        const float gy = sample.imuValid ? normalizeSensor(sample.gyro[1], kGyParams) : 0.0f;
-        const float gz = sample.imuValid ? normalizeSensor(sample.gyro[2], kGzParams) : 0.0f;
+    // Frame i is the last sample of its stride group, so the newest sample is
+    // always the final frame regardless of rate.
+    const uint32_t oldest = newest - static_cast<uint32_t>(span);
+    size_t offset = 0;
+    for (size_t i = 0; i < model_.windowSize; ++i) {
+        const SensorSample& sample =
+            history.at(oldest + static_cast<uint32_t>((i + 1) * model_.sampleStride - 1));
+        sampleFeatures(sample, model_.imuNorm, frame);
+
+        for (size_t f = 0; f < kNumFeatures; ++f) {
+            input[offset++] = quantizeInput(frame[f]);
+            sum[f] += frame[f];
+            sum_sq[f] += frame[f] * frame[f];
+        }
+    }
 
-        input_tensor->data.int8[offset++] = quantize(ax, input_scale, input_zero_point);
-        input_tensor->data.int8[offset++] = quantize(ay, input_scale, input_zero_point);
-        input_tensor->data.int8[offset++] = quantize(az, input_scale, input_zero_point);
-        input_tensor->data.int8[offset++] = quantize(gx, input_scale, input_zero_point);
-        input_tensor->data.int8[offset++] = quantize(gy, input_scale, input_zero_point);
-        input_tensor->data.int8[offset++] = quantize(gz, input_scale, input_zero_point);
+    if (!history.intact(oldest)) {
+        return false;
     }
 
-    // Pad remaining frames with zeros if input expects a fixed length.
-    const size_t total_features = input_tensor->bytes;
-    while (offset < total_features) {
-        input_tensor->data.int8[offset++] = quantize(0.0f, input_scale, input_zero_point);
+    if (model_.gateWeights) {
+        const float inv_n = 1.0f / static_cast<float>(model_.windowSize);
+        float logit = model_.gateBias;
+        for (size_t f = 0; f < kNumFeatures; ++f) {
+            const float mean = sum[f] * inv_n;
+            const float var = std::max(0.0f, sum_sq[f] * inv_n - mean * mean);
+            logit += model_.gateWeights[f] * mean + model_.gateWeights[kNumFeatures + f] * std::sqrt(var);
+        }
+        if (logit < model_.gateLogit) {
+            // Gate holds: report neutral with the gate's own probability.
+            const float neutral_prob = 1.0f / (1.0f + std::exp(logit));
+            if (scores) {
+                for (size_t i = 0; i < model_.numClasses; ++i) {
+                    scores[i] = (static_cast<int>(i) == model_.neutralIndex) ? neutral_prob : 0.0f;
+                }
+            }
+            result.gated = true;
+            result.confidence = neutral_prob;
+            if (model_.neutralIndex >= 0) {
+                result.classIndex = model_.neutralIndex;
+                result.label = model_.labelNames[model_.neutralIndex];
+            }
+            return true;
+        }
     }
 
-    if (interpreter->Invoke() != kTfLiteOk) {
-        Serial.println("[ML] Inference invoke failed.");
+    if (interpreter_->Invoke() != kTfLiteOk) {
+        ML_LOG("[ML] %s: inference invoke failed.\n", model_.name);
         return false;
     }
 
-    const float output_scale = output_tensor->params.scale;
-    const int output_zero_point = output_tensor->params.zero_point;
+    const float output_scale = model_.outputScale;
+    const int output_zero_point = model_.outputZeroPoint;
+
+    // With prototypes attached the scores are re-weighted before the argmax,
+    // so they always go through a buffer.
+    float fused[PrototypeClassifier::kMaxClasses];
+    float* values = scores ? scores : (prototypes_ ? fused : nullptr);
+    if (values) {
+        for (size_t i = 0; i < model_.numClasses; ++i) {
+            values[i] = dequantize(output_tensor_->data.int8[i], output_scale, output_zero_point);
+        }
+    }
+    if (prototypes_) {
+        float embedding[PrototypeClassifier::kMaxDims];
+        for (size_t d = 0; d < model_.embeddingSize; ++d) {
+            embedding[d] = dequantize(embedding_tensor_->data.int8[d], model_.embeddingScale,
+                                      model_.embeddingZeroPoint);
+        }
+        prototypes_->update(embedding, values);
+    }
 
     float best_score = -1.0f;
     int best_index = -1;
-    for (size_t i = 0; i < kNumClasses; ++i) {
-        float value = dequantize(output_tensor->data.int8[i], output_scale, output_zero_point);
+    for (size_t i = 0; i < model_.numClasses; ++i) {
+        const float value =
+            values ? values[i] : dequantize(output_tensor_->data.int8[i], output_scale, output_zero_point);
         if (value > best_score) {
             best_score = value;
             best_index = static_cast<int>(i);
@@ -172,15 +287,100 @@ bool ASLInferenceEngine::classify(const SensorSample* samples,
         return false;
     }
 
-    class_index = best_index;
-    confidence = best_score;
-    letter = kLabelToChar[best_index];
+    result.classIndex = best_index;
+    result.confidence = best_score;
+    result.letter = model_.labelToChar[best_index];
+    result.label = model_.labelNames[best_index];
+    return true;
+}
+
+bool ASLInferenceEngine::setPrototypes(PrototypeClassifier* prototypes) {
+    if (prototypes) {
+        // Descriptors are per translation unit, so compare by content.
+        const asl_model::ModelDescriptor& other = prototypes->model();
+        if (!embedding_tensor_ || !prototypes->available() || std::strcmp(other.name, model_.name) != 0 ||
+            other.numClasses != model_.numClasses || other.embeddingSize != model_.embeddingSize) {
+            return false;
+        }
+    }
+    prototypes_ = prototypes;
     return true;
 }
 
 const char* ASLInferenceEngine::labelForIndex(size_t index) const {
-    if (index >= kLabelNames.size()) {
+    if (index >= model_.numClasses) {
         return "";
     }
-    return kLabelNames[index];
+    return model_.labelNames[index];
+}
+
+char ASLInferenceEngine::tokenForIndex(size_t index) const {
+    if (index >= model_.numClasses) {
+        return kNeutralToken;
+    }
+    return model_.labelToChar[index];
 }
+
+#ifndef ARDUINO
+#include <chrono>
+#include <memory>
+
+bool measureModelCost(const unsigned char* data, uint32_t runs, ModelCost& cost) {
+    // Generous arena so candidates larger than the firmware budget can still be
+    // measured; arena_used_bytes() reports what they actually need.
+    constexpr size_t kBenchArenaSize = 1024 * 1024;
+
+    cost = ModelCost{};
+    const tflite::Model* model = tflite::GetModel(data);
+    if (model->version() != TFLITE_SCHEMA_VERSION) {
+        ML_LOG("[ML] bench: model schema mismatch.\n");
+        return false;
+    }
+
+    std::unique_ptr<uint8_t[]> arena(new uint8_t[kBenchArenaSize]);
+    tflite::MicroInterpreter interpreter(model, opResolver(), arena.get(), kBenchArenaSize,
+                                         error_reporter);
+    if (interpreter.AllocateTensors() != kTfLiteOk) {
+        ML_LOG("[ML] bench: failed to allocate tensors.\n");
+        return false;
+    }
+
+    TfLiteTensor* input = interpreter.input(0);
+    TfLiteTensor* output = interpreter.output(0);
+    if (!input || !output || input->type != kTfLiteInt8 || output->type != kTfLiteInt8) {
+        ML_LOG("[ML] bench: unexpected tensor types.\n");
+        return false;
+    }
+
+    cost.arenaBytes = interpreter.arena_used_bytes();
+    cost.inputBytes = input->bytes;
+    cost.outputBytes = output->bytes;
+
+    // Deterministic, non-constant input so no kernel sees a degenerate case.
+    uint32_t state = 0x9E3779B9u;
+    for (size_t i = 0; i < input->bytes; ++i) {
+        state = state * 1664525u + 1013904223u;
+        input->data.int8[i] = static_cast<int8_t>(state >> 24);
+    }
+
+    double total = 0.0;
+    double best = 0.0;
+    for (uint32_t i = 0; i < runs; ++i) {
+        const auto start = std::chrono::steady_clock::now();
+        if (interpreter.Invoke() != kTfLiteOk) {
+            ML_LOG("[ML] bench: invoke failed.\n");
+            return false;
+        }
+        const double us = std::chrono::duration<double, std::micro>(
+                              std::chrono::steady_clock::now() - start)
+                              .count();
+        total += us;
+        best = (i == 0) ? us : std::min(best, us);
+    }
+
+    cost.runs = runs;
+    cost.meanInvokeUs = runs ? total / runs : 0.0;
+    cost.minInvokeUs = best;
+    return true;
+}
+#endif
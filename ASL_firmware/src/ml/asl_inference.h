@@ -1,28 +1,94 @@
 #pragma once
 
 #include <cstddef>
+#include <cstdint>
 
+#include "ml/model_descriptor.h"
+#include "ml/sample_history.h"
 #include "sensor_types.h"
 
+class PrototypeClassifier;
+struct TfLiteTensor;
+namespace tflite {
+class MicroInterpreter;
+}
+
+struct InferenceResult {
+    char letter{asl_model::kNeutralToken};
+    float confidence{0.0f};
+    int classIndex{-1};
+    const char* label{nullptr};  // points into the model package, never freed
+    int stage{-1};               // router stage that produced the result
+    bool gated{false};           // the gate answered neutral without running the model
+};
+
+// Runs one packaged model (see ml/model_descriptor.h) over a SampleHistory.
 class ASLInferenceEngine {
 public:
-    static constexpr char kNeutralToken = '\x01';
-    static constexpr char kBackspaceToken = '\b';
-    static constexpr char kSpaceToken = ' ';
+    static constexpr char kNeutralToken = asl_model::kNeutralToken;
+    static constexpr char kBackspaceToken = asl_model::kBackspaceToken;
+    static constexpr char kSpaceToken = asl_model::kSpaceToken;
+    static constexpr size_t kTensorArenaSize = 90 * 1024;
+    // Room for the MicroInterpreter object itself, constructed in place;
+    // asl_inference.cpp static_asserts that it fits.
+    static constexpr size_t kInterpreterStorageSize = 512;
+
+    explicit ASLInferenceEngine(const asl_model::ModelDescriptor& model) : model_(model) {}
 
     bool begin();
     bool isReady() const { return ready_; }
 
-    bool classify(const SensorSample* samples,
-                  size_t sample_count,
-                  char& letter,
-                  float& confidence,
-                  int& class_index);
+    // Classifies the newest model_.span() samples of history, taking every
+    // sampleStride-th sample. Returns false if the history is too short or the
+    // writer overran the window while it was being read.
+    // When the package has a gate and it holds, the model is not invoked and a
+    // neutral result with gated = true is returned.
+    // scores (optional) receives numClasses() dequantized outputs, after the
+    // attached prototypes (if any) have re-weighted them.
+    bool classify(const SampleHistory& history, InferenceResult& result, float* scores = nullptr);
 
+    const asl_model::ModelDescriptor& model() const { return model_; }
     const char* labelForIndex(size_t index) const;
+    size_t numClasses() const { return model_.numClasses; }
+    char tokenForIndex(size_t index) const;
+    bool hasGate() const { return model_.gateWeights != nullptr; }
+    bool hasEmbedding() const { return embedding_tensor_ != nullptr; }
+
+    // Feeds every invoked window's embedding to prototypes, which must be
+    // built for this engine's model. Call after begin(); false if the model
+    // exports no embedding.
+    bool setPrototypes(PrototypeClassifier* prototypes);
+
+    // One frame of model input as classify() builds it: flex clamped to
+    // [0, 1] and IMU z-scored with imuNorm; channels of an invalid sensor are 0.
+    static void sampleFeatures(const SensorSample& sample, const asl_model::NormParams* imuNorm, float* frame);
+    // Input tensor value of one feature under this package's quantization.
+    int8_t quantizeInput(float value) const;
 
 private:
+    const asl_model::ModelDescriptor& model_;
     bool ready_{false};
+    tflite::MicroInterpreter* interpreter_{nullptr};
+    alignas(16) uint8_t interpreter_storage_[kInterpreterStorageSize];
+    TfLiteTensor* input_tensor_{nullptr};
+    TfLiteTensor* output_tensor_{nullptr};
+    TfLiteTensor* embedding_tensor_{nullptr};
+    PrototypeClassifier* prototypes_{nullptr};
+    alignas(16) uint8_t tensor_arena_[kTensorArenaSize];
+};
+
+#ifndef ARDUINO
+// Cost of an arbitrary int8 flatbuffer under the engine's op set, measured on
+// the host for ML_model/model_search.py: tensor arena actually used and
+// wall-clock Invoke() time over `runs` calls.
+struct ModelCost {
+    size_t arenaBytes{0};
+    size_t inputBytes{0};
+    size_t outputBytes{0};
+    uint32_t runs{0};
+    double meanInvokeUs{0.0};
+    double minInvokeUs{0.0};
 };
 
-extern ASLInferenceEngine aslInference;
+bool measureModelCost(const unsigned char* data, uint32_t runs, ModelCost& cost);
+#endif
@@ -0,0 +1,759 @@
+// Auto-generated by ML_model/build_lexicon.py - do not edit.
+// Sources: lexicon_words.txt, lexicon_corpus.txt, asl_model_config.h
+// 125 words, 303 trie nodes, 167 bigrams
+#ifndef ASL_LEXICON_PACKAGE_H_
+#define ASL_LEXICON_PACKAGE_H_
+
+#include "ml/lexicon.h"
+
+namespace asl_lexicon {
+
+constexpr size_t kNumNodes = 303;
+constexpr size_t kNumWords = 125;
+constexpr size_t kNumBigrams = 167;
+
+constexpr asl_model::LexiconNode kNodes[kNumNodes] = {
+    {'\0', 21, 1, 0xFFFF, 0},
+    {'A', 7, 22, 0x0000, -577},
+    {'B', 5, 29, 0xFFFF, -928},
+    {'C', 2, 34, 0xFFFF, -903},
+    {'D', 3, 36, 0xFFFF, -898},
+    {'E', 1, 39, 0xFFFF, -1325},
+    {'F', 5, 40, 0xFFFF, -841},
+    {'G', 3, 45, 0xFFFF, -885},
+    {'H', 5, 48, 0xFFFF, -677},
+    {'I', 3, 53, 0x0031, -579},
+    {'K', 1, 56, 0xFFFF, -1257},
+    {'L', 4, 57, 0xFFFF, -982},
+    {'M', 4, 61, 0xFFFF, -735},
+    {'N', 4, 65, 0xFFFF, -715},
+    {'O', 4, 69, 0xFFFF, -759},
+    {'P', 1, 73, 0xFFFF, -1125},
+    {'R', 1, 74, 0xFFFF, -1564},
+    {'S', 9, 75, 0xFFFF, -837},
+    {'T', 6, 84, 0xFFFF, -481},
+    {'U', 2, 90, 0xFFFF, -1547},
+    {'W', 6, 92, 0xFFFF, -569},
+    {'Y', 2, 98, 0xFFFF, -796},
+    {'G', 1, 100, 0xFFFF, -1485},
+    {'L', 1, 101, 0xFFFF, -1332},
+    {'M', 0, 0, 0x0003, -1252},
+    {'N', 1, 102, 0xFFFF, -904},
+    {'R', 1, 103, 0xFFFF, -1079},
+    {'S', 1, 104, 0xFFFF, -1491},
+    {'T', 0, 0, 0x0007, -1201},
+    {'A', 2, 105, 0xFFFF, -1281},
+    {'E', 0, 0, 0x000A, -1155},
+    {'I', 1, 107, 0xFFFF, -1564},
+    {'O', 1, 108, 0xFFFF, -1555},
+    {'Y', 1, 109, 0xFFFF, -1386},
+    {'A', 4, 110, 0xFFFF, -1005},
+    {'O', 2, 114, 0xFFFF, -1188},
+    {'A', 2, 116, 0xFFFF, -1210},
+    {'O', 1, 118, 0x0016, -1048},
+    {'R', 1, 119, 0xFFFF, -1388},
+    {'A', 1, 120, 0xFFFF, -1325},
+    {'A', 2, 121, 0xFFFF, -1364},
+    {'E', 1, 123, 0xFFFF, -1430},
+    {'I', 1, 124, 0xFFFF, -1310},
+    {'O', 2, 125, 0xFFFF, -1014},
+    {'R', 1, 127, 0xFFFF, -1432},
+    {'E', 1, 128, 0xFFFF, -1258},
+    {'I', 1, 129, 0xFFFF, -1432},
+    {'O', 1, 130, 0x0024, -996},
+    {'A', 2, 131, 0xFFFF, -1048},
+    {'E', 2, 133, 0x0028, -902},
+    {'I', 0, 0, 0x002C, -1257},
+    {'O', 3, 135, 0xFFFF, -1070},
+    {'U', 1, 138, 0xFFFF, -1559},
+    {'N', 0, 0, 0x0032, -978},
+    {'S', 0, 0, 0x0033, -972},
+    {'T', 0, 0, 0x0034, -936},
+    {'N', 1, 139, 0xFFFF, -1257},
+    {'A', 1, 140, 0xFFFF, -1432},
+    {'E', 2, 141, 0xFFFF, -1547},
+    {'I', 1, 143, 0xFFFF, -1153},
+    {'O', 1, 144, 0xFFFF, -1386},
+    {'A', 1, 145, 0xFFFF, -1332},
+    {'E', 1, 146, 0x003C, -992},
+    {'O', 2, 147, 0xFFFF, -1134},
+    {'Y', 0, 0, 0x0041, -1021},
+    {'A', 1, 149, 0xFFFF, -1327},
+    {'E', 2, 150, 0xFFFF, -1092},
+    {'I', 2, 152, 0xFFFF, -1281},
+    {'O', 2, 154, 0x0047, -859},
+    {'F', 0, 0, 0x004A, -939},
+    {'K', 0, 0, 0x004B, -1257},
+    {'L', 1, 156, 0xFFFF, -1564},
+    {'N', 1, 157, 0x004D, -1051},
+    {'L', 2, 158, 0xFFFF, -1125},
+    {'E', 1, 160, 0xFFFF, -1564},
+    {'A', 1, 161, 0xFFFF, -1564},
+    {'C', 1, 162, 0xFFFF, -1432},
+    {'E', 1, 163, 0xFFFF, -1327},
+    {'H', 1, 164, 0xFFFF, -1155},
+    {'I', 1, 165, 0xFFFF, -1476},
+    {'L', 1, 166, 0xFFFF, -1604},
+    {'M', 1, 167, 0xFFFF, -1609},
+    {'O', 1, 168, 0x0059, -1327},
+    {'T', 1, 169, 0xFFFF, -1488},
+    {'A', 1, 170, 0xFFFF, -1388},
+    {'E', 1, 171, 0xFFFF, -1432},
+    {'H', 3, 172, 0xFFFF, -596},
+    {'I', 2, 175, 0xFFFF, -1241},
+    {'O', 1, 177, 0x0067, -852},
+    {'W', 1, 178, 0xFFFF, -1435},
+    {'N', 1, 179, 0xFFFF, -1559},
+    {'S', 0, 0, 0x006B, -2335},
+    {'A', 4, 180, 0xFFFF, -886},
+    {'E', 0, 0, 0x0070, -1080},
+    {'H', 4, 184, 0xFFFF, -858},
+    {'I', 2, 188, 0xFFFF, -998},
+    {'O', 1, 190, 0xFFFF, -1386},
+    {'R', 1, 191, 0xFFFF, -1564},
+    {'E', 1, 192, 0xFFFF, -1081},
+    {'O', 1, 193, 0xFFFF, -898},
+    {'A', 1, 194, 0xFFFF, -1485},
+    {'L', 0, 0, 0x0002, -1332},
+    {'D', 0, 0, 0x0004, -904},
+    {'E', 0, 0, 0x0005, -1079},
+    {'K', 0, 0, 0x0006, -1491},
+    {'D', 0, 0, 0x0008, -1386},
+    {'T', 1, 195, 0xFFFF, -1559},
+    {'G', 0, 0, 0x000B, -1564},
+    {'O', 1, 196, 0xFFFF, -1555},
+    {'E', 0, 0, 0x000D, -1386},
+    {'L', 1, 197, 0xFFFF, -1485},
+    {'N', 0, 0, 0x000F, -1114},
+    {'R', 0, 0, 0x0010, -1604},
+    {'T', 0, 0, 0x0011, -1604},
+    {'L', 1, 198, 0xFFFF, -1559},
+    {'M', 1, 199, 0xFFFF, -1256},
+    {'D', 0, 0, 0x0014, -1458},
+    {'Y', 0, 0, 0x0015, -1332},
+    {'G', 0, 0, 0x0017, -1604},
+    {'I', 1, 200, 0xFFFF, -1388},
+    {'T', 0, 0, 0x0019, -1325},
+    {'M', 1, 201, 0xFFFF, -1488},
+    {'S', 1, 202, 0xFFFF, -1609},
+    {'E', 1, 203, 0xFFFF, -1430},
+    {'N', 2, 204, 0xFFFF, -1310},
+    {'O', 1, 206, 0xFFFF, -1388},
+    {'R', 0, 0, 0x0020, -1081},
+    {'I', 1, 207, 0xFFFF, -1432},
+    {'T', 0, 0, 0x0022, -1258},
+    {'V', 1, 208, 0xFFFF, -1432},
+    {'O', 1, 209, 0xFFFF, -1196},
+    {'P', 1, 210, 0xFFFF, -1432},
+    {'V', 1, 211, 0xFFFF, -1113},
+    {'L', 2, 212, 0xFFFF, -1049},
+    {'R', 1, 214, 0xFFFF, -2439},
+    {'M', 1, 215, 0xFFFF, -1328},
+    {'T', 0, 0, 0x002E, -1559},
+    {'W', 0, 0, 0x002F, -1255},
+    {'N', 1, 216, 0xFFFF, -1559},
+    {'O', 1, 217, 0xFFFF, -1257},
+    {'T', 1, 218, 0xFFFF, -1432},
+    {'A', 1, 219, 0xFFFF, -1559},
+    {'T', 0, 0, 0x0038, -2335},
+    {'K', 1, 220, 0xFFFF, -1153},
+    {'V', 1, 221, 0xFFFF, -1386},
+    {'K', 1, 222, 0xFFFF, -1332},
+    {'E', 1, 223, 0xFFFF, -1559},
+    {'M', 0, 0, 0x003E, -1456},
+    {'R', 2, 224, 0xFFFF, -1219},
+    {'M', 1, 226, 0xFFFF, -1327},
+    {'E', 1, 227, 0xFFFF, -1153},
+    {'W', 0, 0, 0x0044, -1488},
+    {'C', 1, 228, 0xFFFF, -1488},
+    {'G', 1, 229, 0xFFFF, -1432},
+    {'T', 0, 0, 0x0048, -1113},
+    {'W', 0, 0, 0x0049, -1257},
+    {'D', 0, 0, 0x004C, -1564},
+    {'E', 0, 0, 0x004E, -1332},
+    {'A', 1, 230, 0xFFFF, -1488},
+    {'E', 1, 231, 0xFFFF, -1195},
+    {'A', 1, 232, 0xFFFF, -1564},
+    {'D', 0, 0, 0x0052, -1564},
+    {'H', 1, 233, 0xFFFF, -1432},
+    {'E', 0, 0, 0x0054, -1327},
+    {'E', 0, 0, 0x0055, -1155},
+    {'G', 1, 234, 0xFFFF, -1476},
+    {'O', 1, 235, 0xFFFF, -1604},
+    {'A', 1, 236, 0xFFFF, -1609},
+    {'R', 1, 237, 0xFFFF, -1330},
+    {'O', 1, 238, 0xFFFF, -1488},
+    {'K', 1, 239, 0xFFFF, -1388},
+    {'L', 1, 240, 0xFFFF, -1432},
+    {'A', 2, 241, 0xFFFF, -902},
+    {'E', 1, 243, 0x0061, -779},
+    {'I', 2, 244, 0xFFFF, -999},
+    {'M', 1, 246, 0xFFFF, -1328},
+    {'R', 1, 247, 0xFFFF, -1559},
+    {'D', 1, 248, 0xFFFF, -1382},
+    {'O', 0, 0, 0x0069, -1435},
+    {'D', 1, 249, 0xFFFF, -1559},
+    {'I', 1, 250, 0xFFFF, -1488},
+    {'N', 1, 251, 0xFFFF, -1112},
+    {'S', 0, 0, 0x006E, -1155},
+    {'T', 1, 252, 0xFFFF, -1384},
+    {'A', 1, 253, 0xFFFF, -1153},
+    {'E', 2, 254, 0xFFFF, -1113},
+    {'O', 0, 0, 0x0074, -1330},
+    {'Y', 0, 0, 0x0075, -1330},
+    {'L', 1, 256, 0xFFFF, -1199},
+    {'T', 1, 257, 0xFFFF, -1154},
+    {'R', 1, 258, 0xFFFF, -1386},
+    {'I', 1, 259, 0xFFFF, -1564},
+    {'S', 0, 0, 0x007A, -1081},
+    {'U', 1, 260, 0x007B, -898},
+    {'I', 1, 261, 0xFFFF, -1485},
+    {'H', 1, 262, 0xFFFF, -1559},
+    {'K', 0, 0, 0x000C, -1555},
+    {'L', 0, 0, 0x000E, -1485},
+    {'D', 0, 0, 0x0012, -1559},
+    {'E', 0, 0, 0x0013, -1256},
+    {'N', 1, 263, 0xFFFF, -1388},
+    {'I', 1, 264, 0xFFFF, -1488},
+    {'T', 0, 0, 0x001B, -1609},
+    {'L', 0, 0, 0x001C, -1430},
+    {'E', 0, 0, 0x001D, -1432},
+    {'I', 1, 265, 0xFFFF, -1559},
+    {'D', 0, 0, 0x001F, -1388},
+    {'E', 1, 266, 0xFFFF, -1432},
+    {'E', 0, 0, 0x0023, -1432},
+    {'D', 0, 0, 0x0025, -1196},
+    {'P', 1, 267, 0xFFFF, -1432},
+    {'E', 0, 0, 0x0027, -1113},
+    {'L', 1, 268, 0xFFFF, -1257},
+    {'P', 0, 0, 0x002A, -1198},
+    {'E', 0, 0, 0x002B, -2439},
+    {'E', 0, 0, 0x002D, -1328},
+    {'G', 1, 269, 0xFFFF, -1559},
+    {'W', 0, 0, 0x0035, -1257},
+    {'E', 1, 270, 0xFFFF, -1432},
+    {'R', 1, 271, 0xFFFF, -1559},
+    {'E', 0, 0, 0x0039, -1153},
+    {'E', 0, 0, 0x003A, -1386},
+    {'E', 0, 0, 0x003B, -1332},
+    {'T', 0, 0, 0x003D, -1559},
+    {'E', 0, 0, 0x003F, -1330},
+    {'N', 1, 272, 0xFFFF, -1488},
+    {'E', 0, 0, 0x0042, -1327},
+    {'D', 0, 0, 0x0043, -1153},
+    {'E', 0, 0, 0x0045, -1488},
+    {'H', 1, 273, 0xFFFF, -1432},
+    {'Y', 0, 0, 0x004F, -1488},
+    {'A', 1, 274, 0xFFFF, -1195},
+    {'D', 0, 0, 0x0051, -1564},
+    {'O', 1, 275, 0xFFFF, -1432},
+    {'N', 0, 0, 0x0056, -1476},
+    {'W', 0, 0, 0x0057, -1604},
+    {'L', 1, 276, 0xFFFF, -1609},
+    {'R', 1, 277, 0xFFFF, -1330},
+    {'P', 0, 0, 0x005B, -1488},
+    {'E', 0, 0, 0x005C, -1388},
+    {'L', 0, 0, 0x005D, -1432},
+    {'N', 1, 278, 0xFFFF, -1113},
+    {'T', 0, 0, 0x0060, -1050},
+    {'Y', 0, 0, 0x0062, -1155},
+    {'N', 1, 279, 0xFFFF, -1330},
+    {'S', 0, 0, 0x0064, -1082},
+    {'E', 0, 0, 0x0065, -1328},
+    {'E', 1, 280, 0xFFFF, -1559},
+    {'A', 1, 281, 0xFFFF, -1382},
+    {'E', 1, 282, 0xFFFF, -1559},
+    {'T', 0, 0, 0x006C, -1488},
+    {'T', 0, 0, 0x006D, -1112},
+    {'E', 1, 283, 0xFFFF, -1384},
+    {'T', 0, 0, 0x0071, -1153},
+    {'N', 0, 0, 0x0072, -1330},
+    {'R', 1, 284, 0xFFFF, -1256},
+    {'L', 0, 0, 0x0076, -1199},
+    {'H', 0, 0, 0x0077, -1154},
+    {'K', 0, 0, 0x0078, -1386},
+    {'T', 1, 285, 0xFFFF, -1564},
+    {'R', 0, 0, 0x007C, -2439},
+    {'N', 0, 0, 0x0001, -1485},
+    {'R', 1, 286, 0xFFFF, -1559},
+    {'K', 0, 0, 0x0018, -1388},
+    {'L', 1, 287, 0xFFFF, -1488},
+    {'S', 1, 288, 0xFFFF, -1559},
+    {'N', 1, 289, 0xFFFF, -1432},
+    {'Y', 0, 0, 0x0026, -1432},
+    {'O', 0, 0, 0x0029, -1257},
+    {'R', 1, 290, 0xFFFF, -1559},
+    {'R', 0, 0, 0x0036, -1432},
+    {'N', 0, 0, 0x0037, -1559},
+    {'I', 1, 291, 0xFFFF, -1488},
+    {'T', 0, 0, 0x0046, -1432},
+    {'S', 1, 292, 0xFFFF, -1195},
+    {'O', 1, 293, 0xFFFF, -1432},
+    {'L', 0, 0, 0x0058, -1609},
+    {'Y', 0, 0, 0x005A, -1330},
+    {'K', 1, 294, 0x005E, -1113},
+    {'K', 0, 0, 0x0063, -1330},
+    {'D', 0, 0, 0x0066, -1559},
+    {'Y', 0, 0, 0x0068, -1382},
+    {'R', 1, 295, 0xFFFF, -1559},
+    {'R', 0, 0, 0x006F, -1384},
+    {'E', 0, 0, 0x0073, -1256},
+    {'E', 0, 0, 0x0079, -1564},
+    {'O', 1, 296, 0xFFFF, -1559},
+    {'Y', 0, 0, 0x001A, -1488},
+    {'H', 0, 0, 0x001E, -1559},
+    {'D', 0, 0, 0x0021, -1432},
+    {'Y', 0, 0, 0x0030, -1559},
+    {'N', 1, 297, 0xFFFF, -1488},
+    {'E', 0, 0, 0x0050, -1195},
+    {'L', 0, 0, 0x0053, -1432},
+    {'S', 0, 0, 0x005F, -1332},
+    {'S', 1, 298, 0xFFFF, -1559},
+    {'O', 1, 299, 0xFFFF, -1559},
+    {'G', 0, 0, 0x0040, -1488},
+    {'T', 1, 300, 0xFFFF, -1559},
+    {'M', 0, 0, 0x0009, -1559},
+    {'A', 1, 301, 0xFFFF, -1559},
+    {'N', 1, 302, 0xFFFF, -1559},
+    {'D', 0, 0, 0x006A, -1559},
+};
+
+constexpr asl_model::LexiconWord kWords[kNumWords] = {
+    {0, -874, -177},  // A
+    {2, -1485, 0},  // AGAIN
+    {8, -1332, 0},  // ALL
+    {12, -1252, -177},  // AM
+    {15, -904, -177},  // AND
+    {19, -1079, -355},  // ARE
+    {23, -1491, 0},  // ASK
+    {27, -1201, 0},  // AT
+    {30, -1386, 0},  // BAD
+    {34, -1559, 0},  // BATHROOM
+    {43, -1155, 0},  // BE
+    {46, -1564, 0},  // BIG
+    {50, -1555, -177},  // BOOK
+    {55, -1386, -177},  // BYE
+    {59, -1485, -177},  // CALL
+    {64, -1114, -177},  // CAN
+    {68, -1604, 0},  // CAR
+    {72, -1604, 0},  // CAT
+    {76, -1559, 0},  // COLD
+    {81, -1256, -177},  // COME
+    {86, -1458, 0},  // DAD
+    {90, -1332, 0},  // DAY
+    {94, -1079, -355},  // DO
+    {97, -1604, 0},  // DOG
+    {101, -1388, 0},  // DRINK
+    {107, -1325, -177},  // EAT
+    {111, -1488, -177},  // FAMILY
+    {118, -1609, 0},  // FAST
+    {123, -1430, -177},  // FEEL
+    {128, -1432, -177},  // FINE
+    {133, -1559, 0},  // FINISH
+    {140, -1388, 0},  // FOOD
+    {145, -1081, -177},  // FOR
+    {149, -1432, -177},  // FRIEND
+    {156, -1258, 0},  // GET
+    {160, -1432, -177},  // GIVE
+    {165, -1152, -281},  // GO
+    {168, -1196, -177},  // GOOD
+    {173, -1432, 0},  // HAPPY
+    {179, -1113, -251},  // HAVE
+    {184, -1116, 0},  // HE
+    {187, -1257, -177},  // HELLO
+    {193, -1198, -355},  // HELP
+    {198, -2439, 0},  // HERE
+    {203, -1257, -177},  // HI
+    {206, -1328, 0},  // HOME
+    {211, -1559, -177},  // HOT
+    {215, -1255, -281},  // HOW
+    {219, -1559, 0},  // HUNGRY
+    {226, -867, -365},  // I
+    {228, -978, 0},  // IN
+    {231, -972, -177},  // IS
+    {234, -936, -532},  // IT
+    {237, -1257, 0},  // KNOW
+    {242, -1432, 0},  // LATER
+    {248, -1559, -177},  // LEARN
+    {254, -2335, -355},  // LET
+    {258, -1153, -355},  // LIKE
+    {263, -1386, -177},  // LOVE
+    {268, -1332, 0},  // MAKE
+    {273, -1021, -177},  // ME
+    {276, -1559, -177},  // MEET
+    {281, -1456, -177},  // MOM
+    {285, -1330, -177},  // MORE
+    {290, -1488, 0},  // MORNING
+    {298, -1021, -264},  // MY
+    {301, -1327, -355},  // NAME
+    {306, -1153, -177},  // NEED
+    {311, -1488, 0},  // NEW
+    {315, -1488, -177},  // NICE
+    {320, -1432, 0},  // NIGHT
+    {326, -1081, -177},  // NO
+    {329, -1113, -177},  // NOT
+    {333, -1257, 0},  // NOW
+    {337, -939, 0},  // OF
+    {340, -1257, 0},  // OK
+    {343, -1564, 0},  // OLD
+    {347, -1155, 0},  // ON
+    {350, -1332, 0},  // ONE
+    {354, -1488, 0},  // PLAY
+    {359, -1195, -281},  // PLEASE
+    {366, -1564, 0},  // READ
+    {371, -1564, 0},  // SAD
+    {375, -1432, 0},  // SCHOOL
+    {382, -1327, -459},  // SEE
+    {386, -1155, 0},  // SHE
+    {390, -1476, -177},  // SIGN
+    {395, -1604, 0},  // SLOW
+    {400, -1609, 0},  // SMALL
+    {406, -2439, 0},  // SO
+    {409, -1330, 0},  // SORRY
+    {415, -1488, -177},  // STOP
+    {420, -1388, 0},  // TAKE
+    {425, -1432, -177},  // TELL
+    {430, -1255, -459},  // THANK
+    {436, -1332, 0},  // THANKS
+    {443, -1050, -177},  // THAT
+    {448, -847, -281},  // THE
+    {452, -1155, 0},  // THEY
+    {457, -1330, -177},  // THINK
+    {463, -1082, 0},  // THIS
+    {468, -1328, -177},  // TIME
+    {473, -1559, 0},  // TIRED
+    {479, -886, -281},  // TO
+    {482, -1382, 0},  // TODAY
+    {488, -1435, 0},  // TWO
+    {492, -1559, 0},  // UNDERSTAND
+    {503, -2335, -177},  // US
+    {506, -1488, -177},  // WAIT
+    {511, -1112, -412},  // WANT
+    {516, -1155, 0},  // WAS
+    {520, -1384, -177},  // WATER
+    {526, -1080, -177},  // WE
+    {529, -1153, -177},  // WHAT
+    {534, -1330, -177},  // WHEN
+    {539, -1256, -177},  // WHERE
+    {545, -1330, -177},  // WHO
+    {549, -1330, -177},  // WHY
+    {553, -1199, -177},  // WILL
+    {558, -1154, -177},  // WITH
+    {563, -1386, -177},  // WORK
+    {568, -1564, 0},  // WRITE
+    {574, -1081, -177},  // YES
+    {578, -899, -217},  // YOU
+    {582, -2439, -177},  // YOUR
+};
+
+constexpr asl_model::LexiconBigram kBigrams[kNumBigrams] = {
+    {0x0000, 17, -354},
+    {0x0000, 23, -354},
+    {0x0003, 29, -585},
+    {0x0003, 30, -587},
+    {0x0003, 48, -587},
+    {0x0003, 90, -582},
+    {0x0003, 102, -587},
+    {0x0004, 20, -177},
+    {0x0005, 38, -530},
+    {0x0005, 123, -117},
+    {0x000C, 51, -172},
+    {0x000D, 84, -176},
+    {0x000E, 65, -346},
+    {0x000E, 123, -340},
+    {0x000F, 49, -338},
+    {0x000F, 123, -340},
+    {0x0013, 119, -175},
+    {0x0016, 72, -249},
+    {0x0016, 123, -246},
+    {0x0019, 73, -176},
+    {0x001A, 51, -172},
+    {0x001C, 8, -353},
+    {0x001C, 37, -350},
+    {0x001D, 94, -176},
+    {0x0020, 60, -173},
+    {0x0021, 51, -172},
+    {0x0023, 60, -173},
+    {0x0024, 45, -176},
+    {0x0024, 103, -443},
+    {0x0025, 64, -353},
+    {0x0025, 70, -353},
+    {0x0027, 0, -243},
+    {0x0027, 63, -528},
+    {0x0027, 103, -509},
+    {0x0029, 47, -176},
+    {0x002A, 60, -72},
+    {0x002C, 65, -173},
+    {0x002E, 104, -176},
+    {0x002F, 5, -175},
+    {0x002F, 22, -451},
+    {0x0031, 3, -436},
+    {0x0031, 22, -706},
+    {0x0031, 28, -716},
+    {0x0031, 39, -498},
+    {0x0031, 53, -980},
+    {0x0031, 57, -970},
+    {0x0031, 58, -988},
+    {0x0031, 67, -709},
+    {0x0031, 84, -985},
+    {0x0031, 99, -985},
+    {0x0031, 109, -498},
+    {0x0031, 118, -975},
+    {0x0033, 18, -807},
+    {0x0033, 37, -786},
+    {0x0033, 43, -813},
+    {0x0033, 46, -807},
+    {0x0033, 52, -744},
+    {0x0033, 65, -762},
+    {0x0033, 68, -805},
+    {0x0033, 75, -792},
+    {0x0033, 96, -767},
+    {0x0033, 97, -720},
+    {0x0033, 101, -797},
+    {0x0033, 124, -813},
+    {0x0034, 51, -33},
+    {0x0037, 86, -177},
+    {0x0038, 107, -74},
+    {0x0039, 52, -71},
+    {0x003A, 123, -170},
+    {0x003C, 1, -353},
+    {0x003C, 97, -337},
+    {0x003D, 123, -170},
+    {0x003E, 4, -170},
+    {0x003F, 111, -176},
+    {0x0041, 16, -673},
+    {0x0041, 26, -672},
+    {0x0041, 33, -671},
+    {0x0041, 62, -393},
+    {0x0041, 66, -392},
+    {0x0042, 51, -72},
+    {0x0043, 42, -350},
+    {0x0043, 103, -339},
+    {0x0045, 103, -170},
+    {0x0047, 94, -176},
+    {0x0048, 57, -349},
+    {0x0048, 106, -354},
+    {0x0050, 42, -454},
+    {0x0050, 86, -177},
+    {0x0054, 123, -45},
+    {0x0056, 1, -529},
+    {0x0056, 37, -523},
+    {0x0056, 87, -530},
+    {0x0056, 96, -516},
+    {0x005B, 80, -175},
+    {0x005D, 60, -173},
+    {0x005E, 123, -45},
+    {0x0060, 51, -172},
+    {0x0061, 9, -458},
+    {0x0061, 12, -177},
+    {0x0063, 89, -177},
+    {0x0065, 51, -344},
+    {0x0065, 103, -339},
+    {0x0067, 25, -326},
+    {0x0067, 36, -453},
+    {0x0067, 55, -736},
+    {0x0067, 61, -736},
+    {0x0067, 83, -734},
+    {0x0067, 120, -733},
+    {0x006B, 25, -352},
+    {0x006B, 79, -353},
+    {0x006C, 32, -174},
+    {0x006D, 103, -89},
+    {0x006D, 111, -587},
+    {0x006F, 80, -175},
+    {0x0070, 5, -347},
+    {0x0070, 36, -349},
+    {0x0071, 51, -344},
+    {0x0071, 101, -352},
+    {0x0072, 118, -175},
+    {0x0073, 5, -347},
+    {0x0073, 51, -344},
+    {0x0074, 51, -172},
+    {0x0075, 72, -174},
+    {0x0076, 14, -353},
+    {0x0076, 123, -340},
+    {0x0077, 60, -173},
+    {0x0078, 104, -176},
+    {0x007A, 80, -175},
+    {0x007B, 19, -664},
+    {0x007B, 42, -662},
+    {0x007B, 54, -670},
+    {0x007B, 86, -393},
+    {0x007B, 104, -669},
+    {0x007B, 109, -656},
+    {0x007C, 66, -176},
+    {0xFFFE, 13, -1231},
+    {0xFFFE, 14, -1241},
+    {0xFFFE, 15, -951},
+    {0xFFFE, 19, -1211},
+    {0xFFFE, 22, -1166},
+    {0xFFFE, 35, -1236},
+    {0xFFFE, 37, -960},
+    {0xFFFE, 41, -1211},
+    {0xFFFE, 44, -1211},
+    {0xFFFE, 47, -964},
+    {0xFFFE, 49, -274},
+    {0xFFFE, 52, -738},
+    {0xFFFE, 56, -984},
+    {0xFFFE, 65, -746},
+    {0xFFFE, 69, -1242},
+    {0xFFFE, 71, -1167},
+    {0xFFFE, 80, -838},
+    {0xFFFE, 84, -1223},
+    {0xFFFE, 91, -1242},
+    {0xFFFE, 93, -1236},
+    {0xFFFE, 94, -1210},
+    {0xFFFE, 96, -1156},
+    {0xFFFE, 97, -1066},
+    {0xFFFE, 108, -1242},
+    {0xFFFE, 112, -947},
+    {0xFFFE, 113, -955},
+    {0xFFFE, 114, -1223},
+    {0xFFFE, 115, -964},
+    {0xFFFE, 116, -1223},
+    {0xFFFE, 117, -1223},
+    {0xFFFE, 122, -1167},
+    {0xFFFE, 123, -1093},
+};
+
+constexpr char kText[] =
+    "A\0"
+    "AGAIN\0"
+    "ALL\0"
+    "AM\0"
+    "AND\0"
+    "ARE\0"
+    "ASK\0"
+    "AT\0"
+    "BAD\0"
+    "BATHROOM\0"
+    "BE\0"
+    "BIG\0"
+    "BOOK\0"
+    "BYE\0"
+    "CALL\0"
+    "CAN\0"
+    "CAR\0"
+    "CAT\0"
+    "COLD\0"
+    "COME\0"
+    "DAD\0"
+    "DAY\0"
+    "DO\0"
+    "DOG\0"
+    "DRINK\0"
+    "EAT\0"
+    "FAMILY\0"
+    "FAST\0"
+    "FEEL\0"
+    "FINE\0"
+    "FINISH\0"
+    "FOOD\0"
+    "FOR\0"
+    "FRIEND\0"
+    "GET\0"
+    "GIVE\0"
+    "GO\0"
+    "GOOD\0"
+    "HAPPY\0"
+    "HAVE\0"
+    "HE\0"
+    "HELLO\0"
+    "HELP\0"
+    "HERE\0"
+    "HI\0"
+    "HOME\0"
+    "HOT\0"
+    "HOW\0"
+    "HUNGRY\0"
+    "I\0"
+    "IN\0"
+    "IS\0"
+    "IT\0"
+    "KNOW\0"
+    "LATER\0"
+    "LEARN\0"
+    "LET\0"
+    "LIKE\0"
+    "LOVE\0"
+    "MAKE\0"
+    "ME\0"
+    "MEET\0"
+    "MOM\0"
+    "MORE\0"
+    "MORNING\0"
+    "MY\0"
+    "NAME\0"
+    "NEED\0"
+    "NEW\0"
+    "NICE\0"
+    "NIGHT\0"
+    "NO\0"
+    "NOT\0"
+    "NOW\0"
+    "OF\0"
+    "OK\0"
+    "OLD\0"
+    "ON\0"
+    "ONE\0"
+    "PLAY\0"
+    "PLEASE\0"
+    "READ\0"
+    "SAD\0"
+    "SCHOOL\0"
+    "SEE\0"
+    "SHE\0"
+    "SIGN\0"
+    "SLOW\0"
+    "SMALL\0"
+    "SO\0"
+    "SORRY\0"
+    "STOP\0"
+    "TAKE\0"
+    "TELL\0"
+    "THANK\0"
+    "THANKS\0"
+    "THAT\0"
+    "THE\0"
+    "THEY\0"
+    "THINK\0"
+    "THIS\0"
+    "TIME\0"
+    "TIRED\0"
+    "TO\0"
+    "TODAY\0"
+    "TWO\0"
+    "UNDERSTAND\0"
+    "US\0"
+    "WAIT\0"
+    "WANT\0"
+    "WAS\0"
+    "WATER\0"
+    "WE\0"
+    "WHAT\0"
+    "WHEN\0"
+    "WHERE\0"
+    "WHO\0"
+    "WHY\0"
+    "WILL\0"
+    "WITH\0"
+    "WORK\0"
+    "WRITE\0"
+    "YES\0"
+    "YOU\0"
+    "YOUR\0";
+
+constexpr asl_model::LexiconDescriptor kLexicon = {
+    kNodes,
+    kNumNodes,
+    kWords,
+    kNumWords,
+    kBigrams,
+    167,
+    kText,
+    -378,
+};
+
+}  // namespace asl_lexicon
+
+#endif  // ASL_LEXICON_PACKAGE_H_
@@ -0,0 +1,74 @@
+// Auto-generated by ML_model/model_package.py - do not edit.
+// Source model: hello_eat_simple
+// Classes: EAT, HELLO
+#ifndef ASL_MODEL_CONFIG_H_
+#define ASL_MODEL_CONFIG_H_
+
+#include "ml/model_descriptor.h"
+#include "ml/asl_model_data.h"
+
+namespace asl_model {
+
+// Input shape [1, kWindowSize, asl_model::kNumFeatures], one frame every
+// kSampleStride sensor samples (50 Hz).
+constexpr size_t kWindowSize = 25;
+constexpr size_t kSampleStride = 1;
+constexpr size_t kNumClasses = 2;
+
+constexpr const char* kLabelNames[kNumClasses] = {
+    "EAT", "HELLO"};
+
+constexpr char kLabelToChar[kNumClasses] = {
+    'E',
+    'H'};
+
+// int8 quantization of the model input/output tensors.
+constexpr float kInputScale = 0.003921408206f;
+constexpr int32_t kInputZeroPoint = -128;
+constexpr float kOutputScale = 0.00390625f;
+constexpr int32_t kOutputZeroPoint = -128;
+
+// Penultimate-layer embedding (a second model output), 0 wide when absent.
+constexpr size_t kClassOutput = 0;
+constexpr size_t kEmbeddingSize = 0;
+constexpr float kEmbeddingScale = 0.0f;
+constexpr int32_t kEmbeddingZeroPoint = 0;
+
+// z-score parameters for ax, ay, az, gx, gy, gz (training normalizer).
+constexpr asl_model::NormParams kImuNorm[asl_model::kNumImu] = {
+    {0.652877f, 0.246747f},  // ax
+    {0.662821f, 0.117152f},  // ay
+    {0.410897f, 0.252453f},  // az
+    {0.504955f, 0.301887f},  // gx
+    {0.501236f, 0.212698f},  // gy
+    {0.485134f, 0.303284f},  // gz
+};
+
+constexpr asl_model::ModelDescriptor kDescriptor = {
+    "asl_model",
+    g_asl_model_data,
+    kWindowSize,
+    kSampleStride,
+    kNumClasses,
+    kLabelNames,
+    kLabelToChar,
+    kInputScale,
+    kInputZeroPoint,
+    kOutputScale,
+    kOutputZeroPoint,
+    kImuNorm,
+    -1,
+    nullptr,
+    0.0f,
+    0.0f,
+    kClassOutput,
+    kEmbeddingSize,
+    kEmbeddingScale,
+    kEmbeddingZeroPoint,
+};
+
+static_assert(11 == asl_model::kNumFeatures, "feature layout mismatch");
+
+}  // namespace asl_model
+
+#endif  // ASL_MODEL_CONFIG_H_
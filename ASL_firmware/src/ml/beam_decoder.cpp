@@ -0,0 +1,460 @@
+#include "ml/beam_decoder.h"
+
+#include <cctype>
+#include <cmath>
+#include <cstring>
+
+#include "ml/asl_lexicon.h"
+
+BeamDecoder aslDecoder{asl_lexicon::kLexicon};
+
+BeamDecoder::Observation BeamDecoder::Observation::fromScores(int stage, const float* scores,
+                                                              size_t numClasses) {
+    Observation observation;
+    observation.stage = static_cast<uint8_t>(stage < 0 ? 0 : stage);
+    if (!scores) {
+        return observation;
+    }
+    for (size_t c = 0; c < numClasses && c < kMaxClasses; ++c) {
+        const float p = scores[c];
+        size_t pos = observation.count;
+        if (pos == kTopK) {
+            if (p <= observation.prob[kTopK - 1]) {
+                continue;
+            }
+            pos = kTopK - 1;
+        } else {
+            observation.count++;
+        }
+        while (pos > 0 && observation.prob[pos - 1] < p) {
+            observation.prob[pos] = observation.prob[pos - 1];
+            observation.classIndex[pos] = observation.classIndex[pos - 1];
+            pos--;
+        }
+        observation.prob[pos] = p;
+        observation.classIndex[pos] = static_cast<uint8_t>(c);
+    }
+    return observation;
+}
+
+BeamDecoder::BeamDecoder(const asl_model::LexiconDescriptor& lexicon) : lexicon_(lexicon) {
+    reset();
+}
+
+bool BeamDecoder::setVocabulary(size_t stage, const asl_model::ModelDescriptor& model) {
+    if (stage >= kMaxStages || model.numClasses > kMaxClasses) {
+        return false;
+    }
+    for (size_t i = 0; i < model.numClasses; ++i) {
+        const char token = model.labelToChar ? model.labelToChar[i] : asl_model::kNeutralToken;
+        const char* label = model.labelNames ? model.labelNames[i] : nullptr;
+        const size_t labelLength = label ? std::strlen(label) : 0;
+
+        ClassSymbol& symbol = symbols_[stage][i];
+        symbol.type = SymbolType::Blank;
+        symbol.letter = 0;
+        symbol.word = asl_model::kNoWord;
+
+        if (token == asl_model::kNeutralToken || token == asl_model::kBackspaceToken) {
+            continue;
+        }
+        if (token == asl_model::kSpaceToken || (label && std::strcmp(label, "SPACE") == 0)) {
+            symbol.type = SymbolType::Space;
+        } else if (labelLength > 1) {
+            if (std::strcmp(label, "NEUTRAL") == 0 || std::strcmp(label, "BACKSPACE") == 0) {
+                continue;
+            }
+            symbol.word = findWord(label);
+            if (symbol.word != asl_model::kNoWord) {
+                symbol.type = SymbolType::Word;
+            }
+        } else if (std::isalpha(static_cast<unsigned char>(token))) {
+            symbol.type = SymbolType::Letter;
+            symbol.letter = static_cast<char>(std::toupper(static_cast<unsigned char>(token)));
+        }
+    }
+    numClasses_[stage] = model.numClasses;
+    return true;
+}
+
+bool BeamDecoder::handles(size_t stage, size_t classIndex) const {
+    if (stage >= kMaxStages || classIndex >= numClasses_[stage]) {
+        return false;
+    }
+    return symbols_[stage][classIndex].type != SymbolType::Blank;
+}
+
+bool BeamDecoder::spellsLetters() const {
+    for (size_t stage = 0; stage < kMaxStages; ++stage) {
+        for (size_t i = 0; i < numClasses_[stage]; ++i) {
+            if (symbols_[stage][i].type == SymbolType::Letter) {
+                return true;
+            }
+        }
+    }
+    return false;
+}
+
+void BeamDecoder::reset() {
+    Hypothesis& root = beam_[0];
+    root.score = 0.0f;
+    root.node = 0;
+    root.context = asl_model::kSentenceStart;
+    root.last = kBlankCode;
+    root.pendingCount = 0;
+    beamSize_ = 1;
+    pauseRun_ = 0;
+}
+
+bool BeamDecoder::hasPending() const {
+    return beamSize_ > 0 && (beam_[0].node != 0 || beam_[0].pendingCount > 0);
+}
+
+uint16_t BeamDecoder::findChild(uint16_t node, char letter) const {
+    const asl_model::LexiconNode& parent = lexicon_.nodes[node];
+    const uint16_t end = static_cast<uint16_t>(parent.firstChild + parent.childCount);
+    for (uint16_t child = parent.firstChild; child < end; ++child) {
+        const char symbol = lexicon_.nodes[child].symbol;
+        if (symbol == letter) {
+            return child;
+        }
+        if (symbol > letter) {
+            break;
+        }
+    }
+    return 0;
+}
+
+uint16_t BeamDecoder::findWord(const char* text) const {
+    uint16_t node = 0;
+    for (const char* p = text; *p; ++p) {
+        node = findChild(node, static_cast<char>(std::toupper(static_cast<unsigned char>(*p))));
+        if (node == 0) {
+            return asl_model::kNoWord;
+        }
+    }
+    return lexicon_.nodes[node].word;
+}
+
+float BeamDecoder::wordLogProb(uint16_t context, uint16_t word) const {
+    size_t lo = 0;
+    size_t hi = lexicon_.numBigrams;
+    while (lo < hi) {
+        const size_t mid = (lo + hi) / 2;
+        const asl_model::LexiconBigram& entry = lexicon_.bigrams[mid];
+        if (entry.prev < context || (entry.prev == context && entry.next < word)) {
+            lo = mid + 1;
+        } else {
+            hi = mid;
+        }
+    }
+    if (lo < lexicon_.numBigrams && lexicon_.bigrams[lo].prev == context &&
+        lexicon_.bigrams[lo].next == word) {
+        return lexicon_.toLog(lexicon_.bigrams[lo].logProb);
+    }
+    const int16_t backoff =
+        context == asl_model::kSentenceStart ? lexicon_.startBackoff : lexicon_.words[context].logBackoff;
+    return lexicon_.toLog(backoff) + lexicon_.toLog(lexicon_.words[word].logProb);
+}
+
+// The trie steps already paid log P(prefix); completing swaps that for the
+// bigram probability of the word.
+bool BeamDecoder::completeWord(Hypothesis& hyp) const {
+    if (hyp.node == 0) {
+        return false;
+    }
+    const asl_model::LexiconNode& node = lexicon_.nodes[hyp.node];
+    if (node.word == asl_model::kNoWord || hyp.pendingCount == kMaxPending) {
+        return false;
+    }
+    hyp.score += params_.lmWeight * (wordLogProb(hyp.context, node.word) - lexicon_.toLog(node.logMass));
+    hyp.pending[hyp.pendingCount++] = node.word;
+    hyp.context = node.word;
+    hyp.node = 0;
+    return true;
+}
+
+bool BeamDecoder::pushWord(Hypothesis& hyp, uint16_t word) const {
+    if (hyp.node != 0 || hyp.pendingCount == kMaxPending) {
+        return false;
+    }
+    hyp.score += params_.lmWeight * wordLogProb(hyp.context, word);
+    hyp.pending[hyp.pendingCount++] = word;
+    hyp.context = word;
+    return true;
+}
+
+void BeamDecoder::addCandidate(const Hypothesis& hyp) {
+    if (candidateCount_ < kMaxCandidates) {
+        candidates_[candidateCount_++] = hyp;
+    }
+}
+
+size_t BeamDecoder::update(const Observation& observation) {
+    struct Item {
+        uint16_t code;
+        ClassSymbol symbol;
+        float logProb;
+        float prob;
+    };
+    Item items[kTopK];
+    size_t itemCount = 0;
+    float handled = 0.0f;
+    float listed = 0.0f;
+    float bestItem = 0.0f;
+    const size_t stage = observation.stage < kMaxStages ? observation.stage : 0;
+    for (size_t i = 0; i < observation.count && i < kTopK; ++i) {
+        const size_t cls = observation.classIndex[i];
+        listed += observation.prob[i];
+        if (cls >= numClasses_[stage] || symbols_[stage][cls].type == SymbolType::Blank) {
+            continue;
+        }
+        Item& item = items[itemCount++];
+        item.symbol = symbols_[stage][cls];
+        item.prob = observation.prob[i] > params_.minProb ? observation.prob[i] : params_.minProb;
+        item.logProb = std::log(item.prob);
+        switch (item.symbol.type) {
+            case SymbolType::Letter:
+                item.code = static_cast<uint16_t>(item.symbol.letter);
+                break;
+            case SymbolType::Space:
+                item.code = ' ';
+                break;
+            default:
+                item.code = static_cast<uint16_t>(kWordCode | cls);
+                break;
+        }
+        handled += observation.prob[i];
+        if (observation.prob[i] > bestItem) {
+            bestItem = observation.prob[i];
+        }
+    }
+    // Blank is the neutral (and BACKSPACE/unknown) classes in the top K plus
+    // an average share of the mass outside it. A window without any letter,
+    // space or word mass, such as a gated one, is all blank.
+    float blank = 1.0f;
+    if (handled > params_.minProb) {
+        const size_t unlisted = numClasses_[stage] > observation.count ? numClasses_[stage] - observation.count : 0;
+        const float residual = listed < 1.0f ? 1.0f - listed : 0.0f;
+        blank = (listed - handled) + residual / static_cast<float>(unlisted + 1);
+        blank = blank > params_.minProb ? blank : params_.minProb;
+    }
+    const float blankLog = std::log(blank);
+
+    candidateCount_ = 0;
+    for (size_t b = 0; b < beamSize_; ++b) {
+        const Hypothesis& hyp = beam_[b];
+
+        Hypothesis next = hyp;
+        next.score += blankLog;
+        next.last = kBlankCode;
+        addCandidate(next);
+
+        for (size_t i = 0; i < itemCount; ++i) {
+            const Item& item = items[i];
+            if (item.code == hyp.last) {
+                next = hyp;
+                next.score += item.logProb;
+                addCandidate(next);
+                continue;
+            }
+
+            switch (item.symbol.type) {
+                case SymbolType::Letter: {
+                    const float rootMass = lexicon_.toLog(lexicon_.nodes[0].logMass);
+                    const uint16_t child = findChild(hyp.node, item.symbol.letter);
+                    if (child != 0) {
+                        next = hyp;
+                        next.node = child;
+                        next.score += item.logProb + params_.letterPenalty +
+                                      params_.lmWeight * (lexicon_.toLog(lexicon_.nodes[child].logMass) -
+                                                          lexicon_.toLog(lexicon_.nodes[hyp.node].logMass));
+                        next.last = item.code;
+                        addCandidate(next);
+                    }
+                    // The letter may also begin the next word
+                    next = hyp;
+                    if (completeWord(next)) {
+                        const uint16_t first = findChild(0, item.symbol.letter);
+                        if (first != 0) {
+                            next.node = first;
+                            next.score += item.logProb + params_.letterPenalty +
+                                          params_.lmWeight * (lexicon_.toLog(lexicon_.nodes[first].logMass) - rootMass);
+                            next.last = item.code;
+                            addCandidate(next);
+                        }
+                    }
+                    break;
+                }
+                case SymbolType::Space:
+                    next = hyp;
+                    if (hyp.node == 0 || completeWord(next)) {
+                        next.score += item.logProb;
+                        next.last = item.code;
+                        addCandidate(next);
+                    }
+                    break;
+                case SymbolType::Word:
+                    next = hyp;
+                    if (hyp.node != 0 && !completeWord(next)) {
+                        break;
+                    }
+                    if (pushWord(next, item.symbol.word)) {
+                        next.score += item.logProb + params_.letterPenalty;
+                        next.last = item.code;
+                        addCandidate(next);
+                    }
+                    break;
+                default:
+                    break;
+            }
+        }
+    }
+    lastExpansions_ = candidateCount_;
+    selectBeam();
+
+    size_t count = 0;
+    if (blank >= bestItem) {
+        if (++pauseRun_ == params_.pauseTicks) {
+            finishPausedWords();
+            count += commitAgreed(true);
+        }
+    } else {
+        pauseRun_ = 0;
+    }
+    count += commitAgreed(false);
+    return count;
+}
+
+void BeamDecoder::selectBeam() {
+    beamSize_ = 0;
+    for (size_t c = 0; c < candidateCount_; ++c) {
+        const Hypothesis& cand = candidates_[c];
+        size_t match = beamSize_;
+        size_t worst = 0;
+        for (size_t b = 0; b < beamSize_; ++b) {
+            const Hypothesis& hyp = beam_[b];
+            if (hyp.node == cand.node && hyp.context == cand.context && hyp.last == cand.last &&
+                hyp.pendingCount == cand.pendingCount &&
+                std::memcmp(hyp.pending, cand.pending, hyp.pendingCount * sizeof(hyp.pending[0])) == 0) {
+                match = b;
+                break;
+            }
+            if (hyp.score < beam_[worst].score) {
+                worst = b;
+            }
+        }
+        if (match < beamSize_) {
+            if (cand.score > beam_[match].score) {
+                beam_[match] = cand;
+            }
+        } else if (beamSize_ < kBeamWidth) {
+            beam_[beamSize_++] = cand;
+        } else if (cand.score > beam_[worst].score) {
+            beam_[worst] = cand;
+        }
+    }
+
+    // Best first, scores relative to the best
+    for (size_t i = 1; i < beamSize_; ++i) {
+        const Hypothesis hyp = beam_[i];
+        size_t j = i;
+        while (j > 0 && beam_[j - 1].score < hyp.score) {
+            beam_[j] = beam_[j - 1];
+            j--;
+        }
+        beam_[j] = hyp;
+    }
+    if (beamSize_ == 0) {
+        reset();
+        return;
+    }
+    const float best = beam_[0].score;
+    for (size_t i = 0; i < beamSize_; ++i) {
+        beam_[i].score -= best;
+    }
+}
+
+// After a pause, a hypothesis that has spelled a whole word ends it; one that
+// stopped inside a word is dropped, unless nothing else survives.
+void BeamDecoder::finishPausedWords() {
+    size_t kept = 0;
+    for (size_t i = 0; i < beamSize_; ++i) {
+        Hypothesis hyp = beam_[i];
+        if (hyp.node == 0 || completeWord(hyp)) {
+            candidates_[kept++] = hyp;
+        }
+    }
+    if (kept == 0) {
+        return;
+    }
+    candidateCount_ = kept;
+    selectBeam();
+}
+
+size_t BeamDecoder::commitAgreed(bool force) {
+    size_t count = 0;
+    while (beamSize_ > 0 && beam_[0].pendingCount > 0) {
+        const uint16_t word = beam_[0].pending[0];
+        bool agreed = true;
+        for (size_t i = 1; i < beamSize_ && agreed; ++i) {
+            const Hypothesis& hyp = beam_[i];
+            if (hyp.score < -params_.commitMargin) {
+                break;  // beam is sorted
+            }
+            agreed = hyp.pendingCount > 0 && hyp.pending[0] == word;
+        }
+        if (!agreed && !force && beam_[0].pendingCount < kMaxPending) {
+            break;
+        }
+
+        size_t kept = 0;
+        for (size_t i = 0; i < beamSize_; ++i) {
+            Hypothesis& hyp = beam_[i];
+            if (hyp.pendingCount == 0 || hyp.pending[0] != word) {
+                continue;
+            }
+            hyp.pendingCount--;
+            std::memmove(hyp.pending, hyp.pending + 1, hyp.pendingCount * sizeof(hyp.pending[0]));
+            beam_[kept++] = hyp;
+        }
+        beamSize_ = kept;
+        emit(word);
+        count++;
+    }
+    return count;
+}
+
+size_t BeamDecoder::flush() {
+    finishPausedWords();
+    const size_t count = commitAgreed(true);
+    reset();
+    return count;
+}
+
+void BeamDecoder::emit(uint16_t word) {
+    if (committedCount_ == kCommitQueue) {
+        // Oldest word is lost if the caller stops draining the queue
+        committedHead_ = (committedHead_ + 1) % kCommitQueue;
+        committedCount_--;
+    }
+    committed_[(committedHead_ + committedCount_) % kCommitQueue] = word;
+    committedCount_++;
+}
+
+bool BeamDecoder::popWord(uint16_t& word) {
+    if (committedCount_ == 0) {
+        return false;
+    }
+    word = committed_[committedHead_];
+    committedHead_ = (committedHead_ + 1) % kCommitQueue;
+    committedCount_--;
+    return true;
+}
+
+const char* BeamDecoder::wordText(uint16_t word) const {
+    if (word >= lexicon_.numWords) {
+        return "";
+    }
+    return lexicon_.text + lexicon_.words[word].textOffset;
+}
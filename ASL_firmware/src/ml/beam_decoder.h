@@ -0,0 +1,133 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+
+#include "ml/lexicon.h"
+#include "ml/model_descriptor.h"
+
+// Lexicon-constrained beam search over the per-window class probabilities.
+//
+// Each inference window is one tick. A hypothesis is a position in the
+// lexicon trie (the word being spelled), the previous word for the bigram
+// model, the last emitted symbol and the words it has completed but not yet
+// committed. Repeated symbols collapse into one letter, as in CTC decoding, so
+// a letter must be separated from a repeat of itself by a neutral window.
+// Letters are only accepted along trie edges; a word ends on a SPACE class, on
+// a letter that cannot extend it, or after a pause. Words are committed once
+// every hypothesis within commitMargin of the best agrees on them.
+//
+// Work per tick is bounded by kMaxCandidates expansions, each a trie child
+// scan (at most 26 entries) and at most one bigram binary search; no
+// allocation.
+class BeamDecoder {
+public:
+    static constexpr size_t kBeamWidth = 8;
+    static constexpr size_t kTopK = 4;  // classes considered per window
+    static constexpr size_t kMaxPending = 4;
+    static constexpr size_t kMaxStages = 2;
+    static constexpr size_t kMaxClasses = 64;
+    // Per hypothesis: one blank extension, and up to two per class (a letter
+    // may both extend the current word and start a new one).
+    static constexpr size_t kMaxCandidates = kBeamWidth * (1 + 2 * kTopK);
+    static constexpr size_t kCommitQueue = 8;
+
+    // The top classes of one inference window.
+    struct Observation {
+        uint8_t stage{0};
+        uint8_t count{0};
+        uint8_t classIndex[kTopK]{};
+        float prob[kTopK]{};
+
+        // Keeps the kTopK most probable of numClasses scores.
+        static Observation fromScores(int stage, const float* scores, size_t numClasses);
+    };
+
+    struct Params {
+        float lmWeight{0.5f};         // scales trie and bigram log probabilities
+        float letterPenalty{-1.0f};   // added per emitted letter or word class
+        float commitMargin{5.0f};     // log-prob gap that counts as unambiguous
+        float minProb{1e-4f};         // floor for window probabilities
+        uint16_t pauseTicks{60};      // neutral windows that end a word
+    };
+
+    explicit BeamDecoder(const asl_model::LexiconDescriptor& lexicon);
+
+    // Map the classes of one router stage to decoder symbols: letters, SPACE,
+    // whole words found in the lexicon, and neutral. Anything else (BACKSPACE,
+    // out-of-lexicon words) is left to the caller and treated as neutral here.
+    bool setVocabulary(size_t stage, const asl_model::ModelDescriptor& model);
+    bool handles(size_t stage, size_t classIndex) const;
+    // True if some stage has letter classes, i.e. there is anything to spell.
+    bool spellsLetters() const;
+
+    void setParams(const Params& params) { params_ = params; }
+    const Params& params() const { return params_; }
+
+    // Drop every hypothesis and start a new utterance.
+    void reset();
+    // Advance by one window. Returns the number of words committed.
+    size_t update(const Observation& observation);
+    // Commit the best hypothesis, including a finished word still being
+    // spelled, then reset. Returns the number of words committed.
+    size_t flush();
+    // True if the best hypothesis holds letters or words not yet committed.
+    bool hasPending() const;
+
+    // Committed words in order, as lexicon word ids.
+    bool popWord(uint16_t& word);
+    const char* wordText(uint16_t word) const;
+
+    size_t lastExpansions() const { return lastExpansions_; }
+    size_t lexiconWords() const { return lexicon_.numWords; }
+
+private:
+    enum class SymbolType : uint8_t { Blank, Letter, Space, Word };
+
+    struct ClassSymbol {
+        SymbolType type;
+        char letter;
+        uint16_t word;
+    };
+
+    struct Hypothesis {
+        float score;
+        uint16_t node;
+        uint16_t context;
+        uint16_t last;  // kBlankCode, a letter, ' ' or kWordCode | class
+        uint8_t pendingCount;
+        uint16_t pending[kMaxPending];
+    };
+
+    static constexpr uint16_t kBlankCode = 0;
+    static constexpr uint16_t kWordCode = 0x8000;
+
+    const asl_model::LexiconDescriptor& lexicon_;
+    Params params_;
+    ClassSymbol symbols_[kMaxStages][kMaxClasses];
+    size_t numClasses_[kMaxStages]{};
+
+    Hypothesis beam_[kBeamWidth];
+    size_t beamSize_{0};
+    Hypothesis candidates_[kMaxCandidates];
+    size_t candidateCount_{0};
+    size_t lastExpansions_{0};
+    uint16_t pauseRun_{0};
+
+    uint16_t committed_[kCommitQueue];
+    size_t committedHead_{0};
+    size_t committedCount_{0};
+
+    uint16_t findChild(uint16_t node, char letter) const;
+    uint16_t findWord(const char* text) const;
+    float wordLogProb(uint16_t context, uint16_t word) const;
+    bool completeWord(Hypothesis& hyp) const;
+    bool pushWord(Hypothesis& hyp, uint16_t word) const;
+    void addCandidate(const Hypothesis& hyp);
+    void selectBeam();
+    void finishPausedWords();
+    size_t commitAgreed(bool force);
+    void emit(uint16_t word);
+};
+
+extern BeamDecoder aslDecoder;
@@ -0,0 +1,508 @@
+#include "ml/dtw_matcher.h"
+
+#include <cctype>
+#include <cmath>
+#include <cstring>
+
+#include "ml/asl_model_config.h"
+
+DtwMatcher dtwMatcher{asl_model::kImuNorm};
+
+namespace {
+
+// A full finger bend weighs as much as four standard deviations of IMU
+// motion; flex spans [0, 1] while the z-scored IMU spans several units.
+constexpr float kFlexGain = 4.0f;
+// Frames whose motion energy is below this share of the peak are trimmed
+// from both ends of a capture.
+constexpr int32_t kTrimPercent = 20;
+// A capture whose peak frame-to-frame change is below one sigma summed over
+// the channels is treated as no sign at all.
+constexpr int32_t kMinMotion = DtwMatcher::kFeatureScale;
+constexpr uint32_t kInfinity = 0xFFFFFFFFu;
+constexpr int kReadRetries = 4;
+
+int16_t quantize(float value) {
+    float scaled = value * DtwMatcher::kFeatureScale;
+    if (scaled > DtwMatcher::kFeatureLimit) scaled = DtwMatcher::kFeatureLimit;
+    if (scaled < -DtwMatcher::kFeatureLimit) scaled = -DtwMatcher::kFeatureLimit;
+    return static_cast<int16_t>(scaled < 0.0f ? scaled - 0.5f : scaled + 0.5f);
+}
+
+// Squared distance between two frames. Fixed width over int16 lanes with an
+// int32 accumulator, so the compiler can unroll and vectorize it.
+inline uint32_t frameDistance(const DtwMatcher::Frame& a, const DtwMatcher::Frame& b) {
+    int32_t sum = 0;
+    for (size_t c = 0; c < DtwMatcher::kLanes; ++c) {
+        const int32_t d = static_cast<int32_t>(a.v[c]) - b.v[c];
+        sum += d * d;
+    }
+    return static_cast<uint32_t>(sum);
+}
+
+inline uint32_t frameMotion(const DtwMatcher::Frame& a, const DtwMatcher::Frame& b) {
+    int32_t sum = 0;
+    for (size_t c = 0; c < DtwMatcher::kLanes; ++c) {
+        const int32_t d = static_cast<int32_t>(a.v[c]) - b.v[c];
+        sum += d < 0 ? -d : d;
+    }
+    return static_cast<uint32_t>(sum);
+}
+
+void copyUpper(char* dst, size_t size, const char* src) {
+    size_t i = 0;
+    for (; src && src[i] != '\0' && i + 1 < size; ++i) {
+        dst[i] = static_cast<char>(std::toupper(static_cast<unsigned char>(src[i])));
+    }
+    std::memset(dst + i, 0, size - i);
+}
+
+}  // namespace
+
+DtwMatcher::DtwMatcher(const asl_model::NormParams* imuNorm) : imuNorm_(imuNorm) {}
+
+void DtwMatcher::setParams(const Params& params) {
+    params_ = params;
+    for (size_t i = 0; i < templateCount_; ++i) {
+        buildEnvelope(i);
+    }
+}
+
+size_t DtwMatcher::band(size_t length) const {
+    const size_t r = static_cast<size_t>(params_.bandFraction * static_cast<float>(length));
+    return r < 1 ? 1 : r;
+}
+
+DtwMatcher::Frame DtwMatcher::toFrame(const SensorSample& sample) const {
+    Frame frame{};
+    if (sample.fingersValid()) {
+        for (size_t f = 0; f < asl_model::kNumFlex; ++f) {
+            frame.v[f] = quantize(sample.flexValue(static_cast<int>(f)) * kFlexGain);
+        }
+    }
+    if (sample.imuValid() && imuNorm_) {
+        for (int axis = 0; axis < 3; ++axis) {
+            const asl_model::NormParams& a = imuNorm_[axis];
+            const asl_model::NormParams& g = imuNorm_[3 + axis];
+            frame.v[asl_model::kNumFlex + axis] = quantize((sample.accelValue(axis) - a.mean) / a.std);
+            frame.v[asl_model::kNumFlex + 3 + axis] = quantize((sample.gyroValue(axis) - g.mean) / g.std);
+        }
+    }
+    return frame;
+}
+
+const DtwMatcher::Frame& DtwMatcher::windowFrame(size_t age) const {
+    return window_[(windowHead_ + kMaxFrames - 1 - age) % kMaxFrames];
+}
+
+DtwMatcher::Event DtwMatcher::update(const SampleHistory& history, Match& match) {
+    Event event = Event::None;
+    if (requestState_.load(std::memory_order_acquire) == 2) {
+        event = applyRequest();
+        requestState_.store(0, std::memory_order_release);
+    }
+
+    const uint32_t written = history.written();
+    constexpr uint32_t kReadable = SampleHistory::kCapacity - 1;
+    if (written - nextSeq_ > kReadable) {
+        // Lapped by SensorTask (or the history was cleared): start over.
+        nextSeq_ = written - (written < kReadable ? written : kReadable);
+        windowFilled_ = 0;
+    }
+
+    bool newFrame = false;
+    for (; nextSeq_ != written; ++nextSeq_) {
+        if (nextSeq_ % kFrameStride != 0) {
+            continue;
+        }
+        const Frame frame = toFrame(history.at(nextSeq_));
+        if (!history.intact(nextSeq_)) {
+            nextSeq_ = history.written();
+            windowFilled_ = 0;
+            return event;
+        }
+        window_[windowHead_] = frame;
+        windowHead_ = (windowHead_ + 1) % kMaxFrames;
+        if (windowFilled_ < kMaxFrames) {
+            windowFilled_++;
+        }
+        if (cooldown_ > 0) {
+            cooldown_--;
+        }
+        newFrame = true;
+
+        if (!capturing_) {
+            continue;
+        }
+        if (leadFrames_ < kLeadFrames) {
+            if (++leadFrames_ == kLeadFrames && event == Event::None) {
+                event = Event::CaptureStarted;
+            }
+            continue;
+        }
+        capture_[captureFrames_++] = frame;
+        if (captureFrames_ == kCaptureFrames) {
+            capturing_ = false;
+            const Event result = finishCapture();
+            if (event == Event::None || event == Event::CaptureStarted) {
+                event = result;
+            }
+        }
+    }
+
+    // Matching only looks at the newest frame, so a call that catches up on
+    // several frames still costs at most one pass over the templates.
+    if (newFrame && !capturing_ && cooldown_ == 0 && event == Event::None && matchNewest(match)) {
+        cooldown_ = match.frames;
+        event = Event::Match;
+    }
+    return event;
+}
+
+uint32_t DtwMatcher::lowerBound(size_t index, uint32_t bound) const {
+    const Envelope& env = envelopes_[index];
+    const size_t length = templates_[index].length;
+    uint32_t sum = 0;
+    for (size_t k = 0; k < length; ++k) {
+        const Frame& q = windowFrame(length - 1 - k);
+        int32_t frameSum = 0;
+        for (size_t c = 0; c < kLanes; ++c) {
+            const int32_t v = q.v[c];
+            const int32_t hi = env.upper[k].v[c];
+            const int32_t lo = env.lower[k].v[c];
+            const int32_t d = v > hi ? v - hi : (v < lo ? lo - v : 0);
+            frameSum += d * d;
+        }
+        sum += static_cast<uint32_t>(frameSum);
+        if (sum > bound) {
+            return kInfinity;
+        }
+    }
+    return sum;
+}
+
+uint32_t DtwMatcher::dtw(size_t index, uint32_t bound, uint32_t& cells) const {
+    const Template& tmpl = templates_[index];
+    const size_t length = tmpl.length;
+    const size_t r = band(length);
+    uint32_t rows[2][kMaxFrames];
+    uint32_t* prev = rows[0];
+    uint32_t* cur = rows[1];
+    for (size_t j = 0; j < length; ++j) {
+        prev[j] = kInfinity;
+    }
+
+    for (size_t i = 0; i < length; ++i) {
+        const Frame& q = windowFrame(length - 1 - i);
+        const size_t lo = i > r ? i - r : 0;
+        const size_t hi = i + r < length - 1 ? i + r : length - 1;
+        if (lo > 0) {
+            cur[lo - 1] = kInfinity;
+        }
+        uint32_t rowMin = kInfinity;
+        for (size_t j = lo; j <= hi; ++j) {
+            uint32_t best;
+            if (i == 0 && j == 0) {
+                best = 0;
+            } else {
+                best = prev[j];
+                if (j > 0) {
+                    if (prev[j - 1] < best) best = prev[j - 1];
+                    if (cur[j - 1] < best) best = cur[j - 1];
+                }
+            }
+            const uint32_t cost = best == kInfinity ? kInfinity : best + frameDistance(q, tmpl.frames[j]);
+            cur[j] = cost;
+            if (cost < rowMin) rowMin = cost;
+        }
+        if (hi + 1 < length) {
+            cur[hi + 1] = kInfinity;
+        }
+        cells += static_cast<uint32_t>(hi - lo + 1);
+        if (rowMin > bound) {
+            return kInfinity;  // every path through this row is already worse
+        }
+        uint32_t* swap = prev;
+        prev = cur;
+        cur = swap;
+    }
+    return prev[length - 1];
+}
+
+bool DtwMatcher::matchNewest(Match& match) {
+    stats_.ticks++;
+    // Distances are compared per frame and channel so templates of different
+    // lengths compete fairly; each template converts the bound to its own
+    // total.
+    const float scale = static_cast<float>(kFeatureScale);
+    float bestNorm = params_.acceptDistance * params_.acceptDistance * scale * scale;
+    int best = -1;
+    uint32_t cells = 0;
+
+    for (size_t i = 0; i < templateCount_; ++i) {
+        const Template& tmpl = templates_[i];
+        if (tmpl.length > windowFilled_) {
+            continue;
+        }
+        if (person_[0] != '\0' && std::strncmp(tmpl.person, person_, kPersonLength) != 0) {
+            continue;
+        }
+        stats_.candidates++;
+        const float divisor = static_cast<float>(tmpl.length * kChannels);
+        const float limit = bestNorm * divisor;
+        const uint32_t bound = limit >= 4.0e9f ? kInfinity - 1 : static_cast<uint32_t>(limit);
+        if (lowerBound(i, bound) == kInfinity) {
+            stats_.lbPruned++;
+            continue;
+        }
+        const uint32_t distance = dtw(i, bound, cells);
+        if (distance == kInfinity) {
+            stats_.abandoned++;
+            continue;
+        }
+        const float norm = static_cast<float>(distance) / divisor;
+        if (norm < bestNorm) {
+            bestNorm = norm;
+            best = static_cast<int>(i);
+        }
+    }
+
+    stats_.lastCells = cells;
+    if (cells > stats_.maxCells) {
+        stats_.maxCells = cells;
+    }
+    if (best < 0) {
+        return false;
+    }
+    match.index = best;
+    std::memcpy(match.word, templates_[best].word, kWordLength);
+    match.distance = std::sqrt(bestNorm) / scale;
+    match.frames = templates_[best].length;
+    return true;
+}
+
+DtwMatcher::Event DtwMatcher::finishCapture() {
+    // Trim the still lead and tail by frame-to-frame motion energy.
+    uint32_t peak = 0;
+    uint32_t motion[kCaptureFrames] = {};
+    for (size_t t = 1; t < kCaptureFrames; ++t) {
+        motion[t] = frameMotion(capture_[t], capture_[t - 1]);
+        if (motion[t] > peak) peak = motion[t];
+    }
+    if (peak < static_cast<uint32_t>(kMinMotion)) {
+        return Event::CaptureFailed;
+    }
+    const uint32_t threshold = peak * kTrimPercent / 100;
+    size_t first = 1;
+    while (motion[first] < threshold) first++;
+    size_t last = kCaptureFrames - 1;
+    while (motion[last] < threshold) last--;
+    first--;  // keep the frame the motion started from
+
+    const size_t span = last - first + 1;
+    if (span < kMinFrames) {
+        return Event::CaptureFailed;
+    }
+
+    Template tmpl{};
+    std::memcpy(tmpl.word, active_.word, kWordLength);
+    std::memcpy(tmpl.person, active_.person, kPersonLength);
+    const size_t length = span < kMaxFrames ? span : kMaxFrames;
+    tmpl.length = static_cast<uint8_t>(length);
+    for (size_t k = 0; k < length; ++k) {
+        // Uniform resampling when the sign ran longer than a template holds.
+        const size_t src = length == span ? k : k * (span - 1) / (length - 1);
+        tmpl.frames[k] = capture_[first + src];
+    }
+    return addTemplate(tmpl) ? Event::CaptureSaved : Event::CaptureFailed;
+}
+
+void DtwMatcher::buildEnvelope(size_t index) {
+    const Template& tmpl = templates_[index];
+    Envelope& env = envelopes_[index];
+    const size_t length = tmpl.length;
+    const size_t r = band(length);
+    for (size_t k = 0; k < length; ++k) {
+        const size_t lo = k > r ? k - r : 0;
+        const size_t hi = k + r < length - 1 ? k + r : length - 1;
+        for (size_t c = 0; c < kLanes; ++c) {
+            int16_t up = tmpl.frames[lo].v[c];
+            int16_t down = up;
+            for (size_t j = lo + 1; j <= hi; ++j) {
+                const int16_t v = tmpl.frames[j].v[c];
+                if (v > up) up = v;
+                if (v < down) down = v;
+            }
+            env.upper[k].v[c] = up;
+            env.lower[k].v[c] = down;
+        }
+    }
+}
+
+bool DtwMatcher::addTemplate(const Template& tmpl) {
+    if (templateCount_ == kMaxTemplates || tmpl.length < kMinFrames || tmpl.length > kMaxFrames ||
+        tmpl.word[0] == '\0') {
+        return false;
+    }
+    beginWrite();
+    Template& slot = templates_[templateCount_];
+    slot = tmpl;
+    slot.word[kWordLength - 1] = '\0';
+    slot.person[kPersonLength - 1] = '\0';
+    buildEnvelope(templateCount_);
+    templateCount_++;
+    endWrite();
+    return true;
+}
+
+size_t DtwMatcher::removeWord(const char* word) {
+    beginWrite();
+    size_t kept = 0;
+    for (size_t i = 0; i < templateCount_; ++i) {
+        if (std::strncmp(templates_[i].word, word, kWordLength) == 0) {
+            continue;
+        }
+        if (kept != i) {
+            templates_[kept] = templates_[i];
+            envelopes_[kept] = envelopes_[i];
+        }
+        kept++;
+    }
+    const size_t removed = templateCount_ - kept;
+    templateCount_ = kept;
+    endWrite();
+    return removed;
+}
+
+bool DtwMatcher::postRequest(RequestKind kind, const char* word, const char* person) {
+    uint8_t expected = 0;
+    if (!requestState_.compare_exchange_strong(expected, 1, std::memory_order_acquire)) {
+        return false;
+    }
+    request_.kind = kind;
+    request_.tmpl = nullptr;
+    copyUpper(request_.word, kWordLength, word);
+    std::memset(request_.person, 0, kPersonLength);
+    if (person) {
+        std::strncpy(request_.person, person, kPersonLength - 1);
+    }
+    requestState_.store(2, std::memory_order_release);
+    return true;
+}
+
+bool DtwMatcher::requestCapture(const char* word, const char* person) {
+    if (!word || word[0] == '\0') {
+        return false;
+    }
+    return postRequest(RequestKind::Capture, word, person);
+}
+
+bool DtwMatcher::requestRemove(const char* word) {
+    if (!word || word[0] == '\0') {
+        return false;
+    }
+    return postRequest(RequestKind::Remove, word, nullptr);
+}
+
+bool DtwMatcher::requestPerson(const char* person) {
+    return postRequest(RequestKind::Person, "", person);
+}
+
+bool DtwMatcher::requestAdd(const Template& tmpl) {
+    uint8_t expected = 0;
+    if (!requestState_.compare_exchange_strong(expected, 1, std::memory_order_acquire)) {
+        return false;
+    }
+    request_.kind = RequestKind::Add;
+    request_.tmpl = &tmpl;
+    requestState_.store(2, std::memory_order_release);
+    return true;
+}
+
+DtwMatcher::Event DtwMatcher::applyRequest() {
+    switch (request_.kind) {
+        case RequestKind::Capture:
+            active_ = request_;
+            capturing_ = true;
+            leadFrames_ = 0;
+            captureFrames_ = 0;
+            return Event::None;
+        case RequestKind::Remove:
+            removeWord(request_.word);
+            return Event::Removed;
+        case RequestKind::Person:
+            std::memcpy(person_, request_.person, kPersonLength);
+            return Event::None;
+        case RequestKind::Add:
+            addTemplate(*request_.tmpl);  // the caller checks count()
+            return Event::None;
+        case RequestKind::None:
+            break;
+    }
+    return Event::None;
+}
+
+void DtwMatcher::beginWrite() {
+    version_.fetch_add(1, std::memory_order_relaxed);
+    std::atomic_thread_fence(std::memory_order_release);
+}
+
+void DtwMatcher::endWrite() {
+    version_.fetch_add(1, std::memory_order_release);
+}
+
+size_t DtwMatcher::count() const {
+    for (int attempt = 0; attempt < kReadRetries; ++attempt) {
+        const uint32_t before = version_.load(std::memory_order_acquire);
+        if (before & 1u) {
+            continue;
+        }
+        const size_t n = templateCount_;
+        std::atomic_thread_fence(std::memory_order_acquire);
+        if (version_.load(std::memory_order_relaxed) == before) {
+            return n;
+        }
+    }
+    return 0;
+}
+
+bool DtwMatcher::copyTemplate(size_t index, Template& out) const {
+    for (int attempt = 0; attempt < kReadRetries; ++attempt) {
+        const uint32_t before = version_.load(std::memory_order_acquire);
+        if (before & 1u) {
+            continue;
+        }
+        const bool valid = index < templateCount_;
+        if (valid) {
+            out = templates_[index];
+        }
+        std::atomic_thread_fence(std::memory_order_acquire);
+        if (version_.load(std::memory_order_relaxed) == before) {
+            return valid;
+        }
+    }
+    return false;
+}
+
+bool DtwMatcher::hasWord(const char* word) const {
+    if (!word) {
+        return false;
+    }
+    char key[kWordLength];
+    copyUpper(key, kWordLength, word);
+    for (int attempt = 0; attempt < kReadRetries; ++attempt) {
+        const uint32_t before = version_.load(std::memory_order_acquire);
+        if (before & 1u) {
+            continue;
+        }
+        bool found = false;
+        for (size_t i = 0; i < templateCount_ && !found; ++i) {
+            found = std::strncmp(templates_[i].word, key, kWordLength) == 0;
+        }
+        std::atomic_thread_fence(std::memory_order_acquire);
+        if (version_.load(std::memory_order_relaxed) == before) {
+            return found;
+        }
+    }
+    return false;
+}
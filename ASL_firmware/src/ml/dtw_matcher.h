@@ -0,0 +1,166 @@
+#pragma once
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+
+#include "ml/model_descriptor.h"
+#include "ml/sample_history.h"
+
+// Per-user template matching for dynamic word signs.
+//
+// Every kFrameStride-th sample of the shared SampleHistory becomes an int16
+// frame (flex and z-scored IMU, Q6, padded to kLanes so a frame is 24
+// bytes). After each new frame the newest L frames are compared with every
+// template of length L by dynamic time warping in a Sakoe-Chiba band. A
+// template is first checked against its LB_Keogh lower bound, and the DTW
+// itself is abandoned as soon as a whole row exceeds the best distance so
+// far, so most templates cost a single pass over the window.
+//
+// Templates are recorded from the live stream: requestCapture() arms a
+// recording that starts after a short lead-in, and the still frames at both
+// ends are trimmed off. Requests may come from any task; update(), which
+// applies them and does all matching, must only run in one (InferenceTask).
+// Readers on other tasks use the seqlock-protected accessors.
+class DtwMatcher {
+public:
+    static constexpr size_t kChannels = asl_model::kNumFeatures;
+    static constexpr size_t kLanes = 12;
+    static constexpr size_t kFrameStride = 2;        // 25 Hz frames
+    static constexpr size_t kMaxFrames = 40;         // 1.6 s per template
+    static constexpr size_t kMinFrames = 8;
+    static constexpr size_t kMaxTemplates = 8;
+    static constexpr size_t kWordLength = 16;
+    static constexpr size_t kPersonLength = 8;
+    static constexpr size_t kLeadFrames = 25;        // 1 s to get ready
+    static constexpr size_t kCaptureFrames = 50;     // 2 s recording
+    static constexpr int32_t kFeatureScale = 64;     // Q6
+    static constexpr int32_t kFeatureLimit = 511;    // |value| after scaling
+    static_assert(kChannels < kLanes, "padded frame too narrow");
+
+    struct Frame {
+        int16_t v[kLanes];
+    };
+
+    struct Template {
+        char word[kWordLength];
+        char person[kPersonLength];
+        uint8_t length;
+        Frame frames[kMaxFrames];
+    };
+
+    enum class Event : uint8_t {
+        None,
+        Match,
+        CaptureStarted,   // lead-in over, sign now
+        CaptureSaved,
+        CaptureFailed,    // too little motion, or no free slot
+        Removed
+    };
+
+    struct Match {
+        int index{-1};
+        char word[kWordLength]{};
+        float distance{0.0f};  // RMS per channel over the path, in sigma units
+        size_t frames{0};
+    };
+
+    struct Params {
+        float acceptDistance{0.8f};   // in the units of Match::distance
+        float bandFraction{0.25f};    // warping window as a share of the length
+    };
+
+    struct Stats {
+        uint32_t ticks{0};
+        uint32_t candidates{0};
+        uint32_t lbPruned{0};
+        uint32_t abandoned{0};
+        uint32_t lastCells{0};  // DTW cells evaluated by the newest frame
+        uint32_t maxCells{0};
+    };
+
+    explicit DtwMatcher(const asl_model::NormParams* imuNorm);
+
+    // Consume new samples and apply pending requests. Returns the first event
+    // produced; match is filled for Event::Match.
+    Event update(const SampleHistory& history, Match& match);
+
+    // Any task. Return false while an earlier request is still pending.
+    bool requestCapture(const char* word, const char* person);
+    bool requestRemove(const char* word);
+    // Only templates recorded by this person match; "" matches everyone's.
+    bool requestPerson(const char* person);
+    // Add a stored template. tmpl must stay untouched until requestPending()
+    // turns false.
+    bool requestAdd(const Template& tmpl);
+    bool requestPending() const { return requestState_.load(std::memory_order_acquire) != 0; }
+
+    // Any task; consistent snapshot of the table.
+    size_t count() const;
+    bool copyTemplate(size_t index, Template& out) const;
+    bool hasWord(const char* word) const;
+    // Changes with every add or remove, for persisting the table.
+    uint32_t generation() const { return version_.load(std::memory_order_acquire) >> 1; }
+
+    // Setup only; rebuilds the envelopes for the new band.
+    void setParams(const Params& params);
+    const Params& params() const { return params_; }
+    const Stats& stats() const { return stats_; }
+    void resetStats() { stats_ = Stats{}; }
+
+private:
+    enum class RequestKind : uint8_t { None, Capture, Remove, Person, Add };
+    struct Request {
+        RequestKind kind;
+        char word[kWordLength];
+        char person[kPersonLength];
+        const Template* tmpl;  // Add only
+    };
+
+    struct Envelope {
+        Frame upper[kMaxFrames];
+        Frame lower[kMaxFrames];
+    };
+
+    const asl_model::NormParams* imuNorm_;
+    Params params_;
+    Stats stats_;
+
+    Template templates_[kMaxTemplates];
+    Envelope envelopes_[kMaxTemplates];
+    size_t templateCount_{0};
+    std::atomic<uint32_t> version_{0};  // odd while the table is being changed
+
+    Frame window_[kMaxFrames];          // ring of the newest frames
+    size_t windowHead_{0};
+    size_t windowFilled_{0};
+    uint32_t nextSeq_{0};
+    size_t cooldown_{0};
+
+    Frame capture_[kCaptureFrames];
+    size_t captureFrames_{0};
+    size_t leadFrames_{0};
+    bool capturing_{false};
+    Request active_{};                  // the capture in progress
+
+    std::atomic<uint8_t> requestState_{0};  // 0 free, 1 being written, 2 ready
+    Request request_{};
+    char person_[kPersonLength]{};
+
+    size_t band(size_t length) const;
+    Frame toFrame(const SensorSample& sample) const;
+    const Frame& windowFrame(size_t age) const;  // 0 = newest
+    uint32_t lowerBound(size_t index, uint32_t bound) const;
+    uint32_t dtw(size_t index, uint32_t bound, uint32_t& cells) const;
+    bool matchNewest(Match& match);
+    Event finishCapture();
+    bool addTemplate(const Template& tmpl);
+    size_t removeWord(const char* word);
+    void buildEnvelope(size_t index);
+    bool postRequest(RequestKind kind, const char* word, const char* person);
+    Event applyRequest();
+    void beginWrite();
+    void endWrite();
+};
+
+extern DtwMatcher dtwMatcher;
@@ -0,0 +1,89 @@
+#include "ml/gesture_segmenter.h"
+
+#include <algorithm>
+#include <cmath>
+
+void GestureSegmenter::reset() {
+    primed_ = false;
+    active_ = false;
+    repetition_ = 0;
+    run_ = 0;
+    flexSpeed_ = 0.0f;
+    gyroEnergy_ = 0.0f;
+    std::fill(rest_, rest_ + kNumFlex, 0.0f);
+    std::fill(smoothFlex_, smoothFlex_ + kNumFlex, 0.0f);
+    std::fill(lastFlex_, lastFlex_ + kNumFlex, 0.0f);
+}
+
+GestureSegmenter::Tag GestureSegmenter::update(const float* flex, const float* gyro) {
+    const float alpha = params_.smoothing;
+
+    if (flex) {
+        if (!primed_) {
+            std::copy(flex, flex + kNumFlex, rest_);
+            std::copy(flex, flex + kNumFlex, smoothFlex_);
+            std::copy(flex, flex + kNumFlex, lastFlex_);
+            primed_ = true;
+        }
+        float speed = 0.0f;
+        for (size_t i = 0; i < kNumFlex; ++i) {
+            speed += std::fabs(flex[i] - lastFlex_[i]);
+            lastFlex_[i] = flex[i];
+            smoothFlex_[i] += alpha * (flex[i] - smoothFlex_[i]);
+        }
+        flexSpeed_ += alpha * (speed - flexSpeed_);
+    }
+    if (gyro) {
+        float energy = 0.0f;
+        for (size_t i = 0; i < kNumGyro; ++i) {
+            energy += gyro[i] * gyro[i];
+        }
+        gyroEnergy_ += alpha * (energy - gyroEnergy_);
+    }
+
+    float pose = 0.0f;
+    if (primed_) {
+        for (size_t i = 0; i < kNumFlex; ++i) {
+            pose = std::max(pose, std::fabs(smoothFlex_[i] - rest_[i]));
+        }
+    }
+    const float activity = std::max({pose / params_.poseThreshold, flexSpeed_ / params_.flexSpeedThreshold,
+                                     gyroEnergy_ / params_.gyroThreshold});
+
+    if (!active_) {
+        run_ = activity >= 1.0f ? run_ + 1 : 0;
+        if (run_ >= params_.onsetSamples) {
+            active_ = true;
+            repetition_++;
+            run_ = 0;
+        } else if (primed_ && activity < params_.release) {
+            for (size_t i = 0; i < kNumFlex; ++i) {
+                rest_[i] += params_.restAdapt * (smoothFlex_[i] - rest_[i]);
+            }
+        }
+    } else {
+        run_ = activity < params_.release ? run_ + 1 : 0;
+        if (run_ >= params_.offsetSamples) {
+            active_ = false;
+            run_ = 0;
+        }
+    }
+
+    Tag tag;
+    tag.repetition = repetition_;
+    tag.active = active_;
+    tag.activity = activity;
+    return tag;
+}
+
+GestureSegmenter::Tag GestureSegmenter::update(const SensorSample& sample) {
+    float flex[kNumFlex];
+    float gyro[kNumGyro];
+    for (size_t i = 0; i < kNumFlex; ++i) {
+        flex[i] = sample.flexValue(static_cast<int>(i));
+    }
+    for (size_t i = 0; i < kNumGyro; ++i) {
+        gyro[i] = sample.gyroValue(static_cast<int>(i));
+    }
+    return update(sample.fingersValid() ? flex : nullptr, sample.imuValid() ? gyro : nullptr);
+}
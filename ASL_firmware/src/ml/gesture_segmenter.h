@@ -0,0 +1,71 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+
+#include "sensor_types.h"
+
+// Splits a logged stream into repetitions of a sign and the rest between them.
+//
+// Three smoothed cues are compared with their thresholds: how far the fingers
+// are from the rest pose, how fast they move (sum of |Δflex| per sample) and
+// the gyro energy |ω|². The largest ratio is the activity. A repetition starts
+// once the activity stays at or above 1 for onsetSamples samples and ends once
+// it stays below `release` for offsetSamples, so a held static sign (far from
+// rest, but still) stays active. The rest pose starts as the first sample and
+// follows the hand slowly while it is resting, so logging should start with
+// the hand relaxed.
+//
+// Purely causal and allocation free: DataLogger runs it per sample on
+// SensorTask to tag the CSV stream, and the host runner replays sessions
+// through it. ML_model's segment_activity() is the same algorithm in Python
+// for recordings made before the tags were logged.
+class GestureSegmenter {
+public:
+    static constexpr size_t kNumFlex = 5;
+    static constexpr size_t kNumGyro = 3;
+
+    struct Params {
+        float poseThreshold{0.10f};       // max |flex - rest| over the fingers
+        float flexSpeedThreshold{0.15f};  // sum of |Δflex| per sample
+        float gyroThreshold{0.25f};       // |ω|² in (rad/s)², about 0.5 rad/s
+        float release{0.6f};              // share of a threshold that counts as rest
+        uint16_t onsetSamples{3};
+        uint16_t offsetSamples{15};       // 0.3 s
+        float smoothing{0.2f};            // EMA factor of every cue
+        float restAdapt{0.02f};           // EMA factor of the rest pose
+    };
+
+    struct Tag {
+        uint16_t repetition{0};  // onsets so far; rest keeps the one it follows
+        bool active{false};
+        float activity{0.0f};
+    };
+
+    GestureSegmenter() { reset(); }
+
+    // Forget the rest pose and restart the repetition count.
+    void reset();
+    // flex or gyro may be null when that sensor is unavailable; its cues then
+    // hold their last value.
+    Tag update(const float* flex, const float* gyro);
+    Tag update(const SensorSample& sample);
+
+    uint16_t repetitions() const { return repetition_; }
+    bool active() const { return active_; }
+
+    void setParams(const Params& params) { params_ = params; }
+    const Params& params() const { return params_; }
+
+private:
+    Params params_;
+    bool primed_{false};
+    bool active_{false};
+    uint16_t repetition_{0};
+    uint16_t run_{0};  // consecutive samples beyond the threshold being watched
+    float rest_[kNumFlex]{};
+    float smoothFlex_[kNumFlex]{};
+    float lastFlex_[kNumFlex]{};
+    float flexSpeed_{0.0f};
+    float gyroEnergy_{0.0f};
+};
@@ -1,23 +1,22 @@
-// Auto-generated normalization parameters
-// Must match training data preprocessing
+// IMU z-score normalization. Parameters come from the generated model package
+// (asl_model_config.h) and must match training data preprocessing.
 #ifndef IMU_NORMALIZATION_H_
 #define IMU_NORMALIZATION_H_
 
-struct NormParams {
-    float mean;
-    float std;
-};
+#include "ml/asl_model_config.h"
 
-constexpr NormParams kAxParams = {0.652877f, 0.246747f};
-constexpr NormParams kAyParams = {0.662821f, 0.117152f};
-constexpr NormParams kAzParams = {0.410897f, 0.252453f};
-constexpr NormParams kGxParams = {0.504955f, 0.301887f};
-constexpr NormParams kGyParams = {0.501236f, 0.212698f};
-constexpr NormParams kGzParams = {0.485134f, 0.303284f};
+using NormParams = asl_model::NormParams;
+
+constexpr NormParams kAxParams = asl_model::kImuNorm[0];
+constexpr NormParams kAyParams = asl_model::kImuNorm[1];
+constexpr NormParams kAzParams = asl_model::kImuNorm[2];
+constexpr NormParams kGxParams = asl_model::kImuNorm[3];
+constexpr NormParams kGyParams = asl_model::kImuNorm[4];
+constexpr NormParams kGzParams = asl_model::kImuNorm[5];
 
 // Normalize sensor value using z-score normalization
 inline float normalizeSensor(float value, const NormParams& p) {
     return (value - p.mean) / p.std;
 }
 
-#endif  // IMU_NORMALIZATION_H_
\ No newline at end of file
+#endif  // IMU_NORMALIZATION_H_
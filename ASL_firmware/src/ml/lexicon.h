@@ -0,0 +1,58 @@
+// Types shared by the generated lexicon package (ml/asl_lexicon.h, written by
+// ML_model/build_lexicon.py) and the BeamDecoder. Everything is constexpr so
+// the trie and language model stay in flash.
+#ifndef ASL_LEXICON_H_
+#define ASL_LEXICON_H_
+
+#include <cstddef>
+#include <cstdint>
+
+namespace asl_model {
+
+// Log probabilities are stored as int16 in units of 1/kLogScale nats.
+constexpr float kLexiconLogScale = 256.0f;
+constexpr uint16_t kNoWord = 0xFFFF;
+// Bigram context before the first word of an utterance.
+constexpr uint16_t kSentenceStart = 0xFFFE;
+
+// One trie node. Children of a node are contiguous and sorted by symbol;
+// node 0 is the root. logMass is the log of the unigram probability of all
+// words below (and at) the node, so child.logMass - parent.logMass is the
+// log probability of the next letter given the prefix.
+struct LexiconNode {
+    char symbol;
+    uint8_t childCount;
+    uint16_t firstChild;
+    uint16_t word;  // word ending at this node, kNoWord if none
+    int16_t logMass;
+};
+
+struct LexiconWord {
+    uint16_t textOffset;  // into LexiconDescriptor::text, NUL terminated
+    int16_t logProb;      // unigram
+    int16_t logBackoff;   // bigram backoff weight when this word is the context
+};
+
+// Seen bigrams, sorted by (prev, next). prev may be kSentenceStart.
+struct LexiconBigram {
+    uint16_t prev;
+    uint16_t next;
+    int16_t logProb;
+};
+
+struct LexiconDescriptor {
+    const LexiconNode* nodes;
+    size_t numNodes;
+    const LexiconWord* words;
+    size_t numWords;
+    const LexiconBigram* bigrams;
+    size_t numBigrams;
+    const char* text;
+    int16_t startBackoff;  // backoff weight of kSentenceStart
+
+    constexpr float toLog(int16_t value) const { return static_cast<float>(value) / kLexiconLogScale; }
+};
+
+}  // namespace asl_model
+
+#endif  // ASL_LEXICON_H_
@@ -0,0 +1,69 @@
+// Types and constants shared by every generated model package
+// (<name>_config.h). Each package describes one TFLite model through a
+// constexpr ModelDescriptor; the engine and router are written against this
+// struct so several models can be linked side by side.
+#ifndef ASL_MODEL_DESCRIPTOR_H_
+#define ASL_MODEL_DESCRIPTOR_H_
+
+#include <cstddef>
+#include <cstdint>
+
+namespace asl_model {
+
+struct NormParams {
+    float mean;
+    float std;
+};
+
+// Token protocol consumed by LogicTask.
+constexpr char kNeutralToken = '\x01';
+constexpr char kBackspaceToken = '\b';
+constexpr char kSpaceToken = ' ';
+
+// SensorTask sampling rate. Models run at kSensorRateHz / sampleStride.
+constexpr uint32_t kSensorRateHz = 50;
+
+// Per-frame feature layout: 5 flex then ax, ay, az, gx, gy, gz.
+constexpr size_t kNumFlex = 5;
+constexpr size_t kNumImu = 6;
+constexpr size_t kNumFeatures = kNumFlex + kNumImu;
+
+// Gate input: per-channel mean over the window, then per-channel std.
+constexpr size_t kGateFeatures = 2 * kNumFeatures;
+
+struct ModelDescriptor {
+    const char* name;
+    const unsigned char* data;
+    size_t windowSize;    // model frames per input
+    size_t sampleStride;  // sensor samples per model frame
+    size_t numClasses;
+    const char* const* labelNames;
+    const char* labelToChar;
+    float inputScale;
+    int32_t inputZeroPoint;
+    float outputScale;
+    int32_t outputZeroPoint;
+    const NormParams* imuNorm;  // kNumImu entries
+    int neutralIndex;           // class reported when the gate holds, -1 if none
+
+    // Optional logistic neutral-vs-gesture gate (nullptr = always run the
+    // model). The model runs when gateBias + gateWeights . summary >= gateLogit.
+    const float* gateWeights;  // kGateFeatures entries
+    float gateBias;
+    float gateLogit;
+
+    // Optional penultimate-layer embedding, exported as a second model output
+    // for on-device prototypes (embeddingSize = 0 when there is none).
+    size_t classOutput;  // output tensor index of the class scores
+    size_t embeddingSize;
+    float embeddingScale;
+    int32_t embeddingZeroPoint;
+
+    // Sensor samples covered by one input window.
+    constexpr size_t span() const { return windowSize * sampleStride; }
+    constexpr size_t inputBytes() const { return windowSize * kNumFeatures; }
+};
+
+}  // namespace asl_model
+
+#endif  // ASL_MODEL_DESCRIPTOR_H_
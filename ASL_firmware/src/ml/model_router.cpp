@@ -0,0 +1,46 @@
+#include "ml/model_router.h"
+
+ModelRouter aslRouter;
+
+bool ModelRouter::begin() {
+    // LogicTask can call this while InferenceTask polls classify(), so the
+    // router is published only after every stage has finished begin().
+    bool ready = true;
+    for (ASLInferenceEngine& engine : stages_) {
+        if (!engine.isReady() && !engine.begin()) {
+            ready = false;
+        }
+    }
+    ready_.store(ready, std::memory_order_release);
+    return ready;
+}
+
+bool ModelRouter::classify(const SampleHistory& history, InferenceResult& result, float* scores) {
+    result = InferenceResult{};
+    if (!isReady()) {
+        return false;
+    }
+
+    bool answered = false;
+    for (size_t i = 0; i < kNumStages; ++i) {
+        InferenceResult candidate;
+        if (!stages_[i].classify(history, candidate, scores)) {
+            // A longer stage may simply not have a full window yet.
+            continue;
+        }
+        runs_[i]++;
+        if (!candidate.gated) {
+            invokes_[i]++;
+        }
+        candidate.stage = static_cast<int>(i);
+        result = candidate;
+        answered = true;
+        // A gate decision is final: no stage needs to look at a resting hand.
+        if (candidate.gated ||
+            (candidate.letter != asl_model::kNeutralToken &&
+             candidate.confidence >= kAcceptConfidence)) {
+            break;
+        }
+    }
+    return answered;
+}
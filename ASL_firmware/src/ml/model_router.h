@@ -0,0 +1,72 @@
+#pragma once
+
+#include <algorithm>
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+
+#include "ml/asl_inference.h"
+#include "ml/asl_model_config.h"
+#include "ml/sample_history.h"
+
+// An optional short-window stage is linked in when its package
+// (model_package.py --model-name asl_model_short) is present in src/ml.
+#if __has_include("ml/asl_model_short_config.h")
+#include "ml/asl_model_short_config.h"
+#define ASL_HAS_SHORT_MODEL 1
+#else
+#define ASL_HAS_SHORT_MODEL 0
+#endif
+
+// Cascades the packaged models over one SampleHistory, cheapest window first.
+// A stage's answer is accepted when its gate holds, or when it is confident and
+// not neutral; otherwise the next, longer stage runs. The last stage always
+// answers once its window is filled.
+class ModelRouter {
+public:
+    static constexpr float kAcceptConfidence = 0.85f;
+#if ASL_HAS_SHORT_MODEL
+    static constexpr size_t kNumStages = 2;
+    static_assert(asl_model_short::kDescriptor.span() < asl_model::kDescriptor.span(),
+                  "short stage must cover fewer samples than the primary model");
+    static constexpr size_t kMaxClasses =
+        std::max(asl_model_short::kNumClasses, asl_model::kNumClasses);
+#else
+    static constexpr size_t kNumStages = 1;
+    static constexpr size_t kMaxClasses = asl_model::kNumClasses;
+#endif
+    static_assert(asl_model::kDescriptor.span() < SampleHistory::kCapacity,
+                  "SampleHistory cannot hold the primary model window");
+
+    bool begin();
+    bool isReady() const { return ready_.load(std::memory_order_acquire); }
+    // Personalizes the primary (last) stage; call after begin(). False if
+    // its model exports no embedding.
+    bool setPrototypes(PrototypeClassifier* prototypes) {
+        return stages_[kNumStages - 1].setPrototypes(prototypes);
+    }
+
+    // scores (optional, kMaxClasses entries) receives the answering stage's outputs.
+    bool classify(const SampleHistory& history, InferenceResult& result, float* scores = nullptr);
+
+    size_t numStages() const { return kNumStages; }
+    // Classifications per stage since boot; the escalation rate is
+    // runs(1) / runs(0). invokes() counts the ones that got past the gate.
+    uint32_t runs(size_t index) const { return runs_[index]; }
+    uint32_t invokes(size_t index) const { return invokes_[index]; }
+    ASLInferenceEngine& stage(size_t index) { return stages_[index]; }
+    const ASLInferenceEngine& stage(size_t index) const { return stages_[index]; }
+
+private:
+    std::atomic<bool> ready_{false};
+    uint32_t runs_[kNumStages]{};
+    uint32_t invokes_[kNumStages]{};
+    ASLInferenceEngine stages_[kNumStages]{
+#if ASL_HAS_SHORT_MODEL
+        ASLInferenceEngine{asl_model_short::kDescriptor},
+#endif
+        ASLInferenceEngine{asl_model::kDescriptor},
+    };
+};
+
+extern ModelRouter aslRouter;
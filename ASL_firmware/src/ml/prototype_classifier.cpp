@@ -0,0 +1,243 @@
+#include "ml/prototype_classifier.h"
+
+#include <cctype>
+#include <cmath>
+#include <cstring>
+
+PrototypeClassifier aslPrototypes{asl_model::kDescriptor};
+
+namespace {
+
+constexpr int kReadRetries = 4;
+
+// FNV-1a over what changes whenever the model is retrained: labels, shapes
+// and the quantization of every tensor the engine touches.
+uint32_t hashBytes(uint32_t hash, const void* data, size_t length) {
+    const uint8_t* bytes = static_cast<const uint8_t*>(data);
+    for (size_t i = 0; i < length; ++i) {
+        hash = (hash ^ bytes[i]) * 16777619u;
+    }
+    return hash;
+}
+
+uint32_t modelFingerprint(const asl_model::ModelDescriptor& model) {
+    uint32_t hash = 2166136261u;
+    for (size_t i = 0; i < model.numClasses; ++i) {
+        hash = hashBytes(hash, model.labelNames[i], std::strlen(model.labelNames[i]) + 1);
+    }
+    const uint32_t sizes[3] = {static_cast<uint32_t>(model.windowSize), static_cast<uint32_t>(model.numClasses),
+                               static_cast<uint32_t>(model.embeddingSize)};
+    const float scales[3] = {model.inputScale, model.outputScale, model.embeddingScale};
+    const int32_t zeroPoints[3] = {model.inputZeroPoint, model.outputZeroPoint, model.embeddingZeroPoint};
+    hash = hashBytes(hash, sizes, sizeof(sizes));
+    hash = hashBytes(hash, scales, sizeof(scales));
+    return hashBytes(hash, zeroPoints, sizeof(zeroPoints));
+}
+
+bool labelEquals(const char* a, const char* b) {
+    for (; *a && *b; ++a, ++b) {
+        if (std::toupper(static_cast<unsigned char>(*a)) != std::toupper(static_cast<unsigned char>(*b))) {
+            return false;
+        }
+    }
+    return *a == *b;
+}
+
+}  // namespace
+
+PrototypeClassifier::PrototypeClassifier(const asl_model::ModelDescriptor& model)
+    : model_(model),
+      available_(model.embeddingSize > 0 && model.embeddingSize <= kMaxDims &&
+                 model.numClasses <= kMaxClasses),
+      fingerprint_(modelFingerprint(model)) {
+    resetProfile();
+}
+
+void PrototypeClassifier::resetProfile() {
+    std::memset(&profile_, 0, sizeof(profile_));
+    profile_.fingerprint = fingerprint_;
+    profile_.numClasses = static_cast<uint16_t>(model_.numClasses);
+    profile_.dims = static_cast<uint16_t>(model_.embeddingSize);
+}
+
+void PrototypeClassifier::poll() {
+    if (requestState_.load(std::memory_order_acquire) != 2) {
+        return;
+    }
+    beginWrite();
+    if (requestKind_ == RequestKind::Load && requestProfile_ &&
+        requestProfile_->fingerprint == fingerprint_) {
+        profile_ = *requestProfile_;
+    } else {
+        resetProfile();
+    }
+    endWrite();
+    requestProfile_ = nullptr;
+    requestState_.store(0, std::memory_order_release);
+}
+
+void PrototypeClassifier::update(const float* embedding, float* scores) {
+    if (!available_ || !embedding) {
+        return;
+    }
+    const size_t dims = model_.embeddingSize;
+    float unit[kMaxDims];
+    float norm = 0.0f;
+    for (size_t d = 0; d < dims; ++d) {
+        norm += embedding[d] * embedding[d];
+    }
+    if (norm <= 0.0f) {
+        return;  // all-zero ReLU output carries no direction
+    }
+    const float inv = 1.0f / std::sqrt(norm);
+    for (size_t d = 0; d < dims; ++d) {
+        unit[d] = embedding[d] * inv;
+    }
+
+    const int learning = learningClass();
+    if (learning != learningSeen_) {
+        learningSeen_ = learning;
+        learnTicks_ = 0;
+    }
+    if (learning >= 0) {
+        // Skip the move into the sign, then take spaced-out windows so one
+        // long hold does not swamp the mean.
+        learnTicks_++;
+        if (learnTicks_ > kLearnSettle && (learnTicks_ - kLearnSettle) % kLearnStride == 1) {
+            learn(static_cast<size_t>(learning), unit);
+        }
+    }
+
+    if (scores && enabled()) {
+        fuse(unit, scores);
+    }
+}
+
+void PrototypeClassifier::learn(size_t classIndex, const float* unit) {
+    if (classIndex >= model_.numClasses) {
+        return;
+    }
+    beginWrite();
+    uint16_t& count = profile_.count[classIndex];
+    float* centroid = profile_.centroid[classIndex];
+    const float rate = 1.0f / static_cast<float>((count < kMaxWeight ? count : kMaxWeight) + 1);
+    for (size_t d = 0; d < model_.embeddingSize; ++d) {
+        centroid[d] += (unit[d] - centroid[d]) * rate;
+    }
+    if (count < UINT16_MAX) {
+        count++;
+    }
+    endWrite();
+}
+
+void PrototypeClassifier::fuse(const float* unit, float* scores) const {
+    const size_t dims = model_.embeddingSize;
+    float logit[kMaxClasses];
+    bool member[kMaxClasses];
+    size_t members = 0;
+    float mass = 0.0f;
+    float maxLogit = -1e30f;
+    for (size_t c = 0; c < model_.numClasses; ++c) {
+        member[c] = profile_.count[c] >= params_.minExamples;
+        if (!member[c]) {
+            continue;
+        }
+        const float* centroid = profile_.centroid[c];
+        float dot = 0.0f;
+        float norm = 0.0f;
+        for (size_t d = 0; d < dims; ++d) {
+            dot += unit[d] * centroid[d];
+            norm += centroid[d] * centroid[d];
+        }
+        logit[c] = norm > 0.0f ? dot / std::sqrt(norm) / params_.temperature : 0.0f;
+        if (logit[c] > maxLogit) maxLogit = logit[c];
+        mass += scores[c];
+        members++;
+    }
+    if (members < 2) {
+        return;  // nothing to choose between
+    }
+
+    float total = 0.0f;
+    for (size_t c = 0; c < model_.numClasses; ++c) {
+        if (member[c]) {
+            logit[c] = std::exp(logit[c] - maxLogit);
+            total += logit[c];
+        }
+    }
+    for (size_t c = 0; c < model_.numClasses; ++c) {
+        if (member[c]) {
+            scores[c] = (1.0f - params_.weight) * scores[c] + params_.weight * mass * logit[c] / total;
+        }
+    }
+    const_cast<PrototypeClassifier*>(this)->fused_++;
+}
+
+bool PrototypeClassifier::startLearning(const char* label) {
+    if (!available_ || !label) {
+        return false;
+    }
+    for (size_t c = 0; c < model_.numClasses; ++c) {
+        if (labelEquals(label, model_.labelNames[c])) {
+            learningClass_.store(static_cast<int>(c), std::memory_order_release);
+            return true;
+        }
+    }
+    return false;
+}
+
+bool PrototypeClassifier::requestLoad(const Profile& profile) {
+    uint8_t expected = 0;
+    if (!available_ || !requestState_.compare_exchange_strong(expected, 1, std::memory_order_acquire)) {
+        return false;
+    }
+    requestKind_ = RequestKind::Load;
+    requestProfile_ = &profile;
+    requestState_.store(2, std::memory_order_release);
+    return true;
+}
+
+bool PrototypeClassifier::requestClear() {
+    uint8_t expected = 0;
+    if (!requestState_.compare_exchange_strong(expected, 1, std::memory_order_acquire)) {
+        return false;
+    }
+    requestKind_ = RequestKind::Clear;
+    requestProfile_ = nullptr;
+    requestState_.store(2, std::memory_order_release);
+    return true;
+}
+
+bool PrototypeClassifier::snapshot(Profile& out) const {
+    for (int attempt = 0; attempt < kReadRetries; ++attempt) {
+        const uint32_t before = version_.load(std::memory_order_acquire);
+        if (before & 1u) {
+            continue;
+        }
+        out = profile_;
+        std::atomic_thread_fence(std::memory_order_acquire);
+        if (version_.load(std::memory_order_relaxed) == before) {
+            return true;
+        }
+    }
+    return false;
+}
+
+size_t PrototypeClassifier::trainedClasses() const {
+    size_t trained = 0;
+    for (size_t c = 0; c < model_.numClasses && c < kMaxClasses; ++c) {
+        if (profile_.count[c] >= params_.minExamples) {
+            trained++;
+        }
+    }
+    return trained;
+}
+
+void PrototypeClassifier::beginWrite() {
+    version_.fetch_add(1, std::memory_order_relaxed);
+    std::atomic_thread_fence(std::memory_order_release);
+}
+
+void PrototypeClassifier::endWrite() {
+    version_.fetch_add(1, std::memory_order_release);
+}
@@ -0,0 +1,111 @@
+#pragma once
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+
+#include "ml/asl_model_config.h"
+#include "ml/model_descriptor.h"
+
+// Per-user class prototypes over the primary model's penultimate-layer
+// embedding (see model_package.py: the embedding is a second model output).
+//
+// While learning, every kLearnStride-th invoked window adds its L2-normalized
+// embedding to the running mean of the class being recorded. At inference the
+// classes that have prototypes compete by cosine similarity: their combined
+// model probability is redistributed between them as a blend of the model's
+// own split and a softmax over the similarities. Classes without prototypes
+// keep their scores, so a user can personalize a few signs only.
+//
+// update() runs inside ASLInferenceEngine::classify on InferenceTask and is
+// the only writer. Other tasks post requests or read a seqlock snapshot, the
+// same scheme as ml/dtw_matcher.h. Storage is sized for the linked model and
+// collapses to a stub when it has no embedding output.
+class PrototypeClassifier {
+public:
+    static constexpr size_t kMaxClasses = asl_model::kNumClasses;
+    static constexpr size_t kMaxDims = asl_model::kEmbeddingSize > 0 ? asl_model::kEmbeddingSize : 1;
+    static constexpr uint16_t kMaxWeight = 64;    // the mean becomes an EMA after this many
+    static constexpr uint16_t kLearnStride = 12;  // windows between examples (~0.25 s)
+    static constexpr uint16_t kLearnSettle = 50;  // windows skipped after learning starts
+
+    // Everything a user profile stores; fingerprint ties it to one model.
+    struct Profile {
+        uint32_t fingerprint;
+        uint16_t numClasses;
+        uint16_t dims;
+        uint16_t count[kMaxClasses];
+        float centroid[kMaxClasses][kMaxDims];
+    };
+
+    struct Params {
+        float temperature{0.1f};  // softmax temperature over cosine similarity
+        float weight{0.6f};       // share of the prototype vote in the blend
+        uint16_t minExamples{3};  // a class joins once it has this many
+    };
+
+    explicit PrototypeClassifier(const asl_model::ModelDescriptor& model);
+
+    // True if the model exports an embedding that fits this build.
+    bool available() const { return available_; }
+    const asl_model::ModelDescriptor& model() const { return model_; }
+
+    // InferenceTask. Applies pending requests; call on every classification.
+    void poll();
+    // InferenceTask, after an invoked (not gated) window: learns from the
+    // embedding, then re-weights the model's scores in place.
+    void update(const float* embedding, float* scores);
+
+    // Any task. Learning is keyed by a model label; false if it has none.
+    bool startLearning(const char* label);
+    void stopLearning() { learningClass_.store(-1, std::memory_order_release); }
+    int learningClass() const { return learningClass_.load(std::memory_order_acquire); }
+    void setEnabled(bool enabled) { enabled_.store(enabled, std::memory_order_release); }
+    bool enabled() const { return enabled_.load(std::memory_order_acquire); }
+
+    // Any task. profile must stay untouched until requestPending() is false.
+    bool requestLoad(const Profile& profile);
+    bool requestClear();
+    bool requestPending() const { return requestState_.load(std::memory_order_acquire) != 0; }
+
+    // Any task; consistent copy of the prototypes.
+    bool snapshot(Profile& out) const;
+    // Changes whenever the prototypes do, for saving the profile.
+    uint32_t generation() const { return version_.load(std::memory_order_acquire) >> 1; }
+    uint32_t fingerprint() const { return fingerprint_; }
+    // Classes with at least minExamples examples (approximate off InferenceTask).
+    size_t trainedClasses() const;
+    uint32_t fusedWindows() const { return fused_; }
+
+    void setParams(const Params& params) { params_ = params; }
+    const Params& params() const { return params_; }
+
+private:
+    enum class RequestKind : uint8_t { None, Load, Clear };
+
+    const asl_model::ModelDescriptor& model_;
+    const bool available_;
+    const uint32_t fingerprint_;
+    Params params_;
+
+    Profile profile_{};
+    std::atomic<uint32_t> version_{0};  // odd while profile_ is being changed
+
+    std::atomic<int> learningClass_{-1};
+    int learningSeen_{-1};  // class of the run learnTicks_ counts
+    uint32_t learnTicks_{0};
+    std::atomic<bool> enabled_{true};
+    uint32_t fused_{0};
+
+    std::atomic<uint8_t> requestState_{0};  // 0 free, 1 being written, 2 ready
+    RequestKind requestKind_{RequestKind::None};
+    const Profile* requestProfile_{nullptr};
+
+    void learn(size_t classIndex, const float* unit);
+    void fuse(const float* unit, float* scores) const;
+    void resetProfile();
+    void beginWrite();
+    void endWrite();
+};
+
+extern PrototypeClassifier aslPrototypes;
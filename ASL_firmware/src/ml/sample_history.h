@@ -0,0 +1,53 @@
+// Single-producer sample history shared by every model in the router.
+//
+// SensorTask pushes each sample once; engines gather their own window length
+// and stride straight from the ring into their input tensor, so no per-model
+// window copies exist. Readers address samples by absolute sequence number and
+// confirm afterwards that the writer has not lapped them (seqlock style), which
+// keeps the producer wait-free.
+#ifndef ASL_SAMPLE_HISTORY_H_
+#define ASL_SAMPLE_HISTORY_H_
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+
+#include "sensor_types.h"
+
+class SampleHistory {
+public:
+    // 2.56 s at 50 Hz; must exceed the longest routed model span plus the
+    // samples that can arrive while one inference runs. At most kCapacity - 1
+    // samples can be read intact: the next push reuses the oldest slot.
+    static constexpr size_t kCapacity = 128;
+    static_assert((kCapacity & (kCapacity - 1)) == 0, "capacity must be a power of two");
+
+    void push(const SensorSample& sample) {
+        const uint32_t seq = written_.load(std::memory_order_relaxed);
+        samples_[seq & kMask] = sample;
+        written_.store(seq + 1, std::memory_order_release);
+    }
+
+    // Total samples pushed; the newest sample has sequence written() - 1.
+    uint32_t written() const { return written_.load(std::memory_order_acquire); }
+
+    const SensorSample& at(uint32_t seq) const { return samples_[seq & kMask]; }
+
+    // True if samples from oldestSeq onwards were not overwritten while read.
+    // push() copies into slot written() & kMask before publishing it, so once
+    // written() reaches oldestSeq + kCapacity that slot may hold a torn copy.
+    bool intact(uint32_t oldestSeq) const {
+        std::atomic_thread_fence(std::memory_order_acquire);
+        return written() - oldestSeq < kCapacity;
+    }
+
+    void clear() { written_.store(0, std::memory_order_release); }
+
+private:
+    static constexpr uint32_t kMask = kCapacity - 1;
+
+    SensorSample samples_[kCapacity];
+    std::atomic<uint32_t> written_{0};
+};
+
+#endif  // ASL_SAMPLE_HISTORY_H_
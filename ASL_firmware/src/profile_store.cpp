@@ -0,0 +1,133 @@
+#include "profile_store.h"
+
+#include <Arduino.h>
+#include <LittleFS.h>
+#include <string.h>
+
+#include "ml/prototype_classifier.h"
+
+ProfileStore profileStore;
+
+namespace {
+const uint32_t kStoreMagic = 0x31544F50;  // "POT1"
+
+// Only used from LogicTask, and held until the classifier has copied it.
+PrototypeClassifier::Profile scratch;
+}  // namespace
+
+ProfileStore::ProfileStore() : ready(false), savedGeneration(0) {
+    memset(currentPerson, 0, sizeof(currentPerson));
+}
+
+bool ProfileStore::begin() {
+    if (!aslPrototypes.available()) {
+        Serial.println("[PROTO] Model has no embedding output, personalization off");
+        return true;
+    }
+    if (!LittleFS.begin(true)) {
+        Serial.println("[PROTO] LittleFS mount failed, prototypes are not persisted");
+        return false;
+    }
+    savedGeneration = aslPrototypes.generation();
+    ready = true;
+    return true;
+}
+
+bool ProfileStore::select(const char* person) {
+    if (!aslPrototypes.available()) return false;
+    if (person && strcmp(person, currentPerson) == 0) return true;
+
+    // Keep whatever the previous person taught before switching
+    aslPrototypes.stopLearning();
+    poll();
+
+    strncpy(currentPerson, person ? person : "", sizeof(currentPerson) - 1);
+    currentPerson[sizeof(currentPerson) - 1] = '\0';
+
+    bool loaded = ready && currentPerson[0] != '\0' && load();
+    if (!loaded && (!aslPrototypes.requestClear() || !waitForRequest())) {
+        Serial.println("[PROTO] Classifier busy, prototypes not switched");
+        return false;
+    }
+    savedGeneration = aslPrototypes.generation();
+    Serial.printf("[PROTO] %s: %u personalized classes\n", currentPerson[0] ? currentPerson : "(nobody)",
+                  (unsigned)aslPrototypes.trainedClasses());
+    return loaded;
+}
+
+bool ProfileStore::clear() {
+    if (!aslPrototypes.available()) return false;
+    aslPrototypes.stopLearning();
+    if (!aslPrototypes.requestClear() || !waitForRequest()) {
+        Serial.println("[PROTO] Classifier busy, try again");
+        return false;
+    }
+    savedGeneration = aslPrototypes.generation();
+    if (ready && currentPerson[0] != '\0') {
+        char path[32];
+        pathFor(path, sizeof(path));
+        LittleFS.remove(path);
+    }
+    return true;
+}
+
+bool ProfileStore::load() {
+    char path[32];
+    pathFor(path, sizeof(path));
+    File file = LittleFS.open(path, FILE_READ);
+    if (!file) return false;
+
+    uint32_t magic = 0;
+    bool ok = file.read((uint8_t*)&magic, sizeof(magic)) == sizeof(magic) && magic == kStoreMagic &&
+              file.read((uint8_t*)&scratch, sizeof(scratch)) == sizeof(scratch);
+    file.close();
+    if (!ok || scratch.fingerprint != aslPrototypes.fingerprint()) {
+        Serial.printf("[PROTO] %s was saved for another model, starting over\n", path);
+        return false;
+    }
+    return aslPrototypes.requestLoad(scratch) && waitForRequest();
+}
+
+void ProfileStore::poll() {
+    if (!ready || currentPerson[0] == '\0') return;
+    // One write per learning run rather than one per example
+    if (aslPrototypes.learningClass() >= 0) return;
+    const uint32_t generation = aslPrototypes.generation();
+    if (generation == savedGeneration) return;
+    if (save()) {
+        savedGeneration = generation;
+    }
+}
+
+bool ProfileStore::save() {
+    if (!aslPrototypes.snapshot(scratch)) return false;
+
+    File file = LittleFS.open(PROFILE_STORE_TMP_PATH, FILE_WRITE);
+    if (!file) return false;
+    bool ok = file.write((const uint8_t*)&kStoreMagic, sizeof(kStoreMagic)) == sizeof(kStoreMagic) &&
+              file.write((const uint8_t*)&scratch, sizeof(scratch)) == sizeof(scratch);
+    file.close();
+
+    char path[32];
+    pathFor(path, sizeof(path));
+    if (!ok || !LittleFS.rename(PROFILE_STORE_TMP_PATH, path)) {
+        LittleFS.remove(PROFILE_STORE_TMP_PATH);
+        Serial.println("[PROTO] Saving prototypes failed");
+        return false;
+    }
+    Serial.printf("[PROTO] Saved prototypes for %s\n", currentPerson);
+    return true;
+}
+
+bool ProfileStore::waitForRequest() const {
+    const uint32_t start = millis();
+    while (aslPrototypes.requestPending()) {
+        if (millis() - start > PROFILE_STORE_TIMEOUT_MS) return false;
+        vTaskDelay(pdMS_TO_TICKS(5));
+    }
+    return true;
+}
+
+void ProfileStore::pathFor(char* path, size_t length) const {
+    snprintf(path, length, PROFILE_STORE_PATH_FORMAT, currentPerson);
+}
@@ -0,0 +1,42 @@
+#pragma once
+
+#include <stddef.h>
+#include <stdint.h>
+
+// Keeps each person's class prototypes (ml/prototype_classifier.h) on
+// LittleFS, one file per person ID. A file is a magic followed by the raw
+// PrototypeClassifier::Profile, whose fingerprint makes a retrained model
+// ignore it. Saves go through a temporary file like TemplateStore.
+#define PROFILE_STORE_PATH_FORMAT "/profile_%s.bin"
+#define PROFILE_STORE_TMP_PATH "/profile.tmp"
+#define PROFILE_STORE_TIMEOUT_MS 2000   // while InferenceTask picks up a request
+
+class ProfileStore {
+public:
+    ProfileStore();
+
+    // Boot phase: mounts LittleFS (shared with the audio cache). Prototypes
+    // start empty until a person is selected.
+    bool begin();
+    // LogicTask. Saves the previous person's changes, then loads this
+    // person's prototypes, or starts them empty.
+    bool select(const char* person);
+    // LogicTask. Forgets the current person's prototypes and deletes the file.
+    bool clear();
+    // LogicTask: writes the prototypes back once a learning run is over.
+    void poll();
+
+    const char* person() const { return currentPerson; }
+
+private:
+    volatile bool ready;
+    uint32_t savedGeneration;
+    char currentPerson[8];
+
+    bool load();
+    bool save();
+    bool waitForRequest() const;
+    void pathFor(char* path, size_t length) const;
+};
+
+extern ProfileStore profileStore;
@@ -1,14 +1,56 @@
 #pragma once
 
-#include <Arduino.h>
+#include <cstdint>
 
+// One 50 Hz sensor frame in fixed point. Accel and gyro are kept in MPU-9250
+// LSB counts at the configured full scale (±2 g, ±250 °/s), so a sample
+// round-trips the sensor's own resolution exactly; flex is Q14 in [0, 1].
+// Normalized model inputs are derived on demand from these values instead of
+// being stored alongside them. 32 bytes versus 84 for the float layout.
 struct SensorSample {
+    static constexpr float kFlexScale = 1.0f / 16384.0f;
+    static constexpr float kAccelScale = 9.81f / 16384.0f;                     // m/s² per LSB
+    static constexpr float kGyroScale = 3.14159265358979f / 180.0f / 131.0f;  // rad/s per LSB
+
+    static constexpr uint8_t kImuValid = 0x01;
+    static constexpr uint8_t kFingersValid = 0x02;
+
     uint32_t timestampMs{0};
-    float flex[5]{0};
-    float accel[3]{0};
-    float gyro[3]{0};
-    float accelNorm[3]{0};
-    float gyroNorm[3]{0};
-    bool imuValid{false};
-    bool fingersValid{false};
+    uint16_t seq{0};
+    uint8_t flags{0};
+    uint8_t reserved{0};
+    int16_t flex[5]{};
+    int16_t accel[3]{};
+    int16_t gyro[3]{};
+
+    bool imuValid() const { return (flags & kImuValid) != 0; }
+    bool fingersValid() const { return (flags & kFingersValid) != 0; }
+
+    float flexValue(int i) const { return flex[i] * kFlexScale; }
+    float accelValue(int axis) const { return accel[axis] * kAccelScale; }
+    float gyroValue(int axis) const { return gyro[axis] * kGyroScale; }
+
+    void setFlex(const float* values) {
+        for (int i = 0; i < 5; ++i) flex[i] = toFixed(values[i], kFlexScale);
+        flags |= kFingersValid;
+    }
+
+    void setImu(const float* accelMss, const float* gyroRads) {
+        for (int axis = 0; axis < 3; ++axis) {
+            accel[axis] = toFixed(accelMss[axis], kAccelScale);
+            gyro[axis] = toFixed(gyroRads[axis], kGyroScale);
+        }
+        flags |= kImuValid;
+    }
+
+    // Round to nearest and saturate at the int16 range, which for the IMU is
+    // the sensor's own full scale.
+    static int16_t toFixed(float value, float scale) {
+        const float counts = value / scale;
+        if (counts >= 32767.0f) return 32767;
+        if (counts <= -32768.0f) return -32768;
+        return static_cast<int16_t>(counts < 0.0f ? counts - 0.5f : counts + 0.5f);
+    }
 };
+
+static_assert(sizeof(SensorSample) == 32, "SensorSample layout changed");
@@ -0,0 +1,100 @@
+#include "template_store.h"
+
+#include <Arduino.h>
+#include <LittleFS.h>
+
+#include "ml/dtw_matcher.h"
+
+TemplateStore templateStore;
+
+namespace {
+const uint32_t kStoreMagic = 0x31575444;  // "DTW1"
+const uint32_t kRecordSize = sizeof(DtwMatcher::Template);
+
+// Shared by load() and save(), which never overlap: save() only runs once
+// begin() has finished.
+DtwMatcher::Template scratch;
+}  // namespace
+
+TemplateStore::TemplateStore() : ready(false), savedGeneration(0), loaded(0) {}
+
+bool TemplateStore::begin() {
+    if (!LittleFS.begin(true)) {
+        Serial.println("[DTW] LittleFS mount failed, templates are not persisted");
+        return false;
+    }
+    load();
+    savedGeneration = dtwMatcher.generation();
+    ready = true;
+    Serial.printf("[DTW] %u word templates loaded\n", (unsigned)loaded);
+    return true;
+}
+
+bool TemplateStore::load() {
+    File file = LittleFS.open(TEMPLATE_STORE_PATH, FILE_READ);
+    if (!file) return false;
+
+    uint32_t magic = 0;
+    uint32_t count = 0;
+    uint32_t recordSize = 0;
+    bool ok = file.read((uint8_t*)&magic, sizeof(magic)) == sizeof(magic) &&
+              file.read((uint8_t*)&count, sizeof(count)) == sizeof(count) &&
+              file.read((uint8_t*)&recordSize, sizeof(recordSize)) == sizeof(recordSize) &&
+              magic == kStoreMagic && recordSize == kRecordSize;
+    if (ok) {
+        count = min(count, (uint32_t)DtwMatcher::kMaxTemplates);
+        for (uint32_t i = 0; i < count; i++) {
+            if (file.read((uint8_t*)&scratch, sizeof(scratch)) != sizeof(scratch)) break;
+            // The matcher owns its table; InferenceTask copies the record in
+            // on its next tick.
+            const uint32_t start = millis();
+            while (!dtwMatcher.requestAdd(scratch)) {
+                if (millis() - start > TEMPLATE_STORE_LOAD_TIMEOUT_MS) break;
+                vTaskDelay(pdMS_TO_TICKS(5));
+            }
+            while (dtwMatcher.requestPending() && millis() - start <= TEMPLATE_STORE_LOAD_TIMEOUT_MS) {
+                vTaskDelay(pdMS_TO_TICKS(5));
+            }
+            if (dtwMatcher.requestPending()) {
+                // InferenceTask is not running; leave the rest on flash.
+                ok = false;
+                break;
+            }
+        }
+    }
+    file.close();
+    loaded = dtwMatcher.count();
+    return ok;
+}
+
+void TemplateStore::poll() {
+    if (!ready) return;
+    const uint32_t generation = dtwMatcher.generation();
+    if (generation == savedGeneration) return;
+    if (save()) {
+        savedGeneration = generation;
+    }
+}
+
+bool TemplateStore::save() {
+    File file = LittleFS.open(TEMPLATE_STORE_TMP_PATH, FILE_WRITE);
+    if (!file) return false;
+
+    const uint32_t count = dtwMatcher.count();
+    bool ok = file.write((const uint8_t*)&kStoreMagic, sizeof(kStoreMagic)) == sizeof(kStoreMagic) &&
+              file.write((const uint8_t*)&count, sizeof(count)) == sizeof(count) &&
+              file.write((const uint8_t*)&kRecordSize, sizeof(kRecordSize)) == sizeof(kRecordSize);
+    for (uint32_t i = 0; ok && i < count; i++) {
+        ok = dtwMatcher.copyTemplate(i, scratch) &&
+             file.write((const uint8_t*)&scratch, sizeof(scratch)) == sizeof(scratch);
+    }
+    file.close();
+
+    if (!ok || !LittleFS.rename(TEMPLATE_STORE_TMP_PATH, TEMPLATE_STORE_PATH)) {
+        LittleFS.remove(TEMPLATE_STORE_TMP_PATH);
+        Serial.println("[DTW] Saving templates failed");
+        return false;
+    }
+    Serial.printf("[DTW] Saved %u word templates\n", (unsigned)count);
+    return true;
+}
@@ -0,0 +1,36 @@
+#pragma once
+
+#include <stddef.h>
+#include <stdint.h>
+
+// Keeps the DTW word templates (ml/dtw_matcher.h) on LittleFS so recorded
+// signs survive a reboot. The file is a magic, a count and the raw
+// DtwMatcher::Template records; saves go through a temporary file so a reset
+// mid-write keeps the previous table.
+#define TEMPLATE_STORE_PATH "/dtw_templates.bin"
+#define TEMPLATE_STORE_TMP_PATH "/dtw_templates.tmp"
+#define TEMPLATE_STORE_LOAD_TIMEOUT_MS 2000   // per template, while InferenceTask picks it up
+
+class TemplateStore {
+public:
+    TemplateStore();
+
+    // Boot phase: mounts LittleFS (shared with the audio cache) and hands the
+    // saved templates to the matcher. Returns false only if flash is
+    // unavailable; a missing file is an empty table.
+    bool begin();
+    // LogicTask: writes the table back after templates were added or removed.
+    void poll();
+
+    size_t loadedCount() const { return loaded; }
+
+private:
+    volatile bool ready;
+    uint32_t savedGeneration;
+    size_t loaded;
+
+    bool load();
+    bool save();
+};
+
+extern TemplateStore templateStore;
@@ -0,0 +1,220 @@
+#include "text_composer.h"
+
+#include <string.h>
+
+static_assert(TEXT_COMPOSER_CAPACITY <= 255, "unit offsets are stored in uint8_t");
+static_assert(TEXT_COMPOSER_MAX_UNIT >= 3, "a word unit needs room for its separators");
+
+TextComposer textComposer;
+
+TextComposer::TextComposer()
+    : tableSize{},
+      textLength(0),
+      wordStart(0),
+      unitCount(0),
+      historyHead(0),
+      undoCount(0),
+      redoCount(0) {
+    buffer[0] = '\0';
+}
+
+bool TextComposer::setVocabulary(size_t stage, const asl_model::ModelDescriptor& model) {
+    if (stage >= TEXT_COMPOSER_MAX_STAGES || model.numClasses > TEXT_COMPOSER_MAX_CLASSES) {
+        return false;
+    }
+
+    for (size_t i = 0; i < model.numClasses; ++i) {
+        const char token = model.labelToChar ? model.labelToChar[i] : asl_model::kNeutralToken;
+        const char* label = model.labelNames ? model.labelNames[i] : nullptr;
+        const size_t labelLength = label ? strlen(label) : 0;
+
+        Entry& entry = table[stage][i];
+        entry.label = label;
+        entry.length = 0;
+        entry.letter = token;
+
+        if (token == asl_model::kNeutralToken || (label && strcmp(label, "NEUTRAL") == 0)) {
+            entry.kind = TokenKind::Ignore;
+        } else if (token == asl_model::kBackspaceToken || (label && strcmp(label, "BACKSPACE") == 0)) {
+            entry.kind = TokenKind::Backspace;
+        } else if (token == asl_model::kSpaceToken || (label && strcmp(label, "SPACE") == 0)) {
+            entry.kind = TokenKind::Space;
+            entry.length = 1;
+        } else if (labelLength > 1) {
+            // Leave room for a leading separator and the trailing space
+            const size_t maxWord = TEXT_COMPOSER_MAX_UNIT - 2;
+            entry.kind = TokenKind::Word;
+            entry.length = static_cast<uint8_t>(labelLength < maxWord ? labelLength : maxWord);
+        } else {
+            entry.kind = TokenKind::Letter;
+            entry.length = 1;
+        }
+    }
+    tableSize[stage] = model.numClasses;
+    return true;
+}
+
+const TextComposer::Entry* TextComposer::entryFor(size_t stage, size_t classIndex) const {
+    if (stage >= TEXT_COMPOSER_MAX_STAGES || classIndex >= tableSize[stage]) {
+        return nullptr;
+    }
+    return &table[stage][classIndex];
+}
+
+TextComposer::TokenKind TextComposer::kindOf(size_t stage, size_t classIndex) const {
+    const Entry* entry = entryFor(stage, classIndex);
+    return entry ? entry->kind : TokenKind::Ignore;
+}
+
+const char* TextComposer::labelOf(size_t stage, size_t classIndex) const {
+    const Entry* entry = entryFor(stage, classIndex);
+    return (entry && entry->label) ? entry->label : "?";
+}
+
+TextComposer::Result TextComposer::commit(size_t stage, size_t classIndex) {
+    const Entry* entry = entryFor(stage, classIndex);
+    if (!entry) {
+        return Result::Ignored;
+    }
+
+    switch (entry->kind) {
+        case TokenKind::Letter:
+            return append(&entry->letter, 1);
+        case TokenKind::Space: {
+            const char space = ' ';
+            return append(&space, 1);
+        }
+        case TokenKind::Word:
+            return appendWord(entry->label, entry->length);
+        case TokenKind::Backspace:
+            return removeLastUnit();
+        case TokenKind::Ignore:
+        default:
+            return Result::Ignored;
+    }
+}
+
+TextComposer::Result TextComposer::commitWord(const char* word) {
+    if (!word || !word[0]) {
+        return Result::Ignored;
+    }
+    const size_t maxWord = TEXT_COMPOSER_MAX_UNIT - 2;
+    const size_t length = strlen(word);
+    return appendWord(word, length < maxWord ? length : maxWord);
+}
+
+// A word is its own unit: "HI " after "AB" becomes "AB HI "
+TextComposer::Result TextComposer::appendWord(const char* word, size_t length) {
+    char bytes[TEXT_COMPOSER_MAX_UNIT];
+    size_t count = 0;
+    if (!atWordBoundary()) {
+        bytes[count++] = ' ';
+    }
+    memcpy(bytes + count, word, length);
+    count += length;
+    bytes[count++] = ' ';
+    return append(bytes, count);
+}
+
+TextComposer::Result TextComposer::append(const char* bytes, size_t count) {
+    if (count == 0 || count > TEXT_COMPOSER_MAX_UNIT) {
+        return Result::Ignored;
+    }
+    if (textLength + count > TEXT_COMPOSER_CAPACITY) {
+        return Result::Full;
+    }
+
+    Edit edit;
+    edit.insert = true;
+    edit.length = static_cast<uint8_t>(count);
+    memcpy(edit.bytes, bytes, count);
+    applyInsert(edit);
+    pushHistory(edit);
+    return Result::Ok;
+}
+
+TextComposer::Result TextComposer::removeLastUnit() {
+    if (unitCount == 0) {
+        return Result::Ignored;
+    }
+
+    const Unit& last = units[unitCount - 1];
+    Edit edit;
+    edit.insert = false;
+    edit.length = static_cast<uint8_t>(textLength - last.start);
+    memcpy(edit.bytes, buffer + last.start, edit.length);
+    applyDelete();
+    pushHistory(edit);
+    return Result::Ok;
+}
+
+void TextComposer::applyInsert(const Edit& edit) {
+    units[unitCount].start = static_cast<uint8_t>(textLength);
+    units[unitCount].prevWordStart = static_cast<uint8_t>(wordStart);
+    unitCount++;
+
+    memcpy(buffer + textLength, edit.bytes, edit.length);
+    textLength += edit.length;
+    buffer[textLength] = '\0';
+    if (buffer[textLength - 1] == ' ') {
+        wordStart = textLength;
+    }
+}
+
+void TextComposer::applyDelete() {
+    const Unit& last = units[--unitCount];
+    textLength = last.start;
+    wordStart = last.prevWordStart;
+    buffer[textLength] = '\0';
+}
+
+void TextComposer::pushHistory(const Edit& edit) {
+    history[historyHead] = edit;
+    historyHead = (historyHead + 1) % TEXT_COMPOSER_HISTORY;
+    if (undoCount < TEXT_COMPOSER_HISTORY) {
+        undoCount++;
+    }
+    redoCount = 0;
+}
+
+bool TextComposer::undo() {
+    if (undoCount == 0) {
+        return false;
+    }
+    historyHead = (historyHead + TEXT_COMPOSER_HISTORY - 1) % TEXT_COMPOSER_HISTORY;
+    const Edit& edit = history[historyHead];
+    if (edit.insert) {
+        applyDelete();
+    } else {
+        applyInsert(edit);
+    }
+    undoCount--;
+    redoCount++;
+    return true;
+}
+
+bool TextComposer::redo() {
+    if (redoCount == 0) {
+        return false;
+    }
+    const Edit& edit = history[historyHead];
+    if (edit.insert) {
+        applyInsert(edit);
+    } else {
+        applyDelete();
+    }
+    historyHead = (historyHead + 1) % TEXT_COMPOSER_HISTORY;
+    redoCount--;
+    undoCount++;
+    return true;
+}
+
+void TextComposer::clear() {
+    textLength = 0;
+    wordStart = 0;
+    unitCount = 0;
+    buffer[0] = '\0';
+    historyHead = 0;
+    undoCount = 0;
+    redoCount = 0;
+}
@@ -0,0 +1,106 @@
+#pragma once
+
+#include <stddef.h>
+#include <stdint.h>
+
+#include "ml/model_descriptor.h"
+
+// Fixed-capacity text buffer that LogicTask builds utterances in. Every class
+// of every router stage is resolved once into a kind table, so a commit is a
+// table lookup plus a bounded copy. Edits are recorded as units (a letter, a
+// space or a whole word with its separators): backspace, undo and redo work
+// on units, and all storage is inline.
+#define TEXT_COMPOSER_CAPACITY 96     // characters, excluding the terminator
+#define TEXT_COMPOSER_MAX_UNIT 24     // longest single edit, including separators
+#define TEXT_COMPOSER_HISTORY 32      // undoable edits
+#define TEXT_COMPOSER_MAX_STAGES 2
+#define TEXT_COMPOSER_MAX_CLASSES 64
+
+class TextComposer {
+public:
+    enum class TokenKind : uint8_t {
+        Ignore,     // neutral or unknown class
+        Letter,
+        Word,
+        Space,
+        Backspace
+    };
+
+    enum class Result : uint8_t {
+        Ok,
+        Ignored,    // neutral class, or nothing to delete
+        Full        // the unit does not fit in the remaining capacity
+    };
+
+    TextComposer();
+
+    // Build the kind table for one router stage. Word labels longer than a
+    // unit allows are truncated. Returns false if the stage or class count is
+    // out of range.
+    bool setVocabulary(size_t stage, const asl_model::ModelDescriptor& model);
+
+    Result commit(size_t stage, size_t classIndex);
+    // Append a whole word (from the beam decoder), truncated to one unit.
+    Result commitWord(const char* word);
+    bool undo();
+    bool redo();
+    // Empty the text and forget the history (after the text has been spoken).
+    void clear();
+
+    TokenKind kindOf(size_t stage, size_t classIndex) const;
+    const char* labelOf(size_t stage, size_t classIndex) const;
+
+    const char* text() const { return buffer; }
+    size_t length() const { return textLength; }
+    bool empty() const { return textLength == 0; }
+    bool atWordBoundary() const { return textLength == 0 || buffer[textLength - 1] == ' '; }
+    // Start of the word being spelled (== length() at a word boundary)
+    size_t currentWordStart() const { return wordStart; }
+    size_t undoDepth() const { return undoCount; }
+    size_t redoDepth() const { return redoCount; }
+
+private:
+    struct Entry {
+        TokenKind kind;
+        char letter;
+        uint8_t length;     // characters appended for Letter/Word/Space
+        const char* label;  // points into the model package
+    };
+
+    struct Unit {
+        uint8_t start;
+        uint8_t prevWordStart;
+    };
+
+    struct Edit {
+        bool insert;
+        Unit unit;
+        uint8_t length;
+        char bytes[TEXT_COMPOSER_MAX_UNIT];
+    };
+
+    Entry table[TEXT_COMPOSER_MAX_STAGES][TEXT_COMPOSER_MAX_CLASSES];
+    size_t tableSize[TEXT_COMPOSER_MAX_STAGES];
+
+    char buffer[TEXT_COMPOSER_CAPACITY + 1];
+    size_t textLength;
+    size_t wordStart;
+
+    Unit units[TEXT_COMPOSER_CAPACITY];
+    size_t unitCount;
+
+    Edit history[TEXT_COMPOSER_HISTORY];
+    size_t historyHead;
+    size_t undoCount;
+    size_t redoCount;
+
+    const Entry* entryFor(size_t stage, size_t classIndex) const;
+    Result appendWord(const char* word, size_t length);
+    Result append(const char* bytes, size_t count);
+    Result removeLastUnit();
+    void pushHistory(const Edit& edit);
+    void applyInsert(const Edit& edit);
+    void applyDelete();
+};
+
+extern TextComposer textComposer;
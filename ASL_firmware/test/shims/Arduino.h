@@ -0,0 +1,114 @@
+#pragma once
+
+// Host stand-in for the parts of the Arduino core that the libraries under
+// test use, so they build in the native_runner test environment. Never on
+// the include path of the ESP32 image.
+//
+// Pin calls go to host::pins when a test installs a listener (a simulated
+// bus, say); Serial collects its output for the test to inspect.
+
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstdarg>
+#include <cstddef>
+#include <cstdint>
+#include <cstdio>
+#include <cstring>
+#include <mutex>
+#include <string>
+#include <thread>
+
+#define LOW 0
+#define HIGH 1
+#define INPUT 0x01
+#define OUTPUT 0x03
+#define INPUT_PULLUP 0x05
+#define OUTPUT_OPEN_DRAIN 0x13
+
+namespace host {
+
+class PinListener {
+public:
+    virtual ~PinListener() = default;
+    virtual void pinMode(int pin, int mode) = 0;
+    virtual void digitalWrite(int pin, int value) = 0;
+    virtual int digitalRead(int pin) = 0;
+};
+
+inline PinListener* pins = nullptr;
+
+inline std::chrono::steady_clock::time_point bootTime() {
+    static const std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+    return start;
+}
+
+}  // namespace host
+
+inline uint32_t micros() {
+    return static_cast<uint32_t>(std::chrono::duration_cast<std::chrono::microseconds>(
+                                     std::chrono::steady_clock::now() - host::bootTime())
+                                     .count());
+}
+
+inline uint32_t millis() {
+    return micros() / 1000;
+}
+
+inline void delay(uint32_t ms) {
+    std::this_thread::sleep_for(std::chrono::milliseconds(ms));
+}
+
+// Bit-banged timing has nothing to wait for on the host.
+inline void delayMicroseconds(uint32_t) {}
+
+inline void pinMode(int pin, int mode) {
+    if (host::pins) host::pins->pinMode(pin, mode);
+}
+
+inline void digitalWrite(int pin, int value) {
+    if (host::pins) host::pins->digitalWrite(pin, value);
+}
+
+inline int digitalRead(int pin) {
+    return host::pins ? host::pins->digitalRead(pin) : HIGH;
+}
+
+class HardwareSerial {
+public:
+    int printf(const char* format, ...) __attribute__((format(printf, 2, 3))) {
+        char buffer[512];
+        va_list args;
+        va_start(args, format);
+        const int length = vsnprintf(buffer, sizeof(buffer), format, args);
+        va_end(args);
+        append(buffer, length < 0 ? 0 : std::min(static_cast<size_t>(length), sizeof(buffer) - 1));
+        return length;
+    }
+
+    size_t print(const char* text) { return append(text, strlen(text)); }
+    size_t println(const char* text = "") { return print(text) + print("\n"); }
+    size_t write(const uint8_t* data, size_t length) {
+        return append(reinterpret_cast<const char*>(data), length);
+    }
+
+    // Everything written since the last call.
+    std::string take() {
+        std::lock_guard<std::mutex> lock(mutex_);
+        std::string out;
+        out.swap(output_);
+        return out;
+    }
+
+private:
+    std::mutex mutex_;
+    std::string output_;
+
+    size_t append(const char* data, size_t length) {
+        std::lock_guard<std::mutex> lock(mutex_);
+        output_.append(data, length);
+        return length;
+    }
+};
+
+inline HardwareSerial Serial;
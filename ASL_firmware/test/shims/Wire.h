@@ -0,0 +1,42 @@
+#pragma once
+
+// Host stand-in for the Arduino TwoWire API. Every call is virtual so a test
+// can derive a simulated bus and hand it to I2CBus; the base class is an
+// empty bus on which no address answers.
+
+#include "Arduino.h"
+
+class TwoWire {
+public:
+    virtual ~TwoWire() = default;
+
+    virtual bool begin(int sda, int scl, uint32_t frequency) {
+        (void)sda;
+        (void)scl;
+        (void)frequency;
+        return true;
+    }
+    virtual bool end() { return true; }
+    virtual void setTimeout(uint16_t timeoutMs) { (void)timeoutMs; }
+
+    virtual void beginTransmission(uint16_t address) { (void)address; }
+    virtual size_t write(uint8_t data) {
+        (void)data;
+        return 1;
+    }
+    // Arduino-ESP32 codes: 0 ok, 2 address NACK, 3 data NACK, 5 timeout.
+    virtual uint8_t endTransmission(bool sendStop = true) {
+        (void)sendStop;
+        return 2;
+    }
+    // Bytes received; 0 on NACK or timeout.
+    virtual uint8_t requestFrom(int address, int count) {
+        (void)address;
+        (void)count;
+        return 0;
+    }
+    virtual int available() { return 0; }
+    virtual int read() { return -1; }
+};
+
+inline TwoWire Wire;
@@ -0,0 +1,27 @@
+#pragma once
+
+// Host stand-in for the FreeRTOS types and calls the libraries under test
+// use. One tick is one millisecond; the "core" a thread runs on is whatever
+// the test assigns to host::core.
+
+#include <cstdint>
+
+typedef int BaseType_t;
+typedef unsigned UBaseType_t;
+typedef uint32_t TickType_t;
+typedef uint8_t StackType_t;
+
+#define pdFALSE 0
+#define pdTRUE 1
+#define pdFAIL 0
+#define pdPASS 1
+#define portMAX_DELAY 0xFFFFFFFFu
+#define pdMS_TO_TICKS(ms) (static_cast<TickType_t>(ms))
+
+namespace host {
+inline thread_local int core = 0;
+}
+
+inline BaseType_t xPortGetCoreID() {
+    return host::core;
+}
@@ -0,0 +1,10 @@
+#pragma once
+
+#include "FreeRTOS.h"
+
+// Declared for static_alloc.h only; no test creates a queue.
+struct StaticQueue_t {};
+typedef struct QueueDefinition* QueueHandle_t;
+
+QueueHandle_t xQueueCreateStatic(UBaseType_t length, UBaseType_t itemSize, uint8_t* storage,
+                                 StaticQueue_t* control);
@@ -0,0 +1,28 @@
+#pragma once
+
+#include <chrono>
+#include <mutex>
+
+#include "FreeRTOS.h"
+
+struct StaticSemaphore_t {
+    std::timed_mutex mutex;
+};
+typedef StaticSemaphore_t* SemaphoreHandle_t;
+
+inline SemaphoreHandle_t xSemaphoreCreateMutexStatic(StaticSemaphore_t* storage) {
+    return storage;
+}
+
+inline BaseType_t xSemaphoreTake(SemaphoreHandle_t semaphore, TickType_t ticks) {
+    if (ticks == portMAX_DELAY) {
+        semaphore->mutex.lock();
+        return pdTRUE;
+    }
+    return semaphore->mutex.try_lock_for(std::chrono::milliseconds(ticks)) ? pdTRUE : pdFALSE;
+}
+
+inline BaseType_t xSemaphoreGive(SemaphoreHandle_t semaphore) {
+    semaphore->mutex.unlock();
+    return pdTRUE;
+}
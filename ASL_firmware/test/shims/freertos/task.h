@@ -0,0 +1,30 @@
+#pragma once
+
+#include <chrono>
+#include <thread>
+
+#include "FreeRTOS.h"
+
+struct StaticTask_t {};
+typedef void* TaskHandle_t;
+typedef void (*TaskFunction_t)(void*);
+
+// Runs the task on a detached thread pinned, as far as xPortGetCoreID() can
+// tell, to the requested core.
+inline TaskHandle_t xTaskCreateStaticPinnedToCore(TaskFunction_t fn, const char* name, uint32_t stackDepth,
+                                                  void* arg, UBaseType_t priority, StackType_t* stack,
+                                                  StaticTask_t* tcb, BaseType_t core) {
+    (void)name;
+    (void)stackDepth;
+    (void)priority;
+    (void)stack;
+    std::thread([fn, arg, core] {
+        host::core = core;
+        fn(arg);
+    }).detach();
+    return tcb;
+}
+
+inline void vTaskDelay(TickType_t ticks) {
+    std::this_thread::sleep_for(std::chrono::milliseconds(ticks));
+}
@@ -0,0 +1,275 @@
+// DtwMatcher prunes candidates with LB_Keogh and abandons the DTW once a row
+// exceeds the best distance so far. Both are meant to be exact: these tests
+// replay synthetic streams and check every decision against a plain banded
+// DTW over all templates, with no bound at all.
+
+#include <unity.h>
+
+#include <algorithm>
+#include <cmath>
+#include <cstdio>
+#include <memory>
+#include <random>
+#include <vector>
+
+#include "ml/dtw_matcher.h"
+#include "ml/sample_history.h"
+
+namespace {
+
+using Frame = DtwMatcher::Frame;
+using Template = DtwMatcher::Template;
+
+constexpr size_t kChannels = DtwMatcher::kChannels;
+constexpr size_t kFlex = asl_model::kNumFlex;
+
+// With this normalization an IMU lane equals the raw LSB count, and a flex
+// lane is the Q14 value / 64, so the test knows every frame exactly.
+const asl_model::NormParams kIdentityNorm[asl_model::kNumImu] = {
+    {0.0f, SensorSample::kAccelScale * DtwMatcher::kFeatureScale},
+    {0.0f, SensorSample::kAccelScale * DtwMatcher::kFeatureScale},
+    {0.0f, SensorSample::kAccelScale * DtwMatcher::kFeatureScale},
+    {0.0f, SensorSample::kGyroScale * DtwMatcher::kFeatureScale},
+    {0.0f, SensorSample::kGyroScale * DtwMatcher::kFeatureScale},
+    {0.0f, SensorSample::kGyroScale * DtwMatcher::kFeatureScale},
+};
+
+SensorSample toSample(const Frame& frame) {
+    SensorSample sample{};
+    sample.flags = SensorSample::kImuValid | SensorSample::kFingersValid;
+    for (size_t f = 0; f < kFlex; ++f) sample.flex[f] = static_cast<int16_t>(frame.v[f] * 64);
+    for (size_t axis = 0; axis < 3; ++axis) {
+        sample.accel[axis] = frame.v[kFlex + axis];
+        sample.gyro[axis] = frame.v[kFlex + 3 + axis];
+    }
+    return sample;
+}
+
+int16_t clampLane(int value, size_t lane) {
+    const int lo = lane < kFlex ? 0 : -400;
+    return static_cast<int16_t>(value < lo ? lo : (value > 400 ? 400 : value));
+}
+
+// A smooth random gesture: a random walk in every channel.
+std::vector<Frame> randomGesture(std::mt19937& rng, size_t length) {
+    std::uniform_int_distribution<int> start(0, 300);
+    std::uniform_int_distribution<int> step(-40, 40);
+    std::vector<Frame> frames(length);
+    Frame current{};
+    for (size_t c = 0; c < kChannels; ++c) current.v[c] = clampLane(start(rng) - (c < kFlex ? 0 : 150), c);
+    for (Frame& frame : frames) {
+        for (size_t c = 0; c < kChannels; ++c) current.v[c] = clampLane(current.v[c] + step(rng), c);
+        frame = current;
+    }
+    return frames;
+}
+
+// The gesture replayed at a different speed with sensor noise.
+std::vector<Frame> performance(std::mt19937& rng, const std::vector<Frame>& gesture, float speed, int noise) {
+    std::uniform_int_distribution<int> jitter(-noise, noise);
+    const size_t length = static_cast<size_t>(gesture.size() / speed);
+    std::vector<Frame> frames(length);
+    for (size_t k = 0; k < length; ++k) {
+        const size_t src = std::min(gesture.size() - 1, static_cast<size_t>(k * speed));
+        for (size_t c = 0; c < kChannels; ++c) frames[k].v[c] = clampLane(gesture[src].v[c] + jitter(rng), c);
+    }
+    return frames;
+}
+
+uint32_t frameDistance(const Frame& a, const Frame& b) {
+    uint32_t sum = 0;
+    for (size_t c = 0; c < DtwMatcher::kLanes; ++c) {
+        const int32_t d = a.v[c] - b.v[c];
+        sum += static_cast<uint32_t>(d * d);
+    }
+    return sum;
+}
+
+// Full banded DTW between the newest template-length frames and a template.
+uint64_t fullDtw(const std::vector<Frame>& window, const Template& tmpl, float bandFraction) {
+    const size_t n = tmpl.length;
+    const size_t r = std::max<size_t>(1, static_cast<size_t>(bandFraction * static_cast<float>(n)));
+    const Frame* query = window.data() + window.size() - n;
+    constexpr uint64_t kInf = UINT64_MAX / 2;
+    std::vector<uint64_t> cost(n * n, kInf);
+    for (size_t i = 0; i < n; ++i) {
+        for (size_t j = 0; j < n; ++j) {
+            if ((i > j ? i - j : j - i) > r) continue;
+            uint64_t best = 0;
+            if (i > 0 || j > 0) {
+                best = kInf;
+                if (i > 0) best = std::min(best, cost[(i - 1) * n + j]);
+                if (j > 0) best = std::min(best, cost[i * n + j - 1]);
+                if (i > 0 && j > 0) best = std::min(best, cost[(i - 1) * n + j - 1]);
+            }
+            if (best < kInf) cost[i * n + j] = best + frameDistance(query[i], tmpl.frames[j]);
+        }
+    }
+    return cost[n * n - 1];
+}
+
+struct Reference {
+    int index{-1};
+    float distance{0.0f};
+};
+
+// What the matcher should report for the current window, by exhaustion.
+Reference bestMatch(const std::vector<Frame>& window, const std::vector<Template>& templates,
+                    const DtwMatcher::Params& params) {
+    const float scale = static_cast<float>(DtwMatcher::kFeatureScale);
+    float bestNorm = params.acceptDistance * params.acceptDistance * scale * scale;
+    Reference best;
+    for (size_t i = 0; i < templates.size(); ++i) {
+        if (templates[i].length > window.size()) continue;
+        const float divisor = static_cast<float>(templates[i].length * kChannels);
+        const float norm = static_cast<float>(fullDtw(window, templates[i], params.bandFraction)) / divisor;
+        if (norm < bestNorm) {
+            bestNorm = norm;
+            best.index = static_cast<int>(i);
+        }
+    }
+    best.distance = std::sqrt(bestNorm) / scale;
+    return best;
+}
+
+struct Replay {
+    uint32_t matches{0};
+    uint32_t decisions{0};
+    uint32_t scorable{0};  // decisions with at least one template filled
+    DtwMatcher::Stats stats;
+};
+
+// Streams performances of the templates mixed with unrelated motion and
+// checks the matcher against bestMatch() on every frame it scores.
+Replay replay(uint32_t seed, const DtwMatcher::Params& params) {
+    std::mt19937 rng(seed);
+    std::unique_ptr<DtwMatcher> matcher(new DtwMatcher(kIdentityNorm));
+    std::unique_ptr<SampleHistory> history(new SampleHistory());
+    matcher->setParams(params);
+
+    // Lengths from the minimum up to a full template.
+    const size_t lengths[] = {DtwMatcher::kMinFrames, 12, 17, 24, 31, DtwMatcher::kMaxFrames};
+    std::vector<Template> templates;
+    std::vector<std::vector<Frame>> gestures;
+    for (size_t i = 0; i < sizeof(lengths) / sizeof(lengths[0]); ++i) {
+        Template tmpl{};
+        snprintf(tmpl.word, sizeof(tmpl.word), "W%zu", i);
+        tmpl.length = static_cast<uint8_t>(lengths[i]);
+        gestures.push_back(randomGesture(rng, lengths[i]));
+        for (size_t k = 0; k < lengths[i]; ++k) tmpl.frames[k] = gestures.back()[k];
+        templates.push_back(tmpl);
+
+        TEST_ASSERT_TRUE(matcher->requestAdd(templates.back()));
+        DtwMatcher::Match unused;
+        TEST_ASSERT_TRUE(matcher->update(*history, unused) == DtwMatcher::Event::None);
+        TEST_ASSERT_FALSE(matcher->requestPending());
+    }
+    TEST_ASSERT_EQUAL_size_t(templates.size(), matcher->count());
+
+    // The stream, in frames: performances of the gestures between stretches
+    // of unrelated motion.
+    std::vector<Frame> stream;
+    std::uniform_int_distribution<size_t> pick(0, gestures.size() - 1);
+    std::uniform_real_distribution<float> speed(0.8f, 1.25f);
+    for (int part = 0; part < 60; ++part) {
+        const std::vector<Frame> gap = randomGesture(rng, 5 + part % 20);
+        stream.insert(stream.end(), gap.begin(), gap.end());
+        const std::vector<Frame> sign = performance(rng, gestures[pick(rng)], speed(rng), 12 + part % 30);
+        stream.insert(stream.end(), sign.begin(), sign.end());
+    }
+
+    Replay result;
+    std::vector<Frame> window;
+    size_t cooldown = 0;
+    for (const Frame& frame : stream) {
+        // Two samples per frame; the matcher takes every kFrameStride-th.
+        for (size_t s = 0; s < DtwMatcher::kFrameStride; ++s) {
+            const bool framed = history->written() % DtwMatcher::kFrameStride == 0;
+            history->push(toSample(frame));
+            DtwMatcher::Match match;
+            const DtwMatcher::Event event = matcher->update(*history, match);
+            if (!framed) {
+                TEST_ASSERT_TRUE(event == DtwMatcher::Event::None);
+                continue;
+            }
+
+            window.push_back(frame);
+            if (window.size() > DtwMatcher::kMaxFrames) window.erase(window.begin());
+            if (cooldown > 0) cooldown--;
+            if (cooldown > 0) {
+                TEST_ASSERT_TRUE(event == DtwMatcher::Event::None);
+                continue;
+            }
+
+            const Reference expected = bestMatch(window, templates, params);
+            result.decisions++;
+            if (window.size() >= DtwMatcher::kMinFrames) result.scorable++;
+            if (expected.index < 0) {
+                TEST_ASSERT_TRUE(event == DtwMatcher::Event::None);
+                continue;
+            }
+            TEST_ASSERT_TRUE(event == DtwMatcher::Event::Match);
+            TEST_ASSERT_EQUAL_INT(expected.index, match.index);
+            TEST_ASSERT_EQUAL_STRING(templates[expected.index].word, match.word);
+            TEST_ASSERT_FLOAT_WITHIN(1e-6f, expected.distance, match.distance);
+            TEST_ASSERT_EQUAL_size_t(templates[expected.index].length, match.frames);
+            cooldown = match.frames;
+            result.matches++;
+        }
+    }
+    result.stats = matcher->stats();
+    return result;
+}
+
+}  // namespace
+
+void setUp() {}
+void tearDown() {}
+
+void test_pruned_search_matches_full_dtw() {
+    DtwMatcher::Params params;
+    const Replay r = replay(1, params);
+    TEST_ASSERT_GREATER_THAN(100, r.decisions);
+    TEST_ASSERT_GREATER_THAN(10, r.matches);
+    // Both shortcuts have to fire for the comparison to mean anything.
+    TEST_ASSERT_GREATER_THAN(0, r.stats.lbPruned);
+    TEST_ASSERT_GREATER_THAN(0, r.stats.abandoned);
+    TEST_ASSERT_EQUAL_UINT32(r.decisions, r.stats.ticks);
+    char line[96];
+    snprintf(line, sizeof(line), "%u decisions, %u matches, %u candidates, %u pruned, %u abandoned",
+             (unsigned)r.decisions, (unsigned)r.matches, (unsigned)r.stats.candidates,
+             (unsigned)r.stats.lbPruned, (unsigned)r.stats.abandoned);
+    TEST_MESSAGE(line);
+}
+
+void test_pruning_is_exact_across_bands_and_thresholds() {
+    const float bands[] = {0.1f, 0.25f, 0.5f};
+    const float accepts[] = {0.3f, 0.8f, 2.0f};
+    uint32_t seed = 10;
+    for (float band : bands) {
+        for (float accept : accepts) {
+            DtwMatcher::Params params;
+            params.bandFraction = band;
+            params.acceptDistance = accept;
+            replay(seed++, params);
+        }
+    }
+}
+
+void test_unbounded_accept_always_matches() {
+    // With an acceptance distance no window exceeds, every frame with a
+    // filled template matches; later candidates are still pruned against the
+    // best so far, and the answer is still the nearest template.
+    DtwMatcher::Params params;
+    params.acceptDistance = 1000.0f;
+    const Replay r = replay(5, params);
+    TEST_ASSERT_EQUAL_UINT32(r.scorable, r.matches);
+}
+
+int main(int, char**) {
+    UNITY_BEGIN();
+    RUN_TEST(test_pruned_search_matches_full_dtw);
+    RUN_TEST(test_pruning_is_exact_across_bands_and_thresholds);
+    RUN_TEST(test_unbounded_accept_always_matches);
+    return UNITY_END();
+}
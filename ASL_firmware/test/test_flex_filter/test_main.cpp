@@ -0,0 +1,227 @@
+// Latency, noise and cost of the flex filter banks, measured the way the
+// table in flex_filter.h quotes them: 50 Hz samples in volts, a ramp for lag,
+// 20 mV rms Gaussian noise about 1.5 V for noise.
+
+#include <unity.h>
+
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <random>
+
+#include "flex_filter.h"
+
+namespace {
+
+constexpr int kChannels = FLEX_FILTER_MAX_CHANNELS;
+constexpr float kNoiseRms = 0.020f;
+
+// The 5-tap moving average with a 20 mV deadband the filters replaced.
+class MovingAverageBank {
+public:
+    void process(const float* in, float* out, int channels) {
+        for (int i = 0; i < channels; i++) {
+            if (count >= 5) sum[i] -= buf[i][idx];
+            buf[i][idx] = in[i];
+            sum[i] += in[i];
+        }
+        idx = (idx + 1) % 5;
+        if (count < 5) count++;
+        for (int i = 0; i < channels; i++) {
+            const float avg = sum[i] / count;
+            if (count < 5 || std::fabs(avg - last[i]) >= 0.02f) last[i] = avg;
+            out[i] = last[i];
+        }
+    }
+
+private:
+    float buf[kChannels][5] = {};
+    float sum[kChannels] = {};
+    float last[kChannels] = {};
+    int idx = 0;
+    int count = 0;
+};
+
+// Samples the output trails a ramp of the given slope, once settled.
+template <class Filter>
+float rampLag(float voltsPerSecond) {
+    const float step = voltsPerSecond / FLEX_FILTER_RATE_HZ;
+    Filter filter;
+    float in[kChannels];
+    float out[kChannels];
+    for (int k = 0; k < 400; k++) {
+        for (int c = 0; c < kChannels; c++) in[c] = 0.5f + k * step;
+        filter.process(in, out, kChannels);
+    }
+    return (in[0] - out[0]) / step;
+}
+
+// Output standard deviation for noisy input at rest, in volts.
+template <class Filter>
+float outputNoise() {
+    Filter filter;
+    std::mt19937 rng(1);
+    std::normal_distribution<float> noise(0.0f, kNoiseRms);
+    float in[kChannels];
+    float out[kChannels];
+    double sum = 0.0;
+    double sumSq = 0.0;
+    int n = 0;
+    for (int k = 0; k < 5000; k++) {
+        for (int c = 0; c < kChannels; c++) in[c] = 1.5f + noise(rng);
+        filter.process(in, out, kChannels);
+        if (k < 100) continue;
+        sum += out[0];
+        sumSq += out[0] * out[0];
+        n++;
+    }
+    const double mean = sum / n;
+    return static_cast<float>(std::sqrt(sumSq / n - mean * mean));
+}
+
+// Samples after a 2 V step until the output covers 90% of it.
+template <class Filter>
+int settleSamples() {
+    Filter filter;
+    float in[kChannels];
+    float out[kChannels];
+    for (int k = 0; k < 100; k++) {
+        for (int c = 0; c < kChannels; c++) in[c] = k < 10 ? 1.0f : 3.0f;
+        filter.process(in, out, kChannels);
+        if (k >= 10 && out[0] >= 2.8f) return k - 10;
+    }
+    return 100;
+}
+
+// Mean host time of one five-channel call.
+template <class Filter>
+double nanosPerSample() {
+    constexpr int kCalls = 200000;
+    Filter filter;
+    float in[kChannels];
+    float out[kChannels];
+    float sink = 0.0f;
+    const auto start = std::chrono::steady_clock::now();
+    for (int k = 0; k < kCalls; k++) {
+        for (int c = 0; c < kChannels; c++) in[c] = 1.0f + (k & 7) * 0.01f + c * 0.1f;
+        filter.process(in, out, kChannels);
+        sink += out[0];
+    }
+    const auto elapsed = std::chrono::steady_clock::now() - start;
+    TEST_ASSERT_TRUE(std::isfinite(sink));
+    return std::chrono::duration<double, std::nano>(elapsed).count() / kCalls;
+}
+
+template <class Filter>
+void checkFilter(float maxFastLag, float maxSlowLag, float maxNoise, int maxSettle) {
+    const float fastLag = rampLag<Filter>(1.0f);
+    const float slowLag = rampLag<Filter>(0.1f);
+    const float noise = outputNoise<Filter>();
+    const int settle = settleSamples<Filter>();
+    const double ns = nanosPerSample<Filter>();
+    char line[160];
+    snprintf(line, sizeof(line), "lag %.2f / %.2f samples, noise %.1f mV, 90%% step in %d, %.1f ns per sample",
+             fastLag, slowLag, noise * 1000.0f, settle, ns);
+    TEST_MESSAGE(line);
+
+    TEST_ASSERT_LESS_OR_EQUAL_FLOAT(maxFastLag, fastLag);
+    TEST_ASSERT_LESS_OR_EQUAL_FLOAT(maxSlowLag, slowLag);
+    TEST_ASSERT_LESS_OR_EQUAL_FLOAT(maxNoise, noise);
+    TEST_ASSERT_LESS_THAN_FLOAT(kNoiseRms, noise);
+    TEST_ASSERT_LESS_OR_EQUAL(maxSettle, settle);
+
+    // Well under the 20 ms sample period; a generous bound so a loaded
+    // host or a sanitizer build does not flake.
+    TEST_ASSERT_LESS_THAN(20000.0, ns);
+}
+
+// The first sample primes the state: no ramp up from 0 V.
+template <class Filter>
+void checkPrimesOnFirstSample() {
+    Filter filter;
+    const float in[kChannels] = {0.4f, 0.8f, 1.2f, 1.6f, 2.0f};
+    float out[kChannels];
+    for (int k = 0; k < 3; k++) {
+        filter.process(in, out, kChannels);
+        for (int c = 0; c < kChannels; c++) TEST_ASSERT_FLOAT_WITHIN(1e-5f, in[c], out[c]);
+    }
+
+    filter.reset();
+    const float other[kChannels] = {3.0f, 3.0f, 3.0f, 3.0f, 3.0f};
+    filter.process(other, out, kChannels);
+    for (int c = 0; c < kChannels; c++) TEST_ASSERT_FLOAT_WITHIN(1e-5f, 3.0f, out[c]);
+}
+
+}  // namespace
+
+void setUp() {}
+void tearDown() {}
+
+void test_moving_average_baseline() {
+    // The reference the table in flex_filter.h compares against: two samples
+    // of averaging delay on a ramp, three when the deadband holds a step.
+    TEST_ASSERT_FLOAT_WITHIN(0.55f, 2.5f, rampLag<MovingAverageBank>(1.0f));
+    TEST_ASSERT_FLOAT_WITHIN(0.05f, 8.0f, rampLag<MovingAverageBank>(0.1f));
+}
+
+void test_one_euro() {
+    checkFilter<OneEuroFilterBank>(1.1f, 3.1f, 0.0080f, 2);
+    checkPrimesOnFirstSample<OneEuroFilterBank>();
+}
+
+void test_biquad() {
+    checkFilter<BiquadFilterBank>(1.05f, 1.05f, 0.0135f, 2);
+    checkPrimesOnFirstSample<BiquadFilterBank>();
+}
+
+void test_median_ema() {
+    checkFilter<MedianEmaFilterBank>(1.5f, 1.5f, 0.0120f, 2);
+    checkPrimesOnFirstSample<MedianEmaFilterBank>();
+}
+
+void test_filters_beat_moving_average_lag() {
+    const float baselineSlow = rampLag<MovingAverageBank>(0.1f);
+    TEST_ASSERT_LESS_THAN_FLOAT(baselineSlow, rampLag<OneEuroFilterBank>(0.1f));
+    TEST_ASSERT_LESS_THAN_FLOAT(baselineSlow, rampLag<BiquadFilterBank>(0.1f));
+    TEST_ASSERT_LESS_THAN_FLOAT(baselineSlow, rampLag<MedianEmaFilterBank>(0.1f));
+}
+
+void test_median_rejects_single_spike() {
+    MedianEmaFilterBank filter;
+    float in[kChannels] = {1.0f, 1.0f, 1.0f, 1.0f, 1.0f};
+    float out[kChannels];
+    for (int k = 0; k < 10; k++) filter.process(in, out, kChannels);
+    in[2] = 3.0f;
+    filter.process(in, out, kChannels);
+    in[2] = 1.0f;
+    for (int k = 0; k < 5; k++) {
+        filter.process(in, out, kChannels);
+        TEST_ASSERT_FLOAT_WITHIN(1e-5f, 1.0f, out[2]);
+    }
+}
+
+void test_channels_are_independent() {
+    FlexFilterBank filter;
+    float in[kChannels];
+    float out[kChannels];
+    for (int k = 0; k < 200; k++) {
+        for (int c = 0; c < kChannels; c++) in[c] = c == 1 && k >= 50 ? 2.5f : 1.0f;
+        filter.process(in, out, kChannels);
+    }
+    TEST_ASSERT_FLOAT_WITHIN(1e-3f, 2.5f, out[1]);
+    for (int c = 0; c < kChannels; c++) {
+        if (c != 1) TEST_ASSERT_FLOAT_WITHIN(1e-5f, 1.0f, out[c]);
+    }
+}
+
+int main(int, char**) {
+    UNITY_BEGIN();
+    RUN_TEST(test_moving_average_baseline);
+    RUN_TEST(test_one_euro);
+    RUN_TEST(test_biquad);
+    RUN_TEST(test_median_ema);
+    RUN_TEST(test_filters_beat_moving_average_lag);
+    RUN_TEST(test_median_rejects_single_spike);
+    RUN_TEST(test_channels_are_independent);
+    return UNITY_END();
+}
@@ -0,0 +1,331 @@
+// I2CBus against a simulated bus: transactions from several threads must not
+// interleave, every device keeps its own counters, and a device that keeps
+// failing gets one standard bus clear (SCL pulses while SDA is low, then a
+// STOP) instead of a Wire teardown per error.
+
+#include <unity.h>
+
+#include <atomic>
+#include <map>
+#include <thread>
+#include <vector>
+
+#include "i2c_bus.h"
+
+namespace {
+
+constexpr int kSda = 18;
+constexpr int kScl = 46;
+constexpr uint8_t kImu = 0x68;
+constexpr uint8_t kMag = 0x0C;
+
+// Register-file devices on one bus. A device can NACK its next transactions
+// or hold SDA low until the controller clocks it free.
+class SimBus : public TwoWire, public host::PinListener {
+public:
+    struct Device {
+        uint8_t regs[256]{};
+        int nacks{0};               // transactions still to NACK
+        int holdPulses{0};          // SCL pulses until SDA is released; -1 never
+    };
+
+    std::map<uint8_t, Device> devices;
+    std::atomic<int> overlaps{0};
+    int begins{0};
+    int ends{0};
+    int stops{0};
+    int pulses{0};                  // SCL pulses seen while SDA was held
+    uint16_t timeoutMs{0};
+
+    // TwoWire
+    bool begin(int, int, uint32_t) override {
+        begins++;
+        return true;
+    }
+    bool end() override {
+        ends++;
+        return true;
+    }
+    void setTimeout(uint16_t ms) override { timeoutMs = ms; }
+
+    void beginTransmission(uint16_t address) override {
+        if (busy_.exchange(true)) overlaps++;
+        address_ = static_cast<uint8_t>(address);
+        tx_.clear();
+        // Leave room for another client to barge in if nothing serializes.
+        std::this_thread::yield();
+    }
+
+    size_t write(uint8_t data) override {
+        tx_.push_back(data);
+        return 1;
+    }
+
+    uint8_t endTransmission(bool sendStop) override {
+        const uint8_t result = transmit();
+        if (sendStop || result != 0) busy_ = false;
+        return result;
+    }
+
+    uint8_t requestFrom(int address, int count) override {
+        rx_.clear();
+        rxPos_ = 0;
+        Device* device = find(static_cast<uint8_t>(address));
+        uint8_t received = 0;
+        if (device && !held()) {
+            for (int i = 0; i < count; i++) rx_.push_back(device->regs[(reg_ + i) & 0xFF]);
+            received = static_cast<uint8_t>(count);
+        }
+        if (received == 0) busy_ = false;
+        return received;
+    }
+
+    int available() override { return static_cast<int>(rx_.size() - rxPos_); }
+
+    int read() override {
+        if (rxPos_ >= rx_.size()) return -1;
+        const int value = rx_[rxPos_++];
+        if (rxPos_ == rx_.size()) busy_ = false;
+        return value;
+    }
+
+    // PinListener: only the bus clear drives the pins directly.
+    void pinMode(int pin, int mode) override {
+        if (pin == kSda && mode == INPUT_PULLUP) sdaLow_ = false;
+    }
+
+    void digitalWrite(int pin, int value) override {
+        if (pin == kScl) {
+            if (value == HIGH && !sclHigh_ && held()) {
+                pulses++;
+                release();
+            }
+            sclHigh_ = value == HIGH;
+        } else if (pin == kSda) {
+            if (value == HIGH && sdaLow_ && sclHigh_) stops++;
+            sdaLow_ = value == LOW;
+        }
+    }
+
+    int digitalRead(int pin) override {
+        if (pin == kSda) return (sdaLow_ || held()) ? LOW : HIGH;
+        return sclHigh_ ? HIGH : LOW;
+    }
+
+private:
+    std::atomic<bool> busy_{false};
+    uint8_t address_{0};
+    uint8_t reg_{0};
+    std::vector<uint8_t> tx_;
+    std::vector<uint8_t> rx_;
+    size_t rxPos_{0};
+    bool sclHigh_{true};
+    bool sdaLow_{false};
+
+    Device* find(uint8_t address) {
+        auto it = devices.find(address);
+        return it == devices.end() ? nullptr : &it->second;
+    }
+
+    bool held() const {
+        for (const auto& entry : devices) {
+            if (entry.second.holdPulses != 0) return true;
+        }
+        return false;
+    }
+
+    void release() {
+        for (auto& entry : devices) {
+            if (entry.second.holdPulses > 0) entry.second.holdPulses--;
+        }
+    }
+
+    uint8_t transmit() {
+        if (held()) return 5;  // SDA stuck low: the controller times out
+        Device* device = find(address_);
+        if (!device) return 2;
+        if (device->nacks > 0) {
+            device->nacks--;
+            return 2;
+        }
+        if (!tx_.empty()) {
+            reg_ = tx_[0];
+            for (size_t i = 1; i < tx_.size(); i++) device->regs[(reg_ + i - 1) & 0xFF] = tx_[i];
+        }
+        return 0;
+    }
+};
+
+SimBus* sim = nullptr;
+I2CBus* bus = nullptr;
+
+}  // namespace
+
+void setUp() {
+    sim = new SimBus();
+    sim->devices[kImu];
+    sim->devices[kMag];
+    host::pins = sim;
+    bus = new I2CBus(*sim);
+    TEST_ASSERT_TRUE(bus->begin(kSda, kScl, 100000));
+    Serial.take();
+}
+
+void tearDown() {
+    delete bus;
+    host::pins = nullptr;
+    delete sim;
+}
+
+void test_begin_arms_wire_with_short_timeout() {
+    TEST_ASSERT_TRUE(bus->isReady());
+    TEST_ASSERT_EQUAL_INT(1, sim->begins);
+    TEST_ASSERT_EQUAL_INT(I2C_BUS_TIMEOUT_MS, sim->timeoutMs);
+    TEST_ASSERT_EQUAL_INT(0, sim->pulses);
+    TEST_ASSERT_EQUAL_UINT32(0, bus->getBusRecoveries());
+}
+
+void test_register_round_trip() {
+    TEST_ASSERT_EQUAL_INT(I2C_OK, bus->writeReg(kImu, 0x1B, 0x18));
+    uint8_t value = 0;
+    TEST_ASSERT_EQUAL_INT(I2C_OK, bus->readReg(kImu, 0x1B, value));
+    TEST_ASSERT_EQUAL_UINT8(0x18, value);
+
+    for (int i = 0; i < 14; i++) sim->devices[kImu].regs[0x3B + i] = static_cast<uint8_t>(i * 3);
+    uint8_t block[14] = {};
+    TEST_ASSERT_EQUAL_INT(I2C_OK, bus->readRegs(kImu, 0x3B, block, sizeof(block)));
+    for (int i = 0; i < 14; i++) TEST_ASSERT_EQUAL_UINT8(i * 3, block[i]);
+
+    const I2CDeviceStats* stats = bus->getStats(kImu);
+    TEST_ASSERT_NOT_NULL(stats);
+    TEST_ASSERT_EQUAL_UINT32(3, stats->transactions);
+    TEST_ASSERT_EQUAL_UINT32(0, stats->errors);
+}
+
+void test_probe_stays_out_of_stats() {
+    TEST_ASSERT_EQUAL_INT(I2C_OK, bus->probe(kImu));
+    TEST_ASSERT_EQUAL_INT(I2C_NACK, bus->probe(0x77));
+    TEST_ASSERT_NULL(bus->getStats(kImu));
+    TEST_ASSERT_NULL(bus->getStats(0x77));
+}
+
+void test_errors_are_counted_per_device() {
+    sim->devices[kMag].nacks = 2;
+    uint8_t value = 0;
+    TEST_ASSERT_EQUAL_INT(I2C_NACK, bus->readReg(kMag, 0x00, value));
+    TEST_ASSERT_EQUAL_INT(I2C_NACK, bus->readReg(kMag, 0x00, value));
+    TEST_ASSERT_EQUAL_INT(I2C_OK, bus->readReg(kMag, 0x00, value));
+    TEST_ASSERT_EQUAL_INT(I2C_OK, bus->readReg(kImu, 0x75, value));
+
+    const I2CDeviceStats* mag = bus->getStats(kMag);
+    const I2CDeviceStats* imu = bus->getStats(kImu);
+    TEST_ASSERT_EQUAL_UINT32(3, mag->transactions);
+    TEST_ASSERT_EQUAL_UINT32(2, mag->errors);
+    TEST_ASSERT_EQUAL_UINT32(0, mag->timeouts);
+    TEST_ASSERT_EQUAL_UINT32(0, mag->consecutiveErrors);
+    TEST_ASSERT_EQUAL_UINT32(0, mag->recoveries);
+    TEST_ASSERT_EQUAL_UINT32(1, imu->transactions);
+    TEST_ASSERT_EQUAL_UINT32(0, imu->errors);
+
+    // Two failures in a row are not enough for a bus clear; Wire was only
+    // detached once, by begin().
+    TEST_ASSERT_EQUAL_UINT32(0, bus->getBusRecoveries());
+    TEST_ASSERT_EQUAL_INT(1, sim->ends);
+
+    bus->resetStats();
+    TEST_ASSERT_EQUAL_UINT32(0, bus->getStats(kMag)->transactions);
+    TEST_ASSERT_EQUAL_UINT32(0, bus->getStats(kMag)->errors);
+}
+
+void test_stuck_device_gets_nine_pulses_after_three_failures() {
+    sim->devices[kMag].holdPulses = -1;
+    uint8_t value = 0;
+    TEST_ASSERT_EQUAL_INT(I2C_TIMEOUT, bus->readReg(kMag, 0x03, value));
+    TEST_ASSERT_EQUAL_INT(I2C_TIMEOUT, bus->readReg(kMag, 0x03, value));
+    TEST_ASSERT_EQUAL_INT(0, sim->pulses);
+    TEST_ASSERT_EQUAL_INT(1, sim->ends);
+
+    TEST_ASSERT_EQUAL_INT(I2C_TIMEOUT, bus->readReg(kMag, 0x03, value));
+    TEST_ASSERT_EQUAL_INT(I2C_BUS_CLEAR_PULSES, sim->pulses);
+    TEST_ASSERT_EQUAL_INT(2, sim->stops);
+    TEST_ASSERT_EQUAL_INT(2, sim->ends);
+    TEST_ASSERT_EQUAL_INT(2, sim->begins);
+    TEST_ASSERT_EQUAL_UINT32(1, bus->getBusRecoveries());
+
+    const I2CDeviceStats* mag = bus->getStats(kMag);
+    TEST_ASSERT_EQUAL_UINT32(3, mag->errors);
+    TEST_ASSERT_EQUAL_UINT32(3, mag->timeouts);
+    TEST_ASSERT_EQUAL_UINT32(1, mag->recoveries);
+    TEST_ASSERT_EQUAL_UINT32(0, mag->consecutiveErrors);
+    TEST_ASSERT_TRUE(Serial.take().find("clearing bus") != std::string::npos);
+}
+
+void test_bus_clear_stops_once_sda_is_released() {
+    sim->devices[kMag].holdPulses = 4;
+    uint8_t value = 0;
+    for (int i = 0; i < I2C_BUS_RECOVER_AFTER; i++) {
+        TEST_ASSERT_EQUAL_INT(I2C_TIMEOUT, bus->readReg(kMag, 0x03, value));
+    }
+    TEST_ASSERT_EQUAL_INT(4, sim->pulses);
+    TEST_ASSERT_EQUAL_UINT32(1, bus->getBusRecoveries());
+
+    sim->devices[kMag].regs[0x03] = 0x5A;
+    TEST_ASSERT_EQUAL_INT(I2C_OK, bus->readReg(kMag, 0x03, value));
+    TEST_ASSERT_EQUAL_UINT8(0x5A, value);
+    TEST_ASSERT_EQUAL_UINT32(1, bus->getStats(kMag)->recoveries);
+}
+
+void test_transactions_from_two_cores_never_interleave() {
+    constexpr int kRounds = 2000;
+    for (int i = 0; i < 6; i++) {
+        sim->devices[kImu].regs[0x3B + i] = static_cast<uint8_t>(0x10 + i);
+        sim->devices[kMag].regs[0x03 + i] = static_cast<uint8_t>(0x80 + i);
+    }
+
+    std::atomic<int> corrupt{0};
+    auto client = [&](int core, uint8_t address, uint8_t reg, uint8_t base) {
+        host::core = core;
+        uint8_t data[6];
+        for (int round = 0; round < kRounds; round++) {
+            if (bus->readRegs(address, reg, data, sizeof(data)) != I2C_OK) {
+                corrupt++;
+                continue;
+            }
+            for (int i = 0; i < 6; i++) {
+                if (data[i] != base + i) corrupt++;
+            }
+        }
+    };
+    std::thread sensor(client, 0, kImu, 0x3B, 0x10);
+    std::thread audio(client, 1, kMag, 0x03, 0x80);
+    sensor.join();
+    audio.join();
+
+    TEST_ASSERT_EQUAL_INT(0, sim->overlaps.load());
+    TEST_ASSERT_EQUAL_INT(0, corrupt.load());
+    TEST_ASSERT_EQUAL_UINT32(kRounds, bus->getStats(kImu)->transactions);
+    TEST_ASSERT_EQUAL_UINT32(kRounds, bus->getStats(kMag)->transactions);
+    TEST_ASSERT_EQUAL_UINT32(0, bus->getBusRecoveries());
+}
+
+void test_latency_is_recorded() {
+    uint8_t value = 0;
+    for (int i = 0; i < 10; i++) bus->readReg(kImu, 0x75, value);
+    const I2CDeviceStats* stats = bus->getStats(kImu);
+    TEST_ASSERT_EQUAL_UINT32(10, stats->transactions);
+    TEST_ASSERT_GREATER_OR_EQUAL(stats->lastUs, stats->maxUs);
+    TEST_ASSERT_GREATER_OR_EQUAL(stats->maxUs, stats->totalUs);
+}
+
+int main(int, char**) {
+    UNITY_BEGIN();
+    RUN_TEST(test_begin_arms_wire_with_short_timeout);
+    RUN_TEST(test_register_round_trip);
+    RUN_TEST(test_probe_stays_out_of_stats);
+    RUN_TEST(test_errors_are_counted_per_device);
+    RUN_TEST(test_stuck_device_gets_nine_pulses_after_three_failures);
+    RUN_TEST(test_bus_clear_stops_once_sda_is_released);
+    RUN_TEST(test_transactions_from_two_cores_never_interleave);
+    RUN_TEST(test_latency_is_recorded);
+    return UNITY_END();
+}
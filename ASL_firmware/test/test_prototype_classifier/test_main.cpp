@@ -0,0 +1,301 @@
+// PrototypeClassifier: enrolment cadence and running means, the score blend
+// at classification, and a profile surviving a save/load round trip. The
+// storage is sized by the linked model package, so the test model exports an
+// embedding of exactly kMaxDims and has kMaxClasses classes.
+
+#include <unity.h>
+
+#include <cctype>
+#include <cmath>
+#include <cstring>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "ml/prototype_classifier.h"
+
+namespace {
+
+using Profile = PrototypeClassifier::Profile;
+
+constexpr size_t kDims = PrototypeClassifier::kMaxDims;
+constexpr size_t kClasses = PrototypeClassifier::kMaxClasses;
+static_assert(kClasses >= 2, "prototypes need two classes to choose between");
+
+asl_model::ModelDescriptor withEmbedding(size_t dims) {
+    asl_model::ModelDescriptor model = asl_model::kDescriptor;
+    model.embeddingSize = dims;
+    model.embeddingScale = 0.05f;
+    return model;
+}
+
+const asl_model::ModelDescriptor kModel = withEmbedding(kDims);
+
+// Class c points along its own axis (or, with a one-wide embedding, classes
+// alternate sign).
+void embeddingFor(size_t c, float* e, float gain = 1.0f) {
+    for (size_t d = 0; d < kDims; ++d) {
+        if (kDims == 1) {
+            e[d] = gain * (c % 2 == 0 ? 1.0f : -1.0f);
+        } else {
+            e[d] = gain * (d == c % kDims ? 1.0f : 0.1f);
+        }
+    }
+}
+
+// Examples learned after this many windows of one learning run.
+uint16_t expectedExamples(uint32_t windows) {
+    const uint32_t settle = PrototypeClassifier::kLearnSettle;
+    if (windows <= settle) return 0;
+    return static_cast<uint16_t>((windows - settle - 1) / PrototypeClassifier::kLearnStride + 1);
+}
+
+void feed(PrototypeClassifier& classifier, size_t c, uint32_t windows) {
+    float e[kDims];
+    embeddingFor(c, e);
+    for (uint32_t i = 0; i < windows; ++i) classifier.update(e, nullptr);
+}
+
+// Teaches classes 0 and 1 enough examples to take part.
+void teach(PrototypeClassifier& classifier) {
+    const uint32_t windows = PrototypeClassifier::kLearnSettle + 10 * PrototypeClassifier::kLearnStride;
+    for (size_t c = 0; c < 2; ++c) {
+        TEST_ASSERT_TRUE(classifier.startLearning(kModel.labelNames[c]));
+        feed(classifier, c, windows);
+    }
+    classifier.stopLearning();
+}
+
+std::string lower(const char* text) {
+    std::string out(text);
+    for (char& ch : out) ch = static_cast<char>(std::tolower(static_cast<unsigned char>(ch)));
+    return out;
+}
+
+std::unique_ptr<PrototypeClassifier> classifier;
+
+}  // namespace
+
+void setUp() {
+    classifier.reset(new PrototypeClassifier(kModel));
+}
+
+void tearDown() {
+    classifier.reset();
+}
+
+void test_availability() {
+    TEST_ASSERT_TRUE(classifier->available());
+
+    static const asl_model::ModelDescriptor none = withEmbedding(0);
+    PrototypeClassifier without(none);
+    TEST_ASSERT_FALSE(without.available());
+    TEST_ASSERT_FALSE(without.startLearning(kModel.labelNames[0]));
+    float e[kDims];
+    float scores[kClasses] = {0.3f, 0.7f};
+    embeddingFor(0, e);
+    without.update(e, scores);
+    TEST_ASSERT_EQUAL_FLOAT(0.3f, scores[0]);
+
+    static const asl_model::ModelDescriptor tooWide = withEmbedding(kDims + 1);
+    TEST_ASSERT_FALSE(PrototypeClassifier(tooWide).available());
+}
+
+void test_learning_is_keyed_by_label() {
+    TEST_ASSERT_TRUE(classifier->startLearning(lower(kModel.labelNames[1]).c_str()));
+    TEST_ASSERT_EQUAL_INT(1, classifier->learningClass());
+    TEST_ASSERT_FALSE(classifier->startLearning("NOT_A_LABEL"));
+    TEST_ASSERT_FALSE(classifier->startLearning(nullptr));
+    TEST_ASSERT_EQUAL_INT(1, classifier->learningClass());
+    classifier->stopLearning();
+    TEST_ASSERT_EQUAL_INT(-1, classifier->learningClass());
+}
+
+void test_enrolment_cadence() {
+    const uint32_t generation = classifier->generation();
+    TEST_ASSERT_TRUE(classifier->startLearning(kModel.labelNames[0]));
+
+    // Nothing is learned while the hand moves into the sign.
+    feed(*classifier, 0, PrototypeClassifier::kLearnSettle);
+    Profile profile;
+    TEST_ASSERT_TRUE(classifier->snapshot(profile));
+    TEST_ASSERT_EQUAL_UINT16(0, profile.count[0]);
+    TEST_ASSERT_EQUAL_UINT32(generation, classifier->generation());
+
+    const uint32_t more = 5 * PrototypeClassifier::kLearnStride + 3;
+    feed(*classifier, 0, more);
+    TEST_ASSERT_TRUE(classifier->snapshot(profile));
+    const uint16_t examples = expectedExamples(PrototypeClassifier::kLearnSettle + more);
+    TEST_ASSERT_EQUAL_UINT16(examples, profile.count[0]);
+    TEST_ASSERT_EQUAL_UINT16(0, profile.count[1]);
+    TEST_ASSERT_EQUAL_UINT32(generation + examples, classifier->generation());
+
+    // A new run settles again before learning.
+    TEST_ASSERT_TRUE(classifier->startLearning(kModel.labelNames[1]));
+    feed(*classifier, 1, PrototypeClassifier::kLearnSettle);
+    TEST_ASSERT_TRUE(classifier->snapshot(profile));
+    TEST_ASSERT_EQUAL_UINT16(0, profile.count[1]);
+
+    // Learning stops with stopLearning().
+    classifier->stopLearning();
+    feed(*classifier, 1, 10 * PrototypeClassifier::kLearnStride);
+    TEST_ASSERT_TRUE(classifier->snapshot(profile));
+    TEST_ASSERT_EQUAL_UINT16(0, profile.count[1]);
+}
+
+void test_centroid_is_mean_of_unit_embeddings() {
+    // Alternate the gain of the examples: the centroid is of L2-normalized
+    // embeddings, so the scale of the model output does not matter.
+    TEST_ASSERT_TRUE(classifier->startLearning(kModel.labelNames[0]));
+    float e[kDims];
+    const uint32_t windows = PrototypeClassifier::kLearnSettle + 8 * PrototypeClassifier::kLearnStride;
+    for (uint32_t i = 0; i < windows; ++i) {
+        embeddingFor(0, e, i % 2 ? 3.0f : 0.5f);
+        classifier->update(e, nullptr);
+    }
+    classifier->stopLearning();
+
+    Profile profile;
+    TEST_ASSERT_TRUE(classifier->snapshot(profile));
+    TEST_ASSERT_EQUAL_UINT16(8, profile.count[0]);
+    embeddingFor(0, e);
+    float norm = 0.0f;
+    for (size_t d = 0; d < kDims; ++d) norm += e[d] * e[d];
+    for (size_t d = 0; d < kDims; ++d) {
+        TEST_ASSERT_FLOAT_WITHIN(1e-5f, e[d] / std::sqrt(norm), profile.centroid[0][d]);
+    }
+}
+
+void test_scores_untouched_until_two_classes_trained() {
+    float e[kDims];
+    float scores[kClasses] = {};
+    scores[0] = 0.3f;
+    scores[1] = 0.7f;
+    embeddingFor(0, e);
+    classifier->update(e, scores);
+    TEST_ASSERT_EQUAL_FLOAT(0.3f, scores[0]);
+    TEST_ASSERT_EQUAL_FLOAT(0.7f, scores[1]);
+
+    TEST_ASSERT_TRUE(classifier->startLearning(kModel.labelNames[0]));
+    feed(*classifier, 0, PrototypeClassifier::kLearnSettle + 10 * PrototypeClassifier::kLearnStride);
+    classifier->stopLearning();
+    TEST_ASSERT_EQUAL_size_t(1, classifier->trainedClasses());
+    classifier->update(e, scores);
+    TEST_ASSERT_EQUAL_FLOAT(0.3f, scores[0]);
+    TEST_ASSERT_EQUAL_UINT32(0, classifier->fusedWindows());
+}
+
+void test_prototypes_pull_scores_toward_the_nearest_class() {
+    teach(*classifier);
+    TEST_ASSERT_EQUAL_size_t(2, classifier->trainedClasses());
+
+    for (size_t truth = 0; truth < 2; ++truth) {
+        // The model leans the wrong way; the prototypes outvote it.
+        float e[kDims];
+        float scores[kClasses] = {};
+        embeddingFor(truth, e);
+        scores[truth] = 0.3f;
+        scores[1 - truth] = 0.7f;
+        classifier->update(e, scores);
+        TEST_ASSERT_GREATER_THAN_FLOAT(scores[1 - truth], scores[truth]);
+        // Probability moves between the prototype classes only.
+        TEST_ASSERT_FLOAT_WITHIN(1e-5f, 1.0f, scores[0] + scores[1]);
+        // The model keeps (1 - weight) of its own say.
+        const float weight = classifier->params().weight;
+        TEST_ASSERT_GREATER_OR_EQUAL_FLOAT((1.0f - weight) * 0.3f, scores[truth] - 1e-6f);
+    }
+    TEST_ASSERT_EQUAL_UINT32(2, classifier->fusedWindows());
+
+    classifier->setEnabled(false);
+    float e[kDims];
+    float scores[kClasses] = {};
+    embeddingFor(0, e);
+    scores[0] = 0.3f;
+    scores[1] = 0.7f;
+    classifier->update(e, scores);
+    TEST_ASSERT_EQUAL_FLOAT(0.3f, scores[0]);
+
+    // Raising the bar drops both classes out of the vote again.
+    classifier->setEnabled(true);
+    PrototypeClassifier::Params params;
+    params.minExamples = 11;
+    classifier->setParams(params);
+    TEST_ASSERT_EQUAL_size_t(0, classifier->trainedClasses());
+    classifier->update(e, scores);
+    TEST_ASSERT_EQUAL_FLOAT(0.3f, scores[0]);
+}
+
+void test_profile_round_trip() {
+    teach(*classifier);
+    Profile saved;
+    TEST_ASSERT_TRUE(classifier->snapshot(saved));
+    TEST_ASSERT_EQUAL_UINT32(classifier->fingerprint(), saved.fingerprint);
+    TEST_ASSERT_EQUAL_UINT16(kModel.numClasses, saved.numClasses);
+    TEST_ASSERT_EQUAL_UINT16(kDims, saved.dims);
+
+    // ProfileStore writes the raw struct; read it back into a fresh engine.
+    std::vector<uint8_t> file(sizeof(Profile));
+    std::memcpy(file.data(), &saved, sizeof(Profile));
+    static Profile loaded;
+    std::memcpy(&loaded, file.data(), sizeof(Profile));
+
+    PrototypeClassifier restored(kModel);
+    TEST_ASSERT_EQUAL_size_t(0, restored.trainedClasses());
+    TEST_ASSERT_TRUE(restored.requestLoad(loaded));
+    TEST_ASSERT_TRUE(restored.requestPending());
+    TEST_ASSERT_FALSE(restored.requestClear());  // one request at a time
+    const uint32_t generation = restored.generation();
+    restored.poll();
+    TEST_ASSERT_FALSE(restored.requestPending());
+    TEST_ASSERT_EQUAL_UINT32(generation + 1, restored.generation());
+    TEST_ASSERT_EQUAL_size_t(2, restored.trainedClasses());
+
+    // Same vote as the engine that learned them.
+    for (size_t truth = 0; truth < 2; ++truth) {
+        float e[kDims];
+        float a[kClasses] = {};
+        float b[kClasses] = {};
+        embeddingFor(truth, e);
+        a[0] = b[0] = 0.45f;
+        a[1] = b[1] = 0.55f;
+        classifier->update(e, a);
+        restored.update(e, b);
+        TEST_ASSERT_EQUAL_FLOAT(a[0], b[0]);
+        TEST_ASSERT_EQUAL_FLOAT(a[1], b[1]);
+    }
+
+    restored.requestClear();
+    restored.poll();
+    TEST_ASSERT_EQUAL_size_t(0, restored.trainedClasses());
+}
+
+void test_profile_for_another_model_is_ignored() {
+    teach(*classifier);
+    Profile saved;
+    TEST_ASSERT_TRUE(classifier->snapshot(saved));
+
+    // A retrained model (new quantization) has a new fingerprint.
+    static asl_model::ModelDescriptor retrained = withEmbedding(kDims);
+    retrained.embeddingScale = 0.06f;
+    PrototypeClassifier other(retrained);
+    TEST_ASSERT_TRUE(other.fingerprint() != classifier->fingerprint());
+    TEST_ASSERT_TRUE(other.requestLoad(saved));
+    other.poll();
+    TEST_ASSERT_EQUAL_size_t(0, other.trainedClasses());
+    Profile profile;
+    TEST_ASSERT_TRUE(other.snapshot(profile));
+    TEST_ASSERT_EQUAL_UINT32(other.fingerprint(), profile.fingerprint);
+}
+
+int main(int, char**) {
+    UNITY_BEGIN();
+    RUN_TEST(test_availability);
+    RUN_TEST(test_learning_is_keyed_by_label);
+    RUN_TEST(test_enrolment_cadence);
+    RUN_TEST(test_centroid_is_mean_of_unit_embeddings);
+    RUN_TEST(test_scores_untouched_until_two_classes_trained);
+    RUN_TEST(test_prototypes_pull_scores_toward_the_nearest_class);
+    RUN_TEST(test_profile_round_trip);
+    RUN_TEST(test_profile_for_another_model_is_ignored);
+    return UNITY_END();
+}
@@ -0,0 +1,132 @@
+// SampleHistory: which sequence numbers a reader may trust. push() copies into
+// the slot before publishing the new count, so the oldest slot of a full ring
+// may be mid-write whenever a reader looks at it.
+
+#include <unity.h>
+
+#include <atomic>
+#include <memory>
+#include <thread>
+
+#include "ml/sample_history.h"
+
+namespace {
+
+constexpr uint32_t kCapacity = SampleHistory::kCapacity;
+
+// Every field derived from seq, so a torn copy shows up as a mismatch.
+SensorSample sampleFor(uint32_t seq) {
+    SensorSample sample{};
+    sample.timestampMs = seq * 20;
+    sample.seq = static_cast<uint16_t>(seq);
+    sample.flags = SensorSample::kImuValid | SensorSample::kFingersValid;
+    for (int i = 0; i < 5; ++i) sample.flex[i] = static_cast<int16_t>(seq + i);
+    for (int axis = 0; axis < 3; ++axis) {
+        sample.accel[axis] = static_cast<int16_t>(seq * 3 + axis);
+        sample.gyro[axis] = static_cast<int16_t>(-static_cast<int32_t>(seq) - axis);
+    }
+    return sample;
+}
+
+bool matches(const SensorSample& sample, uint32_t seq) {
+    const SensorSample expected = sampleFor(seq);
+    bool same = sample.timestampMs == expected.timestampMs && sample.seq == expected.seq;
+    for (int i = 0; i < 5; ++i) same = same && sample.flex[i] == expected.flex[i];
+    for (int axis = 0; axis < 3; ++axis) {
+        same = same && sample.accel[axis] == expected.accel[axis] && sample.gyro[axis] == expected.gyro[axis];
+    }
+    return same;
+}
+
+std::unique_ptr<SampleHistory> history;
+
+void pushUpTo(uint32_t count) {
+    for (uint32_t seq = history->written(); seq < count; ++seq) history->push(sampleFor(seq));
+}
+
+}  // namespace
+
+void setUp() {
+    history.reset(new SampleHistory());
+}
+
+void tearDown() {
+    history.reset();
+}
+
+void test_one_short_of_capacity_is_intact() {
+    pushUpTo(kCapacity - 1);
+    TEST_ASSERT_TRUE(history->intact(0));
+    for (uint32_t seq = 0; seq < kCapacity - 1; ++seq) TEST_ASSERT_TRUE(matches(history->at(seq), seq));
+}
+
+void test_full_ring_oldest_is_not_intact() {
+    // With exactly kCapacity samples written, seq 0 still holds its data, but
+    // the next push writes seq kCapacity into the same slot before written()
+    // moves, so a reader that copied seq 0 cannot tell it was not torn.
+    pushUpTo(kCapacity);
+    TEST_ASSERT_EQUAL_PTR(&history->at(0), &history->at(kCapacity));
+    TEST_ASSERT_FALSE(history->intact(0));
+    TEST_ASSERT_TRUE(history->intact(1));
+
+    history->push(sampleFor(kCapacity));
+    TEST_ASSERT_TRUE(matches(history->at(kCapacity), kCapacity));
+    TEST_ASSERT_FALSE(history->intact(1));
+    TEST_ASSERT_TRUE(history->intact(2));
+}
+
+void test_lapped_reader() {
+    pushUpTo(3 * kCapacity + 5);
+    TEST_ASSERT_FALSE(history->intact(0));
+    TEST_ASSERT_FALSE(history->intact(2 * kCapacity + 4));
+    TEST_ASSERT_FALSE(history->intact(2 * kCapacity + 5));
+    TEST_ASSERT_TRUE(history->intact(2 * kCapacity + 6));
+    TEST_ASSERT_TRUE(matches(history->at(2 * kCapacity + 6), 2 * kCapacity + 6));
+}
+
+void test_clear_restarts_sequence() {
+    pushUpTo(10);
+    history->clear();
+    TEST_ASSERT_EQUAL_UINT32(0, history->written());
+    history->push(sampleFor(0));
+    TEST_ASSERT_TRUE(history->intact(0));
+    TEST_ASSERT_TRUE(matches(history->at(0), 0));
+}
+
+void test_concurrent_reads_trust_only_whole_samples() {
+    // A reader takes the widest window it may (kCapacity - 1 samples) while a
+    // writer pushes; every read that intact() accepts must be whole.
+    constexpr uint32_t kSamples = 200000;
+    std::atomic<bool> done{false};
+    std::thread writer([&] {
+        for (uint32_t seq = 0; seq < kSamples; ++seq) {
+            history->push(sampleFor(seq));
+            if ((seq & 15) == 0) std::this_thread::yield();
+        }
+        done = true;
+    });
+
+    uint32_t accepted = 0;
+    SensorSample copy[kCapacity - 1];
+    while (!done.load()) {
+        const uint32_t written = history->written();
+        if (written < kCapacity - 1) continue;
+        const uint32_t oldest = written - (kCapacity - 1);
+        for (uint32_t i = 0; i < kCapacity - 1; ++i) copy[i] = history->at(oldest + i);
+        if (!history->intact(oldest)) continue;
+        for (uint32_t i = 0; i < kCapacity - 1; ++i) TEST_ASSERT_TRUE(matches(copy[i], oldest + i));
+        accepted++;
+    }
+    writer.join();
+    TEST_ASSERT_GREATER_THAN(0, accepted);
+}
+
+int main(int, char**) {
+    UNITY_BEGIN();
+    RUN_TEST(test_one_short_of_capacity_is_intact);
+    RUN_TEST(test_full_ring_oldest_is_not_intact);
+    RUN_TEST(test_lapped_reader);
+    RUN_TEST(test_clear_restarts_sequence);
+    RUN_TEST(test_concurrent_reads_trust_only_whole_samples);
+    return UNITY_END();
+}
@@ -0,0 +1,216 @@
+// SensorSample stores flex in Q14 and the IMU in MPU-9250 LSB counts. These
+// tests push float readings through that packing and SampleHistory, build the
+// model input with the engine's own sampleFeatures()/quantizeInput(), and
+// compare it with the input the float sample layout used to produce.
+
+#include <unity.h>
+
+#include <algorithm>
+#include <cmath>
+#include <memory>
+#include <random>
+
+#include "ml/asl_inference.h"
+#include "ml/asl_model_config.h"
+#include "ml/imu_normalization.h"
+#include "ml/sample_history.h"
+#include "sensor_types.h"
+
+namespace {
+
+using asl_model::kNumFeatures;
+using asl_model::kNumFlex;
+
+const asl_model::ModelDescriptor& kModel = asl_model::kDescriptor;
+
+struct FloatSample {
+    float flex[kNumFlex];
+    float accel[3];
+    float gyro[3];
+};
+
+// The pre-packing path: features straight from the float readings.
+void floatFeatures(const FloatSample& s, const asl_model::NormParams* norm, float* frame) {
+    for (size_t f = 0; f < kNumFlex; ++f) frame[f] = std::min(1.0f, std::max(0.0f, s.flex[f]));
+    for (int axis = 0; axis < 3; ++axis) {
+        frame[kNumFlex + axis] = normalizeSensor(s.accel[axis], norm[axis]);
+        frame[kNumFlex + 3 + axis] = normalizeSensor(s.gyro[axis], norm[3 + axis]);
+    }
+}
+
+SensorSample pack(const FloatSample& s) {
+    SensorSample sample{};
+    sample.setFlex(s.flex);
+    sample.setImu(s.accel, s.gyro);
+    return sample;
+}
+
+// Readings spread over the part of each channel the quantized input resolves
+// (z in about [-0.1, 1.1] for this package), plus a margin that saturates.
+FloatSample randomSample(std::mt19937& rng) {
+    std::uniform_real_distribution<float> unit(-0.15f, 1.15f);
+    FloatSample s;
+    for (size_t f = 0; f < kNumFlex; ++f) s.flex[f] = unit(rng);
+    for (int axis = 0; axis < 3; ++axis) {
+        const asl_model::NormParams& a = kModel.imuNorm[axis];
+        const asl_model::NormParams& g = kModel.imuNorm[3 + axis];
+        s.accel[axis] = a.mean + a.std * unit(rng);
+        s.gyro[axis] = g.mean + g.std * unit(rng);
+    }
+    return s;
+}
+
+// Largest error packing can cause: half an LSB, plus float rounding of the
+// value / scale division for counts near full scale.
+constexpr float kHalfLsb = 0.51f;
+
+// The same, z-scored into feature units.
+float featureTolerance(size_t f, const asl_model::NormParams* norm) {
+    if (f < kNumFlex) return kHalfLsb * SensorSample::kFlexScale;
+    const size_t imu = f - kNumFlex;
+    const float lsb = imu < 3 ? SensorSample::kAccelScale : SensorSample::kGyroScale;
+    return kHalfLsb * lsb / norm[imu].std;
+}
+
+std::unique_ptr<ASLInferenceEngine> engine;
+
+}  // namespace
+
+void setUp() {}
+void tearDown() {}
+
+void test_sample_is_32_bytes() {
+    TEST_ASSERT_EQUAL_size_t(32, sizeof(SensorSample));
+}
+
+void test_readings_round_trip_within_half_lsb() {
+    std::mt19937 rng(7);
+    std::uniform_real_distribution<float> flex(0.0f, 1.0f);
+    std::uniform_real_distribution<float> accel(-19.0f, 19.0f);
+    std::uniform_real_distribution<float> gyro(-4.3f, 4.3f);
+    for (int i = 0; i < 10000; ++i) {
+        FloatSample s;
+        for (size_t f = 0; f < kNumFlex; ++f) s.flex[f] = flex(rng);
+        for (int axis = 0; axis < 3; ++axis) {
+            s.accel[axis] = accel(rng);
+            s.gyro[axis] = gyro(rng);
+        }
+        const SensorSample packed = pack(s);
+        for (size_t f = 0; f < kNumFlex; ++f) {
+            TEST_ASSERT_FLOAT_WITHIN(kHalfLsb * SensorSample::kFlexScale, s.flex[f],
+                                     packed.flexValue(static_cast<int>(f)));
+        }
+        for (int axis = 0; axis < 3; ++axis) {
+            TEST_ASSERT_FLOAT_WITHIN(kHalfLsb * SensorSample::kAccelScale, s.accel[axis],
+                                     packed.accelValue(axis));
+            TEST_ASSERT_FLOAT_WITHIN(kHalfLsb * SensorSample::kGyroScale, s.gyro[axis],
+                                     packed.gyroValue(axis));
+        }
+    }
+}
+
+void test_out_of_range_readings_saturate() {
+    FloatSample s{};
+    s.accel[0] = 40.0f;   // beyond ±2 g
+    s.accel[1] = -40.0f;
+    s.gyro[2] = 10.0f;    // beyond ±250 °/s
+    s.flex[0] = 3.0f;     // Q14 holds up to ~2
+    const SensorSample packed = pack(s);
+    TEST_ASSERT_EQUAL_INT(32767, packed.accel[0]);
+    TEST_ASSERT_EQUAL_INT(-32768, packed.accel[1]);
+    TEST_ASSERT_EQUAL_INT(32767, packed.gyro[2]);
+    TEST_ASSERT_EQUAL_INT(32767, packed.flex[0]);
+    TEST_ASSERT_FLOAT_WITHIN(0.01f, 19.62f, packed.accelValue(0));
+
+    float frame[kNumFeatures];
+    ASLInferenceEngine::sampleFeatures(packed, kModel.imuNorm, frame);
+    TEST_ASSERT_EQUAL_FLOAT(1.0f, frame[0]);  // flex is clamped to [0, 1] either way
+}
+
+void test_invalid_sensors_give_zero_features() {
+    SensorSample sample{};
+    float frame[kNumFeatures];
+    ASLInferenceEngine::sampleFeatures(sample, kModel.imuNorm, frame);
+    for (size_t f = 0; f < kNumFeatures; ++f) TEST_ASSERT_EQUAL_FLOAT(0.0f, frame[f]);
+
+    const float flex[kNumFlex] = {0.2f, 0.4f, 0.6f, 0.8f, 1.0f};
+    sample.setFlex(flex);
+    ASLInferenceEngine::sampleFeatures(sample, kModel.imuNorm, frame);
+    TEST_ASSERT_FLOAT_WITHIN(1e-4f, 0.6f, frame[2]);
+    for (size_t f = kNumFlex; f < kNumFeatures; ++f) TEST_ASSERT_EQUAL_FLOAT(0.0f, frame[f]);
+}
+
+void test_model_input_matches_float_path() {
+    constexpr int kSamples = 20000;
+    std::mt19937 rng(11);
+    SampleHistory history;
+    int mismatches[kNumFeatures] = {};
+    for (int i = 0; i < kSamples; ++i) {
+        const FloatSample s = randomSample(rng);
+        history.push(pack(s));
+
+        float expected[kNumFeatures];
+        float actual[kNumFeatures];
+        floatFeatures(s, kModel.imuNorm, expected);
+        ASLInferenceEngine::sampleFeatures(history.at(history.written() - 1), kModel.imuNorm, actual);
+
+        for (size_t f = 0; f < kNumFeatures; ++f) {
+            TEST_ASSERT_FLOAT_WITHIN(featureTolerance(f, kModel.imuNorm), expected[f], actual[f]);
+            const int q0 = engine->quantizeInput(expected[f]);
+            const int q1 = engine->quantizeInput(actual[f]);
+            TEST_ASSERT_INT_WITHIN(1, q0, q1);
+            if (q0 != q1) mismatches[f]++;
+        }
+    }
+    // A step can differ only where a value lies within the packing error of a
+    // rounding boundary, i.e. for at most tolerance / inputScale of the
+    // samples: well under 1% for flex, more for the narrow IMU channels.
+    for (size_t f = 0; f < kNumFeatures; ++f) {
+        const float bound = kSamples * featureTolerance(f, kModel.imuNorm) / kModel.inputScale;
+        TEST_ASSERT_LESS_OR_EQUAL(bound, mismatches[f]);
+    }
+    for (size_t f = 0; f < kNumFlex; ++f) TEST_ASSERT_LESS_THAN(kSamples / 100, mismatches[f]);
+}
+
+void test_strided_window_matches_float_path() {
+    // Same comparison over whole windows gathered from the history at the
+    // package's window size and stride, as classify() reads them.
+    std::mt19937 rng(3);
+    const size_t span = kModel.span();
+    std::unique_ptr<FloatSample[]> readings(new FloatSample[span * 4]);
+    SampleHistory history;
+    for (size_t i = 0; i < span * 4; ++i) {
+        readings[i] = randomSample(rng);
+        history.push(pack(readings[i]));
+    }
+
+    const uint32_t oldest = history.written() - static_cast<uint32_t>(span);
+    for (size_t i = 0; i < kModel.windowSize; ++i) {
+        const uint32_t seq = oldest + static_cast<uint32_t>((i + 1) * kModel.sampleStride - 1);
+        float expected[kNumFeatures];
+        float actual[kNumFeatures];
+        floatFeatures(readings[seq], kModel.imuNorm, expected);
+        ASLInferenceEngine::sampleFeatures(history.at(seq), kModel.imuNorm, actual);
+        for (size_t f = 0; f < kNumFeatures; ++f) {
+            TEST_ASSERT_INT_WITHIN(1, engine->quantizeInput(expected[f]), engine->quantizeInput(actual[f]));
+            const float dequantized = (engine->quantizeInput(actual[f]) - kModel.inputZeroPoint) * kModel.inputScale;
+            const float lo = (-128 - kModel.inputZeroPoint) * kModel.inputScale;
+            const float hi = (127 - kModel.inputZeroPoint) * kModel.inputScale;
+            const float clamped = std::min(hi, std::max(lo, expected[f]));
+            TEST_ASSERT_FLOAT_WITHIN(1.5f * kModel.inputScale, clamped, dequantized);
+        }
+    }
+    TEST_ASSERT_TRUE(history.intact(oldest));
+}
+
+int main(int, char**) {
+    engine.reset(new ASLInferenceEngine(kModel));
+    UNITY_BEGIN();
+    RUN_TEST(test_sample_is_32_bytes);
+    RUN_TEST(test_readings_round_trip_within_half_lsb);
+    RUN_TEST(test_out_of_range_readings_saturate);
+    RUN_TEST(test_invalid_sensors_give_zero_features);
+    RUN_TEST(test_model_input_matches_float_path);
+    RUN_TEST(test_strided_window_matches_float_path);
+    return UNITY_END();
+}
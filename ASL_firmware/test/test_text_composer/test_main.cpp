@@ -0,0 +1,219 @@
+// TextComposer: capacity, backspace and undo on edit units, word commits and
+// label truncation, against a small hand-made vocabulary.
+
+#include <unity.h>
+
+#include <cstring>
+#include <string>
+
+#include "text_composer.h"
+
+namespace {
+
+enum Class : size_t { kNeutral, kA, kB, kSpace, kBackspace, kHello, kLong, kNumClasses };
+
+const char* const kLabels[kNumClasses] = {
+    "NEUTRAL", "A", "B", "SPACE", "BACKSPACE", "HELLO", "ABCDEFGHIJKLMNOPQRSTUVWXYZ",
+};
+const char kTokens[kNumClasses] = {
+    asl_model::kNeutralToken, 'A', 'B', asl_model::kSpaceToken, asl_model::kBackspaceToken, 'H', 'L',
+};
+
+constexpr size_t kMaxWord = TEXT_COMPOSER_MAX_UNIT - 2;
+
+asl_model::ModelDescriptor vocabulary() {
+    asl_model::ModelDescriptor model{};
+    model.numClasses = kNumClasses;
+    model.labelNames = kLabels;
+    model.labelToChar = kTokens;
+    return model;
+}
+
+// Large enough that it should not live on the test's stack.
+TextComposer composer;
+
+}  // namespace
+
+void setUp() {
+    composer.clear();
+    TEST_ASSERT_TRUE(composer.setVocabulary(0, vocabulary()));
+}
+
+void tearDown() {}
+
+void test_vocabulary_kinds() {
+    TEST_ASSERT_TRUE(composer.kindOf(0, kNeutral) == TextComposer::TokenKind::Ignore);
+    TEST_ASSERT_TRUE(composer.kindOf(0, kA) == TextComposer::TokenKind::Letter);
+    TEST_ASSERT_TRUE(composer.kindOf(0, kSpace) == TextComposer::TokenKind::Space);
+    TEST_ASSERT_TRUE(composer.kindOf(0, kBackspace) == TextComposer::TokenKind::Backspace);
+    TEST_ASSERT_TRUE(composer.kindOf(0, kHello) == TextComposer::TokenKind::Word);
+    TEST_ASSERT_TRUE(composer.kindOf(0, kNumClasses) == TextComposer::TokenKind::Ignore);
+    TEST_ASSERT_TRUE(composer.kindOf(TEXT_COMPOSER_MAX_STAGES, kA) == TextComposer::TokenKind::Ignore);
+    TEST_ASSERT_EQUAL_STRING("HELLO", composer.labelOf(0, kHello));
+    TEST_ASSERT_EQUAL_STRING("?", composer.labelOf(0, kNumClasses));
+
+    asl_model::ModelDescriptor tooMany = vocabulary();
+    tooMany.numClasses = TEXT_COMPOSER_MAX_CLASSES + 1;
+    TEST_ASSERT_FALSE(composer.setVocabulary(0, tooMany));
+    TEST_ASSERT_FALSE(composer.setVocabulary(TEXT_COMPOSER_MAX_STAGES, vocabulary()));
+}
+
+void test_neutral_is_ignored() {
+    TEST_ASSERT_TRUE(composer.commit(0, kNeutral) == TextComposer::Result::Ignored);
+    TEST_ASSERT_TRUE(composer.commit(0, kNumClasses) == TextComposer::Result::Ignored);
+    TEST_ASSERT_TRUE(composer.empty());
+    TEST_ASSERT_EQUAL_size_t(0, composer.undoDepth());
+}
+
+void test_backspace_at_empty() {
+    TEST_ASSERT_TRUE(composer.commit(0, kBackspace) == TextComposer::Result::Ignored);
+    TEST_ASSERT_TRUE(composer.empty());
+    TEST_ASSERT_EQUAL_STRING("", composer.text());
+    TEST_ASSERT_EQUAL_size_t(0, composer.undoDepth());
+    TEST_ASSERT_FALSE(composer.undo());
+
+    // And again after deleting the only letter.
+    TEST_ASSERT_TRUE(composer.commit(0, kA) == TextComposer::Result::Ok);
+    TEST_ASSERT_TRUE(composer.commit(0, kBackspace) == TextComposer::Result::Ok);
+    TEST_ASSERT_TRUE(composer.commit(0, kBackspace) == TextComposer::Result::Ignored);
+    TEST_ASSERT_EQUAL_STRING("", composer.text());
+    TEST_ASSERT_EQUAL_size_t(0, composer.currentWordStart());
+}
+
+void test_letters_and_spaces() {
+    composer.commit(0, kA);
+    composer.commit(0, kB);
+    TEST_ASSERT_FALSE(composer.atWordBoundary());
+    TEST_ASSERT_EQUAL_size_t(0, composer.currentWordStart());
+    composer.commit(0, kSpace);
+    TEST_ASSERT_TRUE(composer.atWordBoundary());
+    TEST_ASSERT_EQUAL_size_t(3, composer.currentWordStart());
+    composer.commit(0, kA);
+    TEST_ASSERT_EQUAL_STRING("AB A", composer.text());
+    TEST_ASSERT_EQUAL_size_t(4, composer.length());
+
+    composer.commit(0, kBackspace);
+    composer.commit(0, kBackspace);
+    TEST_ASSERT_EQUAL_STRING("AB", composer.text());
+    TEST_ASSERT_EQUAL_size_t(0, composer.currentWordStart());
+}
+
+void test_word_commit_is_one_unit() {
+    composer.commit(0, kA);
+    composer.commit(0, kB);
+    TEST_ASSERT_TRUE(composer.commit(0, kHello) == TextComposer::Result::Ok);
+    TEST_ASSERT_EQUAL_STRING("AB HELLO ", composer.text());
+    TEST_ASSERT_TRUE(composer.atWordBoundary());
+    TEST_ASSERT_EQUAL_size_t(9, composer.currentWordStart());
+
+    // At a word boundary no leading separator is added.
+    TEST_ASSERT_TRUE(composer.commitWord("EAT") == TextComposer::Result::Ok);
+    TEST_ASSERT_EQUAL_STRING("AB HELLO EAT ", composer.text());
+
+    // Backspace removes the whole word with its separators.
+    composer.commit(0, kBackspace);
+    TEST_ASSERT_EQUAL_STRING("AB HELLO ", composer.text());
+    composer.commit(0, kBackspace);
+    TEST_ASSERT_EQUAL_STRING("AB", composer.text());
+    TEST_ASSERT_EQUAL_size_t(0, composer.currentWordStart());
+
+    TEST_ASSERT_TRUE(composer.commitWord("") == TextComposer::Result::Ignored);
+    TEST_ASSERT_TRUE(composer.commitWord(nullptr) == TextComposer::Result::Ignored);
+}
+
+void test_long_words_are_truncated() {
+    const std::string expected = std::string(kLabels[kLong], kMaxWord) + " ";
+    TEST_ASSERT_TRUE(composer.commit(0, kLong) == TextComposer::Result::Ok);
+    TEST_ASSERT_EQUAL_STRING(expected.c_str(), composer.text());
+
+    composer.clear();
+    composer.commit(0, kA);
+    TEST_ASSERT_TRUE(composer.commitWord(kLabels[kLong]) == TextComposer::Result::Ok);
+    const std::string afterLetter = "A " + expected;
+    TEST_ASSERT_EQUAL_STRING(afterLetter.c_str(), composer.text());
+    TEST_ASSERT_EQUAL_size_t(2 + kMaxWord + 1, composer.length());
+}
+
+void test_capacity_overflow() {
+    for (size_t i = 0; i < TEXT_COMPOSER_CAPACITY; ++i) {
+        TEST_ASSERT_TRUE(composer.commit(0, kA) == TextComposer::Result::Ok);
+    }
+    TEST_ASSERT_EQUAL_size_t(TEXT_COMPOSER_CAPACITY, composer.length());
+    TEST_ASSERT_EQUAL_size_t(TEXT_COMPOSER_CAPACITY, std::strlen(composer.text()));
+
+    const size_t undoBefore = composer.undoDepth();
+    TEST_ASSERT_TRUE(composer.commit(0, kB) == TextComposer::Result::Full);
+    TEST_ASSERT_TRUE(composer.commit(0, kSpace) == TextComposer::Result::Full);
+    TEST_ASSERT_TRUE(composer.commitWord("HI") == TextComposer::Result::Full);
+    TEST_ASSERT_EQUAL_size_t(TEXT_COMPOSER_CAPACITY, composer.length());
+    TEST_ASSERT_EQUAL_size_t(undoBefore, composer.undoDepth());
+    TEST_ASSERT_EQUAL_INT('A', composer.text()[TEXT_COMPOSER_CAPACITY - 1]);
+
+    // A word that does not fit is refused whole, not cut to the space left.
+    composer.commit(0, kBackspace);
+    composer.commit(0, kBackspace);
+    TEST_ASSERT_TRUE(composer.commit(0, kHello) == TextComposer::Result::Full);
+    TEST_ASSERT_EQUAL_size_t(TEXT_COMPOSER_CAPACITY - 2, composer.length());
+    TEST_ASSERT_TRUE(composer.commit(0, kSpace) == TextComposer::Result::Ok);
+    TEST_ASSERT_TRUE(composer.commit(0, kB) == TextComposer::Result::Ok);
+    TEST_ASSERT_TRUE(composer.commit(0, kA) == TextComposer::Result::Full);
+    TEST_ASSERT_EQUAL_size_t(TEXT_COMPOSER_CAPACITY, composer.length());
+}
+
+void test_undo_redo() {
+    composer.commit(0, kA);
+    composer.commit(0, kHello);
+    composer.commit(0, kBackspace);
+    TEST_ASSERT_EQUAL_STRING("A", composer.text());
+
+    TEST_ASSERT_TRUE(composer.undo());
+    TEST_ASSERT_EQUAL_STRING("A HELLO ", composer.text());
+    TEST_ASSERT_TRUE(composer.undo());
+    TEST_ASSERT_EQUAL_STRING("A", composer.text());
+    TEST_ASSERT_EQUAL_size_t(2, composer.redoDepth());
+
+    TEST_ASSERT_TRUE(composer.redo());
+    TEST_ASSERT_EQUAL_STRING("A HELLO ", composer.text());
+    TEST_ASSERT_EQUAL_size_t(8, composer.currentWordStart());
+
+    // A new edit drops what was left to redo.
+    composer.commit(0, kB);
+    TEST_ASSERT_EQUAL_size_t(0, composer.redoDepth());
+    TEST_ASSERT_FALSE(composer.redo());
+    TEST_ASSERT_EQUAL_STRING("A HELLO B", composer.text());
+}
+
+void test_history_keeps_newest_edits() {
+    for (size_t i = 0; i < TEXT_COMPOSER_HISTORY + 10; ++i) composer.commit(0, i % 2 ? kB : kA);
+    TEST_ASSERT_EQUAL_size_t(TEXT_COMPOSER_HISTORY, composer.undoDepth());
+    while (composer.undo()) {
+    }
+    TEST_ASSERT_EQUAL_size_t(10, composer.length());
+    TEST_ASSERT_EQUAL_STRING("ABABABABAB", composer.text());
+}
+
+void test_clear() {
+    composer.commit(0, kA);
+    composer.commit(0, kHello);
+    composer.clear();
+    TEST_ASSERT_TRUE(composer.empty());
+    TEST_ASSERT_EQUAL_STRING("", composer.text());
+    TEST_ASSERT_EQUAL_size_t(0, composer.undoDepth());
+    TEST_ASSERT_FALSE(composer.undo());
+    TEST_ASSERT_TRUE(composer.commit(0, kBackspace) == TextComposer::Result::Ignored);
+}
+
+int main(int, char**) {
+    UNITY_BEGIN();
+    RUN_TEST(test_vocabulary_kinds);
+    RUN_TEST(test_neutral_is_ignored);
+    RUN_TEST(test_backspace_at_empty);
+    RUN_TEST(test_letters_and_spaces);
+    RUN_TEST(test_word_commit_is_one_unit);
+    RUN_TEST(test_long_words_are_truncated);
+    RUN_TEST(test_capacity_overflow);
+    RUN_TEST(test_undo_redo);
+    RUN_TEST(test_history_keeps_newest_edits);
+    RUN_TEST(test_clear);
+    return UNITY_END();
+}
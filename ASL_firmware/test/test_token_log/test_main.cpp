@@ -0,0 +1,210 @@
+// TokenLog rings: binary frames, full-ring drops, and lock-free slot
+// reservation with several producers per core racing a draining consumer.
+// The drain task is not started (begin() is never called); the tests call
+// drain() themselves and read binary output, which needs no format table.
+
+#include <unity.h>
+
+#include <atomic>
+#include <cstring>
+#include <memory>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "token_log.h"
+
+namespace {
+
+struct Frame {
+    uint16_t id;
+    uint8_t core;
+    uint8_t words;
+    uint32_t timestampUs;
+    uint32_t args[TOKEN_LOG_MAX_WORDS];
+};
+
+uint32_t readU32(const uint8_t* p) {
+    uint32_t value;
+    memcpy(&value, p, sizeof(value));
+    return value;
+}
+
+// Splits binary output into frames, checking sync bytes and checksums.
+// Text between frames (the drop report) is returned in text.
+std::vector<Frame> parseFrames(const std::string& data, std::string* text = nullptr) {
+    std::vector<Frame> frames;
+    const uint8_t* p = reinterpret_cast<const uint8_t*>(data.data());
+    size_t pos = 0;
+    while (pos < data.size()) {
+        if (p[pos] != TOKEN_LOG_SYNC0) {
+            TEST_ASSERT_NOT_NULL(text);
+            text->push_back(static_cast<char>(p[pos++]));
+            continue;
+        }
+        TEST_ASSERT_TRUE(pos + 11 <= data.size());
+        TEST_ASSERT_EQUAL_UINT8(TOKEN_LOG_SYNC1, p[pos + 1]);
+        const size_t body = pos + 2;
+        Frame frame;
+        frame.id = static_cast<uint16_t>(p[body] | (p[body + 1] << 8));
+        frame.core = p[body + 2];
+        frame.words = p[body + 3];
+        frame.timestampUs = readU32(p + body + 4);
+        TEST_ASSERT_TRUE(frame.words <= TOKEN_LOG_MAX_WORDS);
+        const size_t end = body + 8 + frame.words * 4;
+        TEST_ASSERT_TRUE(end < data.size());
+        for (size_t w = 0; w < frame.words; w++) frame.args[w] = readU32(p + body + 8 + w * 4);
+        uint8_t check = 0;
+        for (size_t i = body; i < end; i++) check ^= p[i];
+        TEST_ASSERT_EQUAL_UINT8(check, p[end]);
+        frames.push_back(frame);
+        pos = end + 1;
+    }
+    return frames;
+}
+
+std::unique_ptr<TokenLog> tlog;
+
+}  // namespace
+
+void setUp() {
+    tlog.reset(new TokenLog());
+    tlog->setBinary(true);
+    Serial.take();
+    host::core = 0;
+}
+
+void tearDown() {
+    tlog.reset();
+}
+
+void test_binary_frame_layout() {
+    tlog->write(7, 1.25f, -3, 42u, 'Q');
+    tlog->drain();
+    const std::vector<Frame> frames = parseFrames(Serial.take());
+    TEST_ASSERT_EQUAL_size_t(1, frames.size());
+    const Frame& f = frames[0];
+    TEST_ASSERT_EQUAL_UINT16(7, f.id);
+    TEST_ASSERT_EQUAL_UINT8(0, f.core);
+    TEST_ASSERT_EQUAL_UINT8(4, f.words);
+    float value;
+    memcpy(&value, &f.args[0], sizeof(value));
+    TEST_ASSERT_EQUAL_FLOAT(1.25f, value);
+    TEST_ASSERT_EQUAL_INT(-3, static_cast<int32_t>(f.args[1]));
+    TEST_ASSERT_EQUAL_UINT32(42, f.args[2]);
+    TEST_ASSERT_EQUAL_UINT32('Q', f.args[3]);
+    TEST_ASSERT_TRUE(f.timestampUs <= micros());
+}
+
+void test_strings_are_inline_and_truncated() {
+    tlog->write(1, "asl_model_short", "A", static_cast<const char*>(nullptr));
+    tlog->drain();
+    const std::vector<Frame> frames = parseFrames(Serial.take());
+    TEST_ASSERT_EQUAL_size_t(1, frames.size());
+    TEST_ASSERT_EQUAL_UINT8(3 * TOKEN_LOG_STRING_WORDS, frames[0].words);
+
+    char str[TOKEN_LOG_STRING_WORDS * 4];
+    memcpy(str, &frames[0].args[0], sizeof(str));
+    TEST_ASSERT_EQUAL_STRING("asl_model_s", str);  // 11 chars and the terminator
+    memcpy(str, &frames[0].args[TOKEN_LOG_STRING_WORDS], sizeof(str));
+    TEST_ASSERT_EQUAL_STRING("A", str);
+    memcpy(str, &frames[0].args[2 * TOKEN_LOG_STRING_WORDS], sizeof(str));
+    TEST_ASSERT_EQUAL_STRING("", str);
+}
+
+void test_records_keep_their_core() {
+    tlog->write(1, 10u);
+    host::core = 1;
+    tlog->write(2, 20u);
+    host::core = 0;
+    tlog->drain();
+    const std::vector<Frame> frames = parseFrames(Serial.take());
+    TEST_ASSERT_EQUAL_size_t(2, frames.size());
+    TEST_ASSERT_EQUAL_UINT8(0, frames[0].core);
+    TEST_ASSERT_EQUAL_UINT32(10, frames[0].args[0]);
+    TEST_ASSERT_EQUAL_UINT8(1, frames[1].core);
+    TEST_ASSERT_EQUAL_UINT32(20, frames[1].args[0]);
+}
+
+void test_full_ring_drops_newest_and_reports() {
+    const uint32_t extra = 9;
+    for (uint32_t i = 0; i < TOKEN_LOG_RING_SLOTS + extra; i++) tlog->write(3, i);
+    TEST_ASSERT_EQUAL_UINT32(extra, tlog->getDropped());
+
+    tlog->drain();
+    std::string text;
+    const std::vector<Frame> frames = parseFrames(Serial.take(), &text);
+    TEST_ASSERT_EQUAL_size_t(TOKEN_LOG_RING_SLOTS, frames.size());
+    for (uint32_t i = 0; i < TOKEN_LOG_RING_SLOTS; i++) TEST_ASSERT_EQUAL_UINT32(i, frames[i].args[0]);
+    TEST_ASSERT_EQUAL_STRING("[LOG] 9 records dropped (ring full)\n", text.c_str());
+
+    // The ring is free again, and the drop is reported only once.
+    tlog->write(3, 100u);
+    tlog->drain();
+    text.clear();
+    TEST_ASSERT_EQUAL_size_t(1, parseFrames(Serial.take(), &text).size());
+    TEST_ASSERT_TRUE(text.empty());
+}
+
+void test_concurrent_reservation() {
+    // Two producers per core share each ring and race the consumer for its
+    // slots. Every record must come out once, whole, and in the order its
+    // producer wrote it; whatever does not fit is counted as dropped.
+    constexpr int kProducers = 4;
+    constexpr uint32_t kRecords = 20000;
+    std::atomic<int> running{kProducers};
+    std::vector<std::thread> producers;
+    for (int t = 0; t < kProducers; t++) {
+        producers.emplace_back([t, &running] {
+            host::core = t % TOKEN_LOG_CORES;
+            for (uint32_t i = 0; i < kRecords; i++) {
+                const uint32_t tag = static_cast<uint32_t>(t) << 24 | i;
+                tlog->write(5, tag, ~tag, tag * 2654435761u, static_cast<uint32_t>(host::core));
+                if ((i & 63) == 0) std::this_thread::yield();
+            }
+            running--;
+        });
+    }
+
+    std::string output;
+    std::thread consumer([&] {
+        while (running.load() > 0) {
+            tlog->drain();
+            output += Serial.take();
+        }
+    });
+    for (std::thread& producer : producers) producer.join();
+    consumer.join();
+    tlog->drain();
+    output += Serial.take();
+
+    std::string text;
+    const std::vector<Frame> frames = parseFrames(output, &text);
+    std::vector<int64_t> last(kProducers, -1);
+    for (const Frame& f : frames) {
+        TEST_ASSERT_EQUAL_UINT16(5, f.id);
+        TEST_ASSERT_EQUAL_UINT8(4, f.words);
+        const uint32_t tag = f.args[0];
+        TEST_ASSERT_EQUAL_UINT32(~tag, f.args[1]);
+        TEST_ASSERT_EQUAL_UINT32(tag * 2654435761u, f.args[2]);
+        const int producer = static_cast<int>(tag >> 24);
+        TEST_ASSERT_TRUE(producer < kProducers);
+        TEST_ASSERT_EQUAL_UINT8(f.args[3], f.core);
+        TEST_ASSERT_EQUAL_INT(producer % TOKEN_LOG_CORES, f.core);
+        const int64_t seq = tag & 0xFFFFFF;
+        TEST_ASSERT_TRUE(seq > last[producer]);
+        last[producer] = seq;
+    }
+    TEST_ASSERT_EQUAL_UINT32(kProducers * kRecords, frames.size() + tlog->getDropped());
+    TEST_ASSERT_TRUE(frames.size() > 0);
+}
+
+int main(int, char**) {
+    UNITY_BEGIN();
+    RUN_TEST(test_binary_frame_layout);
+    RUN_TEST(test_strings_are_inline_and_truncated);
+    RUN_TEST(test_records_keep_their_core);
+    RUN_TEST(test_full_ring_drops_newest_and_reports);
+    RUN_TEST(test_concurrent_reservation);
+    return UNITY_END();
+}
@@ -0,0 +1,234 @@
+"""Build the firmware lexicon package (ASL_firmware/src/ml/asl_lexicon.h).
+
+The lexicon is a letter trie over the vocabulary plus a bigram language model,
+written as constexpr tables for the beam decoder (ml/beam_decoder.h). The
+vocabulary is the word list, every word in the corpus, and the whole-word
+classes of the packaged model (e.g. HELLO, EAT).
+
+    python3 build_lexicon.py
+    python3 build_lexicon.py --words data/lexicon_words.txt --corpus data/lexicon_corpus.txt
+"""
+import argparse
+import math
+import re
+from collections import Counter, defaultdict
+from pathlib import Path
+
+from model_package import FIRMWARE_ML, TOKENS
+
+DATA_DIR = Path(__file__).parent / "data"
+LOG_SCALE = 256.0          # must match asl_model::kLexiconLogScale
+DISCOUNT = 0.5             # absolute discount for seen bigrams
+NO_WORD = 0xFFFF
+SENTENCE_START = 0xFFFE
+WORD_RE = re.compile(r"^[A-Z]+$")
+
+
+def quantize_log(prob: float) -> int:
+    if prob <= 0.0:
+        return -32767
+    return max(-32767, min(0, int(round(math.log(prob) * LOG_SCALE))))
+
+
+def read_words(path: Path) -> Counter:
+    """Word list with optional counts: one 'WORD [count]' per line, '#' comments."""
+    counts = Counter()
+    if not path or not path.exists():
+        return counts
+    for line in path.read_text(encoding="utf-8").splitlines():
+        line = line.split("#", 1)[0].strip()
+        if not line:
+            continue
+        parts = line.split()
+        word = parts[0].upper()
+        if WORD_RE.match(word):
+            counts[word] += int(parts[1]) if len(parts) > 1 else 1
+    return counts
+
+
+def read_corpus(path: Path):
+    """Sentences of the corpus as lists of upper-case words (non-letters dropped)."""
+    sentences = []
+    if not path or not path.exists():
+        return sentences
+    for line in path.read_text(encoding="utf-8").splitlines():
+        words = [re.sub(r"[^A-Z]", "", w.upper()) for w in line.split()]
+        words = [w for w in words if w]
+        if words:
+            sentences.append(words)
+    return sentences
+
+
+def model_word_labels(config: Path):
+    """Whole-word classes of a packaged model: labels longer than one letter that are not tokens."""
+    if not config or not config.exists():
+        return []
+    text = config.read_text(encoding="utf-8")
+    match = re.search(r"kLabelNames\[kNumClasses\]\s*=\s*\{(.*?)\};", text, re.S)
+    if not match:
+        return []
+    labels = re.findall(r'"([^"]*)"', match.group(1))
+    return [l.upper() for l in labels if len(l) > 1 and l.upper() not in TOKENS and WORD_RE.match(l.upper())]
+
+
+def build_language_model(word_counts: Counter, sentences):
+    unigram = Counter(word_counts)
+    bigram = defaultdict(Counter)
+    for words in sentences:
+        prev = SENTENCE_START
+        for word in words:
+            unigram[word] += 1
+            bigram[prev][word] += 1
+            prev = word
+    vocab = sorted(unigram)
+    # Every vocabulary word keeps a little mass even if it never occurs.
+    total = sum(unigram.values()) + len(vocab)
+    p_uni = {w: (unigram[w] + 1) / total for w in vocab}
+    return vocab, p_uni, bigram
+
+
+def build_trie(vocab, p_uni):
+    """Breadth-first node list; children of each node are contiguous and sorted."""
+    root = {"children": {}, "word": None}
+    for word in vocab:
+        node = root
+        for ch in word:
+            node = node["children"].setdefault(ch, {"children": {}, "word": None})
+        node["word"] = word
+
+    def mass(node):
+        total = p_uni[node["word"]] if node["word"] else 0.0
+        for child in node["children"].values():
+            total += mass(child)
+        node["mass"] = total
+        return total
+
+    mass(root)
+    nodes = [("\0", root)]
+    order = [root]
+    index = 0
+    while index < len(order):
+        node = order[index]
+        node["first"] = len(nodes)
+        for ch in sorted(node["children"]):
+            child = node["children"][ch]
+            nodes.append((ch, child))
+            order.append(child)
+        index += 1
+    return nodes
+
+
+def generate_header(vocab, p_uni, bigram, nodes, sources) -> str:
+    word_index = {w: i for i, w in enumerate(vocab)}
+
+    text_offsets = []
+    text = []
+    offset = 0
+    for word in vocab:
+        text_offsets.append(offset)
+        text.append(word)
+        offset += len(word) + 1
+
+    backoff = {}
+    bigram_rows = []
+    for prev, followers in bigram.items():
+        n = sum(followers.values())
+        alpha = DISCOUNT * len(followers) / n
+        backoff[prev] = alpha
+        prev_index = SENTENCE_START if prev == SENTENCE_START else word_index[prev]
+        for word, count in followers.items():
+            prob = (count - DISCOUNT) / n + alpha * p_uni[word]
+            bigram_rows.append((prev_index, word_index[word], quantize_log(prob)))
+    bigram_rows.sort()
+
+    node_lines = []
+    for ch, node in nodes:
+        symbol = "'\\0'" if ch == "\0" else f"'{ch}'"
+        word = word_index[node["word"]] if node["word"] else NO_WORD
+        child_count = len(node["children"])
+        if child_count > 255:
+            raise ValueError("trie node has more than 255 children")
+        node_lines.append(f"    {{{symbol}, {child_count}, {node['first'] if child_count else 0}, "
+                          f"0x{word:04X}, {quantize_log(node['mass'])}}},")
+
+    word_lines = [f"    {{{text_offsets[i]}, {quantize_log(p_uni[w])}, "
+                  f"{quantize_log(backoff.get(w, 1.0))}}},  // {w}" for i, w in enumerate(vocab)]
+    bigram_lines = [f"    {{0x{p:04X}, {n}, {lp}}}," for p, n, lp in bigram_rows]
+    text_literal = "\n".join(f'    "{w}\\0"' for w in text)
+
+    return f"""// Auto-generated by ML_model/build_lexicon.py - do not edit.
+// Sources: {', '.join(sources)}
+// {len(vocab)} words, {len(nodes)} trie nodes, {len(bigram_rows)} bigrams
+#ifndef ASL_LEXICON_PACKAGE_H_
+#define ASL_LEXICON_PACKAGE_H_
+
+#include "ml/lexicon.h"
+
+namespace asl_lexicon {{
+
+constexpr size_t kNumNodes = {len(nodes)};
+constexpr size_t kNumWords = {len(vocab)};
+constexpr size_t kNumBigrams = {max(1, len(bigram_rows))};
+
+constexpr asl_model::LexiconNode kNodes[kNumNodes] = {{
+{chr(10).join(node_lines)}
+}};
+
+constexpr asl_model::LexiconWord kWords[kNumWords] = {{
+{chr(10).join(word_lines)}
+}};
+
+constexpr asl_model::LexiconBigram kBigrams[kNumBigrams] = {{
+{chr(10).join(bigram_lines) if bigram_lines else '    {0xFFFF, 0xFFFF, 0},'}
+}};
+
+constexpr char kText[] =
+{text_literal};
+
+constexpr asl_model::LexiconDescriptor kLexicon = {{
+    kNodes,
+    kNumNodes,
+    kWords,
+    kNumWords,
+    kBigrams,
+    {len(bigram_rows)},
+    kText,
+    {quantize_log(backoff.get(SENTENCE_START, 1.0))},
+}};
+
+}}  // namespace asl_lexicon
+
+#endif  // ASL_LEXICON_PACKAGE_H_
+"""
+
+
+def main() -> None:
+    parser = argparse.ArgumentParser(description=__doc__, formatter_class=argparse.RawDescriptionHelpFormatter)
+    parser.add_argument("--words", type=Path, default=DATA_DIR / "lexicon_words.txt",
+                        help="Word list, one 'WORD [count]' per line")
+    parser.add_argument("--corpus", type=Path, default=DATA_DIR / "lexicon_corpus.txt",
+                        help="Sentences for the bigram model, one per line")
+    parser.add_argument("--config", type=Path, default=FIRMWARE_ML / "asl_model_config.h",
+                        help="Model package whose word classes join the vocabulary")
+    parser.add_argument("--out", type=Path, default=FIRMWARE_ML / "asl_lexicon.h")
+    args = parser.parse_args()
+
+    word_counts = read_words(args.words)
+    for label in model_word_labels(args.config):
+        word_counts[label] += 0
+    sentences = read_corpus(args.corpus)
+    vocab, p_uni, bigram = build_language_model(word_counts, sentences)
+    if not vocab:
+        raise SystemExit("Empty vocabulary: give --words or --corpus")
+    if len(vocab) >= SENTENCE_START:
+        raise SystemExit(f"Vocabulary too large ({len(vocab)} words)")
+    nodes = build_trie(vocab, p_uni)
+
+    sources = [p.name for p in (args.words, args.corpus, args.config) if p and p.exists()]
+    args.out.write_text(generate_header(vocab, p_uni, bigram, nodes, sources))
+    print(f"Lexicon: {len(vocab)} words, {len(nodes)} nodes, "
+          f"{sum(len(f) for f in bigram.values())} bigrams -> {args.out}")
+
+
+if __name__ == "__main__":
+    main()
@@ -2,75 +2,218 @@
 import os
 os.environ['TF_CPP_MIN_LOG_LEVEL'] = '2'
 
+import argparse
+import json
+import subprocess
+import sys
 from pathlib import Path
 import numpy as np
+import pandas as pd
 import tensorflow as tf
 
+sys.path.insert(0, str(Path(__file__).parent / 'src'))
+from src.core.model import ChannelMask
+from src.data_processing.data_preprocessing import firmware_preprocess, imu_is_raw, load_firmware_windows
+from model_package import DEFAULT_MODEL_NAME, norm_params_path, write_model_package
+
+PROJECT_ROOT = Path(__file__).parent.parent
 MODEL_BASE = Path(__file__).parent / "model"
+FIRMWARE_DIR = PROJECT_ROOT / "ASL_firmware"
+
+parser = argparse.ArgumentParser(description=__doc__)
+parser.add_argument('--data-dir', type=Path, default=PROJECT_ROOT / "python" / "data_logs",
+                    help="Recorded session CSVs used for int8 calibration")
+parser.add_argument('--norm-params', type=Path, default=None,
+                    help="IMU normalization params shipped to the firmware (default: the "
+                         "run's normalization_params.json written by train.py)")
+parser.add_argument('--calibration-windows', type=int, default=500,
+                    help="Number of real windows fed to the quantizer")
+parser.add_argument('--model-name', default=DEFAULT_MODEL_NAME,
+                    help="Package name in the firmware; use e.g. asl_model_short for the "
+                         "router's short-window stage")
+parser.add_argument('--no-embedding', action='store_true',
+                    help="Export only the class scores, without the embedding output the "
+                         "firmware's per-user prototypes need")
+parser.add_argument('--validate', action='store_true',
+                    help="Build the host runner and score the converted model on the recordings")
+args = parser.parse_args()
+
 latest_dir = max([d for d in MODEL_BASE.iterdir() if d.is_dir()], key=lambda x: x.stat().st_mtime)
 
 print(f"Converting model from {latest_dir.name}")
 
-for fname in ["best_model.keras", "final_model.keras", "model.keras"]:
+# The last compression stage's checkpoint, if train.py ran one (--prune/--qat)
+for fname in ["qat_best_model.keras", "pruned_best_model.keras", "best_model.keras",
+              "final_model.keras", "model.keras"]:
     model_path = latest_dir / fname
     if model_path.exists():
         break
 
-model = tf.keras.models.load_model(model_path)
+config_path = latest_dir / "config.json"
+train_config = json.load(config_path.open()) if config_path.exists() else {}
+
+
+def load_keras(path):
+    # ChannelMask: first-layer constraint used by model_search.py candidates
+    custom_objects = {'ChannelMask': ChannelMask}
+    if train_config.get('use_qat'):
+        import tensorflow_model_optimization as tfmot
+        with tfmot.quantization.keras.quantize_scope(custom_objects):
+            return tf.keras.models.load_model(path)
+    return tf.keras.models.load_model(path, custom_objects=custom_objects)
+
+
+model = load_keras(model_path)
 
 for fname in ["label_encoder_classes.npy", "classes.npy"]:
     classes_path = latest_dir / fname
     if classes_path.exists():
         break
 
-classes = np.load(classes_path)
+classes = np.load(classes_path, allow_pickle=True)
 print(f"Classes: {list(classes)}")
 
-def representative_dataset():
-    for _ in range(100):
-        yield [np.random.rand(1, 25, 11).astype(np.float32)]
-
-converter = tf.lite.TFLiteConverter.from_keras_model(model)
-converter.optimizations = [tf.lite.Optimize.DEFAULT]
-converter.representative_dataset = representative_dataset
-converter.target_spec.supported_ops = [tf.lite.OpsSet.TFLITE_BUILTINS_INT8]
-converter.inference_input_type = tf.int8
-converter.inference_output_type = tf.int8
-
-tflite_model = converter.convert()
+window_size, num_features = model.input_shape[1], model.input_shape[2]
+sample_stride = int(train_config.get('sample_stride', 1))
+gate_path = latest_dir / "gate.json"
+gate = json.load(gate_path.open()) if gate_path.exists() else None
+norm_path = norm_params_path(latest_dir, args.norm_params)
+print(f"IMU normalization: {norm_path}")
+norm_params = json.load(norm_path.open())
+
+# Calibrate on real windows pushed through the firmware feature transform so the
+# input scale/zero point cover the ranges the glove actually produces.
+calib_windows, calib_labels = load_firmware_windows(
+    args.data_dir, norm_params, labels=[str(c) for c in classes],
+    window_size=window_size, sample_stride=sample_stride)
+rng = np.random.default_rng(42)
+calib_idx = rng.choice(len(calib_windows), min(args.calibration_windows, len(calib_windows)), replace=False)
+print(f"Calibrating with {len(calib_idx)} of {len(calib_windows)} recorded windows "
+      f"(feature range {calib_windows.min():.2f} .. {calib_windows.max():.2f})")
 
-tflite_path = latest_dir / "model_quantized.tflite"
-tflite_path.write_bytes(tflite_model)
-print(f"Saved TFLite model: {len(tflite_model)/1024:.1f} KB")
-
-def generate_c_array(data, var_name):
-    header = f"""#ifndef ASL_MODEL_DATA_H_
-#define ASL_MODEL_DATA_H_
-
-extern const unsigned char {var_name}[];
-extern const int {var_name}_len;
+def representative_dataset():
+    for idx in calib_idx:
+        yield [calib_windows[idx:idx + 1]]
 
-#endif  // ASL_MODEL_DATA_H_"""
+def quantize(keras_model):
+    converter = tf.lite.TFLiteConverter.from_keras_model(keras_model)
+    converter.optimizations = [tf.lite.Optimize.DEFAULT]
+    converter.representative_dataset = representative_dataset
+    converter.target_spec.supported_ops = [tf.lite.OpsSet.TFLITE_BUILTINS_INT8]
+    converter.inference_input_type = tf.int8
+    converter.inference_output_type = tf.int8
+    return converter.convert()
 
-    formatted_lines = []
-    for i in range(0, len(data), 12):
-        line_bytes = [f'0x{b:02x}' for b in data[i:i+12]]
-        formatted_lines.append('  ' + ', '.join(line_bytes) + ',')
 
-    source = f"""#include "ml/asl_model_data.h"
+def with_embedding(keras_model):
+    """Adds the penultimate-layer embedding as a second output: the input of the
+    final Dense layer, i.e. dense_1 after its BatchNorm/ReLU in cnn_small."""
+    head = keras_model.layers[-1]
+    return tf.keras.Model(keras_model.inputs, [keras_model.output, head.input], name=keras_model.name)
 
-alignas(8) const unsigned char {var_name}[] = {{
-{chr(10).join(formatted_lines)}
-}};
 
-const int {var_name}_len = {len(data)};"""
+def export(keras_model):
+    return quantize(keras_model if args.no_embedding else with_embedding(keras_model))
 
-    return header, source
 
-header_content, source_content = generate_c_array(tflite_model, 'g_asl_model_data')
+tflite_model = export(model)
 
-firmware_ml = Path(__file__).parent.parent / "ASL_firmware/src/ml"
-(firmware_ml / "asl_model_data.h").write_text(header_content)
-(firmware_ml / "asl_model_data.cc").write_text(source_content)
+tflite_path = latest_dir / "model_quantized.tflite"
+tflite_path.write_bytes(tflite_model)
+print(f"Saved TFLite model: {len(tflite_model)/1024:.1f} KB")
 
-print("Generated firmware model files")
+# Pruned/QAT runs keep the uncompressed model for comparison, exported with
+# the same outputs so the deltas measure compression alone.
+baseline_path = latest_dir / "baseline_model.keras"
+baseline_tflite_path = None
+if baseline_path.exists():
+    baseline = tf.keras.models.load_model(baseline_path, custom_objects={'ChannelMask': ChannelMask})
+    baseline_tflite_path = latest_dir / "baseline_quantized.tflite"
+    baseline_tflite_path.write_bytes(export(baseline))
+    compression = json.load((latest_dir / "compression.json").open())
+    final = compression.get('pruned', compression['baseline'])
+    print(f"Compression vs baseline: int8 {baseline_tflite_path.stat().st_size / 1024:.1f} KB -> "
+          f"{len(tflite_model) / 1024:.1f} KB, MACs {compression['baseline']['macs']:,} -> "
+          f"{final['macs']:,}{', QAT' if compression.get('qat') else ''}")
+
+interpreter = tf.lite.Interpreter(model_content=tflite_model)
+input_details = interpreter.get_input_details()[0]
+input_scale, input_zero_point = input_details['quantization']
+print(f"Input quantization: scale={input_scale:.6f}, zero_point={input_zero_point}")
+
+write_model_package(tflite_model, classes, norm_params, latest_dir.name,
+                    model_name=args.model_name, sample_stride=sample_stride, gate=gate)
+
+print(f"Generated firmware model package ({args.model_name}_data.cc, {args.model_name}_config.h, "
+      f"{window_size} frames @ {50 // sample_stride} Hz, {'with' if gate else 'no'} gate, "
+      f"{'no' if args.no_embedding else 'with'} embedding output)")
+
+
+def runner_windows(results, stage):
+    """Rebuilds, from the CSVs, the float input of every window the runner's
+    `stage` answered with the CNN, so Keras and int8 are scored on the same
+    sessions, samples and labels. Returns (windows, labels, int8 labels)."""
+    span = (window_size - 1) * sample_stride
+    windows, labels, int8_labels = [], [], []
+    for session in results['sessions']:
+        if 'error' in session or session['label'] not in classes:
+            continue
+        df = pd.read_csv(session['file'])
+        if not imu_is_raw(df):
+            continue
+        features = firmware_preprocess(df, norm_params)
+        # Same newest-sample timestamps the runner reports (20 ms apart if the CSV has none)
+        stamps = df['timestamp'].astype(np.int64) if 'timestamp' in df.columns else pd.Series(np.arange(len(df)) * 20)
+        row_of = {int(t): i for i, t in enumerate(stamps)}
+        for window in session['windows']:
+            end = row_of.get(window['t'])
+            if window['stage'] != stage or window['gated'] or end is None or end < span:
+                continue
+            windows.append(features[end - span:end + 1:sample_stride])
+            labels.append(session['label'])
+            int8_labels.append(window['label'])
+    return np.asarray(windows, dtype=np.float32), np.asarray(labels), np.asarray(int8_labels)
+
+
+if args.validate:
+    # Score what the glove runs: the C++ preprocessing + TFLite Micro int8 path.
+    print("\nBuilding host runner...")
+    build = subprocess.run(["pio", "run", "-e", "native_runner"], cwd=FIRMWARE_DIR)
+    if build.returncode != 0:
+        print("Host runner build failed")
+        sys.exit(1)
+
+    sessions = [str(p) for p in sorted(args.data_dir.glob('*.csv'))]
+    results_path = latest_dir / "host_validation.json"
+    run = subprocess.run([str(FIRMWARE_DIR / ".pio/build/native_runner/program"),
+                          "--out", str(results_path)] + sessions)
+    if run.returncode != 0:
+        print("Host runner failed")
+        sys.exit(1)
+
+    results = json.load(results_path.open())
+    summary = results['summary']
+    stage = next(i for i, s in enumerate(results['stages']) if s['name'] == args.model_name)
+    windows, labels, int8_labels = runner_windows(results, stage)
+    if len(windows):
+        keras_labels = np.asarray(classes)[model.predict(windows, verbose=0).argmax(axis=1)]
+
+    if baseline_tflite_path is not None:
+        bench_path = latest_dir / "compression_bench.json"
+        subprocess.run([str(FIRMWARE_DIR / ".pio/build/native_runner/program"), "--out", str(bench_path),
+                        "--bench", str(baseline_tflite_path), "--bench", str(tflite_path)])
+        base, compressed = json.load(bench_path.open())['models']
+        if 'error' not in base and 'error' not in compressed:
+            print(f"Arena:   {base['arena_bytes']} -> {compressed['arena_bytes']} bytes")
+            print(f"Invoke:  {base['mean_invoke_us']:.1f} -> {compressed['mean_invoke_us']:.1f} us on host "
+                  f"({1 - compressed['mean_invoke_us'] / base['mean_invoke_us']:.0%} faster)")
+    if len(windows):
+        print(f"Keras float accuracy:      {np.mean(keras_labels == labels):.4f} "
+              f"({len(windows)} windows {args.model_name} answered)")
+        print(f"Firmware int8 accuracy:    {np.mean(int8_labels == labels):.4f} (same windows)")
+        print(f"Float/int8 agreement:      {np.mean(keras_labels == int8_labels):.4f}")
+    else:
+        print(f"No raw-IMU recordings of {list(classes)} for {args.model_name} to validate on")
+    print(f"Firmware end to end:       {summary['accuracy']:.4f} "
+          f"({summary['scored_windows']} windows, all stages, "
+          f"mean {summary['latency']['mean_us']:.0f} us/inference on host)")
@@ -9,15 +9,13 @@ from pathlib import Path
 print("Deploying model to ESP32...\n")
 
 scripts = [
-    ("Converting to TFLite", "convert_to_tflite.py"),
-    ("Updating firmware code", "update_firmware.py"),
-    ("Updating normalization", "update_normalization.py")
+    ("Converting to TFLite and generating firmware package", "convert_to_tflite.py"),
 ]
 
 for step, (desc, script) in enumerate(scripts, 1):
     print(f"[{step}/{len(scripts)}] {desc}...")
     result = subprocess.run([sys.executable, script], capture_output=False, text=True)
-    if result.returncode != 0 and step < 3:
+    if result.returncode != 0:
         print(f"Error in {script}")
         sys.exit(1)
 
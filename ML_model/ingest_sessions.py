@@ -0,0 +1,32 @@
+"""Ingest recorded session CSVs into the memory-mapped training store.
+
+Only new or modified CSVs are parsed; run after every recording session.
+"""
+import argparse
+import sys
+from pathlib import Path
+
+sys.path.insert(0, str(Path(__file__).parent / 'src'))
+from src.data_processing.session_store import SessionStore
+
+PROJECT_ROOT = Path(__file__).parent.parent
+
+parser = argparse.ArgumentParser(description=__doc__)
+parser.add_argument('--data-dir', type=Path, default=PROJECT_ROOT / "python" / "data_logs",
+                    help="Directory of session CSVs")
+parser.add_argument('--store', type=Path, default=Path(__file__).parent / "data" / "sessions",
+                    help="Session store directory")
+parser.add_argument('--keep-missing', action='store_true',
+                    help="Keep sessions whose CSV no longer exists")
+args = parser.parse_args()
+
+store = SessionStore(args.store)
+store.ingest(args.data_dir, prune=not args.keep_missing)
+
+by_label = {}
+for session in store.sessions():
+    by_label.setdefault(session['label'], []).append(session)
+for label, sessions in sorted(by_label.items()):
+    persons = sorted({s['person_id'] for s in sessions})
+    print(f"  {label:10s}: {len(sessions):3d} sessions, {sum(s['samples'] for s in sessions):6d} samples, "
+          f"signers {', '.join(persons)}")
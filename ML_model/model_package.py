@@ -0,0 +1,282 @@
+"""Generate the firmware model package (model bytes + constexpr metadata)."""
+import math
+import struct
+from pathlib import Path
+
+FIRMWARE_ML = Path(__file__).parent.parent / "ASL_firmware/src/ml"
+IMU_SENSORS = ['ax', 'ay', 'az', 'gx', 'gy', 'gz']
+NUM_FLEX = 5
+SENSOR_RATE_HZ = 50
+
+# The primary (longest-window) model. Extra router stages use their own name,
+# e.g. "asl_model_short", and are picked up by ml/model_router.h when present.
+DEFAULT_MODEL_NAME = "asl_model"
+
+# Token protocol shared with LogicTask; letters map to themselves.
+TOKENS = {
+    "NEUTRAL": "asl_model::kNeutralToken",
+    "NEUTR": "asl_model::kNeutralToken",
+    "SPACE": "asl_model::kSpaceToken",
+    "BACKSPACE": "asl_model::kBackspaceToken",
+    "BACK": "asl_model::kBackspaceToken",
+}
+
+
+def norm_params_path(run_dir: Path, override: Path = None) -> Path:
+    """IMU normalization for a training run: the statistics train.py fitted on
+    that run's training sessions, or an explicitly given file (e.g. the
+    combined-CSV params written by train_hello_eat.py)."""
+    if override is not None:
+        return override
+    path = run_dir / "normalization_params.json"
+    if not path.exists():
+        raise SystemExit(f"{run_dir.name} has no normalization_params.json; pass --norm-params "
+                         f"with the file its training data was normalized with")
+    return path
+
+
+def read_tflite_io(tflite_model: bytes):
+    """Return (input, outputs): dicts with shape/scale/zero_point from a .tflite flatbuffer,
+    one per model output in tensor order.
+
+    Walks the schema directly so the package can be regenerated without TensorFlow.
+    """
+    data = bytes(tflite_model)
+
+    def u32(pos):
+        return struct.unpack_from('<I', data, pos)[0]
+
+    def table(pos):
+        vtable = pos - struct.unpack_from('<i', data, pos)[0]
+        vtable_len = struct.unpack_from('<H', data, vtable)[0]
+
+        def field(index):
+            offset = 4 + 2 * index
+            if offset >= vtable_len:
+                return None
+            field_offset = struct.unpack_from('<H', data, vtable + offset)[0]
+            return pos + field_offset if field_offset else None
+        return field
+
+    def deref(pos):
+        return pos + u32(pos)
+
+    def vector(pos):
+        pos = deref(pos)
+        return pos + 4, u32(pos)
+
+    model = table(u32(0))
+    subgraphs, _ = vector(model(2))
+    subgraph = table(deref(subgraphs))
+    tensors, _ = vector(subgraph(0))
+
+    def tensor_info(index):
+        tensor = table(deref(tensors + 4 * index))
+        shape_pos, shape_len = vector(tensor(0))
+        quant = table(deref(tensor(4)))
+        scale_pos, _ = vector(quant(2))
+        zero_pos, _ = vector(quant(3))
+        return {
+            'shape': [struct.unpack_from('<i', data, shape_pos + 4 * i)[0] for i in range(shape_len)],
+            'scale': struct.unpack_from('<f', data, scale_pos)[0],
+            'zero_point': struct.unpack_from('<q', data, zero_pos)[0],
+        }
+
+    inputs, _ = vector(subgraph(1))
+    outputs, num_outputs = vector(subgraph(2))
+    return tensor_info(u32(inputs)), [tensor_info(u32(outputs + 4 * i)) for i in range(num_outputs)]
+
+
+def split_outputs(outputs, num_classes: int):
+    """Return (class output index, embedding info or None) for a model's outputs.
+
+    convert_to_tflite.py exports the penultimate-layer embedding as a second
+    output; the converter does not keep the Keras output order, so the class
+    scores are told apart by their width.
+    """
+    if len(outputs) == 1:
+        return 0, None
+    if len(outputs) != 2:
+        raise ValueError(f"Model has {len(outputs)} outputs, expected class scores and an embedding")
+    widths = [o['shape'][-1] for o in outputs]
+    if widths.count(num_classes) != 1:
+        raise ValueError(f"Cannot tell the class output from the embedding (widths {widths}, "
+                         f"{num_classes} classes); change the embedding width")
+    class_output = widths.index(num_classes)
+    return class_output, outputs[1 - class_output]
+
+
+def c_float(value: float) -> str:
+    """A float literal that stays valid C++ for whole numbers (0.0f, not 0f)."""
+    text = f"{value:.10g}"
+    if not any(c in text for c in '.en'):
+        text += '.0'
+    return text + 'f'
+
+
+def token_for_label(label: str) -> str:
+    upper = label.upper()
+    if upper in TOKENS:
+        return TOKENS[upper]
+    return f"'{upper[0]}'"
+
+
+def generate_c_array(data, var_name, header_name):
+    guard = f"{header_name.upper().replace('.', '_')}_"
+    header = f"""#ifndef {guard}
+#define {guard}
+
+extern const unsigned char {var_name}[];
+extern const int {var_name}_len;
+
+#endif  // {guard}"""
+
+    formatted_lines = []
+    for i in range(0, len(data), 12):
+        line_bytes = [f'0x{b:02x}' for b in data[i:i+12]]
+        formatted_lines.append('  ' + ', '.join(line_bytes) + ',')
+
+    source = f"""#include "ml/{header_name}"
+
+alignas(8) const unsigned char {var_name}[] = {{
+{chr(10).join(formatted_lines)}
+}};
+
+const int {var_name}_len = {len(data)};"""
+
+    return header, source
+
+
+def neutral_index(classes) -> int:
+    for i, c in enumerate(classes):
+        if TOKENS.get(str(c).upper()) == "asl_model::kNeutralToken":
+            return i
+    return -1
+
+
+def generate_gate_block(gate) -> str:
+    """C++ arrays for a gate exported by model.export_gate(), or '' without one."""
+    if gate is None:
+        return ''
+    weights = gate['weights']
+    if len(weights) != 2 * (NUM_FLEX + len(IMU_SENSORS)):
+        raise ValueError(f"Gate has {len(weights)} weights, expected mean+std per channel")
+    threshold = min(max(gate['threshold'], 1e-6), 1 - 1e-6)
+    rows = ',\n    '.join(', '.join(f'{w:.6f}f' for w in weights[i:i + 6]) for i in range(0, len(weights), 6))
+    return f"""
+// Neutral-vs-gesture gate (logistic regression on per-channel window mean,
+// then std). The model is skipped while the gesture probability < {threshold:.3f}.
+constexpr float kGateWeights[asl_model::kGateFeatures] = {{
+    {rows}}};
+constexpr float kGateBias = {gate['bias']:.6f}f;
+constexpr float kGateLogit = {math.log(threshold / (1 - threshold)):.6f}f;
+"""
+
+
+def generate_config_header(tflite_model: bytes, classes, norm_params, source_name: str,
+                           model_name: str = DEFAULT_MODEL_NAME, sample_stride: int = 1,
+                           gate=None) -> str:
+    """Render <model_name>_config.h for the given model, labels, IMU normalization and gate."""
+    input_info, outputs = read_tflite_io(tflite_model)
+    _, window_size, num_features = input_info['shape']
+    classes = [str(c) for c in classes]
+    if len(outputs) == 1 and outputs[0]['shape'][-1] != len(classes):
+        raise ValueError(f"Model outputs {outputs[0]['shape'][-1]} classes but {len(classes)} labels were given")
+    class_output, embedding = split_outputs(outputs, len(classes))
+    output_info = outputs[class_output]
+    num_classes = output_info['shape'][-1]
+    if num_features != NUM_FLEX + len(IMU_SENSORS):
+        raise ValueError(f"Model expects {num_features} features, firmware provides "
+                         f"{NUM_FLEX + len(IMU_SENSORS)}")
+    if sample_stride < 1 or SENSOR_RATE_HZ % sample_stride:
+        raise ValueError(f"Sample stride {sample_stride} does not divide {SENSOR_RATE_HZ} Hz")
+
+    guard = f"{model_name.upper()}_CONFIG_H_"
+    labels = ', '.join(f'"{c}"' for c in classes)
+    tokens = ',\n    '.join(token_for_label(c) for c in classes)
+    norms = '\n    '.join(
+        f"{{{norm_params[s]['mean']:.6f}f, {norm_params[s]['std']:.6f}f}},  // {s}" for s in IMU_SENSORS)
+    gate_fields = ("kGateWeights,\n    kGateBias,\n    kGateLogit," if gate is not None
+                   else "nullptr,\n    0.0f,\n    0.0f,")
+
+    return f"""// Auto-generated by ML_model/model_package.py - do not edit.
+// Source model: {source_name}
+// Classes: {', '.join(classes)}
+#ifndef {guard}
+#define {guard}
+
+#include "ml/model_descriptor.h"
+#include "ml/{model_name}_data.h"
+
+namespace {model_name} {{
+
+// Input shape [1, kWindowSize, asl_model::kNumFeatures], one frame every
+// kSampleStride sensor samples ({SENSOR_RATE_HZ // sample_stride} Hz).
+constexpr size_t kWindowSize = {window_size};
+constexpr size_t kSampleStride = {sample_stride};
+constexpr size_t kNumClasses = {num_classes};
+
+constexpr const char* kLabelNames[kNumClasses] = {{
+    {labels}}};
+
+constexpr char kLabelToChar[kNumClasses] = {{
+    {tokens}}};
+
+// int8 quantization of the model input/output tensors.
+constexpr float kInputScale = {input_info['scale']:.10g}f;
+constexpr int32_t kInputZeroPoint = {input_info['zero_point']};
+constexpr float kOutputScale = {output_info['scale']:.10g}f;
+constexpr int32_t kOutputZeroPoint = {output_info['zero_point']};
+
+// Penultimate-layer embedding (a second model output), 0 wide when absent.
+constexpr size_t kClassOutput = {class_output};
+constexpr size_t kEmbeddingSize = {embedding['shape'][-1] if embedding else 0};
+constexpr float kEmbeddingScale = {c_float(embedding['scale'] if embedding else 0.0)};
+constexpr int32_t kEmbeddingZeroPoint = {embedding['zero_point'] if embedding else 0};
+
+// z-score parameters for ax, ay, az, gx, gy, gz (training normalizer).
+constexpr asl_model::NormParams kImuNorm[asl_model::kNumImu] = {{
+    {norms}
+}};
+{generate_gate_block(gate)}
+constexpr asl_model::ModelDescriptor kDescriptor = {{
+    "{model_name}",
+    g_{model_name}_data,
+    kWindowSize,
+    kSampleStride,
+    kNumClasses,
+    kLabelNames,
+    kLabelToChar,
+    kInputScale,
+    kInputZeroPoint,
+    kOutputScale,
+    kOutputZeroPoint,
+    kImuNorm,
+    {neutral_index(classes)},
+    {gate_fields}
+    kClassOutput,
+    kEmbeddingSize,
+    kEmbeddingScale,
+    kEmbeddingZeroPoint,
+}};
+
+static_assert({num_features} == asl_model::kNumFeatures, "feature layout mismatch");
+
+}}  // namespace {model_name}
+
+#endif  // {guard}
+"""
+
+
+def write_model_package(tflite_model: bytes, classes, norm_params, source_name: str,
+                        model_name: str = DEFAULT_MODEL_NAME, sample_stride: int = 1,
+                        gate=None, output_dir: Path = FIRMWARE_ML):
+    """Write <model_name>_data.h/.cc and <model_name>_config.h into the firmware tree."""
+    header_content, source_content = generate_c_array(
+        tflite_model, f'g_{model_name}_data', f'{model_name}_data.h')
+    output_dir = Path(output_dir)
+    (output_dir / f"{model_name}_data.h").write_text(header_content)
+    (output_dir / f"{model_name}_data.cc").write_text(source_content)
+    (output_dir / f"{model_name}_config.h").write_text(
+        generate_config_header(tflite_model, classes, norm_params, source_name,
+                               model_name, sample_stride, gate))
@@ -0,0 +1,342 @@
+"""Architecture search scored on accuracy and measured int8 on-device cost.
+
+Trains candidates (conv widths, kernel size, window length, sensor subset) in
+parallel worker processes, converts each to int8 TFLite, measures tensor arena
+and Invoke() time with the host TFLite Micro runner (asl_host_runner --bench),
+scales host time to the ESP32-S3 with data/esp32s3_cost.json and writes the
+Pareto front of deployable candidates (accuracy vs. latency vs. arena).
+Early stopping and the front use validation windows from the training
+sessions; the test windows only score the candidates on the front.
+
+    python3 model_search.py --candidates 24 --workers 6
+    python3 model_search.py --promote search/<run>/c07   # copy into model/ for convert_to_tflite.py
+
+Calibrate the cost model once per firmware build: flash a model, run 'o',
+sign for a while, run 'O' and pass the "Inference" avg together with that
+model's .tflite:
+
+    python3 model_search.py --calibrate model/<run>/model_quantized.tflite --device-ms 4.8
+"""
+import os
+os.environ['TF_CPP_MIN_LOG_LEVEL'] = '2'
+
+import argparse
+import itertools
+import json
+import multiprocessing
+import shutil
+import subprocess
+import sys
+from concurrent.futures import ProcessPoolExecutor
+from datetime import datetime
+from pathlib import Path
+
+import numpy as np
+
+ROOT = Path(__file__).parent
+PROJECT_ROOT = ROOT.parent
+FIRMWARE_DIR = PROJECT_ROOT / "ASL_firmware"
+RUNNER = FIRMWARE_DIR / ".pio/build/native_runner/program"
+COST_MODEL_PATH = ROOT / "data" / "esp32s3_cost.json"
+SEARCH_BASE = ROOT / "search"
+MODEL_BASE = ROOT / "model"
+
+# Search space. Feature subsets keep the 11-channel firmware input and mask the
+# unused channels in the first conv (see model.ChannelMask).
+CONV_WIDTHS = [(8, 16), (16, 32), (24, 48), (8, 16, 32), (16, 32, 64)]
+KERNEL_SIZES = [3, 5]
+WINDOW_SIZES = [15, 25, 35]
+FEATURE_SUBSETS = {
+    'all': list(range(11)),
+    'flex_accel': list(range(8)),
+    'flex_gyro': list(range(5)) + [8, 9, 10],
+    'flex': list(range(5)),
+}
+SENSOR_RATE_HZ = 50
+
+_worker_data = None
+
+
+def load_cost_model():
+    return json.loads(COST_MODEL_PATH.read_text())
+
+
+def build_runner():
+    if subprocess.run(["pio", "run", "-e", "native_runner"], cwd=FIRMWARE_DIR).returncode != 0:
+        sys.exit("Host runner build failed")
+
+
+def bench(runner, tflite_paths, runs, out_path):
+    """Arena bytes and host invoke time per model from asl_host_runner --bench."""
+    cmd = [str(runner), "--runs", str(runs), "--out", str(out_path)]
+    for path in tflite_paths:
+        cmd += ["--bench", str(path)]
+    subprocess.run(cmd, check=False)
+    report = json.loads(Path(out_path).read_text())
+    return report['arena_budget_bytes'], {m['file']: m for m in report['models']}
+
+
+def calibrate(args):
+    """Fit host -> ESP32-S3 latency ratio from one on-device measurement."""
+    runner = args.runner or RUNNER
+    if not args.runner:
+        build_runner()
+    _, costs = bench(runner, [args.calibrate], args.bench_runs, ROOT / "calibration_bench.json")
+    host_us = costs[str(args.calibrate)]['mean_invoke_us']
+    cost_model = load_cost_model()
+    cost_model.update({
+        'host_to_device': round(args.device_ms * 1000.0 / host_us, 2),
+        'calibrated': True,
+        'reference_model': str(args.calibrate),
+        'reference_host_us': host_us,
+        'reference_device_us': args.device_ms * 1000.0,
+        'date': datetime.now().strftime('%Y-%m-%d'),
+    })
+    COST_MODEL_PATH.write_text(json.dumps(cost_model, indent=2) + "\n")
+    print(f"Host {host_us:.1f} us vs device {args.device_ms * 1000:.0f} us: "
+          f"ratio {cost_model['host_to_device']} written to {COST_MODEL_PATH}")
+
+
+def candidate_space(args):
+    grid = [
+        {'conv_widths': list(widths), 'kernel_size': kernel, 'window_size': window, 'features': subset}
+        for widths, kernel, window, subset in itertools.product(
+            CONV_WIDTHS, KERNEL_SIZES, WINDOW_SIZES, FEATURE_SUBSETS)
+    ]
+    if args.candidates and args.candidates < len(grid):
+        rng = np.random.default_rng(args.seed)
+        grid = [grid[i] for i in sorted(rng.choice(len(grid), args.candidates, replace=False))]
+    for i, candidate in enumerate(grid):
+        candidate['id'] = f"c{i:02d}"
+    return grid
+
+
+def load_data(window_sizes, output_dir):
+    """Train/validation/test windows per window size, split by session like train.py."""
+    from src.core.train import TrainingConfig, load_and_prepare_data
+
+    data = {}
+    for window_size in window_sizes:
+        config = TrainingConfig()
+        config.window_size = window_size
+        config.output_dir = output_dir
+        (X_train, X_val, X_test, y_train, y_val, y_test,
+         label_encoder, _) = load_and_prepare_data(config, return_validation=True)
+        data[window_size] = (X_train, X_val, X_test, y_train, y_val, y_test, label_encoder.classes_)
+    return data
+
+
+def int8_accuracy(tflite_path, X, y):
+    """Accuracy of the int8 model itself, since that is what ships."""
+    import tensorflow as tf
+
+    interpreter = tf.lite.Interpreter(model_path=str(tflite_path))
+    interpreter.allocate_tensors()
+    inp, out = interpreter.get_input_details()[0], interpreter.get_output_details()[0]
+    scale, zero_point = inp['quantization']
+    correct = 0
+    for window, target in zip(X, y):
+        q = np.clip(np.round(window / scale) + zero_point, -128, 127).astype(np.int8)
+        interpreter.set_tensor(inp['index'], q[None])
+        interpreter.invoke()
+        correct += int(interpreter.get_tensor(out['index'])[0].argmax() == target.argmax())
+    return correct / max(1, len(X))
+
+
+def _init_worker(data):
+    global _worker_data
+    _worker_data = data
+    import tensorflow as tf
+    # Several candidates train at once; one core each.
+    tf.config.threading.set_intra_op_parallelism_threads(1)
+    tf.config.threading.set_inter_op_parallelism_threads(1)
+
+
+def train_candidate(candidate, run_dir, epochs, calibration_windows):
+    """Train one candidate and write its Keras model and int8 TFLite to run_dir/<id>."""
+    import tensorflow as tf
+    from src.core.model import build_search_cnn, count_macs
+
+    tf.random.set_seed(42)
+    X_train, X_val, _, y_train, y_val, _, classes = _worker_data[candidate['window_size']]
+    mask = [1.0 if i in FEATURE_SUBSETS[candidate['features']] else 0.0 for i in range(X_train.shape[2])]
+
+    model = build_search_cnn(len(classes), candidate['window_size'], X_train.shape[2],
+                             candidate['conv_widths'], candidate['kernel_size'],
+                             feature_mask=mask)
+    model.compile(optimizer=tf.keras.optimizers.Adam(0.001),
+                  loss='categorical_crossentropy', metrics=['accuracy'])
+    model.fit(X_train, y_train, validation_data=(X_val, y_val), epochs=epochs,
+              batch_size=32, verbose=0,
+              callbacks=[tf.keras.callbacks.EarlyStopping(monitor='val_accuracy', patience=6,
+                                                          restore_best_weights=True)])
+    _, accuracy = model.evaluate(X_val, y_val, verbose=0)
+
+    out_dir = run_dir / candidate['id']
+    out_dir.mkdir(parents=True, exist_ok=True)
+    model.save(out_dir / 'final_model.keras')
+    np.save(out_dir / 'label_encoder_classes.npy', classes)
+    (out_dir / 'config.json').write_text(json.dumps({
+        'window_size': candidate['window_size'], 'sample_stride': 1,
+        'conv_widths': candidate['conv_widths'], 'kernel_size': candidate['kernel_size'],
+        'features': candidate['features'], 'model_type': 'search_cnn'}, indent=2))
+
+    rng = np.random.default_rng(42)
+    calib = X_train[rng.choice(len(X_train), min(calibration_windows, len(X_train)), replace=False)]
+
+    def representative_dataset():
+        for window in calib:
+            yield [window[None].astype(np.float32)]
+
+    converter = tf.lite.TFLiteConverter.from_keras_model(model)
+    converter.optimizations = [tf.lite.Optimize.DEFAULT]
+    converter.representative_dataset = representative_dataset
+    converter.target_spec.supported_ops = [tf.lite.OpsSet.TFLITE_BUILTINS_INT8]
+    converter.inference_input_type = tf.int8
+    converter.inference_output_type = tf.int8
+    tflite_path = out_dir / 'model_quantized.tflite'
+    tflite_path.write_bytes(converter.convert())
+
+    return dict(candidate,
+                params=int(model.count_params()),
+                macs=count_macs(model),
+                val_accuracy=float(accuracy),
+                int8_val_accuracy=int8_accuracy(tflite_path, X_val, y_val),
+                tflite=str(tflite_path))
+
+
+def pareto_front(rows):
+    """Rows not dominated on (int8 validation accuracy up, device latency down, arena down)."""
+    def dominates(a, b):
+        better_or_equal = (a['int8_val_accuracy'] >= b['int8_val_accuracy'] and
+                           a['device_ms'] <= b['device_ms'] and
+                           a['arena_bytes'] <= b['arena_bytes'])
+        strictly = (a['int8_val_accuracy'] > b['int8_val_accuracy'] or
+                    a['device_ms'] < b['device_ms'] or
+                    a['arena_bytes'] < b['arena_bytes'])
+        return better_or_equal and strictly
+    return [r for r in rows if not any(dominates(o, r) for o in rows if o is not r)]
+
+
+def search(args):
+    run_dir = SEARCH_BASE / datetime.now().strftime('%Y%m%d_%H%M%S')
+    run_dir.mkdir(parents=True, exist_ok=True)
+    cost_model = load_cost_model()
+    if not cost_model.get('calibrated'):
+        print(f"Note: {COST_MODEL_PATH.name} is not calibrated; device latency uses the default "
+              f"ratio {cost_model['host_to_device']}x (see --calibrate)")
+
+    candidates = candidate_space(args)
+    data = load_data(sorted({c['window_size'] for c in candidates}), run_dir)
+    workers = args.workers or os.cpu_count()
+    print(f"\nTraining {len(candidates)} candidates on {workers} workers -> {run_dir}")
+
+    ctx = multiprocessing.get_context('spawn')  # TensorFlow is not fork-safe
+    with ProcessPoolExecutor(workers, mp_context=ctx, initializer=_init_worker,
+                             initargs=(data,)) as pool:
+        futures = [pool.submit(train_candidate, c, run_dir, args.epochs, args.calibration_windows)
+                   for c in candidates]
+        rows = []
+        for future in futures:
+            row = future.result()
+            rows.append(row)
+            print(f"  {row['id']}: {row['conv_widths']} k{row['kernel_size']} w{row['window_size']} "
+                  f"{row['features']:10s} val acc {row['int8_val_accuracy']:.3f}")
+
+    # Measure after training so timings do not contend with the workers.
+    runner = args.runner or RUNNER
+    if not args.runner:
+        build_runner()
+    arena_budget, costs = bench(runner, [r['tflite'] for r in rows], args.bench_runs,
+                                run_dir / 'bench.json')
+
+    ratio = cost_model['host_to_device']
+    deployable = []
+    for row in rows:
+        cost = costs.get(row['tflite'], {})
+        row['model_bytes'] = cost.get('model_bytes', 0)
+        row['arena_bytes'] = cost.get('arena_bytes', 0)
+        row['host_us'] = cost.get('mean_invoke_us')
+        row['device_ms'] = row['host_us'] * ratio / 1000.0 if row['host_us'] is not None else None
+        # Deployable: runs on the glove's op set, fits its arena and flash
+        # budget, and finishes within one sensor period.
+        row['deployable'] = bool(
+            'error' not in cost and cost.get('fits_arena') and
+            row['model_bytes'] <= args.flash_budget_kb * 1024 and
+            row['device_ms'] <= args.latency_budget_ms)
+        if row['deployable']:
+            deployable.append(row)
+
+    front = sorted(pareto_front(deployable), key=lambda r: r['device_ms'])
+    # Test windows score only the chosen front, never the selection.
+    for row in front:
+        _, _, X_test, _, _, y_test, _ = data[row['window_size']]
+        row['int8_test_accuracy'] = int8_accuracy(row['tflite'], X_test, y_test)
+    results = {
+        'cost_model': cost_model,
+        'budgets': {'arena_bytes': arena_budget, 'flash_kb': args.flash_budget_kb,
+                    'latency_ms': args.latency_budget_ms},
+        'candidates': rows,
+        'pareto': [r['id'] for r in front],
+    }
+    (run_dir / 'search_results.json').write_text(json.dumps(results, indent=2))
+
+    print("\n" + "="*70)
+    print(f"PARETO FRONT ({len(front)} of {len(deployable)} deployable, {len(rows)} trained)")
+    print("="*70)
+    print(f"{'id':4s} {'convs':12s} {'k':>2s} {'win':>4s} {'features':10s} "
+          f"{'val acc':>8s} {'test acc':>8s} {'dev ms':>7s} {'arena KB':>9s} {'model KB':>9s} {'MACs':>8s}")
+    for r in front:
+        print(f"{r['id']:4s} {'x'.join(map(str, r['conv_widths'])):12s} {r['kernel_size']:2d} "
+              f"{r['window_size']:4d} {r['features']:10s} {r['int8_val_accuracy']:8.3f} "
+              f"{r['int8_test_accuracy']:8.3f} "
+              f"{r['device_ms']:7.2f} {r['arena_bytes'] / 1024:9.1f} "
+              f"{r['model_bytes'] / 1024:9.1f} {r['macs']:8d}")
+    print(f"\nResults written to {run_dir / 'search_results.json'}")
+
+
+def promote(candidate_dir):
+    """Copy a candidate into model/ so convert_to_tflite.py picks it up as the latest run."""
+    target = MODEL_BASE / datetime.now().strftime('%Y%m%d_%H%M%S')
+    shutil.copytree(candidate_dir, target)
+    # load_data fitted the IMU normalization once per search run.
+    norm_path = candidate_dir.parent / 'normalization_params.json'
+    if norm_path.exists() and not (target / norm_path.name).exists():
+        shutil.copy(norm_path, target / norm_path.name)
+    print(f"Promoted {candidate_dir} -> {target}; run convert_to_tflite.py next")
+
+
+if __name__ == "__main__":
+    parser = argparse.ArgumentParser(description=__doc__,
+                                     formatter_class=argparse.RawDescriptionHelpFormatter)
+    parser.add_argument('--candidates', type=int, default=24,
+                        help="Random sample of the grid to train (0 = full grid)")
+    parser.add_argument('--workers', type=int, default=0,
+                        help="Training processes (0 = all cores)")
+    parser.add_argument('--epochs', type=int, default=40)
+    parser.add_argument('--seed', type=int, default=42)
+    parser.add_argument('--calibration-windows', type=int, default=300,
+                        help="Training windows fed to the int8 quantizer")
+    parser.add_argument('--bench-runs', type=int, default=200,
+                        help="Invoke() calls timed per model")
+    parser.add_argument('--latency-budget-ms', type=float, default=1000.0 / SENSOR_RATE_HZ,
+                        help="Estimated device latency limit (default: one sensor period)")
+    parser.add_argument('--flash-budget-kb', type=float, default=256.0)
+    parser.add_argument('--runner', type=Path, default=None,
+                        help="Prebuilt asl_host_runner (default: build native_runner with pio)")
+    parser.add_argument('--calibrate', type=Path, default=None,
+                        help=".tflite whose on-device time is given by --device-ms")
+    parser.add_argument('--device-ms', type=float, default=None,
+                        help="Measured 'Inference' avg from the profiler ('O') for --calibrate")
+    parser.add_argument('--promote', type=Path, default=None,
+                        help="Candidate directory to copy into model/")
+    args = parser.parse_args()
+
+    if args.promote:
+        promote(args.promote)
+    elif args.calibrate:
+        if args.device_ms is None:
+            parser.error("--calibrate needs --device-ms")
+        calibrate(args)
+    else:
+        search(args)
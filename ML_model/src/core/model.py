@@ -1,5 +1,6 @@
 """1D CNN model architecture for ASL gesture classification on ESP32."""
 
+import numpy as np
 import tensorflow as tf
 from tensorflow.keras import layers, models, regularizers
 
@@ -163,6 +164,197 @@ def create_model(model_type: str = 'cnn_small',
     return model
 
 
+class ChannelMask(tf.keras.constraints.Constraint):
+    """Zeroes first-layer kernel weights of unused input channels.
+
+    Lets a candidate ignore sensors while keeping the firmware's 11-feature
+    input, so it stays deployable without a new feature layout.
+    """
+
+    def __init__(self, mask):
+        self.mask = [float(m) for m in mask]
+
+    def __call__(self, w):
+        return w * tf.reshape(tf.constant(self.mask, dtype=w.dtype), (1, -1, 1))
+
+    def get_config(self):
+        return {'mask': self.mask}
+
+
+def build_search_cnn(num_classes: int,
+                     window_size: int = 25,
+                     num_features: int = 11,
+                     conv_widths=(16, 32),
+                     kernel_size: int = 3,
+                     dense_units: int = 32,
+                     feature_mask=None,
+                     l2_reg: float = 0.001,
+                     dropout_rate: float = 0.3) -> models.Model:
+    """Parameterized cnn_small for model_search.py: one conv block per width,
+    max-pooling between blocks, global average pooling and a dense head.
+    Uses only ops registered in the firmware's op resolver."""
+    inputs = layers.Input(shape=(window_size, num_features), name='sensor_input')
+    x = inputs
+    for i, width in enumerate(conv_widths):
+        constraint = ChannelMask(feature_mask) if (i == 0 and feature_mask is not None) else None
+        x = layers.Conv1D(width, kernel_size, padding='same',
+                          kernel_regularizer=regularizers.l2(l2_reg),
+                          kernel_constraint=constraint,
+                          name=f'conv1d_{i + 1}')(x)
+        x = layers.BatchNormalization(name=f'bn_{i + 1}')(x)
+        x = layers.Activation('relu', name=f'relu_{i + 1}')(x)
+        if i + 1 < len(conv_widths) and x.shape[1] >= 4:
+            x = layers.MaxPooling1D(2, name=f'maxpool_{i + 1}')(x)
+        x = layers.Dropout(dropout_rate * 0.5, name=f'dropout_{i + 1}')(x)
+
+    x = layers.GlobalAveragePooling1D(name='global_avg_pool')(x)
+    if dense_units:
+        x = layers.Dense(dense_units, activation='relu',
+                         kernel_regularizer=regularizers.l2(l2_reg), name='dense_1')(x)
+        x = layers.Dropout(dropout_rate, name='dropout_head')(x)
+    outputs = layers.Dense(num_classes, activation='softmax', name='output')(x)
+
+    widths = 'x'.join(str(w) for w in conv_widths)
+    return models.Model(inputs=inputs, outputs=outputs, name=f'ASL_CNN_{widths}_k{kernel_size}')
+
+
+def count_macs(model: models.Model) -> int:
+    """Multiply-accumulates per inference of the Conv1D and Dense layers."""
+    macs = 0
+    for layer in model.layers:
+        if isinstance(layer, layers.Conv1D):
+            kernel = layer.kernel.shape
+            macs += int(layer.output.shape[1]) * int(kernel[0]) * int(kernel[1]) * int(kernel[2])
+        elif isinstance(layer, layers.Dense):
+            macs += int(layer.kernel.shape[0]) * int(layer.kernel.shape[1])
+    return macs
+
+
+def prune_conv_channels(model: models.Model, fraction: float) -> models.Model:
+    """Structured pruning: drop the lowest-L1 `fraction` of filters in every Conv1D.
+
+    Returns a physically smaller model (fewer channels, so fewer MACs and a
+    smaller arena on the glove) with the surviving weights copied over. The
+    following BatchNormalization, Conv1D or Dense input rows are sliced to match.
+    Layers must form a single chain, as all builders in this module do.
+    """
+    keep = {}
+    prev_keep = None
+    for layer in model.layers:
+        if isinstance(layer, layers.Conv1D):
+            kernel = layer.get_weights()[0]
+            if prev_keep is not None:
+                kernel = kernel[:, prev_keep, :]
+            n_keep = max(1, int(np.ceil(kernel.shape[2] * (1.0 - fraction))))
+            norms = np.abs(kernel).sum(axis=(0, 1))
+            prev_keep = np.sort(np.argsort(norms)[::-1][:n_keep])
+            keep[layer.name] = prev_keep
+        elif isinstance(layer, layers.Dense):
+            prev_keep = None
+
+    config = model.get_config()
+    for layer_config in config['layers']:
+        if layer_config['class_name'] == 'Conv1D':
+            layer_config['config']['filters'] = int(len(keep[layer_config['config']['name']]))
+    pruned = models.Model.from_config(config, custom_objects={'ChannelMask': ChannelMask})
+
+    prev_keep = None
+    for old, new in zip(model.layers, pruned.layers):
+        weights = old.get_weights()
+        if isinstance(old, layers.Conv1D):
+            kernel = weights[0] if prev_keep is None else weights[0][:, prev_keep, :]
+            prev_keep = keep[old.name]
+            weights = [kernel[:, :, prev_keep]] + [w[prev_keep] for w in weights[1:]]
+        elif isinstance(old, layers.BatchNormalization) and prev_keep is not None:
+            weights = [w[prev_keep] for w in weights]
+        elif isinstance(old, layers.Dense):
+            if prev_keep is not None:
+                weights = [weights[0][prev_keep, :]] + weights[1:]
+            prev_keep = None
+        new.set_weights(weights)
+    return pruned
+
+
+def quantize_aware(model: models.Model) -> models.Model:
+    """Wrap a model for quantization-aware training (tensorflow-model-optimization).
+
+    Layers the default 8-bit scheme cannot wrap are left float during
+    fine-tuning; the converter still quantizes them post-training.
+    """
+    import tensorflow_model_optimization as tfmot
+
+    quantize = tfmot.quantization.keras
+    try:
+        return quantize.quantize_model(model)
+    except (RuntimeError, ValueError) as err:
+        print(f"QAT: whole-model wrap failed ({err}); annotating supported layers only")
+
+    def annotate(layer):
+        if isinstance(layer, (layers.Conv1D, layers.Dense)):
+            return quantize.quantize_annotate_layer(layer)
+        return layer.__class__.from_config(layer.get_config())
+
+    annotated = tf.keras.models.clone_model(model, clone_function=annotate)
+    annotated.set_weights(model.get_weights())
+    with quantize.quantize_scope({'ChannelMask': ChannelMask}):
+        return quantize.quantize_apply(annotated)
+
+
+def summary_features(windows: np.ndarray) -> np.ndarray:
+    """Per-channel mean then std over time, [N, T, F] -> [N, 2F].
+
+    Matches the sums ASLInferenceEngine gathers while filling its input tensor.
+    """
+    windows = np.asarray(windows, dtype=np.float32)
+    return np.concatenate([windows.mean(axis=1), windows.std(axis=1)], axis=1)
+
+
+def build_gate_model(num_features: int = 11, l2_reg: float = 0.001) -> models.Model:
+    """Logistic neutral-vs-gesture gate on window summary features."""
+    inputs = layers.Input(shape=(2 * num_features,), name='summary_input')
+    outputs = layers.Dense(1, activation='sigmoid',
+                           kernel_regularizer=regularizers.l2(l2_reg),
+                           name='gate')(inputs)
+    return models.Model(inputs=inputs, outputs=outputs, name='ASL_Gate')
+
+
+def train_gate(windows: np.ndarray, is_gesture: np.ndarray, recall: float = 0.98,
+               epochs: int = 200, verbose: bool = True):
+    """Fit the gate and pick the threshold that keeps `recall` of gesture windows.
+
+    Returns (gate_model, threshold).
+    """
+    features = summary_features(windows)
+    is_gesture = np.asarray(is_gesture, dtype=np.float32)
+    gate = build_gate_model(windows.shape[2])
+    gate.compile(optimizer=tf.keras.optimizers.Adam(0.01), loss='binary_crossentropy',
+                 metrics=['accuracy'])
+    gate.fit(features, is_gesture, epochs=epochs, batch_size=256, verbose=0,
+             class_weight={0: 0.5 / max(1.0 - is_gesture.mean(), 1e-3),
+                           1: 0.5 / max(is_gesture.mean(), 1e-3)})
+
+    probs = gate.predict(features, verbose=0)[:, 0]
+    gesture_probs = np.sort(probs[is_gesture > 0.5])
+    threshold = float(gesture_probs[int((1.0 - recall) * len(gesture_probs))]) if len(gesture_probs) else 0.5
+    if verbose:
+        skip = float(np.mean(probs < threshold))
+        print(f"Gate: threshold {threshold:.3f}, skips {skip:.1%} of windows "
+              f"({np.mean(probs[is_gesture < 0.5] < threshold):.1%} of neutral), "
+              f"gesture recall {np.mean(probs[is_gesture > 0.5] >= threshold):.1%}")
+    return gate, threshold
+
+
+def export_gate(gate: models.Model, threshold: float) -> dict:
+    """Gate weights in the layout model_package.py writes into <name>_config.h."""
+    kernel, bias = gate.get_layer('gate').get_weights()
+    return {
+        'features': 'mean,std',
+        'weights': [float(w) for w in kernel[:, 0]],
+        'bias': float(bias[0]),
+        'threshold': float(threshold),
+    }
+
+
 if __name__ == "__main__":
     print("Testing model architectures...\n")
     for model_type in ['cnn_small', 'cnn_medium', 'dense']:
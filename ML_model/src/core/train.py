@@ -3,6 +3,8 @@
 import os
 os.environ['TF_CPP_MIN_LOG_LEVEL'] = '2'  # Reduce TF logging
 
+from concurrent.futures import ProcessPoolExecutor
+
 import numpy as np
 import pandas as pd
 import tensorflow as tf
@@ -16,10 +18,18 @@ import json
 from datetime import datetime
 
 try:
-    from .model import create_model
+    from .model import (count_macs, create_model, export_gate, prune_conv_channels,
+                        quantize_aware, summary_features, train_gate)
+    from ..data_processing.data_preprocessing import FLEX_COLUMNS, IMU_COLUMNS
+    from ..data_processing.session_store import SessionStore, signer_id
 except ImportError:
     # Allow running as standalone script (python train.py)
-    from model import create_model
+    import sys
+    sys.path.insert(0, str(Path(__file__).parent.parent / 'data_processing'))
+    from model import (count_macs, create_model, export_gate, prune_conv_channels,
+                       quantize_aware, summary_features, train_gate)
+    from data_preprocessing import FLEX_COLUMNS, IMU_COLUMNS
+    from session_store import SessionStore, signer_id
 
 
 class TrainingConfig:
@@ -27,9 +37,13 @@ class TrainingConfig:
 
     def __init__(self):
         # Data parameters
-        self.window_size = 25  # 500ms at 50Hz
+        self.window_size = 25  # frames per window
+        self.sample_stride = 1  # sensor samples per frame: 1 = 50Hz, 2 = 25Hz
         self.num_features = 11  # 5 flex + 6 IMU
         self.test_size = 0.2  # 80/20 split
+        self.split_mode = 'session'  # 'session', 'person' (leave-signer-out) or 'sequence'
+        self.test_persons = None  # held-out signers for 'person' (None = last signer)
+        self.val_persons = None  # validation signers for 'person' (None = last training signer)
         self.random_seed = 42
 
         # Model parameters
@@ -50,13 +64,37 @@ class TrainingConfig:
         self.aug_noise_level = 0.01  # Gaussian noise std
         self.aug_scale_range = (0.95, 1.05)  # Scaling factor range
         self.aug_time_jitter = 2  # Max samples to shift
+        self.aug_on_the_fly = True  # augment per batch in tf.data instead of materializing copies
+        self.aug_workers = 1  # processes for materialized augmentation (0 = all cores)
 
         # Class imbalance handling
         self.use_class_weights = True
 
+        # Compression after training (exported through the same firmware codegen)
+        self.prune_fraction = 0.0  # fraction of filters removed per Conv1D (0 = off)
+        self.prune_finetune_epochs = 20
+        self.use_qat = False  # quantization-aware fine-tuning (tensorflow-model-optimization)
+        self.qat_epochs = 10
+        self.qat_learning_rate = 1e-4
+
+        # Neutral-vs-gesture gate exported with the model (skips the CNN at rest)
+        self.train_gate = True
+        self.neutral_labels = ['NEUTRAL']
+        self.gate_recall = 0.98  # fraction of gesture windows the gate must pass
+
         # Paths
         self.project_root = Path(__file__).parent.parent.parent
-        self.data_file = self.project_root / 'data' / 'combined_dataset.csv'
+        # Sessions are ingested incrementally into session_store and read via
+        # mmap. Set data_file to a combined CSV to train from that instead.
+        self.raw_data_dir = self.project_root.parent / 'python' / 'data_logs'
+        self.session_store = self.project_root / 'data' / 'sessions'
+        self.session_labels = None  # restrict to these labels (None = all)
+        # Sign sessions train on their active repetitions (gesture segmenter);
+        # this fixed trim cuts rest-label sessions and any repetition end the
+        # segmenter did not see.
+        self.trim_start = 40
+        self.trim_end = 15
+        self.data_file = None
         self.output_dir = self.project_root / 'model' / datetime.now().strftime('%Y%m%d_%H%M%S')
 
     def save(self, filepath: str):
@@ -67,68 +105,219 @@ class TrainingConfig:
             json.dump(config_dict, f, indent=2)
 
 
-def load_and_prepare_data(config: TrainingConfig):
-    """Load CSV data with sequence-based split to prevent data leakage."""
-    print("\n" + "="*70)
-    print("LOADING DATA (SEQUENCE-BASED SPLIT)")
-    print("="*70)
+def load_sessions_csv(config: TrainingConfig):
+    """Sessions from a combined (already normalized) CSV.
 
-    # Load dataset
+    Rows are grouped by the 'session' column written by create_combined_dataset,
+    and within a session into segments by its 'rep_id'; older CSVs without them
+    yield one pseudo-session (and segment) per label.
+    """
     df = pd.read_csv(config.data_file)
-    print(f"Loaded {len(df)} samples from {config.data_file.name}")
-    print(f"Columns: {list(df.columns)}")
+    print(f"Loaded {len(df)} samples from {Path(config.data_file).name}")
 
-    # Extract features
     feature_cols = ['flex1', 'flex2', 'flex3', 'flex4', 'flex5',
                    'ax', 'ay', 'az', 'gx', 'gy', 'gz']
+    group_col = 'session' if 'session' in df.columns else 'target'
+    sessions = []
+    for name, group in df.groupby(group_col, sort=True):
+        segments = ([part[feature_cols].to_numpy(dtype=np.float32)
+                     for _, part in group.groupby('rep_id', sort=True)]
+                    if 'rep_id' in group.columns else [group[feature_cols].to_numpy(dtype=np.float32)])
+        sessions.append({
+            'file': str(name),
+            'signer': (signer_id(str(group['person_id'].iloc[0]), str(group['target'].iloc[0]))
+                       if 'person_id' in group.columns else 'unknown'),
+            'label': str(group['target'].iloc[0]),
+            'segments': segments,
+        })
+    return sessions, None
+
+
+def load_sessions_store(config: TrainingConfig):
+    """Raw (un-normalized) session segments from the store, ingesting new CSVs first."""
+    store = SessionStore(config.session_store)
+    store.ingest(config.raw_data_dir)
+    records = store.sessions(labels=config.session_labels)
+    if not records:
+        raise ValueError(f"No sessions in {config.session_store}")
+
+    sessions = [dict(record, record=record,
+                     segments=store.segments(record, config.trim_start, config.trim_end))
+                for record in records]
+    print(f"Loaded {len(sessions)} sessions, {sum(len(seg) for s in sessions for seg in s['segments'])} "
+          f"samples in {sum(len(s['segments']) for s in sessions)} segments "
+          f"from {len({s['signer'] for s in sessions})} signer(s) in the session store")
+    return sessions, store
+
+
+def split_within_session(segments, config: TrainingConfig):
+    """Split one session's segments in time into (train, test) segment lists.
+
+    With several repetitions the last test_size of them are held out. A single
+    segment gives its first (1 - test_size) for training and the tail for
+    testing, with a purge gap of one window span so no test window overlaps a
+    training window.
+    """
+    if len(segments) > 1:
+        n_test = max(1, int(round(config.test_size * len(segments))))
+        return segments[:-n_test], segments[-n_test:]
+    gap = config.window_size * config.sample_stride
+    train, test = [], []
+    for features in segments:
+        split_idx = int(len(features) * (1 - config.test_size))
+        train.append(features[:max(0, split_idx - gap)])
+        test.append(features[split_idx:])
+    return train, test
+
+
+def split_sessions(sessions, config: TrainingConfig):
+    """Assign whole sessions (or parts of them) to train and test.
+
+    split_mode:
+      'sequence' - every session split in time (legacy behaviour, now with a gap)
+      'session'  - whole recordings held out per label; labels with a single
+                   recording fall back to the in-session split
+      'person'   - all recordings of config.test_persons held out (leave-signer-out)
+    Returns (train_parts, test_parts), lists of (session, segments).
+    """
+    rng = np.random.default_rng(config.random_seed)
+    train_parts, test_parts = [], []
+
+    if config.split_mode == 'person':
+        persons = sorted({s['signer'] for s in sessions})
+        test_persons = config.test_persons or persons[-1:]
+        if not set(test_persons) & set(persons) or set(persons) <= set(test_persons):
+            raise ValueError(f"Person split needs held-out and training signers; "
+                             f"have {persons}, test_persons={test_persons}")
+        for session in sessions:
+            target = test_parts if session['signer'] in test_persons else train_parts
+            target.append((session, session['segments']))
+        print(f"Held-out signers: {', '.join(test_persons)}")
+        return train_parts, test_parts
+
+    by_label = {}
+    for session in sessions:
+        by_label.setdefault(session['label'], []).append(session)
+
+    for label, label_sessions in sorted(by_label.items()):
+        if config.split_mode == 'session' and len(label_sessions) > 1:
+            order = rng.permutation(len(label_sessions))
+            n_test = max(1, int(round(config.test_size * len(label_sessions))))
+            for rank, idx in enumerate(order):
+                session = label_sessions[idx]
+                (test_parts if rank < n_test else train_parts).append((session, session['segments']))
+        elif config.split_mode in ('session', 'sequence'):
+            for session in label_sessions:
+                train_seq, test_seq = split_within_session(session['segments'], config)
+                train_parts.append((session, train_seq))
+                test_parts.append((session, test_seq))
+        else:
+            raise ValueError(f"Unknown split_mode: {config.split_mode}")
+    return train_parts, test_parts
+
+
+def split_validation(train_parts, config: TrainingConfig):
+    """Carve a validation set out of the training parts, so the test parts are
+    only seen by the final evaluation.
+
+    A 'person' split with two or more training signers validates on
+    config.val_persons (default: the last of them); otherwise each training
+    session is split in time like split_within_session.
+    Returns (train_parts, val_parts).
+    """
+    persons = sorted({s['signer'] for s, _ in train_parts})
+    if config.split_mode == 'person' and len(persons) > 1:
+        val_persons = config.val_persons or persons[-1:]
+        if not set(val_persons) & set(persons) or set(persons) <= set(val_persons):
+            raise ValueError(f"Validation needs signers left to train on; "
+                             f"have {persons}, val_persons={val_persons}")
+        print(f"Validation signers: {', '.join(val_persons)}")
+        return ([p for p in train_parts if p[0]['signer'] not in val_persons],
+                [p for p in train_parts if p[0]['signer'] in val_persons])
+
+    train, val = [], []
+    for session, segments in train_parts:
+        train_seq, val_seq = split_within_session(segments, config)
+        train.append((session, train_seq))
+        val.append((session, val_seq))
+    print(f"Validation: last {config.test_size:.0%} of each training session")
+    return train, val
+
+
+def windows_from_parts(parts, config: TrainingConfig, normalize=None):
+    """Window every segment of every part (after decimation to the model rate);
+    labels per window. Windows never span two segments."""
+    windows_list, labels_list = [], []
+    for session, segments in parts:
+        for features in segments:
+            if normalize is not None:
+                features = normalize(session, features)
+            # Decimate to the model rate the same way the firmware engine does
+            samples = features[config.sample_stride - 1::config.sample_stride]
+            if len(samples) < config.window_size:
+                continue
+            windows = create_windows(samples, config.window_size)
+            windows_list.append(windows)
+            labels_list.extend([session['label']] * len(windows))
+    if not windows_list:
+        return np.empty((0, config.window_size, config.num_features), np.float32), np.array([])
+    return np.concatenate(windows_list, axis=0), np.array(labels_list)
+
+
+def load_and_prepare_data(config: TrainingConfig, return_validation=False):
+    """Load sessions and split them by session/person so no window leaks into the test set.
+
+    With return_validation, also returns validation windows (X_val and y_val
+    after X_train and y_train), drawn from the training sessions by
+    split_validation, for early stopping and model selection.
+    """
+    print("\n" + "="*70)
+    print(f"LOADING DATA ({config.split_mode.upper()} SPLIT)")
+    print("="*70)
 
-    # Group by target class to split sequences
-    print(f"\nSplitting sequences by class (train/test = {(1-config.test_size)*100:.0f}/{config.test_size*100:.0f})...")
-
-    train_windows_list = []
-    train_labels_list = []
-    test_windows_list = []
-    test_labels_list = []
-
-    # Get unique labels and sort for consistency
-    unique_labels = sorted(df['target'].unique())
-
+    if config.data_file is not None:
+        sessions, store = load_sessions_csv(config)
+    else:
+        sessions, store = load_sessions_store(config)
+    unique_labels = sorted({s['label'] for s in sessions})
+
+    train_parts, test_parts = split_sessions(sessions, config)
+    val_parts = None
+    if return_validation:
+        train_parts, val_parts = split_validation(train_parts, config)
+
+    normalize = None
+    if store is not None:
+        # Fit IMU normalization on training sessions only, then apply everywhere.
+        train_records = list({id(s): s['record'] for s, _ in train_parts}.values())
+        normalizer = store.fit_normalizer(train_records, config.trim_start, config.trim_end)
+        config.output_dir.mkdir(parents=True, exist_ok=True)
+        normalizer.save_params(str(config.output_dir / 'normalization_params.json'))
+        mean = np.array([normalizer.params[c]['mean'] for c in IMU_COLUMNS], dtype=np.float32)
+        std = np.array([normalizer.params[c]['std'] for c in IMU_COLUMNS], dtype=np.float32)
+
+        def normalize(session, features):
+            features = np.array(features, dtype=np.float32)
+            features[:, len(FLEX_COLUMNS):] = (features[:, len(FLEX_COLUMNS):] - mean) / std
+            return features
+
+    X_train, y_train_labels = windows_from_parts(train_parts, config, normalize)
+    X_test, y_test_labels = windows_from_parts(test_parts, config, normalize)
+    if val_parts is not None:
+        X_val, y_val_labels = windows_from_parts(val_parts, config, normalize)
+
+    print(f"\nSplit (train/test):")
     for label in unique_labels:
-        # Get all samples for this class
-        class_df = df[df['target'] == label].reset_index(drop=True)
-        class_samples = class_df[feature_cols].values
-
-        # Split sequence: first 80% for train, last 20% for test
-        split_idx = int(len(class_samples) * (1 - config.test_size))
-
-        train_seq = class_samples[:split_idx]
-        test_seq = class_samples[split_idx:]
-
-        # Create windows from train sequence
-        if len(train_seq) >= config.window_size:
-            train_windows = create_windows(train_seq, config.window_size)
-            train_windows_list.append(train_windows)
-            train_labels_list.extend([label] * len(train_windows))
-
-        # Create windows from test sequence
-        if len(test_seq) >= config.window_size:
-            test_windows = create_windows(test_seq, config.window_size)
-            test_windows_list.append(test_windows)
-            test_labels_list.extend([label] * len(test_windows))
-
-        print(f"  {label:10s}: {len(class_samples):4d} samples → "
-              f"train: {len(train_seq):4d} → {len(train_windows) if len(train_seq) >= config.window_size else 0:4d} windows, "
-              f"test: {len(test_seq):4d} → {len(test_windows) if len(test_seq) >= config.window_size else 0:4d} windows")
-
-    # Concatenate all windows
-    X_train = np.concatenate(train_windows_list, axis=0)
-    X_test = np.concatenate(test_windows_list, axis=0)
-    y_train_labels = np.array(train_labels_list)
-    y_test_labels = np.array(test_labels_list)
+        n_train_sessions = len({s['file'] for s, f in train_parts if s['label'] == label})
+        n_test_sessions = len({s['file'] for s, f in test_parts if s['label'] == label})
+        print(f"  {label:10s}: sessions {n_train_sessions:2d}/{n_test_sessions:2d}, "
+              f"windows {int(np.sum(y_train_labels == label)):5d}/{int(np.sum(y_test_labels == label)):5d}")
 
     print(f"\nTotal windows:")
     print(f"  Train: {len(X_train)} windows")
     print(f"  Test:  {len(X_test)} windows")
+    if val_parts is not None:
+        print(f"  Val:   {len(X_val)} windows (from training sessions)")
 
     # Encode labels
     label_encoder = LabelEncoder()
@@ -156,16 +345,19 @@ def load_and_prepare_data(config: TrainingConfig):
     for cls, count in zip(label_encoder.classes_[unique], counts):
         print(f"  {cls:10s}: {count:4d} windows")
 
-    return X_train, X_test, y_train_categorical, y_test_categorical, label_encoder, num_classes
+    if not return_validation:
+        return X_train, X_test, y_train_categorical, y_test_categorical, label_encoder, num_classes
+    y_val_categorical = tf.keras.utils.to_categorical(label_encoder.transform(y_val_labels), num_classes)
+    return (X_train, X_val, X_test, y_train_categorical, y_val_categorical, y_test_categorical,
+            label_encoder, num_classes)
 
 
 def create_windows(data, window_size):
-    """Create sliding windows from flat sequential data."""
-    n_samples = len(data)
-    n_windows = n_samples - window_size + 1
+    """Create sliding windows from flat sequential data, [N, F] -> [N - W + 1, W, F].
 
-    windows = np.array([data[i:i+window_size] for i in range(n_windows)])
-    return windows
+    Returns a strided view; copy (or concatenate) it before writing to it.
+    """
+    return np.lib.stride_tricks.sliding_window_view(data, window_size, axis=0).transpose(0, 2, 1)
 
 
 def shuffle_train_data(X_train, y_train, random_seed=42):
@@ -175,56 +367,121 @@ def shuffle_train_data(X_train, y_train, random_seed=42):
     return X_train[indices], y_train[indices]
 
 
-def augment_window(window, config: TrainingConfig):
-    """Apply data augmentation to a single window."""
-    aug_window = window.copy()
+def jitter_indices(shifts, window_size):
+    """Per-window time indices for jitter: shift by `shifts` and pad by wrapping the tail.
+
+    A shift j > 0 drops the first j frames and repeats the last j; j < 0 drops
+    the last |j| frames and repeats the first |j|.
+    """
+    t = np.arange(window_size)[None, :]
+    j = shifts[:, None]
+    k = np.abs(j)
+    forward = np.where(t < window_size - k, t + k, t)
+    backward = np.where(t < window_size - k, t, t - (window_size - k))
+    return np.where(j >= 0, forward, backward)
+
+
+def augment_batch(X, config: TrainingConfig, rng=None):
+    """Apply noise, scaling and time jitter to a batch of windows [N, W, F].
+
+    Each window gets each augmentation independently (noise 50%, scale 50%,
+    jitter 30%), as augment_window did one window at a time.
+    """
+    rng = rng if rng is not None else np.random.default_rng()
+    n, window_size, _ = X.shape
+    X = X.astype(np.float32, copy=True)
 
     # 1. Add Gaussian noise
-    if np.random.rand() < 0.5:
-        noise = np.random.normal(0, config.aug_noise_level, window.shape)
-        aug_window = aug_window + noise
+    noisy = rng.random(n) < 0.5
+    X[noisy] += rng.normal(0, config.aug_noise_level, X[noisy].shape).astype(np.float32)
 
     # 2. Scale features (simulate sensor variation)
-    if np.random.rand() < 0.5:
-        scale = np.random.uniform(*config.aug_scale_range)
-        aug_window = aug_window * scale
+    scales = np.where(rng.random(n) < 0.5, rng.uniform(*config.aug_scale_range, n), 1.0)
+    X *= scales[:, None, None].astype(np.float32)
 
     # 3. Time jittering (shift window slightly)
-    if np.random.rand() < 0.3 and config.aug_time_jitter > 0:
-        jitter = np.random.randint(-config.aug_time_jitter, config.aug_time_jitter + 1)
-        if jitter > 0:
-            aug_window = np.concatenate([aug_window[jitter:], aug_window[-jitter:]], axis=0)
-        elif jitter < 0:
-            aug_window = np.concatenate([aug_window[:jitter], aug_window[:abs(jitter)]], axis=0)
+    if config.aug_time_jitter > 0:
+        shifts = rng.integers(-config.aug_time_jitter, config.aug_time_jitter + 1, n)
+        shifts[rng.random(n) >= 0.3] = 0
+        X = np.take_along_axis(X, jitter_indices(shifts, window_size)[:, :, None], axis=1)
+
+    return X
+
 
-    return aug_window
+def _augment_chunk(args):
+    X, config, seed = args
+    return augment_batch(X, config, np.random.default_rng(seed))
 
 
 def augment_data(X, y, config: TrainingConfig, augmentation_factor=0.5):
-    """Augment training data to reduce overfitting."""
+    """Augment training data to reduce overfitting (materializes the copies)."""
     print(f"\nApplying data augmentation (factor={augmentation_factor})...")
 
+    rng = np.random.default_rng(config.random_seed)
     n_augment = int(len(X) * augmentation_factor)
-    aug_indices = np.random.choice(len(X), n_augment, replace=False)
+    aug_indices = rng.choice(len(X), n_augment, replace=False)
 
-    X_aug_list = []
-    y_aug_list = []
+    workers = config.aug_workers or os.cpu_count() or 1
+    if workers > 1 and n_augment > workers:
+        chunks = np.array_split(aug_indices, workers)
+        seeds = rng.integers(0, 2**31, len(chunks))
+        with ProcessPoolExecutor(max_workers=workers) as pool:
+            X_aug = np.concatenate(list(pool.map(
+                _augment_chunk, [(X[c], config, seed) for c, seed in zip(chunks, seeds)])))
+    else:
+        X_aug = augment_batch(X[aug_indices], config, rng)
 
-    for idx in aug_indices:
-        aug_window = augment_window(X[idx], config)
-        X_aug_list.append(aug_window)
-        y_aug_list.append(y[idx])
-
-    X_augmented = np.concatenate([X, np.array(X_aug_list)], axis=0)
-    y_augmented = np.concatenate([y, np.array(y_aug_list)], axis=0)
+    X_augmented = np.concatenate([X, X_aug], axis=0)
+    y_augmented = np.concatenate([y, y[aug_indices]], axis=0)
 
     print(f"  Original: {len(X)} samples")
-    print(f"  Augmented: {len(X_aug_list)} samples")
+    print(f"  Augmented: {len(X_aug)} samples ({workers} worker{'s' if workers > 1 else ''})")
     print(f"  Total: {len(X_augmented)} samples")
 
     return X_augmented, y_augmented
 
 
+def tf_augment_batch(X, config: TrainingConfig):
+    """tf.data counterpart of augment_batch for a batch tensor [B, W, F]."""
+    batch = tf.shape(X)[0]
+    window_size = X.shape[1]
+
+    # 1. Add Gaussian noise
+    noisy = tf.cast(tf.random.uniform([batch, 1, 1]) < 0.5, X.dtype)
+    X = X + noisy * tf.random.normal(tf.shape(X), stddev=config.aug_noise_level, dtype=X.dtype)
+
+    # 2. Scale features (simulate sensor variation)
+    low, high = config.aug_scale_range
+    scales = tf.where(tf.random.uniform([batch]) < 0.5,
+                      tf.random.uniform([batch], low, high), tf.ones([batch]))
+    X = X * tf.cast(scales, X.dtype)[:, None, None]
+
+    # 3. Time jittering (shift window slightly)
+    if config.aug_time_jitter > 0:
+        shifts = tf.random.uniform([batch], -config.aug_time_jitter, config.aug_time_jitter + 1,
+                                   dtype=tf.int32)
+        shifts = tf.where(tf.random.uniform([batch]) < 0.3, shifts, tf.zeros_like(shifts))
+        t = tf.range(window_size)[None, :]
+        j = shifts[:, None]
+        k = tf.abs(j)
+        forward = tf.where(t < window_size - k, t + k, t)
+        backward = tf.where(t < window_size - k, t, t - (window_size - k))
+        X = tf.gather(X, tf.where(j >= 0, forward, backward), batch_dims=1)
+
+    return X
+
+
+def make_train_dataset(X, y, config: TrainingConfig):
+    """Shuffled, batched tf.data pipeline that augments every batch on the fly."""
+    dataset = tf.data.Dataset.from_tensor_slices((X.astype(np.float32), y.astype(np.float32)))
+    dataset = dataset.shuffle(len(X), seed=config.random_seed, reshuffle_each_iteration=True)
+    dataset = dataset.batch(config.batch_size)
+    if config.use_augmentation:
+        dataset = dataset.map(lambda x, labels: (tf_augment_batch(x, config), labels),
+                              num_parallel_calls=tf.data.AUTOTUNE)
+    return dataset.prefetch(tf.data.AUTOTUNE)
+
+
 def compute_class_weights_dict(y_train, num_classes):
     """Compute class weights to handle imbalanced dataset."""
     y_train_labels = y_train.argmax(axis=1)
@@ -242,9 +499,15 @@ def compute_class_weights_dict(y_train, num_classes):
     return class_weight_dict
 
 
-def create_callbacks(config: TrainingConfig):
-    """Create training callbacks for early stopping, LR reduction, and checkpointing."""
+def create_callbacks(config: TrainingConfig, stage=None):
+    """Create training callbacks for early stopping, LR reduction, and checkpointing.
+
+    A compression stage ('pruned', 'qat') checkpoints to <stage>_best_model.keras
+    and logs under logs/<stage>, so it never overwrites the trained best_model.keras.
+    """
     config.output_dir.mkdir(parents=True, exist_ok=True)
+    checkpoint_name = f'{stage}_best_model.keras' if stage else 'best_model.keras'
+    log_dir = config.output_dir / 'logs' / stage if stage else config.output_dir / 'logs'
 
     callback_list = [
         # Early stopping
@@ -266,7 +529,7 @@ def create_callbacks(config: TrainingConfig):
 
         # Model checkpoint
         callbacks.ModelCheckpoint(
-            filepath=str(config.output_dir / 'best_model.keras'),
+            filepath=str(config.output_dir / checkpoint_name),
             monitor='val_accuracy',
             save_best_only=True,
             verbose=1
@@ -274,7 +537,7 @@ def create_callbacks(config: TrainingConfig):
 
         # TensorBoard logging
         callbacks.TensorBoard(
-            log_dir=str(config.output_dir / 'logs'),
+            log_dir=str(log_dir),
             histogram_freq=1
         )
     ]
@@ -382,7 +645,8 @@ def evaluate_model(model, X_test, y_test, label_encoder, output_dir):
     # Confusion matrix
     from sklearn.metrics import confusion_matrix, classification_report
 
-    cm = confusion_matrix(y_true_classes, y_pred_classes)
+    cm = confusion_matrix(y_true_classes, y_pred_classes,
+                          labels=np.arange(len(label_encoder.classes_)))
 
     # Plot confusion matrix
     plt.figure(figsize=(14, 12))
@@ -399,7 +663,8 @@ def evaluate_model(model, X_test, y_test, label_encoder, output_dir):
 
     # Classification report
     report = classification_report(y_true_classes, y_pred_classes,
-                                   target_names=label_encoder.classes_)
+                                   labels=np.arange(len(label_encoder.classes_)),
+                                   target_names=label_encoder.classes_, zero_division=0)
     print("\nClassification Report:")
     print(report)
 
@@ -410,20 +675,94 @@ def evaluate_model(model, X_test, y_test, label_encoder, output_dir):
     return results
 
 
-def train():
+def compress_model(model, fit_data, X_val, y_val, class_weights, config: TrainingConfig):
+    """Structured channel pruning and/or QAT fine-tuning of a trained model.
+
+    The uncompressed model is kept as baseline_model.keras, each fine-tune
+    checkpoints to its own file (create_callbacks stage), and compression.json
+    records parameter/MAC deltas; convert_to_tflite.py adds int8 size and
+    host-measured arena/latency deltas against it.
+    """
+    baseline = model
+    baseline.save(config.output_dir / 'baseline_model.keras')
+    report = {'baseline': {'params': int(baseline.count_params()), 'macs': count_macs(baseline)}}
+
+    if config.prune_fraction > 0:
+        print("\n" + "="*70)
+        print(f"PRUNING {config.prune_fraction:.0%} OF CONV CHANNELS")
+        print("="*70)
+        model = prune_conv_channels(model, config.prune_fraction)
+        model = compile_model(model, config)
+        model.fit(**fit_data, validation_data=(X_val, y_val),
+                  epochs=config.prune_finetune_epochs, class_weight=class_weights,
+                  callbacks=create_callbacks(config, stage='pruned'), verbose=1)
+        report['pruned'] = {'params': int(model.count_params()), 'macs': count_macs(model),
+                            'fraction': config.prune_fraction}
+
+    if config.use_qat:
+        print("\n" + "="*70)
+        print("QUANTIZATION-AWARE TRAINING")
+        print("="*70)
+        model = quantize_aware(model)
+        learning_rate = config.learning_rate
+        config.learning_rate = config.qat_learning_rate
+        model = compile_model(model, config)
+        config.learning_rate = learning_rate
+        model.fit(**fit_data, validation_data=(X_val, y_val),
+                  epochs=config.qat_epochs, class_weight=class_weights,
+                  callbacks=create_callbacks(config, stage='qat'), verbose=1)
+        report['qat'] = True
+
+    final = report.get('pruned', report['baseline'])
+    print(f"\nParams {report['baseline']['params']:,} -> {final['params']:,}, "
+          f"MACs {report['baseline']['macs']:,} -> {final['macs']:,}"
+          f"{' (QAT)' if config.use_qat else ''}")
+    with open(config.output_dir / 'compression.json', 'w') as f:
+        json.dump(report, f, indent=2)
+    return model
+
+
+def train_and_save_gate(X_train, y_train, X_test, y_test, label_encoder, config: TrainingConfig):
+    """Fit the neutral-vs-gesture gate on the same windows and save gate.json."""
+    print("\n" + "="*70)
+    print("TRAINING GATE")
+    print("="*70)
+
+    neutral = [i for i, c in enumerate(label_encoder.classes_) if str(c) in config.neutral_labels]
+    if not neutral:
+        print("No neutral class in the dataset, skipping gate")
+        return None
+
+    train_gesture = ~np.isin(y_train.argmax(axis=1), neutral)
+    gate, threshold = train_gate(X_train, train_gesture, recall=config.gate_recall)
+
+    test_gesture = ~np.isin(y_test.argmax(axis=1), neutral)
+    test_probs = gate.predict(summary_features(X_test), verbose=0)[:, 0]
+    print(f"Test: skips {np.mean(test_probs < threshold):.1%} of windows, "
+          f"gesture recall {np.mean(test_probs[test_gesture] >= threshold):.1%}")
+
+    gate_path = config.output_dir / 'gate.json'
+    with open(gate_path, 'w') as f:
+        json.dump(export_gate(gate, threshold), f, indent=2)
+    print(f"Gate saved to {gate_path}")
+    return gate
+
+
+def train(config: TrainingConfig = None):
     """Main training function."""
     print("\n" + "="*70)
     print("ASL GLOVE CNN TRAINING")
     print("="*70)
 
     # Configuration
-    config = TrainingConfig()
+    config = config or TrainingConfig()
 
     # Load data with sequence-based split (prevents data leakage)
-    X_train, X_test, y_train, y_test, label_encoder, num_classes = load_and_prepare_data(config)
+    (X_train, X_val, X_test, y_train, y_val, y_test,
+     label_encoder, num_classes) = load_and_prepare_data(config, return_validation=True)
 
-    # Apply data augmentation
-    if config.use_augmentation:
+    # Apply data augmentation (materialized copies unless tf.data does it per batch)
+    if config.use_augmentation and not config.aug_on_the_fly:
         X_train, y_train = augment_data(X_train, y_train, config, augmentation_factor=0.5)
 
     # Shuffle training data for better batch diversity
@@ -463,10 +802,14 @@ def train():
     print("TRAINING")
     print("="*70)
 
+    if config.aug_on_the_fly:
+        fit_data = {'x': make_train_dataset(X_train, y_train, config)}
+    else:
+        fit_data = {'x': X_train, 'y': y_train, 'batch_size': config.batch_size}
+
     history = model.fit(
-        X_train, y_train,
-        validation_data=(X_test, y_test),
-        batch_size=config.batch_size,
+        **fit_data,
+        validation_data=(X_val, y_val),
         epochs=config.epochs,
         class_weight=class_weights,
         callbacks=callback_list,
@@ -476,8 +819,11 @@ def train():
     # Plot history
     plot_training_history(history, config.output_dir)
 
+    if config.prune_fraction > 0 or config.use_qat:
+        model = compress_model(model, fit_data, X_val, y_val, class_weights, config)
+
     # Evaluate
-    evaluate_model(model, X_test, y_test, label_encoder, config.output_dir)
+    config.test_results = evaluate_model(model, X_test, y_test, label_encoder, config.output_dir)
 
     # Save final model
     model.save(config.output_dir / 'final_model.keras')
@@ -487,6 +833,9 @@ def train():
     np.save(config.output_dir / 'label_encoder_classes.npy', label_encoder.classes_)
     print(f"Label encoder saved to {config.output_dir / 'label_encoder_classes.npy'}")
 
+    if config.train_gate:
+        train_and_save_gate(X_train, y_train, X_test, y_test, label_encoder, config)
+
     print("\n" + "="*70)
     print("TRAINING COMPLETE!")
     print("="*70)
@@ -495,10 +844,84 @@ def train():
     return model, history, config
 
 
+def leave_one_signer_out(base_config: TrainingConfig = None):
+    """Train once per signer with that signer held out; report per-signer test accuracy.
+
+    Each fold validates on another training signer (split_validation), so the
+    held-out signer does not steer early stopping or checkpointing.
+    """
+    base_config = base_config or TrainingConfig()
+    store = SessionStore(base_config.session_store)
+    store.ingest(base_config.raw_data_dir, verbose=False)
+    persons = sorted({s['signer'] for s in store.sessions(labels=base_config.session_labels)})
+    if len(persons) < 2:
+        raise ValueError(f"Leave-one-signer-out needs at least two signers, found {persons}")
+
+    root = base_config.output_dir
+    scores = {}
+    for person in persons:
+        config = TrainingConfig()
+        config.__dict__.update({k: v for k, v in base_config.__dict__.items() if k != 'test_results'})
+        config.split_mode = 'person'
+        config.test_persons = [person]
+        config.val_persons = [p for p in base_config.val_persons or [] if p != person] or None
+        config.train_gate = False
+        config.output_dir = root / f'loso_{person}'
+        config.output_dir.mkdir(parents=True, exist_ok=True)
+        train(config)
+        scores[person] = float(config.test_results[1])
+
+    accuracies = np.array(list(scores.values()))
+    summary = {'per_signer_accuracy': scores,
+               'mean_accuracy': float(accuracies.mean()),
+               'std_accuracy': float(accuracies.std())}
+    with open(root / 'loso_summary.json', 'w') as f:
+        json.dump(summary, f, indent=2)
+
+    print("\n" + "="*70)
+    print("LEAVE-ONE-SIGNER-OUT")
+    print("="*70)
+    for person, acc in scores.items():
+        print(f"  {person:10s}: {acc:.4f}")
+    print(f"  Mean: {summary['mean_accuracy']:.4f} +/- {summary['std_accuracy']:.4f}")
+    return summary
+
+
 if __name__ == "__main__":
+    import argparse
+    parser = argparse.ArgumentParser(description=__doc__)
+    parser.add_argument('--split', choices=['session', 'person', 'sequence'], default=None,
+                        help="Train/test split (default: config.split_mode)")
+    parser.add_argument('--test-person', action='append', default=None,
+                        help="Held-out signer for --split person (repeatable)")
+    parser.add_argument('--val-person', action='append', default=None,
+                        help="Validation signer for --split person (repeatable; "
+                             "default: the last training signer)")
+    parser.add_argument('--loso', action='store_true',
+                        help="Leave-one-signer-out evaluation over every signer")
+    parser.add_argument('--prune', type=float, default=None,
+                        help="Fraction of Conv1D filters to remove after training, e.g. 0.5")
+    parser.add_argument('--qat', action='store_true',
+                        help="Quantization-aware fine-tuning before export")
+    args = parser.parse_args()
+
     # Set random seeds for reproducibility
     np.random.seed(42)
     tf.random.set_seed(42)
 
-    # Train model
-    model, history, config = train()
+    config = TrainingConfig()
+    if args.split:
+        config.split_mode = args.split
+    if args.test_person:
+        config.test_persons = args.test_person
+    if args.val_person:
+        config.val_persons = args.val_person
+    if args.prune is not None:
+        config.prune_fraction = args.prune
+    config.use_qat = config.use_qat or args.qat
+
+    if args.loso:
+        leave_one_signer_out(config)
+    else:
+        # Train model
+        model, history, config = train(config)
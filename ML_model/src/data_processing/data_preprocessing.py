@@ -77,7 +77,10 @@ class SensorNormalizer:
 
 
 def load_csv_data(data_dir: str, trim_start=40, trim_end=15) -> pd.DataFrame:
-    """Load CSV files and remove unstable start/end rows from each file."""
+    """Load CSV files, keeping only the active repetitions of each file.
+
+    See select_segments(); trim_start/trim_end only apply to rest-label files.
+    """
     csv_files = list(Path(data_dir).glob('*.csv'))
     if not csv_files:
         raise ValueError(f"No CSV files found in {data_dir}")
@@ -87,12 +90,14 @@ def load_csv_data(data_dir: str, trim_start=40, trim_end=15) -> pd.DataFrame:
     for csv_file in csv_files:
         df = pd.read_csv(csv_file)
         original_len = len(df)
-        df = df.iloc[trim_start:-trim_end] if trim_end > 0 else df.iloc[trim_start:]
+        df = select_segments(df, trim_start, trim_end)
+        # Keep the recording identity so training can split by session/person
+        df = df.assign(session=csv_file.stem)
         total_trimmed += (original_len - len(df))
         dfs.append(df)
 
     combined_df = pd.concat(dfs, ignore_index=True)
-    print(f"Loaded {len(csv_files)} files, trimmed {total_trimmed} rows, {len(combined_df)} samples remaining")
+    print(f"Loaded {len(csv_files)} files, dropped {total_trimmed} rest rows, {len(combined_df)} samples remaining")
     return combined_df
 
 
@@ -141,9 +146,244 @@ def generate_firmware_code(normalizer: SensorNormalizer) -> str:
     return code
 
 
+FLEX_COLUMNS = ['flex1', 'flex2', 'flex3', 'flex4', 'flex5']
+IMU_COLUMNS = ['ax', 'ay', 'az', 'gx', 'gy', 'gz']
+
+# Raw captures carry gravity, so their mean accel magnitude sits near 9.81
+# m/s²; min-max or z-scored columns stay below ~1.7 (kMinRawGravity in
+# asl_host_runner.cpp).
+MIN_RAW_GRAVITY = 0.5 * 9.81
+
+
+def imu_is_raw(df: pd.DataFrame) -> bool:
+    """True when the IMU columns hold raw m/s² and rad/s readings, as DataLogger
+    writes them, rather than the normalized values older firmware logged."""
+    accel = df[IMU_COLUMNS[:3]].to_numpy(dtype=np.float64)
+    return len(accel) > 0 and float(np.linalg.norm(accel, axis=1).mean()) >= MIN_RAW_GRAVITY
+
+
+def firmware_preprocess(df: pd.DataFrame, norm_params: Dict) -> np.ndarray:
+    """Apply the exact feature transform of ASLInferenceEngine::classify.
+
+    Flex values are clamped to [0, 1] and IMU channels are z-scored with the
+    parameters compiled into asl_model_config.h. Returns float32 [N, 11].
+    Raises ValueError for captures with normalized IMU columns, which the
+    firmware would never see (see imu_is_raw).
+    """
+    if not imu_is_raw(df):
+        raise ValueError("IMU columns are normalized, not raw m/s² and rad/s")
+    flex = np.clip(df[FLEX_COLUMNS].to_numpy(dtype=np.float32), 0.0, 1.0)
+    imu = df[IMU_COLUMNS].to_numpy(dtype=np.float32)
+    mean = np.array([norm_params[c]['mean'] for c in IMU_COLUMNS], dtype=np.float32)
+    std = np.array([norm_params[c]['std'] for c in IMU_COLUMNS], dtype=np.float32)
+    return np.concatenate([flex, (imu - mean) / std], axis=1)
+
+
+# Labels whose recordings are the resting hand itself; they keep the fixed trim.
+NEUTRAL_LABELS = ('NEUTRAL',)
+GYRO_COLUMNS = ['gx', 'gy', 'gz']
+
+# GestureSegmenter::Params (ASL_firmware/src/ml/gesture_segmenter.h)
+SEGMENTER_PARAMS = {
+    'pose_threshold': 0.10,
+    'flex_speed_threshold': 0.15,
+    'gyro_threshold': 0.25,
+    'release': 0.6,
+    'onset_samples': 3,
+    'offset_samples': 15,
+    'smoothing': 0.2,
+    'rest_adapt': 0.02,
+}
+
+# MPU9250 gyro full scale at ±250 °/s, in rad/s (GYRO_SCALE in mpu9250_sensor.cpp).
+GYRO_FULL_SCALE = 4.3633
+
+
+def segment_activity(flex: np.ndarray, gyro: np.ndarray,
+                     params: Dict = None) -> Tuple[np.ndarray, np.ndarray]:
+    """Replay GestureSegmenter over raw flex [N, 5] and gyro (rad/s) [N, 3].
+
+    Used for recordings made before the firmware logged rep_id/active. Returns
+    (rep_id [N] int, active [N] bool) with the firmware's meaning: rep_id
+    counts onsets, and rest rows keep the id of the repetition they follow.
+    """
+    p = dict(SEGMENTER_PARAMS, **(params or {}))
+    alpha = p['smoothing']
+    flex = np.asarray(flex, dtype=np.float64)
+    gyro = np.asarray(gyro, dtype=np.float64)
+    rep_id = np.zeros(len(flex), dtype=np.int32)
+    active_out = np.zeros(len(flex), dtype=bool)
+
+    rest = smooth = last = None
+    flex_speed = gyro_energy = 0.0
+    active, repetition, run = False, 0, 0
+    for i in range(len(flex)):
+        if rest is None:
+            rest, smooth, last = flex[i].copy(), flex[i].copy(), flex[i].copy()
+        flex_speed += alpha * (np.abs(flex[i] - last).sum() - flex_speed)
+        last = flex[i]
+        smooth = smooth + alpha * (flex[i] - smooth)
+        gyro_energy += alpha * ((gyro[i] * gyro[i]).sum() - gyro_energy)
+
+        activity = max(np.abs(smooth - rest).max() / p['pose_threshold'],
+                       flex_speed / p['flex_speed_threshold'],
+                       gyro_energy / p['gyro_threshold'])
+        if not active:
+            run = run + 1 if activity >= 1.0 else 0
+            if run >= p['onset_samples']:
+                active, repetition, run = True, repetition + 1, 0
+            elif activity < p['release']:
+                rest = rest + p['rest_adapt'] * (smooth - rest)
+        else:
+            run = run + 1 if activity < p['release'] else 0
+            if run >= p['offset_samples']:
+                active, run = False, 0
+        rep_id[i] = repetition
+        active_out[i] = active
+    return rep_id, active_out
+
+
+def active_segments(active: np.ndarray) -> List[Tuple[int, int]]:
+    """[start, stop) row ranges of every active run."""
+    active = np.asarray(active, dtype=bool)
+    edges = np.flatnonzero(np.diff(np.concatenate([[False], active, [False]]).astype(np.int8)))
+    return list(zip(edges[0::2].tolist(), edges[1::2].tolist()))
+
+
+def imu_unit_scaled(df: pd.DataFrame) -> bool:
+    """True for captures whose IMU columns were logged min-max normalized to [0, 1].
+
+    Raw captures always carry gravity (|a| ≈ 9.8 m/s²) on some axis, so they
+    can never fall entirely inside [0, 1].
+    """
+    imu = df[IMU_COLUMNS].to_numpy(dtype=np.float32)
+    return len(imu) > 0 and float(imu.min()) >= 0.0 and float(imu.max()) <= 1.0
+
+
+def session_gyro(df: pd.DataFrame) -> np.ndarray:
+    """Gyro columns in rad/s, the unit GestureSegmenter thresholds are set in.
+
+    Min-max normalized captures are mapped back assuming the calibration span
+    covered the sensor's full scale, centred on 0.5. A narrower span only
+    makes motion look slower, never makes rest look active.
+    """
+    gyro = df[GYRO_COLUMNS].to_numpy(dtype=np.float32)
+    if imu_unit_scaled(df):
+        gyro = (gyro - 0.5) * (2.0 * GYRO_FULL_SCALE)
+    return gyro
+
+
+def session_activity(df: pd.DataFrame) -> np.ndarray:
+    """Per-row active flags: the logged 'active' column, else segment_activity()."""
+    if 'active' in df.columns:
+        return df['active'].to_numpy() != 0
+    _, active = segment_activity(df[FLEX_COLUMNS].to_numpy(dtype=np.float32), session_gyro(df))
+    return active
+
+
+def repetition_segments(df: pd.DataFrame) -> List[Tuple[int, int]]:
+    """Active repetitions of one session as [start, stop) row ranges.
+
+    A repetition only ends after offset_samples quiet samples, all but the last
+    of which are still tagged active; they are dropped here. A repetition still
+    active when logging stopped runs to len(df); see trim_segments().
+    """
+    active = session_activity(df)
+    quiet = SEGMENTER_PARAMS['offset_samples'] - 1
+    segments = []
+    for start, stop in active_segments(active):
+        if stop < len(active):
+            stop = max(start, stop - quiet)
+        if stop > start:
+            segments.append((start, stop))
+    return segments
+
+
+def trim_segments(segments: List[Tuple[int, int]], length: int, trim_start=40,
+                  trim_end=15) -> List[Tuple[int, int]]:
+    """Fall back to the fixed trim wherever the segmenter found no boundary.
+
+    A repetition with no offset before the end of the file (a sign held until
+    logging stopped) ends trim_end rows early, dropping the move back out of
+    the sign. A session with no onset at all is trimmed at both ends.
+    """
+    end = length - trim_end if trim_end > 0 else length
+    if not segments:
+        return [(trim_start, end)] if end > trim_start else []
+    trimmed = []
+    for start, stop in segments:
+        if stop >= length:
+            stop = end
+        if stop > start:
+            trimmed.append((start, stop))
+    return trimmed
+
+
+def session_segments(df: pd.DataFrame, trim_start=40, trim_end=15,
+                     neutral_labels=NEUTRAL_LABELS) -> List[Tuple[int, int]]:
+    """Row ranges of one session worth training on.
+
+    Sign recordings contribute their active repetitions, from the logged
+    'active' column or, for older captures, from segment_activity(), with
+    trim_segments() covering any boundary the segmenter did not see. Rest-label
+    recordings are rest throughout and keep the fixed trim_start/trim_end.
+    """
+    label = str(df['label'].iloc[0]) if 'label' in df.columns and len(df) else ''
+    if label in neutral_labels:
+        return trim_segments([], len(df), trim_start, trim_end)
+    return trim_segments(repetition_segments(df), len(df), trim_start, trim_end)
+
+
+def select_segments(df: pd.DataFrame, trim_start=40, trim_end=15) -> pd.DataFrame:
+    """Rows of session_segments(), with rep_id numbering the segments from 1."""
+    parts = [df.iloc[start:stop].assign(rep_id=i + 1)
+             for i, (start, stop) in enumerate(session_segments(df, trim_start, trim_end))]
+    return pd.concat(parts) if parts else df.iloc[0:0].assign(rep_id=0)
+
+
+def load_firmware_windows(data_dir: str, norm_params: Dict, labels: List[str] = None,
+                          window_size: int = 25, stride: int = 1, sample_stride: int = 1,
+                          trim_start=40, trim_end=15) -> Tuple[np.ndarray, np.ndarray]:
+    """Cut raw session CSVs into firmware-preprocessed windows.
+
+    Only sessions whose label is in `labels` are used (all when None), and
+    windows never cross a segment boundary (see session_segments). Sessions
+    with normalized IMU columns are skipped (see imu_is_raw).
+    `sample_stride` decimates like ASLInferenceEngine: each window spans
+    window_size * sample_stride samples and keeps the last sample of every group.
+    Returns (windows [M, window_size, 11], window labels [M]).
+    """
+    span = window_size * sample_stride
+    windows, window_labels = [], []
+    for csv_file in sorted(Path(data_dir).glob('*.csv')):
+        df = pd.read_csv(csv_file)
+        if 'label' not in df.columns or df.empty:
+            continue
+        label = str(df['label'].iloc[0])
+        if labels is not None and label not in labels:
+            continue
+        if not imu_is_raw(df):
+            print(f"  Skipping {csv_file.name}: IMU columns are normalized, not raw")
+            continue
+        features = firmware_preprocess(df, norm_params)
+        for seg_start, seg_stop in session_segments(df, trim_start, trim_end):
+            for start in range(seg_start, seg_stop - span + 1, stride):
+                windows.append(features[start + sample_stride - 1:start + span:sample_stride])
+                window_labels.append(label)
+
+    if not windows:
+        raise ValueError(f"No usable sessions in {data_dir} for labels {labels}")
+    return np.stack(windows).astype(np.float32), np.array(window_labels)
+
+
 def create_combined_dataset(data_dir: str, output_file: str, trim_start=40, trim_end=15,
                            normalize_method='standardize') -> Tuple[pd.DataFrame, SensorNormalizer]:
-    """Trim and normalize each CSV, combine into single dataset with target column at end."""
+    """Keep each CSV's active segments, normalize, and combine into a single dataset
+    with the target column at the end.
+
+    person_id, a per-file 'session' column and the segment's rep_id are kept for
+    session-aware splits and segment-bounded windows.
+    """
     csv_files = list(Path(data_dir).glob('*.csv'))
     if not csv_files:
         raise ValueError(f"No CSV files found in {data_dir}")
@@ -162,14 +402,17 @@ def create_combined_dataset(data_dir: str, output_file: str, trim_start=40, trim
     for csv_file in csv_files:
         df = pd.read_csv(csv_file)
         original_len = len(df)
-        df = df.iloc[trim_start:-trim_end] if trim_end > 0 else df.iloc[trim_start:]
+        df = select_segments(df, trim_start, trim_end)
+        # Keep the recording identity so training can split by session/person
+        df = df.assign(session=csv_file.stem)
         total_trimmed += (original_len - len(df))
         all_dfs.append(df)
-        print(f"  Loaded {csv_file.name}: {original_len} -> {len(df)} rows (trimmed {original_len - len(df)})")
+        print(f"  Loaded {csv_file.name}: {original_len} -> {len(df)} rows in "
+              f"{df['rep_id'].nunique()} segment(s) (dropped {original_len - len(df)})")
 
     # Combine all data to fit normalizer
     combined_temp = pd.concat(all_dfs, ignore_index=True)
-    print(f"\nTotal rows after trimming: {len(combined_temp)} (trimmed {total_trimmed} total)")
+    print(f"\nTotal rows in active segments: {len(combined_temp)} (dropped {total_trimmed} total)")
 
     # Fit normalizer on all IMU data
     normalizer = SensorNormalizer()
@@ -186,11 +429,6 @@ def create_combined_dataset(data_dir: str, output_file: str, trim_start=40, trim
     # Combine all normalized data
     combined_df = pd.concat(normalized_dfs, ignore_index=True)
 
-    # Drop person_id if it exists
-    if 'person_id' in combined_df.columns:
-        combined_df = combined_df.drop(columns=['person_id'])
-        print("Dropped 'person_id' column")
-
     # Move label column to end and rename to target
     if 'label' in combined_df.columns:
         label_data = combined_df['label']
@@ -0,0 +1,194 @@
+"""Incremental, memory-mappable store of recorded glove sessions.
+
+Each session CSV from python/data_logs is parsed once into a float32 .npy
+array [N, 11] (flex1..flex5, ax..gz, raw values) next to a manifest.json that
+holds per-session metadata: person, label, sample count, sample rate, source
+file size/mtime, calibration statistics and the active repetitions found by
+the gesture segmenter. Re-running ingest() only parses
+CSVs that are new or changed, and training reads the arrays with mmap, so
+start-up no longer scales with CSV parsing.
+"""
+
+import json
+from pathlib import Path
+from typing import Dict, List, Optional
+
+import numpy as np
+import pandas as pd
+
+try:
+    from .data_preprocessing import (FLEX_COLUMNS, IMU_COLUMNS, NEUTRAL_LABELS, SensorNormalizer,
+                                     repetition_segments, trim_segments)
+except ImportError:
+    from data_preprocessing import (FLEX_COLUMNS, IMU_COLUMNS, NEUTRAL_LABELS, SensorNormalizer,
+                                    repetition_segments, trim_segments)
+
+FEATURE_COLUMNS = FLEX_COLUMNS + IMU_COLUMNS
+MANIFEST_NAME = "manifest.json"
+STORE_VERSION = 3
+
+
+def signer_id(person_id: str, label: str) -> str:
+    """Signer behind a session's person_id.
+
+    Older captures typed the label into the person prompt (P1Z, P1HELLO,
+    P1NEUTR for NEUTRAL); strip that suffix so recordings group by signer.
+    """
+    for n in range(len(label), 0, -1):
+        if len(person_id) > n and person_id.endswith(label[:n]):
+            return person_id[:-n]
+    return person_id
+
+
+class SessionStore:
+    """Directory of per-session .npy arrays plus a JSON manifest."""
+
+    def __init__(self, store_dir):
+        self.store_dir = Path(store_dir)
+        self.manifest_path = self.store_dir / MANIFEST_NAME
+        self.manifest = {'version': STORE_VERSION, 'columns': FEATURE_COLUMNS, 'sessions': {}}
+        if self.manifest_path.exists():
+            manifest = json.loads(self.manifest_path.read_text())
+            if manifest.get('version') == STORE_VERSION and manifest.get('columns') == FEATURE_COLUMNS:
+                self.manifest = manifest
+
+    def ingest(self, data_dir, prune: bool = True, verbose: bool = True) -> Dict[str, int]:
+        """Parse new or modified CSVs from data_dir; drop sessions whose CSV is gone."""
+        self.store_dir.mkdir(parents=True, exist_ok=True)
+        sessions = self.manifest['sessions']
+        counts = {'added': 0, 'updated': 0, 'unchanged': 0, 'removed': 0}
+
+        csv_files = sorted(Path(data_dir).glob('*.csv'))
+        for csv_file in csv_files:
+            stat = csv_file.stat()
+            entry = sessions.get(csv_file.name)
+            if (entry and entry['source_size'] == stat.st_size
+                    and entry['source_mtime_ns'] == stat.st_mtime_ns
+                    and (self.store_dir / entry['array']).exists()):
+                counts['unchanged'] += 1
+                continue
+
+            record = self._ingest_file(csv_file, stat)
+            if record is None:
+                continue
+            counts['updated' if entry else 'added'] += 1
+            sessions[csv_file.name] = record
+            if verbose:
+                print(f"  Ingested {csv_file.name}: {record['label']} / {record['person_id']}, "
+                      f"{record['samples']} samples")
+
+        if prune:
+            present = {f.name for f in csv_files}
+            for name in [n for n in sessions if n not in present]:
+                (self.store_dir / sessions.pop(name)['array']).unlink(missing_ok=True)
+                counts['removed'] += 1
+
+        self.manifest_path.write_text(json.dumps(self.manifest, indent=2))
+        if verbose:
+            print(f"Session store {self.store_dir}: {len(sessions)} sessions "
+                  f"({counts['added']} added, {counts['updated']} updated, "
+                  f"{counts['removed']} removed, {counts['unchanged']} unchanged)")
+        return counts
+
+    def _ingest_file(self, csv_file: Path, stat) -> Optional[Dict]:
+        df = pd.read_csv(csv_file)
+        missing = [c for c in FEATURE_COLUMNS + ['label'] if c not in df.columns]
+        if missing or df.empty:
+            print(f"  Skipping {csv_file.name}: missing columns {missing}" if missing
+                  else f"  Skipping {csv_file.name}: empty")
+            return None
+
+        features = df[FEATURE_COLUMNS].to_numpy(dtype=np.float32)
+        array_name = csv_file.with_suffix('.npy').name
+        np.save(self.store_dir / array_name, features)
+
+        rate_hz = None
+        if 'timestamp' in df.columns and len(df) > 1:
+            period_ms = float(np.median(np.diff(df['timestamp'].to_numpy(dtype=np.float64))))
+            rate_hz = round(1000.0 / period_ms, 2) if period_ms > 0 else None
+
+        # Sign sessions train on their active repetitions only. The fixed trim
+        # for rest-label sessions and unseen boundaries is applied at read time,
+        # so the segments are stored untrimmed.
+        segments = repetition_segments(df)
+        flex = features[:, :len(FLEX_COLUMNS)]
+        imu = features[:, len(FLEX_COLUMNS):]
+        return {
+            'array': array_name,
+            'person_id': str(df['person_id'].iloc[0]) if 'person_id' in df.columns else 'unknown',
+            'label': str(df['label'].iloc[0]),
+            'samples': int(len(features)),
+            'rate_hz': rate_hz,
+            'source_size': stat.st_size,
+            'source_mtime_ns': stat.st_mtime_ns,
+            'segments': [[int(start), int(stop)] for start, stop in segments],
+            # Per-session sensor range, used to spot badly calibrated recordings.
+            'calibration': {
+                'flex_min': flex.min(axis=0).round(4).tolist(),
+                'flex_max': flex.max(axis=0).round(4).tolist(),
+                'imu_mean': imu.mean(axis=0).round(4).tolist(),
+                'imu_std': imu.std(axis=0).round(4).tolist(),
+            },
+        }
+
+    def sessions(self, labels: Optional[List[str]] = None,
+                 persons: Optional[List[str]] = None) -> List[Dict]:
+        """Session records (with 'file' and 'signer' added), sorted by file name."""
+        records = []
+        for name in sorted(self.manifest['sessions']):
+            record = dict(self.manifest['sessions'][name], file=name)
+            record['signer'] = signer_id(record['person_id'], record['label'])
+            if labels is not None and record['label'] not in labels:
+                continue
+            if persons is not None and record['person_id'] not in persons:
+                continue
+            records.append(record)
+        return records
+
+    def features(self, session: Dict, trim_start: int = 40, trim_end: int = 15) -> np.ndarray:
+        """Memory-mapped raw features [N, 11] for one session, trimmed."""
+        array = np.load(self.store_dir / session['array'], mmap_mode='r')
+        return array[trim_start:len(array) - trim_end] if trim_end > 0 else array[trim_start:]
+
+    def segments(self, session: Dict, trim_start: int = 40, trim_end: int = 15,
+                 neutral_labels=NEUTRAL_LABELS) -> List[np.ndarray]:
+        """Memory-mapped raw features of each active repetition.
+
+        Rest-label sessions are one segment, trimmed like features(); sign
+        sessions fall back to the same trim where no boundary was found
+        (see trim_segments()).
+        """
+        if session['label'] in neutral_labels:
+            features = self.features(session, trim_start, trim_end)
+            return [features] if len(features) else []
+        array = np.load(self.store_dir / session['array'], mmap_mode='r')
+        segments = trim_segments([tuple(segment) for segment in session['segments']],
+                                 session['samples'], trim_start, trim_end)
+        return [array[start:stop] for start, stop in segments]
+
+    def fit_normalizer(self, sessions: List[Dict], trim_start: int = 40,
+                       trim_end: int = 15) -> SensorNormalizer:
+        """Fit IMU z-score parameters over the sessions' segments (same rows as create_combined_dataset)."""
+        imu = np.concatenate([segment[:, len(FLEX_COLUMNS):] for s in sessions
+                              for segment in self.segments(s, trim_start, trim_end)]).astype(np.float64)
+        normalizer = SensorNormalizer()
+        normalizer.params = {
+            col: {
+                'mean': float(imu[:, i].mean()),
+                'std': float(imu[:, i].std(ddof=1)),
+                'min': float(imu[:, i].min()),
+                'max': float(imu[:, i].max()),
+            }
+            for i, col in enumerate(IMU_COLUMNS)
+        }
+        normalizer.is_fitted = True
+        return normalizer
+
+    def normalized_features(self, session: Dict, normalizer: SensorNormalizer,
+                            trim_start: int = 40, trim_end: int = 15) -> np.ndarray:
+        """Trimmed features with IMU channels standardized, float32 [N, 11]."""
+        features = np.array(self.features(session, trim_start, trim_end), dtype=np.float32)
+        mean = np.array([normalizer.params[c]['mean'] for c in IMU_COLUMNS], dtype=np.float32)
+        std = np.array([normalizer.params[c]['std'] for c in IMU_COLUMNS], dtype=np.float32)
+        features[:, len(FLEX_COLUMNS):] = (features[:, len(FLEX_COLUMNS):] - mean) / std
+        return features
@@ -0,0 +1,116 @@
+"""Segmentation of the recorded sessions in python/data_logs.
+
+Run from the repository root:  python3 -m pytest ML_model/tests
+"""
+import shutil
+import sys
+from pathlib import Path
+
+import numpy as np
+import pandas as pd
+import pytest
+
+sys.path.insert(0, str(Path(__file__).parent.parent / 'src'))
+from data_processing.data_preprocessing import (SEGMENTER_PARAMS, firmware_preprocess, imu_is_raw,
+                                                imu_unit_scaled, repetition_segments,
+                                                session_segments)
+from data_processing.session_store import SessionStore
+
+DATA_DIR = Path(__file__).parent.parent.parent / 'python' / 'data_logs'
+TRIM_START, TRIM_END = 40, 15
+
+
+def load(name: str) -> pd.DataFrame:
+    path = DATA_DIR / f'{name}_data.csv'
+    if not path.exists():
+        pytest.skip(f'{path.name} not recorded')
+    return pd.read_csv(path)
+
+
+def test_held_letter_drops_tail():
+    # P1A holds the sign until logging stops, so no offset is ever seen.
+    df = load('P1A')
+    assert repetition_segments(df)[-1][1] == len(df)
+    segments = session_segments(df, TRIM_START, TRIM_END)
+    assert len(segments) == 1
+    start, stop = segments[0]
+    assert 30 <= start <= 45
+    assert stop == len(df) - TRIM_END
+
+
+@pytest.mark.parametrize('name', ['P1EAT', 'P1HELLO'])
+def test_unit_scaled_imu_starts_at_onset(name):
+    # These captures logged the IMU min-max normalized; read as rad/s, gyro
+    # values around 0.5 would look active from the first samples.
+    df = load(name)
+    assert imu_unit_scaled(df)
+    segments = session_segments(df, TRIM_START, TRIM_END)
+    assert segments[0][0] >= 30
+    assert segments[-1][1] == len(df) - TRIM_END
+
+
+def test_raw_imu_is_not_unit_scaled():
+    assert not imu_unit_scaled(load('P1A'))
+    assert not imu_unit_scaled(load('P1NEUTR'))
+
+
+def test_firmware_preprocess_rejects_normalized_imu():
+    # P1EAT/P1HELLO were logged with the IMU already normalized; the firmware
+    # transform would z-score it a second time.
+    assert imu_is_raw(load('P1A'))
+    df = load('P1EAT')
+    assert not imu_is_raw(df)
+    with pytest.raises(ValueError):
+        firmware_preprocess(df, {})
+
+
+def test_every_recording_drops_tail():
+    files = sorted(DATA_DIR.glob('*.csv'))
+    if not files:
+        pytest.skip('no recorded sessions')
+    for path in files:
+        df = pd.read_csv(path)
+        segments = session_segments(df, TRIM_START, TRIM_END)
+        assert segments, path.name
+        assert segments[-1][1] <= len(df) - TRIM_END, path.name
+
+
+def test_spliced_repetitions_split_at_rest():
+    # Rest rows from the NEUTRAL capture between held A signs: each sign is a
+    # repetition of its own, closed by an offset instead of the fallback trim.
+    # The smoothed cues take up to offset_samples rows to settle after the
+    # abrupt return to rest.
+    rest = load('P1NEUTR').iloc[100:200]
+    sign = load('P1A').iloc[100:220]
+    stream = pd.concat([rest] + [sign, rest] * 3, ignore_index=True)
+    stream['label'] = 'A'
+
+    segments = session_segments(stream, TRIM_START, TRIM_END)
+    assert len(segments) == 3
+    for i, (start, stop) in enumerate(segments):
+        sign_start = len(rest) + i * (len(sign) + len(rest))
+        sign_stop = sign_start + len(sign)
+        assert abs(start - sign_start) <= SEGMENTER_PARAMS['onset_samples'] + 2
+        assert sign_stop <= stop <= sign_stop + SEGMENTER_PARAMS['offset_samples']
+    assert segments[-1][1] < len(stream) - TRIM_END
+
+
+def test_store_segments_match_csv(tmp_path):
+    data_dir = tmp_path / 'logs'
+    data_dir.mkdir()
+    for name in ('P1A', 'P1EAT', 'P1NEUTR'):
+        source = DATA_DIR / f'{name}_data.csv'
+        if not source.exists():
+            pytest.skip(f'{source.name} not recorded')
+        shutil.copy(source, data_dir)
+
+    store = SessionStore(tmp_path / 'store')
+    store.ingest(data_dir, verbose=False)
+    for session in store.sessions():
+        df = pd.read_csv(data_dir / session['file'])
+        expected = session_segments(df, TRIM_START, TRIM_END)
+        stored = store.segments(session, TRIM_START, TRIM_END)
+        assert [len(s) for s in stored] == [stop - start for start, stop in expected]
+        features = df[['flex1', 'flex2', 'flex3', 'flex4', 'flex5']].to_numpy(dtype=np.float32)
+        start = expected[0][0]
+        np.testing.assert_array_equal(stored[0][:, :5], features[start:start + len(stored[0])])
@@ -1,9 +1,20 @@
-"""Update firmware inference code with new classes."""
-import re
+"""Regenerate the firmware model package from the latest converted model."""
+import argparse
+import json
 from pathlib import Path
 import numpy as np
 
+from model_package import DEFAULT_MODEL_NAME, norm_params_path, write_model_package
+
 MODEL_BASE = Path(__file__).parent / "model"
+
+parser = argparse.ArgumentParser(description=__doc__)
+parser.add_argument('--model-name', default=DEFAULT_MODEL_NAME,
+                    help="Package name in the firmware (asl_model_short for the short router stage)")
+parser.add_argument('--norm-params', type=Path, default=None,
+                    help="IMU normalization params (default: the run's normalization_params.json)")
+args = parser.parse_args()
+
 latest_dir = max([d for d in MODEL_BASE.iterdir() if d.is_dir()], key=lambda x: x.stat().st_mtime)
 
 for fname in ["label_encoder_classes.npy", "classes.npy"]:
@@ -11,56 +22,19 @@ for fname in ["label_encoder_classes.npy", "classes.npy"]:
     if classes_path.exists():
         break
 
-classes = np.load(classes_path)
-num_classes = len(classes)
-
-print(f"Updating firmware for {num_classes} classes: {list(classes)}")
-
-firmware_path = Path(__file__).parent.parent / "ASL_firmware/src/ml/asl_inference.cpp"
-content = firmware_path.read_text()
-
-content = re.sub(
-    r'constexpr size_t kNumClasses = \d+;',
-    f'constexpr size_t kNumClasses = {num_classes};',
-    content
-)
-
-label_names_str = ', '.join([f'"{cls}"' for cls in classes])
-label_names_array = f'constexpr std::array<const char*, kNumClasses> kLabelNames = {{\n    {label_names_str}}};'
-
-content = re.sub(
-    r'constexpr std::array<const char\*, kNumClasses> kLabelNames = \{[^}]+\};',
-    label_names_array,
-    content,
-    flags=re.DOTALL
-)
-
-label_mapping = {
-    "EAT": "'E'", "HELLO": "'H'",
-    "NEUTRAL": "ASLInferenceEngine::kNeutralToken",
-    "NEUTR": "ASLInferenceEngine::kNeutralToken",
-    "SPACE": "ASLInferenceEngine::kSpaceToken",
-    "BACKSPACE": "ASLInferenceEngine::kBackspaceToken",
-    "BACK": "ASLInferenceEngine::kBackspaceToken"
-}
-
-label_to_char = []
-for cls in classes:
-    if cls.upper() in label_mapping:
-        label_to_char.append(label_mapping[cls.upper()])
-    elif len(cls) == 1:
-        label_to_char.append(f"'{cls.upper()}'")
-    else:
-        label_to_char.append(f"'{cls[0].upper()}'")
-
-label_to_char_array = f"constexpr std::array<char, kNumClasses> kLabelToChar = {{\n    {',\n    '.join(label_to_char)}}};"
-
-content = re.sub(
-    r'constexpr std::array<char, kNumClasses> kLabelToChar = \{[^}]+\};',
-    label_to_char_array,
-    content,
-    flags=re.DOTALL
-)
-
-firmware_path.write_text(content)
+tflite_path = latest_dir / "model_quantized.tflite"
+if not tflite_path.exists():
+    print(f"No model_quantized.tflite in {latest_dir.name}, run convert_to_tflite.py first")
+    exit(1)
+
+classes = np.load(classes_path, allow_pickle=True)
+norm_params = json.load(norm_params_path(latest_dir, args.norm_params).open())
+config_path = latest_dir / "config.json"
+sample_stride = int(json.load(config_path.open()).get('sample_stride', 1)) if config_path.exists() else 1
+gate_path = latest_dir / "gate.json"
+gate = json.load(gate_path.open()) if gate_path.exists() else None
+
+print(f"Updating firmware for {len(classes)} classes: {list(classes)}")
+write_model_package(tflite_path.read_bytes(), classes, norm_params, latest_dir.name,
+                    model_name=args.model_name, sample_stride=sample_stride, gate=gate)
 print("Firmware updated successfully")
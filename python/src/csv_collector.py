@@ -25,6 +25,8 @@ DATA_HEADER = [
     "gx",
     "gy",
     "gz",
+    "rep_id",
+    "active",
 ]
 
 LABEL_OPTIONS = [chr(value) for value in range(ord("A"), ord("Z") + 1)] + [
@@ -0,0 +1,195 @@
+"""Decode tokenized firmware debug logs.
+
+With binary log output enabled on the glove (serial command 'z'), debug
+messages arrive as compact frames holding a format ID and raw 32-bit
+arguments. This tool rebuilds the text from the format table in
+ASL_firmware/src/log_formats.h. Ordinary serial text between frames is
+passed through unchanged.
+
+    python decode_log.py --port /dev/ttyUSB0
+    python decode_log.py --input capture.bin --timestamps
+"""
+
+import argparse
+import re
+import struct
+import sys
+from pathlib import Path
+from typing import BinaryIO, Iterator, List, Optional, TextIO, Tuple
+
+DEFAULT_BAUD = 115200
+DEFAULT_FORMATS = Path(__file__).resolve().parents[2] / "ASL_firmware" / "src" / "log_formats.h"
+
+SYNC = b"\xa5\x5a"
+HEADER = struct.Struct("<HBBI")  # id, core, word count, timestamp (us)
+STRING_WORDS = 3
+
+_ENTRY_RE = re.compile(r'X\(\s*(\w+)\s*,\s*((?:"(?:[^"\\]|\\.)*"\s*)+)\)')
+_SPEC_RE = re.compile(r"%(?:%|[-+ #0]*\d*(?:\.\d+)?[hlzjt]*([diouxXcfFeEgGs]))")
+
+
+def load_formats(path: Path) -> List[Tuple[str, str]]:
+    """Return (name, format) pairs in ID order from the ASL_LOG_FORMATS table."""
+    text = path.read_text(encoding="utf-8")
+    start = text.find("#define ASL_LOG_FORMATS")
+    if start < 0:
+        raise ValueError(f"No ASL_LOG_FORMATS table in {path}")
+    body = text[start:].replace("\\\n", "\n")
+    end = body.find("\n\n")
+    if end > 0:
+        body = body[:end]
+
+    formats = []
+    for name, literals in _ENTRY_RE.findall(body):
+        parts = re.findall(r'"((?:[^"\\]|\\.)*)"', literals)
+        raw = "".join(parts)
+        formats.append((name, raw.encode("utf-8").decode("unicode_escape")))
+    return formats
+
+
+def render(fmt: str, words: List[int]) -> str:
+    """Apply a printf format to 32-bit argument words the way the firmware packs them."""
+    out = []
+    pos = 0
+    index = 0
+
+    def take() -> int:
+        nonlocal index
+        value = words[index] if index < len(words) else 0
+        index += 1
+        return value
+
+    for match in _SPEC_RE.finditer(fmt):
+        out.append(fmt[pos:match.start()])
+        pos = match.end()
+        conv = match.group(1)
+        if conv is None:
+            out.append("%")
+            continue
+        spec = re.sub(r"[hlzjt]", "", match.group(0))
+        if conv == "s":
+            raw = b"".join(struct.pack("<I", take()) for _ in range(STRING_WORDS))
+            out.append(spec % raw.split(b"\0", 1)[0].decode("utf-8", "replace"))
+        elif conv in "fFeEgG":
+            out.append(spec % struct.unpack("<f", struct.pack("<I", take()))[0])
+        elif conv in "dic":
+            value = struct.unpack("<i", struct.pack("<I", take()))[0]
+            out.append(spec % value)
+        else:
+            out.append(spec % take())
+    out.append(fmt[pos:])
+    return "".join(out)
+
+
+class FrameDecoder:
+    """Splits a byte stream into pass-through text and decoded log frames."""
+
+    def __init__(self, formats: List[Tuple[str, str]], timestamps: bool = False) -> None:
+        self.formats = formats
+        self.timestamps = timestamps
+        self.buffer = bytearray()
+        self.bad_frames = 0
+
+    def feed(self, data: bytes) -> Iterator[str]:
+        self.buffer.extend(data)
+        while self.buffer:
+            sync = self.buffer.find(SYNC)
+            if sync < 0:
+                # Keep a trailing 0xA5 in case the sync word is split across reads
+                keep = 1 if self.buffer[-1:] == SYNC[:1] else 0
+                text = bytes(self.buffer[: len(self.buffer) - keep])
+                del self.buffer[: len(self.buffer) - keep]
+                if text:
+                    yield text.decode("utf-8", "replace")
+                return
+            if sync > 0:
+                yield bytes(self.buffer[:sync]).decode("utf-8", "replace")
+                del self.buffer[:sync]
+
+            if len(self.buffer) < 2 + HEADER.size:
+                return
+            log_id, core, count, timestamp = HEADER.unpack_from(self.buffer, 2)
+            size = 2 + HEADER.size + count * 4 + 1
+            if len(self.buffer) < size:
+                return
+
+            body = self.buffer[2 : size - 1]
+            check = 0
+            for byte in body:
+                check ^= byte
+            if check != self.buffer[size - 1]:
+                # Not a frame after all: emit the first byte as text and rescan
+                self.bad_frames += 1
+                yield bytes(self.buffer[:1]).decode("utf-8", "replace")
+                del self.buffer[:1]
+                continue
+
+            words = list(struct.unpack_from(f"<{count}I", self.buffer, 2 + HEADER.size))
+            del self.buffer[:size]
+            yield self._format(log_id, core, timestamp, words)
+
+    def _format(self, log_id: int, core: int, timestamp: int, words: List[int]) -> str:
+        if log_id >= len(self.formats):
+            text = f"[LOG] unknown id {log_id} ({len(words)} words)\n"
+        else:
+            text = render(self.formats[log_id][1], words)
+        if self.timestamps:
+            text = f"{timestamp / 1e6:12.6f} c{core} {text}"
+        return text
+
+
+def decode_stream(source: BinaryIO, decoder: FrameDecoder, sink: TextIO, chunk: int = 256) -> None:
+    while True:
+        data = source.read(chunk)
+        if not data:
+            break
+        for text in decoder.feed(data):
+            sink.write(text)
+        sink.flush()
+
+
+def parse_args() -> argparse.Namespace:
+    parser = argparse.ArgumentParser(description="Decode tokenized ASL glove debug logs")
+    source = parser.add_mutually_exclusive_group()
+    source.add_argument("--port", help="Serial port to read live (e.g., /dev/ttyUSB0, COM5)")
+    source.add_argument("--input", type=Path, help="Raw binary capture to decode (default: stdin)")
+    parser.add_argument("--baud", type=int, default=DEFAULT_BAUD, help="Serial baud rate")
+    parser.add_argument("--formats", type=Path, default=DEFAULT_FORMATS, help="Path to log_formats.h")
+    parser.add_argument("--timestamps", action="store_true", help="Prefix decoded lines with device time and core")
+    return parser.parse_args()
+
+
+def main() -> int:
+    args = parse_args()
+    formats = load_formats(args.formats)
+    decoder = FrameDecoder(formats, timestamps=args.timestamps)
+
+    source: Optional[BinaryIO] = None
+    try:
+        if args.port:
+            import serial
+
+            source = serial.Serial(args.port, args.baud, timeout=0.1)
+            while True:
+                data = source.read(source.in_waiting or 1)
+                for text in decoder.feed(data):
+                    sys.stdout.write(text)
+                sys.stdout.flush()
+        elif args.input:
+            with args.input.open("rb") as handle:
+                decode_stream(handle, decoder, sys.stdout)
+        else:
+            decode_stream(sys.stdin.buffer, decoder, sys.stdout)
+    except KeyboardInterrupt:
+        pass
+    finally:
+        if source is not None:
+            source.close()
+
+    if decoder.bad_frames:
+        print(f"[decode_log] {decoder.bad_frames} corrupt frames skipped", file=sys.stderr)
+    return 0
+
+
+if __name__ == "__main__":
+    sys.exit(main())